@@ -0,0 +1,156 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// ParallelFor thread scaling.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Runs the policy overloads of Transform, Multiply, Slerp and CullSpheres
+// on ElementCount elements, sequentially and on ThreadPools of 1 to 16
+// threads, and prints the best of RunCount runs in M elements/s.
+//
+// Usage: BenchParallelFor [maxThreads]
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+#include "PhxMathBatch.h"
+#include "PhxMathExecution.h"
+
+// C Standard Library Includes
+#include <stdio.h>
+#include <stdlib.h>
+
+// C++ Standard Library Includes
+#include <chrono>
+
+using namespace Phx::Math;
+
+namespace
+{
+    const unsigned int ElementCount = 1000000;
+    const unsigned int RunCount = 7;
+    const unsigned int PlaneCount = 6;
+
+    struct Data
+    {
+        AlignedArray<Vector3> Points;
+        AlignedArray<Vector3> OutPoints;
+        AlignedArray<Matrix4x4> Matrices;
+        AlignedArray<Matrix4x4> OutMatrices;
+        AlignedArray<Quaternion> Q1;
+        AlignedArray<Quaternion> Q2;
+        AlignedArray<Quaternion> OutQ;
+        AlignedArray<Vector4> Spheres;
+        AlignedArray<unsigned int> OutIndices;
+        Vector4 Planes[PlaneCount];
+        Matrix4x4 M;
+    };
+
+    float Random(float min, float max)
+    {
+        return min + (max - min) * (static_cast<float>(rand()) / static_cast<float>(RAND_MAX));
+    }
+
+    void Fill(Data & data)
+    {
+        data.Points.Resize(ElementCount);
+        data.OutPoints.Resize(ElementCount);
+        data.Matrices.Resize(ElementCount);
+        data.OutMatrices.Resize(ElementCount);
+        data.Q1.Resize(ElementCount);
+        data.Q2.Resize(ElementCount);
+        data.OutQ.Resize(ElementCount);
+        data.Spheres.Resize(ElementCount);
+        data.OutIndices.Resize(ElementCount);
+
+        for (unsigned int i = 0; i < ElementCount; ++i)
+        {
+            data.Points[i] = Vector3(Random(-100.0f, 100.0f), Random(-100.0f, 100.0f), Random(-100.0f, 100.0f));
+            data.Matrices[i] = Matrix4x4::CreateRotationY(Random(0.0f, 6.0f));
+            data.Q1[i] = Quaternion::CreateRotationX(Random(0.0f, 6.0f));
+            data.Q2[i] = Quaternion::CreateRotationX(Random(0.0f, 6.0f));
+            data.Spheres[i] = Vector4(Random(-100.0f, 100.0f), Random(-100.0f, 100.0f), Random(-100.0f, 100.0f), Random(0.1f, 5.0f));
+        }
+
+        // An axis aligned box of planes facing inwards, about half the spheres are inside.
+        data.Planes[0] = Vector4(1.0f, 0.0f, 0.0f, 50.0f);
+        data.Planes[1] = Vector4(-1.0f, 0.0f, 0.0f, 50.0f);
+        data.Planes[2] = Vector4(0.0f, 1.0f, 0.0f, 50.0f);
+        data.Planes[3] = Vector4(0.0f, -1.0f, 0.0f, 50.0f);
+        data.Planes[4] = Vector4(0.0f, 0.0f, 1.0f, 100.0f);
+        data.Planes[5] = Vector4(0.0f, 0.0f, -1.0f, 100.0f);
+
+        data.M = Matrix4x4::CreateRotationZ(0.5f);
+    }
+
+    template <class Function>
+    double BestElementsPerSecond(Function function)
+    {
+        double best = 0.0;
+        for (unsigned int run = 0; run < RunCount; ++run)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            function();
+            const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+            const double rate = ElementCount / seconds.count();
+            best = (rate > best) ? rate : best;
+        }
+        return best;
+    }
+
+    void Run(const char * pName, const ExecutionPolicy & policy, Data & data)
+    {
+        const double transform = BestElementsPerSecond([&]() { Transform(policy, data.Points.GetData(), data.M, data.OutPoints.GetData(), ElementCount); });
+        const double multiply = BestElementsPerSecond([&]() { Multiply(policy, data.Matrices.GetData(), data.Matrices.GetData(), data.OutMatrices.GetData(), ElementCount); });
+        const double slerp = BestElementsPerSecond([&]() { Slerp(policy, data.Q1.GetData(), data.Q2.GetData(), 0.3f, data.OutQ.GetData(), ElementCount); });
+        const double cull = BestElementsPerSecond([&]() { CullSpheres(policy, data.Spheres.GetData(), data.Planes, PlaneCount, data.OutIndices.GetData(), ElementCount); });
+
+        printf("  %-12s %9.0f %9.0f %6.0f %11.0f\n", pName, transform / 1e6, multiply / 1e6, slerp / 1e6, cull / 1e6);
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    const unsigned int maxThreads = (argc > 1) ? static_cast<unsigned int>(atoi(argv[1])) : 16;
+
+    Data data;
+    Fill(data);
+
+    printf("%u elements, best of %u runs, %s kernels, %u hardware threads\n\n", ElementCount, RunCount, GetCpuTierName(GetBatchTier()), GetDefaultThreadPool().GetThreadCount());
+    printf("  M elements/s  Transform  Multiply  Slerp  CullSpheres\n");
+
+    Run("sequential", ExecutionPolicy::CreateSequential(), data);
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        ThreadPool pool(threads);
+
+        char name[32];
+        snprintf(name, sizeof(name), "pool %u", threads);
+        Run(name, ExecutionPolicy::CreateThreadPool(&pool), data);
+    }
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Ray packet throughput per kernel tier.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Intersects RayCount random rays against one box and one triangle on each
+// tier the cpu supports, and prints the best of RunCount runs in M rays/s.
+// The rays fit in L2 and each run makes PassCount passes over them, so the
+// numbers are the kernels and not memory bandwidth.
+//
+// Usage: BenchRayPacket
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+#include "PhxMathBatch.h"
+#include "PhxMathRay.h"
+
+// C Standard Library Includes
+#include <stdio.h>
+#include <stdlib.h>
+
+// C++ Standard Library Includes
+#include <chrono>
+
+using namespace Phx::Math;
+
+namespace
+{
+    const unsigned int RayCount = 1 << 14;
+    const unsigned int PassCount = 64;
+    const unsigned int RunCount = 9;
+
+    float Random(float min, float max)
+    {
+        return min + (max - min) * (static_cast<float>(rand()) / static_cast<float>(RAND_MAX));
+    }
+
+    template <class Function>
+    double BestRaysPerSecond(Function function)
+    {
+        double best = 0.0;
+        for (unsigned int run = 0; run < RunCount; ++run)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (unsigned int pass = 0; pass < PassCount; ++pass)
+            {
+                function();
+            }
+            const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+            const double rate = static_cast<double>(RayCount) * PassCount / seconds.count();
+            best = (rate > best) ? rate : best;
+        }
+        return best;
+    }
+}
+
+int main()
+{
+    AlignedArray<float> storage(RayCount * 9);
+    RaySoA rays;
+    rays.Origin.X = storage.GetData();
+    rays.Origin.Y = rays.Origin.X + RayCount;
+    rays.Origin.Z = rays.Origin.Y + RayCount;
+    rays.Direction.X = rays.Origin.Z + RayCount;
+    rays.Direction.Y = rays.Direction.X + RayCount;
+    rays.Direction.Z = rays.Direction.Y + RayCount;
+    rays.InvDirection.X = rays.Direction.Z + RayCount;
+    rays.InvDirection.Y = rays.InvDirection.X + RayCount;
+    rays.InvDirection.Z = rays.InvDirection.Y + RayCount;
+
+    // Rays from a shell around the origin, aimed at points near it.
+    for (unsigned int i = 0; i < RayCount; ++i)
+    {
+        const Vector3 origin(Random(-10.0f, 10.0f), Random(-10.0f, 10.0f), Random(5.0f, 10.0f));
+        const Vector3 target(Random(-2.0f, 2.0f), Random(-2.0f, 2.0f), Random(-2.0f, 2.0f));
+        Set(rays, i, Ray(origin, Normalize(Subtract(target, origin))));
+    }
+
+    const AABB box(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f));
+    const Vector3 v0(-2.0f, -1.0f, 0.0f);
+    const Vector3 v1(2.0f, -1.0f, 0.0f);
+    const Vector3 v2(0.0f, 2.0f, 0.0f);
+
+    AlignedArray<float> hits(RayCount);
+
+    printf("%u rays x %u passes, best of %u runs\n\n", RayCount, PassCount, RunCount);
+    printf("  tier     box M rays/s  triangle M rays/s\n");
+
+    for (unsigned int tier = 0; tier < CpuTier::Count; ++tier)
+    {
+        if (false == IsCpuTierSupported(static_cast<CpuTier::Type>(tier)))
+        {
+            continue;
+        }
+
+        SetBatchTier(static_cast<CpuTier::Type>(tier));
+
+        const double boxRate = BestRaysPerSecond([&]() { Intersect(rays, box, hits.GetData(), RayCount); });
+        const double triangleRate = BestRaysPerSecond([&]() { Intersect(rays, v0, v1, v2, hits.GetData(), RayCount); });
+
+        printf("  %-7s  %12.0f  %17.0f\n", GetCpuTierName(static_cast<CpuTier::Type>(tier)), boxRate / 1e6, triangleRate / 1e6);
+    }
+
+    ResetBatchTier();
+    return 0;
+}
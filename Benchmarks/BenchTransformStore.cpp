@@ -0,0 +1,234 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// TransformStore contention against a mutex guarded array.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// One writer republishes TransformCount matrices in a loop while 1 to 16
+// readers each take a snapshot, read every matrix and release it. The
+// mutex baseline runs the same loops on one std::mutex guarded array.
+// Each run lasts RunMilliseconds and reports reads and publishes per
+// second and the longest single read and write in microseconds.
+//
+// The uncontended cost of acquire plus release, and of lock plus unlock,
+// is printed first.
+//
+// Usage: BenchTransformStore [maxReaders]
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+#include "PhxMathTransformStore.h"
+
+// C Standard Library Includes
+#include <stdio.h>
+#include <stdlib.h>
+
+// C++ Standard Library Includes
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Phx::Math;
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const unsigned int TransformCount = 1000;
+    const unsigned int RunMilliseconds = 500;
+    const unsigned int UncontendedIterations = 10000000;
+
+    struct Result
+    {
+        uint64_t Reads;
+        uint64_t Publishes;
+        double MaxReadMicroseconds;
+        double MaxWriteMicroseconds;
+    };
+
+    double Microseconds(Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::micro>(duration).count();
+    }
+
+    // Sums a translation so the reads can't be optimized away.
+    float ReadAll(const Matrix4x4 * pMatrices, unsigned int count)
+    {
+        float sum = 0.0f;
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            sum += pMatrices[i].M41;
+        }
+        return sum;
+    }
+
+    void WriteAll(Matrix4x4 * pMatrices, unsigned int count, float value)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            pMatrices[i] = Matrix4x4::Identity;
+            pMatrices[i].M41 = value;
+        }
+    }
+
+    // Runs the reader and writer loops for RunMilliseconds. Read and Write each do one full pass and are timed.
+    template <class ReadFunction, class WriteFunction>
+    Result Contend(unsigned int readerCount, ReadFunction read, WriteFunction write)
+    {
+        std::atomic<bool> stop(false);
+        std::atomic<uint64_t> reads(0);
+        std::vector<double> maxReads(readerCount, 0.0);
+        std::vector<std::thread> readers;
+
+        for (unsigned int r = 0; r < readerCount; ++r)
+        {
+            readers.push_back(std::thread([&, r]()
+            {
+                uint64_t count = 0;
+                double maxRead = 0.0;
+                while (false == stop.load(std::memory_order_relaxed))
+                {
+                    const Clock::time_point start = Clock::now();
+                    read();
+                    const double elapsed = Microseconds(Clock::now() - start);
+                    maxRead = (elapsed > maxRead) ? elapsed : maxRead;
+                    ++count;
+                }
+                reads += count;
+                maxReads[r] = maxRead;
+            }));
+        }
+
+        Result result;
+        result.Publishes = 0;
+        result.MaxWriteMicroseconds = 0.0;
+
+        const Clock::time_point end = Clock::now() + std::chrono::milliseconds(RunMilliseconds);
+        while (Clock::now() < end)
+        {
+            const Clock::time_point start = Clock::now();
+            write(static_cast<float>(result.Publishes));
+            const double elapsed = Microseconds(Clock::now() - start);
+            result.MaxWriteMicroseconds = (elapsed > result.MaxWriteMicroseconds) ? elapsed : result.MaxWriteMicroseconds;
+            ++result.Publishes;
+        }
+
+        stop = true;
+        for (unsigned int r = 0; r < readerCount; ++r)
+        {
+            readers[r].join();
+        }
+
+        const double seconds = RunMilliseconds / 1000.0;
+        result.Reads = static_cast<uint64_t>(reads.load() / seconds);
+        result.Publishes = static_cast<uint64_t>(result.Publishes / seconds);
+        result.MaxReadMicroseconds = 0.0;
+        for (unsigned int r = 0; r < readerCount; ++r)
+        {
+            result.MaxReadMicroseconds = (maxReads[r] > result.MaxReadMicroseconds) ? maxReads[r] : result.MaxReadMicroseconds;
+        }
+        return result;
+    }
+
+    void Print(unsigned int readerCount, const char * pKind, const Result & result)
+    {
+        printf("  %-7u  %-5s  %9llu  %11llu  %11.0f  %12.0f\n", readerCount, pKind,
+            static_cast<unsigned long long>(result.Reads), static_cast<unsigned long long>(result.Publishes),
+            result.MaxReadMicroseconds, result.MaxWriteMicroseconds);
+    }
+
+    volatile float g_sink;
+}
+
+int main(int argc, char ** argv)
+{
+    const unsigned int maxReaders = (argc > 1) ? static_cast<unsigned int>(atoi(argv[1])) : 16;
+
+    Matrix4x4Store store(TransformCount);
+    WriteAll(store.BeginWrite().GetData(), TransformCount, 0.0f);
+    store.Publish();
+
+    std::mutex mutex;
+    std::vector<Matrix4x4> locked(TransformCount, Matrix4x4::Identity);
+
+    // Uncontended cost of getting to the data.
+    {
+        const Clock::time_point start = Clock::now();
+        for (unsigned int i = 0; i < UncontendedIterations; ++i)
+        {
+            TransformSnapshot<Matrix4x4> snapshot;
+            store.AcquireSnapshot(snapshot);
+            g_sink = snapshot[0].M41;
+        }
+        const double storeNanoseconds = Microseconds(Clock::now() - start) * 1000.0 / UncontendedIterations;
+
+        const Clock::time_point mutexStart = Clock::now();
+        for (unsigned int i = 0; i < UncontendedIterations; ++i)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            g_sink = locked[0].M41;
+        }
+        const double mutexNanoseconds = Microseconds(Clock::now() - mutexStart) * 1000.0 / UncontendedIterations;
+
+        printf("%u hardware threads\n", std::thread::hardware_concurrency());
+        printf("Uncontended: acquire + release %.1f ns, lock + unlock %.1f ns\n\n", storeNanoseconds, mutexNanoseconds);
+    }
+
+    printf("  readers  kind     reads/s  publishes/s  max read us  max write us\n");
+
+    for (unsigned int readerCount = 1; readerCount <= maxReaders; readerCount *= 2)
+    {
+        const Result storeResult = Contend(readerCount,
+            [&]()
+            {
+                TransformSnapshot<Matrix4x4> snapshot;
+                store.AcquireSnapshot(snapshot);
+                g_sink = ReadAll(snapshot.GetData(), snapshot.GetCount());
+            },
+            [&](float value)
+            {
+                WriteAll(store.BeginWrite().GetData(), TransformCount, value);
+                store.Publish();
+            });
+        Print(readerCount, "store", storeResult);
+
+        const Result mutexResult = Contend(readerCount,
+            [&]()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                g_sink = ReadAll(locked.data(), TransformCount);
+            },
+            [&](float value)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                WriteAll(locked.data(), TransformCount, value);
+            });
+        Print(readerCount, "mutex", mutexResult);
+    }
+
+    return 0;
+}
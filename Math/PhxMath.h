@@ -50,6 +50,14 @@ THE SOFTWARE
 # define PHX_RESTRICT_PTR __restrict
 #endif
 
+// Vector4 and Quaternion are aligned to 16 bytes so a SIMD load of one never splits a cache line,
+// Matrix4x4 is aligned to 64 bytes so each matrix sits in a single cache line. The kernels don't
+// rely on it, they use unaligned loads and stores (see PHX_CACHE_LINE_SIZE in PhxMathMemory.h).
+// Define this as empty before including PhxMath.h to get the packed (4 byte aligned) layout back.
+#ifndef PHX_ALIGN
+# define PHX_ALIGN(bytes) alignas(bytes)
+#endif
+
 // Mangage the dependencies between the math classes by explicity
 // ordering their declarations before their inlined implementations.
 
@@ -57,35 +65,65 @@ THE SOFTWARE
 namespace Phx {
 namespace Math {
 
+    class AABB;
+    class Matrix3x2;
+    class Matrix3x3;
     class Matrix4x4;
+    class OBB;
+    class Plane;
     class Quaternion;
+    class Ray;
     class Rect;
+    class Sphere;
     class Vector2;
     class Vector3;
     class Vector4;
+    class Vector3d;
 
 } //namespace Math
 } //namespace Phx
 
 // Class Declarations
+#include "PhxMathStats.h"
+#include "PhxMathShadow.h"
 #include "PhxMathFloat.h"
+#include "PhxMathMatrix3x2.h"
+#include "PhxMathMatrix3x3.h"
 #include "PhxMathMatrix4x4.h"
 #include "PhxMathQuaternion.h"
 #include "PhxMathRectangle.h"
 #include "PhxMathVector2.h"
 #include "PhxMathVector3.h"
 #include "PhxMathVector4.h"
+#include "PhxMathVector3d.h"
+#include "PhxMathAABB.h"
+#include "PhxMathSphere.h"
+#include "PhxMathOBB.h"
+#include "PhxMathPlane.h"
+#include "PhxMathRay.h"
+#include "PhxMathRebase.h"
 
 // Inline Implementations
+#include "PhxMathStats.inl"
+#include "PhxMathShadow.inl"
 #include "PhxMathFloat.inl"
+#include "PhxMathMatrix3x2.inl"
+#include "PhxMathMatrix3x3.inl"
 #include "PhxMathMatrix4x4.inl"
 #include "PhxMathQuaternion.inl"
 #include "PhxMathRectangle.inl"
 #include "PhxMathVector2.inl"
 #include "PhxMathVector3.inl"
 #include "PhxMathVector4.inl"
-
-// Typedef for basic matrix (4x3, 3x3, 2x2 may be implemented in the future)
+#include "PhxMathVector3d.inl"
+#include "PhxMathAABB.inl"
+#include "PhxMathSphere.inl"
+#include "PhxMathOBB.inl"
+#include "PhxMathPlane.inl"
+#include "PhxMathRay.inl"
+#include "PhxMathRebase.inl"
+
+// Typedef for basic matrix (Matrix3x3 holds rotation and scale only, Matrix3x2 is the 2D affine transform)
 namespace Phx {
 namespace Math {
 
@@ -0,0 +1,116 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_AABB_H_
+#define _PHX_MATH_AABB_H_
+
+namespace Phx {
+namespace Math {
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Axis Aligned Bounding Box
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Empty is inverted (Min = FLT_MAX, Max = -FLT_MAX) so merging anything
+    // into it gives that thing back.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    class AABB
+    {
+    public:
+        Vector3 Min;
+        Vector3 Max;
+
+    public:
+        static const AABB Empty;
+
+    public:
+        static inline AABB CreateFromPoints(const Vector3 * pPoints, unsigned int count);
+        static inline void CreateFromPoints(const Vector3 * pPoints, unsigned int count, AABB & out);
+
+        static inline AABB CreateFromCenterExtents(const Vector3 & center, const Vector3 & extents);
+        static inline void CreateFromCenterExtents(const Vector3 & center, const Vector3 & extents, AABB & out);
+
+    public:
+        inline AABB()
+        {
+            // Do nothing in the default ctor.
+            // So we don't have to pay for arrays or boxes initialized as an out parameter.
+        }
+        inline explicit AABB(const Vector3 & min, const Vector3 & max);
+        inline AABB(const AABB & src);
+
+        inline ~AABB() { }
+
+        inline AABB & operator=(const AABB & rhs);
+
+        inline Vector3 GetCenter() const;
+
+        // Half the size on each axis.
+        inline Vector3 GetExtents() const;
+        inline Vector3 GetSize() const;
+
+        inline bool IsEmpty() const;
+
+        inline bool Contains(const Vector3 & p) const;
+        inline bool Contains(const AABB & box) const;
+
+        inline bool Intersects(const AABB & box) const;
+
+        inline void Merge(const Vector3 & p);
+        inline void Merge(const AABB & box);
+
+        inline void Set(const Vector3 & min, const Vector3 & max);
+        inline void Set(const AABB & src);
+    };
+
+    inline bool operator==(const AABB & lhs, const AABB & rhs);
+    inline bool operator!=(const AABB & lhs, const AABB & rhs);
+
+    inline bool ExactlyEqual(const AABB & lhs, const AABB & rhs);
+    inline bool NearlyEqual(const AABB & lhs, const AABB & rhs);
+
+    inline bool IsEmpty(const AABB & box);
+
+    // Points right on the faces are contained.
+    inline bool Contains(const AABB & box, const Vector3 & p);
+    inline bool Contains(const AABB & box1, const AABB & box2);
+
+    // Touching boxes intersect.
+    inline bool Intersects(const AABB & box1, const AABB & box2);
+
+    inline AABB Merge(const AABB & box, const Vector3 & p);
+    inline AABB Merge(const AABB & box1, const AABB & box2);
+    inline void Merge(const AABB & box, const Vector3 & p, AABB & out);
+    inline void Merge(const AABB & box1, const AABB & box2, AABB & out);
+
+    // Box containing the transformed corners of box.
+    inline AABB Transform(const AABB & box, const Matrix4x4 & m);
+    inline void Transform(const AABB & box, const Matrix4x4 & m, AABB & out);
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_AABB_H_
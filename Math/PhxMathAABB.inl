@@ -0,0 +1,253 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_AABB_INL_
+#define _PHX_MATH_AABB_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline AABB AABB::CreateFromPoints(const Vector3 * pPoints, unsigned int count)
+    {
+        AABB out;
+        CreateFromPoints(pPoints, count, out);
+        return out;
+    }
+
+    inline void AABB::CreateFromPoints(const Vector3 * pPoints, unsigned int count, AABB & out)
+    {
+        out.Set(AABB::Empty);
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            out.Merge(pPoints[i]);
+        }
+    }
+
+    inline AABB AABB::CreateFromCenterExtents(const Vector3 & center, const Vector3 & extents)
+    {
+        AABB out;
+        CreateFromCenterExtents(center, extents, out);
+        return out;
+    }
+
+    inline void AABB::CreateFromCenterExtents(const Vector3 & center, const Vector3 & extents, AABB & out)
+    {
+        DebugAssert(AllGreaterEqual(extents, Vector3::Zero), "Box extents cannot be negative.");
+
+        Subtract(center, extents, out.Min);
+        Add(center, extents, out.Max);
+    }
+
+    inline AABB::AABB(const Vector3 & min, const Vector3 & max)
+        : Min(min)
+        , Max(max)
+    { }
+
+    inline AABB::AABB(const AABB & src)
+    {
+        Set(src);
+    }
+
+    inline AABB & AABB::operator=(const AABB & rhs)
+    {
+        Set(rhs);
+        return *this;
+    }
+
+    inline Vector3 AABB::GetCenter() const
+    {
+        return Vector3((this->Min.X + this->Max.X) * 0.5f,
+                       (this->Min.Y + this->Max.Y) * 0.5f,
+                       (this->Min.Z + this->Max.Z) * 0.5f);
+    }
+
+    inline Vector3 AABB::GetExtents() const
+    {
+        return Vector3((this->Max.X - this->Min.X) * 0.5f,
+                       (this->Max.Y - this->Min.Y) * 0.5f,
+                       (this->Max.Z - this->Min.Z) * 0.5f);
+    }
+
+    inline Vector3 AABB::GetSize() const
+    {
+        return Subtract(this->Max, this->Min);
+    }
+
+    inline bool AABB::IsEmpty() const
+    {
+        return Math::IsEmpty(*this);
+    }
+
+    inline bool AABB::Contains(const Vector3 & p) const
+    {
+        return Math::Contains(*this, p);
+    }
+
+    inline bool AABB::Contains(const AABB & box) const
+    {
+        return Math::Contains(*this, box);
+    }
+
+    inline bool AABB::Intersects(const AABB & box) const
+    {
+        return Math::Intersects(*this, box);
+    }
+
+    inline void AABB::Merge(const Vector3 & p)
+    {
+        Math::Merge(*this, p, *this);
+    }
+
+    inline void AABB::Merge(const AABB & box)
+    {
+        Math::Merge(*this, box, *this);
+    }
+
+    inline void AABB::Set(const Vector3 & min, const Vector3 & max)
+    {
+        this->Min.Set(min);
+        this->Max.Set(max);
+    }
+
+    inline void AABB::Set(const AABB & src)
+    {
+        this->Min.Set(src.Min);
+        this->Max.Set(src.Max);
+    }
+
+    inline bool operator==(const AABB & lhs, const AABB & rhs)
+    {
+        return ExactlyEqual(lhs, rhs);
+    }
+
+    inline bool operator!=(const AABB & lhs, const AABB & rhs)
+    {
+        return (false == ExactlyEqual(lhs, rhs));
+    }
+
+    inline bool ExactlyEqual(const AABB & lhs, const AABB & rhs)
+    {
+        return ExactlyEqual(lhs.Min, rhs.Min) &&
+               ExactlyEqual(lhs.Max, rhs.Max);
+    }
+
+    inline bool NearlyEqual(const AABB & lhs, const AABB & rhs)
+    {
+        return NearlyEqual(lhs.Min, rhs.Min) &&
+               NearlyEqual(lhs.Max, rhs.Max);
+    }
+
+    inline bool IsEmpty(const AABB & box)
+    {
+        // Any inverted axis, Empty and anything merged from it without points.
+        return (box.Min.X > box.Max.X) ||
+               (box.Min.Y > box.Max.Y) ||
+               (box.Min.Z > box.Max.Z);
+    }
+
+    inline bool Contains(const AABB & box, const Vector3 & p)
+    {
+        return AllLessEqual(box.Min, p) && AllLessEqual(p, box.Max);
+    }
+
+    inline bool Contains(const AABB & box1, const AABB & box2)
+    {
+        return AllLessEqual(box1.Min, box2.Min) && AllLessEqual(box2.Max, box1.Max);
+    }
+
+    inline bool Intersects(const AABB & box1, const AABB & box2)
+    {
+        return AllLessEqual(box1.Min, box2.Max) && AllLessEqual(box2.Min, box1.Max);
+    }
+
+    inline AABB Merge(const AABB & box, const Vector3 & p)
+    {
+        AABB out;
+        Merge(box, p, out);
+        return out;
+    }
+
+    inline AABB Merge(const AABB & box1, const AABB & box2)
+    {
+        AABB out;
+        Merge(box1, box2, out);
+        return out;
+    }
+
+    inline void Merge(const AABB & box, const Vector3 & p, AABB & out)
+    {
+        Min(box.Min, p, out.Min);
+        Max(box.Max, p, out.Max);
+    }
+
+    inline void Merge(const AABB & box1, const AABB & box2, AABB & out)
+    {
+        Min(box1.Min, box2.Min, out.Min);
+        Max(box1.Max, box2.Max, out.Max);
+    }
+
+    inline AABB Transform(const AABB & box, const Matrix4x4 & m)
+    {
+        AABB out;
+        Transform(box, m, out);
+        return out;
+    }
+
+    inline void Transform(const AABB & box, const Matrix4x4 & m, AABB & out)
+    {
+        // Arvo's method: start from the translation, and for each matrix element take the
+        // smaller and larger of the element times the min and max of that axis.
+
+        DebugAssert(false == IsEmpty(box), "Trying to transform an empty box.");
+
+        float min[3] = { m.M41, m.M42, m.M43 };
+        float max[3] = { m.M41, m.M42, m.M43 };
+
+        const float boxMin[3] = { box.Min.X, box.Min.Y, box.Min.Z };
+        const float boxMax[3] = { box.Max.X, box.Max.Y, box.Max.Z };
+
+        for (unsigned int row = 0; row < 3; ++row)
+        {
+            for (unsigned int col = 0; col < 3; ++col)
+            {
+                const float e = m[row * 4 + col];
+                const float a = e * boxMin[row];
+                const float b = e * boxMax[row];
+
+                min[col] += Math::Min(a, b);
+                max[col] += Math::Max(a, b);
+            }
+        }
+
+        out.Min.Set(min[0], min[1], min[2]);
+        out.Max.Set(max[0], max[1], max[2]);
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_AABB_INL_
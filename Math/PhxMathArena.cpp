@@ -0,0 +1,205 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathArena.h"
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // Remembers which sub arena this thread claimed with GetLocalArena.
+        // A few entries so a thread can work with more than one frame arena without re-claiming every call.
+        struct LocalArenaCache
+        {
+            const FrameArena * pOwner;
+            unsigned int generation;
+            LinearArena * pArena;
+        };
+
+        const unsigned int LocalArenaCacheSize = 4;
+
+        thread_local LocalArenaCache t_localArenas[LocalArenaCacheSize] = { };
+        thread_local unsigned int t_nextLocalArena = 0;
+
+        // Non zero and unique per thread, marks the sub arenas a thread claimed so it finds them again
+        // once they dropped out of its cache.
+        std::atomic<unsigned int> s_nextThreadToken(1);
+        thread_local unsigned int t_threadToken = 0;
+
+        uint64_t GetClaim(unsigned int generation)
+        {
+            if (t_threadToken == 0)
+            {
+                t_threadToken = s_nextThreadToken.fetch_add(1, std::memory_order_relaxed);
+            }
+            return (static_cast<uint64_t>(generation) << 32) | t_threadToken;
+        }
+
+        // Every initialize/reset gets a new generation, so claims from a previous frame
+        // (or a previous arena that lived at the same address) are never reused.
+        std::atomic<unsigned int> s_nextGeneration(1);
+    }
+
+    FrameArena::FrameArena()
+        : m_pSlots(nullptr)
+        , m_pMemory(nullptr)
+        , m_threadCount(0)
+        , m_generation(0)
+        , m_nextLocalSlot(0)
+    { }
+
+    FrameArena::~FrameArena()
+    {
+        Shutdown();
+    }
+
+    bool FrameArena::Initialize(size_t bytesPerThread, unsigned int threadCount)
+    {
+        DebugAssert(m_pMemory == nullptr, "Frame arena is already initialized.");
+        DebugAssert(threadCount > 0, "A frame arena needs at least one thread.");
+
+        // Round each sub arena up to a whole number of cache lines so neighbouring threads never share one.
+        const size_t lineMask = PHX_CACHE_LINE_SIZE - 1;
+        const size_t arenaBytes = (bytesPerThread + lineMask) & ~lineMask;
+
+        m_pSlots = AlignedAllocArray<Slot>(threadCount, alignof(Slot));
+        m_pMemory = static_cast<unsigned char *>(AlignedAlloc(arenaBytes * threadCount, PHX_CACHE_LINE_SIZE));
+
+        if (m_pSlots == nullptr || m_pMemory == nullptr)
+        {
+            Shutdown();
+            return false;
+        }
+
+        for (unsigned int i = 0; i < threadCount; ++i)
+        {
+            new (&m_pSlots[i]) Slot();
+            m_pSlots[i].Arena.Initialize(m_pMemory + (arenaBytes * i), arenaBytes);
+            m_pSlots[i].Claim.store(0, std::memory_order_relaxed);
+        }
+
+        m_threadCount = threadCount;
+        m_generation = s_nextGeneration.fetch_add(1, std::memory_order_relaxed);
+        m_nextLocalSlot.store(0);
+
+        return true;
+    }
+
+    void FrameArena::Shutdown()
+    {
+        AlignedFree(m_pSlots);
+        AlignedFree(m_pMemory);
+
+        m_pSlots = nullptr;
+        m_pMemory = nullptr;
+        m_threadCount = 0;
+
+        // Invalidate any thread local claims on this arena.
+        m_generation = 0;
+    }
+
+    LinearArena * FrameArena::GetLocalArena()
+    {
+        for (unsigned int i = 0; i < LocalArenaCacheSize; ++i)
+        {
+            if (t_localArenas[i].pOwner == this && t_localArenas[i].generation == m_generation)
+            {
+                return t_localArenas[i].pArena;
+            }
+        }
+
+        // Not cached, but the thread may still have claimed a sub arena this frame and used enough other frame
+        // arenas since to push it out of the cache. Only this thread writes its own claim, so it always sees it.
+        const uint64_t claim = GetClaim(m_generation);
+        const unsigned int claimed = m_nextLocalSlot.load(std::memory_order_relaxed);
+
+        unsigned int slot = m_threadCount;
+        for (unsigned int i = 0; i < claimed && i < m_threadCount; ++i)
+        {
+            if (m_pSlots[i].Claim.load(std::memory_order_relaxed) == claim)
+            {
+                slot = i;
+                break;
+            }
+        }
+
+        if (slot == m_threadCount)
+        {
+            slot = m_nextLocalSlot.fetch_add(1, std::memory_order_relaxed);
+            if (slot >= m_threadCount)
+            {
+                DebugAssert(false, "More threads (%u) asked for a local arena than the frame arena was created for (%u).", slot + 1, m_threadCount);
+                return nullptr;
+            }
+
+            m_pSlots[slot].Claim.store(claim, std::memory_order_relaxed);
+        }
+
+        LocalArenaCache & entry = t_localArenas[t_nextLocalArena];
+        t_nextLocalArena = (t_nextLocalArena + 1) % LocalArenaCacheSize;
+
+        entry.pOwner = this;
+        entry.generation = m_generation;
+        entry.pArena = &m_pSlots[slot].Arena;
+
+        return entry.pArena;
+    }
+
+    void FrameArena::Reset()
+    {
+        for (unsigned int i = 0; i < m_threadCount; ++i)
+        {
+            m_pSlots[i].Arena.Reset();
+        }
+
+        // Threads have to claim a new local arena next frame.
+        m_generation = s_nextGeneration.fetch_add(1, std::memory_order_relaxed);
+        m_nextLocalSlot.store(0, std::memory_order_relaxed);
+    }
+
+    size_t FrameArena::GetUsed() const
+    {
+        size_t used = 0;
+        for (unsigned int i = 0; i < m_threadCount; ++i)
+        {
+            used += m_pSlots[i].Arena.GetUsed();
+        }
+        return used;
+    }
+
+    size_t FrameArena::GetHighWater() const
+    {
+        size_t highWater = 0;
+        for (unsigned int i = 0; i < m_threadCount; ++i)
+        {
+            highWater += m_pSlots[i].Arena.GetHighWater();
+        }
+        return highWater;
+    }
+
+} //namespace Math
+} //namespace Phx
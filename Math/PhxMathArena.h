@@ -0,0 +1,172 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_ARENA_H_
+#define _PHX_MATH_ARENA_H_
+
+#include "PhxMathMemory.h"
+
+// C Standard Library Includes
+#include <stdint.h>
+
+// C++ Standard Library Includes
+#include <atomic>
+
+namespace Phx {
+namespace Math {
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Typed view of a block of memory handed out by an arena.
+    // Does not own the memory.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    template <class T>
+    class Span
+    {
+    public:
+        inline Span();
+        inline Span(T * pData, unsigned int count);
+
+        inline T & operator[](unsigned int idx) const;
+
+        inline unsigned int GetCount() const;
+        inline bool IsEmpty() const;
+
+        inline T * GetData() const;
+
+        inline T * begin() const;
+        inline T * end() const;
+
+    private:
+        T * m_pData;
+        unsigned int m_count;
+    };
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Linear (bump pointer) allocator over a fixed block of memory.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Allocations are never freed individually, Reset releases everything
+    // at once by moving the cursor back to the start of the block.
+    // Not thread safe, give every thread its own arena (see FrameArena).
+    //
+    // Like the math types, memory handed out by the arena is not
+    // initialized.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    class LinearArena
+    {
+    public:
+        inline LinearArena();
+        inline LinearArena(void * pBuffer, size_t bytes);
+
+        inline void Initialize(void * pBuffer, size_t bytes);
+
+        inline void * Allocate(size_t bytes, size_t alignment);
+
+        template <class T>
+        inline Span<T> AllocateSpan(unsigned int count);
+        template <class T>
+        inline Span<T> AllocateSpan(unsigned int count, size_t alignment);
+
+        inline size_t GetMarker() const;
+        inline void ResetToMarker(size_t marker);
+        inline void Reset();
+
+        inline size_t GetUsed() const;
+        inline size_t GetCapacity() const;
+        inline size_t GetHighWater() const;
+
+    private:
+        unsigned char * m_pBuffer;
+        size_t m_capacity;
+        size_t m_offset;
+        size_t m_highWater;
+    };
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Per frame scratch memory split into one LinearArena per thread.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // The whole frame arena is a single allocation made up front, every
+    // thread allocates from its own sub arena so parallel jobs never
+    // contend on a lock or on the global heap. Each sub arena and its
+    // bookkeeping start on their own cache line.
+    //
+    // Threads either pass their own index (job system worker index) to
+    // GetThreadArena, or call GetLocalArena which hands out the next free
+    // sub arena the first time a thread asks for one during a frame, and
+    // the same one on every later call that frame. The last few arenas a
+    // thread used are cached, a thread going through more of them finds
+    // its sub arena again by scanning the ones claimed this frame.
+    //
+    // Reset must be called when no other thread is using the arena,
+    // typically at the end of the frame. It costs one store per sub arena
+    // regardless of how much was allocated.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    class FrameArena
+    {
+    public:
+        FrameArena();
+        ~FrameArena();
+
+        bool Initialize(size_t bytesPerThread, unsigned int threadCount);
+        void Shutdown();
+
+        inline LinearArena & GetThreadArena(unsigned int threadIndex);
+        LinearArena * GetLocalArena();
+
+        void Reset();
+
+        inline unsigned int GetThreadCount() const;
+
+        size_t GetUsed() const;
+        size_t GetHighWater() const;
+
+    private:
+        // Non-copyable
+        FrameArena(const FrameArena &);
+        FrameArena & operator=(const FrameArena &);
+
+    private:
+        struct PHX_ALIGN(PHX_CACHE_LINE_SIZE) Slot
+        {
+            LinearArena Arena;
+            std::atomic<uint64_t> Claim;    // Generation in the high bits and the claiming thread's token in the low bits, 0 when free.
+        };
+
+        Slot * m_pSlots;
+        unsigned char * m_pMemory;
+        unsigned int m_threadCount;
+        unsigned int m_generation;
+        std::atomic<unsigned int> m_nextLocalSlot;
+    };
+
+} //namespace Math
+} //namespace Phx
+
+#include "PhxMathArena.inl"
+
+#endif //_PHX_MATH_ARENA_H_
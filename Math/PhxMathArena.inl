@@ -0,0 +1,192 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_ARENA_INL_
+#define _PHX_MATH_ARENA_INL_
+
+namespace Phx {
+namespace Math {
+
+    template <class T>
+    inline Span<T>::Span()
+        : m_pData(nullptr)
+        , m_count(0)
+    { }
+
+    template <class T>
+    inline Span<T>::Span(T * pData, unsigned int count)
+        : m_pData(pData)
+        , m_count(count)
+    { }
+
+    template <class T>
+    inline T & Span<T>::operator[](unsigned int idx) const
+    {
+        DebugAssert(idx < m_count, "Invalid index (%u) into a span of size (%u)!", idx, m_count);
+        return m_pData[idx];
+    }
+
+    template <class T>
+    inline unsigned int Span<T>::GetCount() const
+    {
+        return m_count;
+    }
+
+    template <class T>
+    inline bool Span<T>::IsEmpty() const
+    {
+        return (m_count == 0);
+    }
+
+    template <class T>
+    inline T * Span<T>::GetData() const
+    {
+        return m_pData;
+    }
+
+    template <class T>
+    inline T * Span<T>::begin() const
+    {
+        return m_pData;
+    }
+
+    template <class T>
+    inline T * Span<T>::end() const
+    {
+        return m_pData + m_count;
+    }
+
+    inline LinearArena::LinearArena()
+        : m_pBuffer(nullptr)
+        , m_capacity(0)
+        , m_offset(0)
+        , m_highWater(0)
+    { }
+
+    inline LinearArena::LinearArena(void * pBuffer, size_t bytes)
+    {
+        Initialize(pBuffer, bytes);
+    }
+
+    inline void LinearArena::Initialize(void * pBuffer, size_t bytes)
+    {
+        m_pBuffer = static_cast<unsigned char *>(pBuffer);
+        m_capacity = bytes;
+        m_offset = 0;
+        m_highWater = 0;
+    }
+
+    inline void * LinearArena::Allocate(size_t bytes, size_t alignment)
+    {
+        DebugAssert((alignment & (alignment - 1)) == 0, "Alignment (%u) must be a power of two.", alignment);
+
+        // Align the address rather than the offset so the alignment holds for any buffer.
+        const size_t address = reinterpret_cast<size_t>(m_pBuffer) + m_offset;
+        const size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+        const size_t start = m_offset + padding;
+
+        if (start + bytes > m_capacity || start + bytes < start)
+        {
+            DebugAssert(false, "Linear arena is out of memory, (%u) bytes requested with (%u) of (%u) used.", bytes, m_offset, m_capacity);
+            return nullptr;
+        }
+
+        m_offset = start + bytes;
+        if (m_offset > m_highWater)
+        {
+            m_highWater = m_offset;
+        }
+
+        return m_pBuffer + start;
+    }
+
+    template <class T>
+    inline Span<T> LinearArena::AllocateSpan(unsigned int count)
+    {
+        // At least 16 byte aligned so the span can be used with SIMD loads and stores.
+        return AllocateSpan<T>(count, (alignof(T) < 16) ? 16 : alignof(T));
+    }
+
+    template <class T>
+    inline Span<T> LinearArena::AllocateSpan(unsigned int count, size_t alignment)
+    {
+        DebugAssert(alignment >= alignof(T), "Alignment (%u) is less than the alignment of the type (%u).", alignment, alignof(T));
+
+        T * pData = static_cast<T *>(Allocate(sizeof(T) * count, alignment));
+        if (pData == nullptr)
+        {
+            return Span<T>();
+        }
+        return Span<T>(pData, count);
+    }
+
+    inline size_t LinearArena::GetMarker() const
+    {
+        return m_offset;
+    }
+
+    inline void LinearArena::ResetToMarker(size_t marker)
+    {
+        // Frees everything allocated after the marker was taken.
+        DebugAssert(marker <= m_offset, "Invalid marker (%u), the arena has only (%u) bytes allocated.", marker, m_offset);
+        m_offset = marker;
+    }
+
+    inline void LinearArena::Reset()
+    {
+        m_offset = 0;
+    }
+
+    inline size_t LinearArena::GetUsed() const
+    {
+        return m_offset;
+    }
+
+    inline size_t LinearArena::GetCapacity() const
+    {
+        return m_capacity;
+    }
+
+    inline size_t LinearArena::GetHighWater() const
+    {
+        return m_highWater;
+    }
+
+    inline LinearArena & FrameArena::GetThreadArena(unsigned int threadIndex)
+    {
+        DebugAssert(threadIndex < m_threadCount, "Invalid thread index (%u) into a frame arena with (%u) threads!", threadIndex, m_threadCount);
+        return m_pSlots[threadIndex].Arena;
+    }
+
+    inline unsigned int FrameArena::GetThreadCount() const
+    {
+        return m_threadCount;
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_ARENA_INL_
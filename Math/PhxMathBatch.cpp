@@ -0,0 +1,542 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathBatchKernels.h"
+
+// C Standard Library Includes
+#include <stdlib.h>
+
+// C++ Standard Library Includes
+#include <atomic>
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // Tier the kernels are bound to, -1 until the first batch operation.
+        std::atomic<int> s_batchTier(-1);
+
+        const BatchKernels * GetTierKernels(CpuTier::Type tier)
+        {
+            switch (tier)
+            {
+#if PHX_MATH_X86
+            case CpuTier::SSE42:
+                return &BatchKernelsSSE42;
+
+            case CpuTier::AVX2:
+                return &BatchKernelsAVX2;
+
+            case CpuTier::AVX512:
+                return &BatchKernelsAVX512;
+#endif
+            default:
+                return &BatchKernelsScalar;
+            }
+        }
+
+        CpuTier::Type ClampToSupportedTier(CpuTier::Type tier)
+        {
+            const CpuTier::Type highestTier = GetHighestCpuTier();
+            return (tier > highestTier) ? highestTier : tier;
+        }
+
+        CpuTier::Type GetDefaultBatchTier()
+        {
+            CpuTier::Type tier = GetHighestCpuTier();
+
+#if defined(_MSC_VER)
+            char * pValue = nullptr;
+            size_t length = 0;
+            if (_dupenv_s(&pValue, &length, "PHX_MATH_CPU_TIER") == 0 && pValue != nullptr)
+            {
+                CpuTier::Type requestedTier;
+                if (ParseCpuTier(pValue, requestedTier))
+                {
+                    tier = ClampToSupportedTier(requestedTier);
+                }
+                free(pValue);
+            }
+#else
+            CpuTier::Type requestedTier;
+            if (ParseCpuTier(getenv("PHX_MATH_CPU_TIER"), requestedTier))
+            {
+                tier = ClampToSupportedTier(requestedTier);
+            }
+#endif
+
+            return tier;
+        }
+
+        CpuTier::Type BindBatchTier()
+        {
+            int tier = s_batchTier.load(std::memory_order_acquire);
+            if (tier < 0)
+            {
+                // If another thread got here first (or called SetBatchTier), keep its tier.
+                const int defaultTier = GetDefaultBatchTier();
+                int expected = -1;
+                tier = s_batchTier.compare_exchange_strong(expected, defaultTier, std::memory_order_acq_rel) ? defaultTier : expected;
+            }
+            return static_cast<CpuTier::Type>(tier);
+        }
+
+        //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+        // Arguments of the operations split over threads, one range function each.
+        //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+        template <class T, class M = Matrix4x4>
+        struct TransformArgs
+        {
+            const BatchKernels * pKernels;
+            const T * pIn;
+            const M * pMatrix;
+            T * pOut;
+        };
+
+        void TransformVector3Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const TransformArgs<Vector3> & args = *static_cast<const TransformArgs<Vector3> *>(pContext);
+            args.pKernels->TransformVector3(args.pIn + first, *args.pMatrix, args.pOut + first, count);
+        }
+
+        void TransformVector4Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const TransformArgs<Vector4> & args = *static_cast<const TransformArgs<Vector4> *>(pContext);
+            args.pKernels->TransformVector4(args.pIn + first, *args.pMatrix, args.pOut + first, count);
+        }
+
+        void TransformVector2Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const TransformArgs<Vector2, Matrix3x2> & args = *static_cast<const TransformArgs<Vector2, Matrix3x2> *>(pContext);
+            args.pKernels->TransformVector2(args.pIn + first, *args.pMatrix, args.pOut + first, count);
+        }
+
+        void TransformRectRange(void * pContext, unsigned int first, unsigned int count)
+        {
+            const TransformArgs<Rect, Matrix3x2> & args = *static_cast<const TransformArgs<Rect, Matrix3x2> *>(pContext);
+            args.pKernels->TransformRect(args.pIn + first, *args.pMatrix, args.pOut + first, count);
+        }
+
+        void MultiplyMatrix4x4ByMatrixRange(void * pContext, unsigned int first, unsigned int count)
+        {
+            const TransformArgs<Matrix4x4> & args = *static_cast<const TransformArgs<Matrix4x4> *>(pContext);
+            args.pKernels->MultiplyMatrix4x4ByMatrix(args.pIn + first, *args.pMatrix, args.pOut + first, count);
+        }
+
+        struct NormalMatrixArgs
+        {
+            const BatchKernels * pKernels;
+            const Matrix4x4 * pIn;
+            Matrix3x3 * pOut;
+        };
+
+        void NormalMatrixRange(void * pContext, unsigned int first, unsigned int count)
+        {
+            const NormalMatrixArgs & args = *static_cast<const NormalMatrixArgs *>(pContext);
+            args.pKernels->NormalMatrix(args.pIn + first, args.pOut + first, count);
+        }
+
+        struct NormalizeArgs
+        {
+            const BatchKernels * pKernels;
+            const Vector3 * pIn;
+            Vector3 * pOut;
+        };
+
+        void NormalizeVector3Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const NormalizeArgs & args = *static_cast<const NormalizeArgs *>(pContext);
+            args.pKernels->NormalizeVector3(args.pIn + first, args.pOut + first, count);
+        }
+
+        struct SlerpArgs
+        {
+            const BatchKernels * pKernels;
+            const Quaternion * pQ1;
+            const Quaternion * pQ2;
+            float Weight;
+            Quaternion * pOut;
+        };
+
+        void SlerpQuaternionRange(void * pContext, unsigned int first, unsigned int count)
+        {
+            const SlerpArgs & args = *static_cast<const SlerpArgs *>(pContext);
+            args.pKernels->SlerpQuaternion(args.pQ1 + first, args.pQ2 + first, args.Weight, args.pOut + first, count);
+        }
+
+        struct MultiplyArgs
+        {
+            const BatchKernels * pKernels;
+            const Matrix4x4 * pLhs;
+            const Matrix4x4 * pRhs;
+            Matrix4x4 * pOut;
+        };
+
+        void MultiplyMatrix4x4Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const MultiplyArgs & args = *static_cast<const MultiplyArgs *>(pContext);
+            args.pKernels->MultiplyMatrix4x4(args.pLhs + first, args.pRhs + first, args.pOut + first, count);
+        }
+
+        // Each range writes its visible indices at the start of its own part of pOutIndices,
+        // the parts are moved together once every range is done.
+        struct CullRange
+        {
+            unsigned int First;
+            unsigned int VisibleCount;
+        };
+
+        struct CullArgs
+        {
+            const BatchKernels * pKernels;
+            const Vector4 * pSpheres;
+            const Vector4 * pPlanes;
+            unsigned int PlaneCount;
+            unsigned int * pOutIndices;
+            std::atomic<unsigned int> RangeCount;
+            CullRange Ranges[MaxParallelTasks];
+        };
+
+        void CullSpheresRange(void * pContext, unsigned int first, unsigned int count)
+        {
+            CullArgs & args = *static_cast<CullArgs *>(pContext);
+
+            unsigned int * pOutIndices = args.pOutIndices + first;
+            const unsigned int visibleCount = args.pKernels->CullSpheres(args.pSpheres + first, args.pPlanes, args.PlaneCount, pOutIndices, count);
+            for (unsigned int i = 0; i < visibleCount; ++i)
+            {
+                pOutIndices[i] += first;
+            }
+
+            CullRange & range = args.Ranges[args.RangeCount.fetch_add(1, std::memory_order_relaxed)];
+            range.First = first;
+            range.VisibleCount = visibleCount;
+        }
+
+        struct IntersectOBBArgs
+        {
+            const BatchKernels * pKernels;
+            const OBB * pBox;
+            const OBB * pBoxes;
+            unsigned int * pOutIndices;
+            std::atomic<unsigned int> RangeCount;
+            CullRange Ranges[MaxParallelTasks];
+        };
+
+        void IntersectOBBsRange(void * pContext, unsigned int first, unsigned int count)
+        {
+            IntersectOBBArgs & args = *static_cast<IntersectOBBArgs *>(pContext);
+
+            unsigned int * pOutIndices = args.pOutIndices + first;
+            const unsigned int hitCount = args.pKernels->IntersectOBBs(*args.pBox, args.pBoxes + first, pOutIndices, count);
+            for (unsigned int i = 0; i < hitCount; ++i)
+            {
+                pOutIndices[i] += first;
+            }
+
+            CullRange & range = args.Ranges[args.RangeCount.fetch_add(1, std::memory_order_relaxed)];
+            range.First = first;
+            range.VisibleCount = hitCount;
+        }
+
+        // The ranges finish in any order, sort them by position (there are only a few) and pack the indices.
+        // Returns the total number of indices.
+        unsigned int PackRanges(CullRange * pRanges, unsigned int rangeCount, unsigned int * pOutIndices)
+        {
+            for (unsigned int i = 1; i < rangeCount; ++i)
+            {
+                const CullRange range = pRanges[i];
+                unsigned int j = i;
+                for (; j > 0 && pRanges[j - 1].First > range.First; --j)
+                {
+                    pRanges[j] = pRanges[j - 1];
+                }
+                pRanges[j] = range;
+            }
+
+            unsigned int visibleCount = 0;
+            for (unsigned int i = 0; i < rangeCount; ++i)
+            {
+                const CullRange & range = pRanges[i];
+                if (range.First != visibleCount)
+                {
+                    memmove(pOutIndices + visibleCount, pOutIndices + range.First, sizeof(unsigned int) * range.VisibleCount);
+                }
+                visibleCount += range.VisibleCount;
+            }
+
+            return visibleCount;
+        }
+    }
+
+    const BatchKernels & GetBatchKernels()
+    {
+        return *GetTierKernels(BindBatchTier());
+    }
+
+    const BatchKernels * GetBatchKernels(CpuTier::Type tier)
+    {
+        if (false == IsCpuTierSupported(tier))
+        {
+            return nullptr;
+        }
+        return GetTierKernels(tier);
+    }
+
+    CpuTier::Type GetBatchTier()
+    {
+        return BindBatchTier();
+    }
+
+    CpuTier::Type SetBatchTier(CpuTier::Type tier)
+    {
+        DebugAssert(tier >= CpuTier::Scalar && tier < CpuTier::Count, "Invalid cpu tier (%d)!", tier);
+
+        const CpuTier::Type boundTier = ClampToSupportedTier(tier);
+        s_batchTier.store(boundTier, std::memory_order_release);
+        return boundTier;
+    }
+
+    CpuTier::Type ResetBatchTier()
+    {
+        const CpuTier::Type boundTier = GetDefaultBatchTier();
+        s_batchTier.store(boundTier, std::memory_order_release);
+        return boundTier;
+    }
+
+    void Transform(const Vector3 * pIn, const Matrix4x4 & m, Vector3 * pOut, unsigned int count)
+    {
+        GetBatchKernels().TransformVector3(pIn, m, pOut, count);
+    }
+
+    void Transform(const Vector4 * pIn, const Matrix4x4 & m, Vector4 * pOut, unsigned int count)
+    {
+        GetBatchKernels().TransformVector4(pIn, m, pOut, count);
+    }
+
+    void Transform(const Vector2 * pIn, const Matrix3x2 & m, Vector2 * pOut, unsigned int count)
+    {
+        GetBatchKernels().TransformVector2(pIn, m, pOut, count);
+    }
+
+    void Transform(const Rect * pIn, const Matrix3x2 & m, Rect * pOut, unsigned int count)
+    {
+        GetBatchKernels().TransformRect(pIn, m, pOut, count);
+    }
+
+    void Normalize(const Vector3 * pIn, Vector3 * pOut, unsigned int count)
+    {
+        GetBatchKernels().NormalizeVector3(pIn, pOut, count);
+    }
+
+    void Slerp(const Quaternion * pQ1, const Quaternion * pQ2, float weight, Quaternion * pOut, unsigned int count)
+    {
+        GetBatchKernels().SlerpQuaternion(pQ1, pQ2, weight, pOut, count);
+    }
+
+    void Multiply(const Matrix4x4 * pLhs, const Matrix4x4 * pRhs, Matrix4x4 * pOut, unsigned int count)
+    {
+        GetBatchKernels().MultiplyMatrix4x4(pLhs, pRhs, pOut, count);
+    }
+
+    void Multiply(const Matrix4x4 * pLhs, const Matrix4x4 & rhs, Matrix4x4 * pOut, unsigned int count)
+    {
+        GetBatchKernels().MultiplyMatrix4x4ByMatrix(pLhs, rhs, pOut, count);
+    }
+
+    void NormalMatrix(const Matrix4x4 * pIn, Matrix3x3 * pOut, unsigned int count)
+    {
+        GetBatchKernels().NormalMatrix(pIn, pOut, count);
+    }
+
+    unsigned int CullSpheres(const Vector4 * pSpheres, const Vector4 * pPlanes, unsigned int planeCount, unsigned int * pOutIndices, unsigned int count)
+    {
+        return GetBatchKernels().CullSpheres(pSpheres, pPlanes, planeCount, pOutIndices, count);
+    }
+
+    void FindExtremePoints(const Vector3 * pPoints, unsigned int count, unsigned int pOutIndices[6])
+    {
+        DebugAssert(count > 0, "Cannot find the extreme points of an empty array.");
+        GetBatchKernels().ExtremePointsVector3(pPoints, count, pOutIndices);
+    }
+
+    unsigned int Intersect(const OBB & box, const OBB * pBoxes, unsigned int * pOutIndices, unsigned int count)
+    {
+        return GetBatchKernels().IntersectOBBs(box, pBoxes, pOutIndices, count);
+    }
+
+    void Transform(const ExecutionPolicy & policy, const Vector3 * pIn, const Matrix4x4 & m, Vector3 * pOut, unsigned int count)
+    {
+        TransformArgs<Vector3> args = { &GetBatchKernels(), pIn, &m, pOut };
+        ParallelFor(policy, count, sizeof(Vector3), TransformVector3Range, &args);
+    }
+
+    void Transform(const ExecutionPolicy & policy, const Vector4 * pIn, const Matrix4x4 & m, Vector4 * pOut, unsigned int count)
+    {
+        TransformArgs<Vector4> args = { &GetBatchKernels(), pIn, &m, pOut };
+        ParallelFor(policy, count, sizeof(Vector4), TransformVector4Range, &args);
+    }
+
+    void Transform(const ExecutionPolicy & policy, const Vector2 * pIn, const Matrix3x2 & m, Vector2 * pOut, unsigned int count)
+    {
+        TransformArgs<Vector2, Matrix3x2> args = { &GetBatchKernels(), pIn, &m, pOut };
+        ParallelFor(policy, count, sizeof(Vector2), TransformVector2Range, &args);
+    }
+
+    void Transform(const ExecutionPolicy & policy, const Rect * pIn, const Matrix3x2 & m, Rect * pOut, unsigned int count)
+    {
+        TransformArgs<Rect, Matrix3x2> args = { &GetBatchKernels(), pIn, &m, pOut };
+        ParallelFor(policy, count, sizeof(Rect), TransformRectRange, &args);
+    }
+
+    void Normalize(const ExecutionPolicy & policy, const Vector3 * pIn, Vector3 * pOut, unsigned int count)
+    {
+        NormalizeArgs args = { &GetBatchKernels(), pIn, pOut };
+        ParallelFor(policy, count, sizeof(Vector3), NormalizeVector3Range, &args);
+    }
+
+    void Slerp(const ExecutionPolicy & policy, const Quaternion * pQ1, const Quaternion * pQ2, float weight, Quaternion * pOut, unsigned int count)
+    {
+        SlerpArgs args = { &GetBatchKernels(), pQ1, pQ2, weight, pOut };
+        ParallelFor(policy, count, sizeof(Quaternion), SlerpQuaternionRange, &args);
+    }
+
+    void Multiply(const ExecutionPolicy & policy, const Matrix4x4 * pLhs, const Matrix4x4 * pRhs, Matrix4x4 * pOut, unsigned int count)
+    {
+        MultiplyArgs args = { &GetBatchKernels(), pLhs, pRhs, pOut };
+        ParallelFor(policy, count, sizeof(Matrix4x4), MultiplyMatrix4x4Range, &args);
+    }
+
+    void Multiply(const ExecutionPolicy & policy, const Matrix4x4 * pLhs, const Matrix4x4 & rhs, Matrix4x4 * pOut, unsigned int count)
+    {
+        TransformArgs<Matrix4x4> args = { &GetBatchKernels(), pLhs, &rhs, pOut };
+        ParallelFor(policy, count, sizeof(Matrix4x4), MultiplyMatrix4x4ByMatrixRange, &args);
+    }
+
+    void NormalMatrix(const ExecutionPolicy & policy, const Matrix4x4 * pIn, Matrix3x3 * pOut, unsigned int count)
+    {
+        NormalMatrixArgs args = { &GetBatchKernels(), pIn, pOut };
+        ParallelFor(policy, count, sizeof(Matrix3x3), NormalMatrixRange, &args);
+    }
+
+    unsigned int CullSpheres(const ExecutionPolicy & policy, const Vector4 * pSpheres, const Vector4 * pPlanes, unsigned int planeCount, unsigned int * pOutIndices, unsigned int count)
+    {
+        CullArgs args;
+        args.pKernels = &GetBatchKernels();
+        args.pSpheres = pSpheres;
+        args.pPlanes = pPlanes;
+        args.PlaneCount = planeCount;
+        args.pOutIndices = pOutIndices;
+        args.RangeCount.store(0, std::memory_order_relaxed);
+
+        ParallelFor(policy, count, sizeof(unsigned int), CullSpheresRange, &args);
+
+        return PackRanges(args.Ranges, args.RangeCount.load(std::memory_order_relaxed), pOutIndices);
+    }
+
+    unsigned int Intersect(const ExecutionPolicy & policy, const OBB & box, const OBB * pBoxes, unsigned int * pOutIndices, unsigned int count)
+    {
+        IntersectOBBArgs args;
+        args.pKernels = &GetBatchKernels();
+        args.pBox = &box;
+        args.pBoxes = pBoxes;
+        args.pOutIndices = pOutIndices;
+        args.RangeCount.store(0, std::memory_order_relaxed);
+
+        ParallelFor(policy, count, sizeof(unsigned int), IntersectOBBsRange, &args);
+
+        return PackRanges(args.Ranges, args.RangeCount.load(std::memory_order_relaxed), pOutIndices);
+    }
+
+    void Add(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count)
+    {
+        GetBatchKernels().AddVector3SoA(lhs, rhs, out, count);
+    }
+
+    void Subtract(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count)
+    {
+        GetBatchKernels().SubtractVector3SoA(lhs, rhs, out, count);
+    }
+
+    void Multiply(const Vector3SoA & lhs, float rhs, const Vector3SoA & out, unsigned int count)
+    {
+        GetBatchKernels().MultiplyVector3SoA(lhs, rhs, out, count);
+    }
+
+    void Dot(const Vector3SoA & lhs, const Vector3SoA & rhs, float * pOut, unsigned int count)
+    {
+        GetBatchKernels().DotVector3SoA(lhs, rhs, pOut, count);
+    }
+
+    void Transform(const Vector3SoA & in, const Matrix4x4 & m, const Vector3SoA & out, unsigned int count)
+    {
+        GetBatchKernels().TransformVector3SoA(in, m, out, count);
+    }
+
+    void Normalize(const Vector3SoA & in, const Vector3SoA & out, unsigned int count)
+    {
+        GetBatchKernels().NormalizeVector3SoA(in, out, count);
+    }
+
+    void Multiply(const QuaternionSoA & lhs, const QuaternionSoA & rhs, const QuaternionSoA & out, unsigned int count)
+    {
+        GetBatchKernels().MultiplyQuaternionSoA(lhs, rhs, out, count);
+    }
+
+    void Normalize(const QuaternionSoA & in, const QuaternionSoA & out, unsigned int count)
+    {
+        GetBatchKernels().NormalizeQuaternionSoA(in, out, count);
+    }
+
+    void Slerp(const QuaternionSoA & q1, const QuaternionSoA & q2, float weight, const QuaternionSoA & out, unsigned int count)
+    {
+        GetBatchKernels().SlerpQuaternionSoA(q1, q2, weight, out, count);
+    }
+
+    void Intersect(const RaySoA & rays, const AABB & box, float * pOutT, unsigned int count)
+    {
+        GetBatchKernels().IntersectRaysAABB(rays, box, pOutT, count);
+    }
+
+    void Intersect(const RaySoA & rays, const Vector3 & v0, const Vector3 & v1, const Vector3 & v2, float * pOutT, unsigned int count)
+    {
+        GetBatchKernels().IntersectRaysTriangle(rays, v0, v1, v2, pOutT, count);
+    }
+
+    void SignedDistance(const Plane & plane, const Vector3SoA & points, float * pOut, unsigned int count)
+    {
+        GetBatchKernels().SignedDistanceVector3SoA(plane, points, pOut, count);
+    }
+
+    PlaneSide::Type Classify(const Plane & plane, const Vector3SoA & points, float epsilon, uint32_t * pOutFront, uint32_t * pOutBack, unsigned int count)
+    {
+        return static_cast<PlaneSide::Type>(GetBatchKernels().ClassifyVector3SoA(plane, points, epsilon, pOutFront, pOutBack, count));
+    }
+
+} //namespace Math
+} //namespace Phx
@@ -0,0 +1,192 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_BATCH_H_
+#define _PHX_MATH_BATCH_H_
+
+#include "PhxMathCpu.h"
+#include "PhxMathExecution.h"
+#include "PhxMathSoA.h"
+
+// C Standard Library Includes
+#include <stdint.h>
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Batch Operations
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Array versions of the hot math operations. Every operation has a kernel
+// per CpuTier, the kernels for the best tier the cpu supports are bound
+// the first time a batch operation is called, so the same binary runs on
+// any x86 machine (and falls back to the scalar kernels elsewhere).
+//
+// The tier can be forced with the PHX_MATH_CPU_TIER environment variable
+// (scalar, sse42, avx2 or avx512) or with SetBatchTier, a tier above what
+// the cpu supports is lowered to the highest supported tier. This is meant
+// for testing and benchmarking each path on one machine, the tier should
+// not be changed while batch operations are running on other threads.
+//
+// Unless noted otherwise pOut may be the same array as an input array (in
+// place), but the arrays must not partially overlap. The tiers can differ
+// by a few ulp since the wider tiers use fused multiply adds.
+//
+// The SoA operations take the same arguments as their AoS counterparts,
+// with the views in place of the arrays.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    struct BatchKernels
+    {
+        void (*TransformVector3)(const Vector3 * pIn, const Matrix4x4 & m, Vector3 * pOut, unsigned int count);
+        void (*TransformVector4)(const Vector4 * pIn, const Matrix4x4 & m, Vector4 * pOut, unsigned int count);
+        void (*TransformVector2)(const Vector2 * pIn, const Matrix3x2 & m, Vector2 * pOut, unsigned int count);
+        void (*TransformRect)(const Rect * pIn, const Matrix3x2 & m, Rect * pOut, unsigned int count);
+        void (*NormalizeVector3)(const Vector3 * pIn, Vector3 * pOut, unsigned int count);
+        void (*SlerpQuaternion)(const Quaternion * pQ1, const Quaternion * pQ2, float weight, Quaternion * pOut, unsigned int count);
+        void (*MultiplyMatrix4x4)(const Matrix4x4 * pLhs, const Matrix4x4 * pRhs, Matrix4x4 * pOut, unsigned int count);
+        void (*MultiplyMatrix4x4ByMatrix)(const Matrix4x4 * pLhs, const Matrix4x4 & rhs, Matrix4x4 * pOut, unsigned int count);
+        void (*NormalMatrix)(const Matrix4x4 * pIn, Matrix3x3 * pOut, unsigned int count);
+        unsigned int (*CullSpheres)(const Vector4 * pSpheres, const Vector4 * pPlanes, unsigned int planeCount, unsigned int * pOutIndices, unsigned int count);
+        void (*ExtremePointsVector3)(const Vector3 * pIn, unsigned int count, unsigned int * pOutIndices);
+        unsigned int (*IntersectOBBs)(const OBB & box, const OBB * pBoxes, unsigned int * pOutIndices, unsigned int count);
+
+        void (*AddVector3SoA)(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count);
+        void (*SubtractVector3SoA)(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count);
+        void (*MultiplyVector3SoA)(const Vector3SoA & lhs, float rhs, const Vector3SoA & out, unsigned int count);
+        void (*DotVector3SoA)(const Vector3SoA & lhs, const Vector3SoA & rhs, float * pOut, unsigned int count);
+        void (*TransformVector3SoA)(const Vector3SoA & in, const Matrix4x4 & m, const Vector3SoA & out, unsigned int count);
+        void (*NormalizeVector3SoA)(const Vector3SoA & in, const Vector3SoA & out, unsigned int count);
+        void (*MultiplyQuaternionSoA)(const QuaternionSoA & lhs, const QuaternionSoA & rhs, const QuaternionSoA & out, unsigned int count);
+        void (*NormalizeQuaternionSoA)(const QuaternionSoA & in, const QuaternionSoA & out, unsigned int count);
+        void (*SlerpQuaternionSoA)(const QuaternionSoA & q1, const QuaternionSoA & q2, float weight, const QuaternionSoA & out, unsigned int count);
+        void (*IntersectRaysAABB)(const RaySoA & rays, const AABB & box, float * pOutT, unsigned int count);
+        void (*IntersectRaysTriangle)(const RaySoA & rays, const Vector3 & v0, const Vector3 & v1, const Vector3 & v2, float * pOutT, unsigned int count);
+        void (*SignedDistanceVector3SoA)(const Plane & plane, const Vector3SoA & points, float * pOut, unsigned int count);
+        unsigned int (*ClassifyVector3SoA)(const Plane & plane, const Vector3SoA & points, float epsilon, uint32_t * pOutFront, uint32_t * pOutBack, unsigned int count);
+
+        // Counts are in floats, see PhxMathPacked.h
+        void (*PackHalf)(const float * pIn, uint16_t * pOut, unsigned int count);
+        void (*UnpackHalf)(const uint16_t * pIn, float * pOut, unsigned int count);
+    };
+
+    // Kernels in use, binds the default tier on the first call.
+    const BatchKernels & GetBatchKernels();
+
+    // Kernels for a specific tier, nullptr if the cpu doesn't support the tier.
+    const BatchKernels * GetBatchKernels(CpuTier::Type tier);
+
+    CpuTier::Type GetBatchTier();
+
+    // Returns the tier that was actually bound.
+    CpuTier::Type SetBatchTier(CpuTier::Type tier);
+
+    // Goes back to the default tier (PHX_MATH_CPU_TIER or the highest supported tier).
+    CpuTier::Type ResetBatchTier();
+
+    // Points (w = 1) transformed by m.
+    void Transform(const Vector3 * pIn, const Matrix4x4 & m, Vector3 * pOut, unsigned int count);
+    void Transform(const Vector4 * pIn, const Matrix4x4 & m, Vector4 * pOut, unsigned int count);
+
+    // 2D points, and the bounding rects of the transformed rects (see Transform in PhxMathMatrix3x2.h).
+    void Transform(const Vector2 * pIn, const Matrix3x2 & m, Vector2 * pOut, unsigned int count);
+    void Transform(const Rect * pIn, const Matrix3x2 & m, Rect * pOut, unsigned int count);
+
+    // Zero length vectors are normalized to zero instead of asserting.
+    void Normalize(const Vector3 * pIn, Vector3 * pOut, unsigned int count);
+
+    // Slerps each pair of quaternions by the same weight.
+    // Unlike the single Slerp this takes the shortest arc, and handles aligned quaternions.
+    void Slerp(const Quaternion * pQ1, const Quaternion * pQ2, float weight, Quaternion * pOut, unsigned int count);
+
+    // pLhs[i] * pRhs[i], or pLhs[i] * rhs.
+    void Multiply(const Matrix4x4 * pLhs, const Matrix4x4 * pRhs, Matrix4x4 * pOut, unsigned int count);
+    void Multiply(const Matrix4x4 * pLhs, const Matrix4x4 & rhs, Matrix4x4 * pOut, unsigned int count);
+
+    // Inverse transpose of the upper 3x3 of each matrix, see NormalMatrix in PhxMathMatrix3x3.h.
+    // Singular matrices give the zero matrix instead of asserting, pIn and pOut must not overlap.
+    void NormalMatrix(const Matrix4x4 * pIn, Matrix3x3 * pOut, unsigned int count);
+
+    // Spheres are (center, radius), planes are (normal, d) with the normals pointing inside the volume.
+    // Writes the indices of the spheres that are not completely behind any of the planes to pOutIndices
+    // (which must have room for count indices), and returns the number of indices written.
+    unsigned int CullSpheres(const Vector4 * pSpheres, const Vector4 * pPlanes, unsigned int planeCount, unsigned int * pOutIndices, unsigned int count);
+
+    // Indices of the points with the smallest and largest X, Y and Z, in the order
+    // min X, max X, min Y, max Y, min Z, max Z. The first point wins ties, count must not be 0.
+    void FindExtremePoints(const Vector3 * pPoints, unsigned int count, unsigned int pOutIndices[6]);
+
+    // One box against many with the same test as Intersects(OBB, OBB), for the narrowphase.
+    // Writes the indices of the boxes in pBoxes that intersect box to pOutIndices (which must have
+    // room for count indices), and returns the number of indices written.
+    unsigned int Intersect(const OBB & box, const OBB * pBoxes, unsigned int * pOutIndices, unsigned int count);
+
+    // The operations above split over threads by policy, see PhxMathExecution.h.
+    // The results are the same as the single threaded versions, CullSpheres and Intersect still write the indices in order.
+    void Transform(const ExecutionPolicy & policy, const Vector3 * pIn, const Matrix4x4 & m, Vector3 * pOut, unsigned int count);
+    void Transform(const ExecutionPolicy & policy, const Vector4 * pIn, const Matrix4x4 & m, Vector4 * pOut, unsigned int count);
+    void Transform(const ExecutionPolicy & policy, const Vector2 * pIn, const Matrix3x2 & m, Vector2 * pOut, unsigned int count);
+    void Transform(const ExecutionPolicy & policy, const Rect * pIn, const Matrix3x2 & m, Rect * pOut, unsigned int count);
+    void Normalize(const ExecutionPolicy & policy, const Vector3 * pIn, Vector3 * pOut, unsigned int count);
+    void Slerp(const ExecutionPolicy & policy, const Quaternion * pQ1, const Quaternion * pQ2, float weight, Quaternion * pOut, unsigned int count);
+    void Multiply(const ExecutionPolicy & policy, const Matrix4x4 * pLhs, const Matrix4x4 * pRhs, Matrix4x4 * pOut, unsigned int count);
+    void Multiply(const ExecutionPolicy & policy, const Matrix4x4 * pLhs, const Matrix4x4 & rhs, Matrix4x4 * pOut, unsigned int count);
+    void NormalMatrix(const ExecutionPolicy & policy, const Matrix4x4 * pIn, Matrix3x3 * pOut, unsigned int count);
+    unsigned int CullSpheres(const ExecutionPolicy & policy, const Vector4 * pSpheres, const Vector4 * pPlanes, unsigned int planeCount, unsigned int * pOutIndices, unsigned int count);
+    unsigned int Intersect(const ExecutionPolicy & policy, const OBB & box, const OBB * pBoxes, unsigned int * pOutIndices, unsigned int count);
+
+    void Add(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count);
+    void Subtract(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count);
+    void Multiply(const Vector3SoA & lhs, float rhs, const Vector3SoA & out, unsigned int count);
+    void Dot(const Vector3SoA & lhs, const Vector3SoA & rhs, float * pOut, unsigned int count);
+    void Transform(const Vector3SoA & in, const Matrix4x4 & m, const Vector3SoA & out, unsigned int count);
+    void Normalize(const Vector3SoA & in, const Vector3SoA & out, unsigned int count);
+
+    // lhs * rhs = rhs rotated by lhs, same as the single Multiply.
+    void Multiply(const QuaternionSoA & lhs, const QuaternionSoA & rhs, const QuaternionSoA & out, unsigned int count);
+
+    // Zero length quaternions are normalized to zero.
+    void Normalize(const QuaternionSoA & in, const QuaternionSoA & out, unsigned int count);
+    void Slerp(const QuaternionSoA & q1, const QuaternionSoA & q2, float weight, const QuaternionSoA & out, unsigned int count);
+
+    // Packets of rays against one box or triangle, same tests as the single Intersects (PhxMathRay.h).
+    // Writes the hit distance of each ray, or FLT_MAX for the rays that miss.
+    void Intersect(const RaySoA & rays, const AABB & box, float * pOutT, unsigned int count);
+    void Intersect(const RaySoA & rays, const Vector3 & v0, const Vector3 & v1, const Vector3 & v2, float * pOutT, unsigned int count);
+
+    // Signed distance of each point to the plane, see SignedDistance in PhxMathPlane.h.
+    void SignedDistance(const Plane & plane, const Vector3SoA & points, float * pOut, unsigned int count);
+
+    // Bit i of the masks is point i, set in pOutFront when the point is more than epsilon in front of the
+    // plane and in pOutBack when it is more than epsilon behind. Each mask is (count + 31) / 32 words, the
+    // bits past count in the last word are cleared. Returns the sides of all the points or'ed together,
+    // so Straddle when the points are on both sides (and On when count is 0).
+    PlaneSide::Type Classify(const Plane & plane, const Vector3SoA & points, float epsilon, uint32_t * pOutFront, uint32_t * pOutBack, unsigned int count);
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_BATCH_H_
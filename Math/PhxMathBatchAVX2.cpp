@@ -0,0 +1,967 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathBatchKernels.h"
+
+#if PHX_MATH_X86
+
+#include <immintrin.h>
+
+#define PHX_TARGET_AVX2 PHX_TARGET("avx2,fma,f16c")
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // Same shuffles as the SSE4.2 kernels, run on both 128 bit lanes: vectors 0-3 end up in the
+        // low lane and vectors 4-7 in the high lane of each component register.
+        PHX_TARGET_AVX2 inline void LoadVector3x8(const Vector3 * p, __m256 & outX, __m256 & outY, __m256 & outZ)
+        {
+            const float * pSrc = &p->X;
+            const __m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pSrc)), _mm_loadu_ps(pSrc + 12), 1);
+            const __m256 b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pSrc + 4)), _mm_loadu_ps(pSrc + 16), 1);
+            const __m256 c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pSrc + 8)), _mm_loadu_ps(pSrc + 20), 1);
+
+            const __m256 xy = _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+            const __m256 yz = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+
+            outX = _mm256_shuffle_ps(a, xy, _MM_SHUFFLE(2, 0, 3, 0));
+            outY = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+            outZ = _mm256_shuffle_ps(yz, c, _MM_SHUFFLE(3, 0, 3, 1));
+        }
+
+        PHX_TARGET_AVX2 inline void StoreVector3x8(__m256 x, __m256 y, __m256 z, Vector3 * p)
+        {
+            const __m256 xy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m256 yz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+            const __m256 zx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+
+            const __m256 a = _mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m256 b = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+            const __m256 c = _mm256_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1));
+
+            float * pDst = &p->X;
+            _mm_storeu_ps(pDst, _mm256_castps256_ps128(a));
+            _mm_storeu_ps(pDst + 4, _mm256_castps256_ps128(b));
+            _mm_storeu_ps(pDst + 8, _mm256_castps256_ps128(c));
+            _mm_storeu_ps(pDst + 12, _mm256_extractf128_ps(a, 1));
+            _mm_storeu_ps(pDst + 16, _mm256_extractf128_ps(b, 1));
+            _mm_storeu_ps(pDst + 20, _mm256_extractf128_ps(c, 1));
+        }
+
+        // Loads 8 consecutive 4 float elements (Vector4, Quaternion) as one register per component.
+        PHX_TARGET_AVX2 inline void LoadFloat4x8(const float * pSrc, __m256 & outX, __m256 & outY, __m256 & outZ, __m256 & outW)
+        {
+            const __m256 r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pSrc + 0)), _mm_loadu_ps(pSrc + 16), 1);
+            const __m256 r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pSrc + 4)), _mm_loadu_ps(pSrc + 20), 1);
+            const __m256 r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pSrc + 8)), _mm_loadu_ps(pSrc + 24), 1);
+            const __m256 r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pSrc + 12)), _mm_loadu_ps(pSrc + 28), 1);
+
+            const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+            const __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+            const __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+            const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+
+            outX = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            outY = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            outZ = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            outW = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        }
+
+        PHX_TARGET_AVX2 inline void StoreFloat4x8(__m256 x, __m256 y, __m256 z, __m256 w, float * pDst)
+        {
+            // The in lane transpose is its own inverse.
+            const __m256 t0 = _mm256_unpacklo_ps(x, y);
+            const __m256 t1 = _mm256_unpackhi_ps(x, y);
+            const __m256 t2 = _mm256_unpacklo_ps(z, w);
+            const __m256 t3 = _mm256_unpackhi_ps(z, w);
+
+            const __m256 r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m256 r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            const __m256 r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m256 r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+            _mm_storeu_ps(pDst + 0, _mm256_castps256_ps128(r0));
+            _mm_storeu_ps(pDst + 4, _mm256_castps256_ps128(r1));
+            _mm_storeu_ps(pDst + 8, _mm256_castps256_ps128(r2));
+            _mm_storeu_ps(pDst + 12, _mm256_castps256_ps128(r3));
+            _mm_storeu_ps(pDst + 16, _mm256_extractf128_ps(r0, 1));
+            _mm_storeu_ps(pDst + 20, _mm256_extractf128_ps(r1, 1));
+            _mm_storeu_ps(pDst + 24, _mm256_extractf128_ps(r2, 1));
+            _mm_storeu_ps(pDst + 28, _mm256_extractf128_ps(r3, 1));
+        }
+
+        // Two rows (one per lane) transformed by m, m0-m3 hold each row of m in both lanes.
+        PHX_TARGET_AVX2 inline __m256 TransformRows(__m256 rows, __m256 m0, __m256 m1, __m256 m2, __m256 m3)
+        {
+            __m256 r = _mm256_mul_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(0, 0, 0, 0)), m0);
+            r = _mm256_fmadd_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(1, 1, 1, 1)), m1, r);
+            r = _mm256_fmadd_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(2, 2, 2, 2)), m2, r);
+            r = _mm256_fmadd_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(3, 3, 3, 3)), m3, r);
+            return r;
+        }
+
+        PHX_TARGET_AVX2 void TransformVector3(const Vector3 * pIn, const Matrix4x4 & m, Vector3 * pOut, unsigned int count)
+        {
+            const __m256 m11 = _mm256_set1_ps(m.M11), m12 = _mm256_set1_ps(m.M12), m13 = _mm256_set1_ps(m.M13);
+            const __m256 m21 = _mm256_set1_ps(m.M21), m22 = _mm256_set1_ps(m.M22), m23 = _mm256_set1_ps(m.M23);
+            const __m256 m31 = _mm256_set1_ps(m.M31), m32 = _mm256_set1_ps(m.M32), m33 = _mm256_set1_ps(m.M33);
+            const __m256 m41 = _mm256_set1_ps(m.M41), m42 = _mm256_set1_ps(m.M42), m43 = _mm256_set1_ps(m.M43);
+
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 x, y, z;
+                LoadVector3x8(pIn + i, x, y, z);
+
+                const __m256 outX = _mm256_fmadd_ps(z, m31, _mm256_fmadd_ps(y, m21, _mm256_fmadd_ps(x, m11, m41)));
+                const __m256 outY = _mm256_fmadd_ps(z, m32, _mm256_fmadd_ps(y, m22, _mm256_fmadd_ps(x, m12, m42)));
+                const __m256 outZ = _mm256_fmadd_ps(z, m33, _mm256_fmadd_ps(y, m23, _mm256_fmadd_ps(x, m13, m43)));
+
+                StoreVector3x8(outX, outY, outZ, pOut + i);
+            }
+
+            BatchKernelsSSE42.TransformVector3(pIn + i, m, pOut + i, count - i);
+        }
+
+        PHX_TARGET_AVX2 void TransformVector4(const Vector4 * pIn, const Matrix4x4 & m, Vector4 * pOut, unsigned int count)
+        {
+            const __m256 m0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&m.M11));
+            const __m256 m1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&m.M21));
+            const __m256 m2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&m.M31));
+            const __m256 m3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&m.M41));
+
+            unsigned int i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                const __m256 v = _mm256_loadu_ps(&pIn[i].X);
+                _mm256_storeu_ps(&pOut[i].X, TransformRows(v, m0, m1, m2, m3));
+            }
+
+            BatchKernelsSSE42.TransformVector4(pIn + i, m, pOut + i, count - i);
+        }
+
+        PHX_TARGET_AVX2 void TransformVector2(const Vector2 * pIn, const Matrix3x2 & m, Vector2 * pOut, unsigned int count)
+        {
+            const __m256 m1 = _mm256_setr_ps(m.M11, m.M12, m.M11, m.M12, m.M11, m.M12, m.M11, m.M12);
+            const __m256 m2 = _mm256_setr_ps(m.M21, m.M22, m.M21, m.M22, m.M21, m.M22, m.M21, m.M22);
+            const __m256 m3 = _mm256_setr_ps(m.M31, m.M32, m.M31, m.M32, m.M31, m.M32, m.M31, m.M32);
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m256 v = _mm256_loadu_ps(&pIn[i].X);
+                const __m256 x = _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 0, 0));
+                const __m256 y = _mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 1, 1));
+
+                _mm256_storeu_ps(&pOut[i].X, _mm256_fmadd_ps(y, m2, _mm256_fmadd_ps(x, m1, m3)));
+            }
+
+            BatchKernelsSSE42.TransformVector2(pIn + i, m, pOut + i, count - i);
+        }
+
+        PHX_TARGET_AVX2 void TransformRect(const Rect * pIn, const Matrix3x2 & m, Rect * pOut, unsigned int count)
+        {
+            // See the SSE4.2 version, one rect per lane.
+            const __m256 m1 = _mm256_setr_ps(m.M11, m.M12, m.M11, m.M12, m.M11, m.M12, m.M11, m.M12);
+            const __m256 m2 = _mm256_setr_ps(m.M21, m.M22, m.M21, m.M22, m.M21, m.M22, m.M21, m.M22);
+            const __m256 m3 = _mm256_setr_ps(m.M31, m.M32, 0.0f, 0.0f, m.M31, m.M32, 0.0f, 0.0f);
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+            unsigned int i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                const __m256 r = _mm256_loadu_ps(&pIn[i].X);
+                const __m256 a = _mm256_mul_ps(_mm256_permute_ps(r, _MM_SHUFFLE(2, 2, 0, 0)), m1);
+                const __m256 b = _mm256_mul_ps(_mm256_permute_ps(r, _MM_SHUFFLE(3, 3, 1, 1)), m2);
+
+                const __m256 negative = _mm256_add_ps(_mm256_min_ps(a, zero), _mm256_min_ps(b, zero));
+                const __m256 position = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(a, b), m3), _mm256_permute_ps(negative, _MM_SHUFFLE(3, 2, 3, 2)));
+                const __m256 size = _mm256_add_ps(_mm256_andnot_ps(signBit, a), _mm256_andnot_ps(signBit, b));
+
+                _mm256_storeu_ps(&pOut[i].X, _mm256_blend_ps(position, size, 0xCC));
+            }
+
+            BatchKernelsSSE42.TransformRect(pIn + i, m, pOut + i, count - i);
+        }
+
+        PHX_TARGET_AVX2 void NormalizeVector3(const Vector3 * pIn, Vector3 * pOut, unsigned int count)
+        {
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 zero = _mm256_setzero_ps();
+
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 x, y, z;
+                LoadVector3x8(pIn + i, x, y, z);
+
+                const __m256 lengthSquared = _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x)));
+                const __m256 invLength = _mm256_and_ps(_mm256_cmp_ps(lengthSquared, zero, _CMP_GT_OQ), _mm256_div_ps(one, _mm256_sqrt_ps(lengthSquared)));
+
+                StoreVector3x8(_mm256_mul_ps(x, invLength), _mm256_mul_ps(y, invLength), _mm256_mul_ps(z, invLength), pOut + i);
+            }
+
+            BatchKernelsSSE42.NormalizeVector3(pIn + i, pOut + i, count - i);
+        }
+
+        PHX_TARGET_AVX2 inline __m256 EvaluateSlerpPolynomial(const float coefficients[SlerpPolynomial::Terms], __m256 xm1)
+        {
+            const __m256 one = _mm256_set1_ps(1.0f);
+
+            __m256 poly = one;
+            for (int j = SlerpPolynomial::Terms - 1; j >= 0; --j)
+            {
+                poly = _mm256_fmadd_ps(_mm256_mul_ps(_mm256_set1_ps(coefficients[j]), xm1), poly, one);
+            }
+            return poly;
+        }
+
+        struct SlerpWeights
+        {
+            float T;
+            float D;
+            float CoefficientsT[SlerpPolynomial::Terms];
+            float CoefficientsD[SlerpPolynomial::Terms];
+        };
+
+        inline void PrepareSlerp(float weight, SlerpWeights & out)
+        {
+            out.T = weight;
+            out.D = 1.0f - weight;
+            SlerpPolynomial::Prepare(out.T, out.CoefficientsT);
+            SlerpPolynomial::Prepare(out.D, out.CoefficientsD);
+        }
+
+        PHX_TARGET_AVX2 inline void GetSlerpWeights(const SlerpWeights & weights, __m256 cosTheta, __m256 & t1, __m256 & t2)
+        {
+            const __m256 sign = _mm256_and_ps(cosTheta, _mm256_set1_ps(-0.0f));
+            const __m256 xm1 = _mm256_sub_ps(_mm256_xor_ps(cosTheta, sign), _mm256_set1_ps(1.0f));
+
+            t1 = _mm256_mul_ps(_mm256_set1_ps(weights.D), EvaluateSlerpPolynomial(weights.CoefficientsD, xm1));
+            t2 = _mm256_xor_ps(_mm256_mul_ps(_mm256_set1_ps(weights.T), EvaluateSlerpPolynomial(weights.CoefficientsT, xm1)), sign);
+        }
+
+        PHX_TARGET_AVX2 void SlerpQuaternion(const Quaternion * pQ1, const Quaternion * pQ2, float weight, Quaternion * pOut, unsigned int count)
+        {
+            SlerpWeights weights;
+            PrepareSlerp(weight, weights);
+
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 x1, y1, z1, w1;
+                LoadFloat4x8(&pQ1[i].X, x1, y1, z1, w1);
+
+                __m256 x2, y2, z2, w2;
+                LoadFloat4x8(&pQ2[i].X, x2, y2, z2, w2);
+
+                const __m256 cosTheta = _mm256_fmadd_ps(w1, w2, _mm256_fmadd_ps(z1, z2, _mm256_fmadd_ps(y1, y2, _mm256_mul_ps(x1, x2))));
+
+                __m256 t1, t2;
+                GetSlerpWeights(weights, cosTheta, t1, t2);
+
+                const __m256 x = _mm256_fmadd_ps(t2, x2, _mm256_mul_ps(t1, x1));
+                const __m256 y = _mm256_fmadd_ps(t2, y2, _mm256_mul_ps(t1, y1));
+                const __m256 z = _mm256_fmadd_ps(t2, z2, _mm256_mul_ps(t1, z1));
+                const __m256 w = _mm256_fmadd_ps(t2, w2, _mm256_mul_ps(t1, w1));
+
+                StoreFloat4x8(x, y, z, w, &pOut[i].X);
+            }
+
+            BatchKernelsSSE42.SlerpQuaternion(pQ1 + i, pQ2 + i, weight, pOut + i, count - i);
+        }
+
+        PHX_TARGET_AVX2 inline void MultiplyMatrix(const Matrix4x4 & lhs, __m256 m0, __m256 m1, __m256 m2, __m256 m3, Matrix4x4 & out)
+        {
+            // Rows 1-2 and 3-4 of lhs are loaded before out is written, so lhs and out can be the same matrix.
+            const __m256 l01 = _mm256_loadu_ps(&lhs.M11);
+            const __m256 l23 = _mm256_loadu_ps(&lhs.M31);
+
+            _mm256_storeu_ps(&out.M11, TransformRows(l01, m0, m1, m2, m3));
+            _mm256_storeu_ps(&out.M31, TransformRows(l23, m0, m1, m2, m3));
+        }
+
+        PHX_TARGET_AVX2 void MultiplyMatrix4x4(const Matrix4x4 * pLhs, const Matrix4x4 * pRhs, Matrix4x4 * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Matrix4x4 & rhs = pRhs[i];
+                const __m256 m0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&rhs.M11));
+                const __m256 m1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&rhs.M21));
+                const __m256 m2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&rhs.M31));
+                const __m256 m3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&rhs.M41));
+
+                MultiplyMatrix(pLhs[i], m0, m1, m2, m3, pOut[i]);
+            }
+        }
+
+        PHX_TARGET_AVX2 void MultiplyMatrix4x4ByMatrix(const Matrix4x4 * pLhs, const Matrix4x4 & rhs, Matrix4x4 * pOut, unsigned int count)
+        {
+            const __m256 m0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&rhs.M11));
+            const __m256 m1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&rhs.M21));
+            const __m256 m2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&rhs.M31));
+            const __m256 m3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&rhs.M41));
+
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                MultiplyMatrix(pLhs[i], m0, m1, m2, m3, pOut[i]);
+            }
+        }
+
+        // (a.yzx * b - a * b.yzx).yzx in each lane, the w lanes are 0.
+        PHX_TARGET_AVX2 inline __m256 Cross(__m256 a, __m256 b)
+        {
+            const __m256 aYZX = _mm256_permute_ps(a, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m256 bYZX = _mm256_permute_ps(b, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m256 c = _mm256_fmsub_ps(aYZX, b, _mm256_mul_ps(a, bYZX));
+            return _mm256_permute_ps(c, _MM_SHUFFLE(3, 0, 2, 1));
+        }
+
+        // Writes the xyz of 3 rows to 9 consecutive floats.
+        PHX_TARGET_AVX2 inline void StoreRows3x3(__m128 r0, __m128 r1, __m128 r2, float * pDst)
+        {
+            // Each row write spills one float into the next row, which the next write replaces.
+            _mm_storeu_ps(pDst, r0);
+            _mm_storeu_ps(pDst + 3, r1);
+            _mm_storel_pi(reinterpret_cast<__m64 *>(pDst + 6), r2);
+            _mm_store_ss(pDst + 8, _mm_movehl_ps(r2, r2));
+        }
+
+        PHX_TARGET_AVX2 void NormalMatrix4x4(const Matrix4x4 * pIn, Matrix3x3 * pOut, unsigned int count)
+        {
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.0f);
+
+            // Two matrices at a time, one per lane.
+            unsigned int i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                const __m256 r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&pIn[i].M11)), _mm_loadu_ps(&pIn[i + 1].M11), 1);
+                const __m256 r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&pIn[i].M21)), _mm_loadu_ps(&pIn[i + 1].M21), 1);
+                const __m256 r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&pIn[i].M31)), _mm_loadu_ps(&pIn[i + 1].M31), 1);
+
+                const __m256 c0 = Cross(r1, r2);
+                const __m256 c1 = Cross(r2, r0);
+                const __m256 c2 = Cross(r0, r1);
+
+                const __m256 det = _mm256_dp_ps(r0, c0, 0x7F);
+                const __m256 invDet = _mm256_and_ps(_mm256_div_ps(one, det), _mm256_cmp_ps(det, zero, _CMP_NEQ_UQ));
+
+                const __m256 n0 = _mm256_mul_ps(c0, invDet);
+                const __m256 n1 = _mm256_mul_ps(c1, invDet);
+                const __m256 n2 = _mm256_mul_ps(c2, invDet);
+
+                StoreRows3x3(_mm256_castps256_ps128(n0), _mm256_castps256_ps128(n1), _mm256_castps256_ps128(n2), &pOut[i].M11);
+                StoreRows3x3(_mm256_extractf128_ps(n0, 1), _mm256_extractf128_ps(n1, 1), _mm256_extractf128_ps(n2, 1), &pOut[i + 1].M11);
+            }
+
+            BatchKernelsSSE42.NormalMatrix(pIn + i, pOut + i, count - i);
+        }
+
+        PHX_TARGET_AVX2 unsigned int CullSpheresByPlanes(const Vector4 * pSpheres, const Vector4 * pPlanes, unsigned int planeCount, unsigned int * pOutIndices, unsigned int count)
+        {
+            const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+            unsigned int visibleCount = 0;
+
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                // Lane k of each component register (and bit k of the movemask) is sphere i + k.
+                __m256 x, y, z, r;
+                LoadFloat4x8(&pSpheres[i].X, x, y, z, r);
+
+                const __m256 negRadius = _mm256_xor_ps(r, signBit);
+
+                __m256 culled = _mm256_setzero_ps();
+                for (unsigned int j = 0; j < planeCount; ++j)
+                {
+                    const Vector4 & plane = pPlanes[j];
+                    const __m256 distance = _mm256_fmadd_ps(z, _mm256_broadcast_ss(&plane.Z),
+                        _mm256_fmadd_ps(y, _mm256_broadcast_ss(&plane.Y), _mm256_fmadd_ps(x, _mm256_broadcast_ss(&plane.X), _mm256_broadcast_ss(&plane.W))));
+
+                    culled = _mm256_or_ps(culled, _mm256_cmp_ps(distance, negRadius, _CMP_LT_OQ));
+                    if (_mm256_movemask_ps(culled) == 0xFF)
+                    {
+                        break;
+                    }
+                }
+
+                const unsigned int visibleMask = ~static_cast<unsigned int>(_mm256_movemask_ps(culled));
+                for (unsigned int k = 0; k < 8; ++k)
+                {
+                    pOutIndices[visibleCount] = i + k;
+                    visibleCount += (visibleMask >> k) & 1;
+                }
+            }
+
+            const unsigned int tailCount = BatchKernelsSSE42.CullSpheres(pSpheres + i, pPlanes, planeCount, pOutIndices + visibleCount, count - i);
+            for (unsigned int k = 0; k < tailCount; ++k)
+            {
+                pOutIndices[visibleCount + k] += i;
+            }
+
+            return visibleCount + tailCount;
+        }
+
+        // Keeps v and its index in the lanes where v is strictly smaller than min, or strictly larger than max.
+        PHX_TARGET_AVX2 inline void UpdateExtremes(__m256 v, __m256i index, __m256 & min, __m256i & minIndex, __m256 & max, __m256i & maxIndex)
+        {
+            const __m256 less = _mm256_cmp_ps(v, min, _CMP_LT_OQ);
+            const __m256 greater = _mm256_cmp_ps(v, max, _CMP_GT_OQ);
+
+            min = _mm256_blendv_ps(min, v, less);
+            max = _mm256_blendv_ps(max, v, greater);
+            minIndex = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(minIndex), _mm256_castsi256_ps(index), less));
+            maxIndex = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(maxIndex), _mm256_castsi256_ps(index), greater));
+        }
+
+        PHX_TARGET_AVX2 void ExtremePointsVector3(const Vector3 * pIn, unsigned int count, unsigned int * pOutIndices)
+        {
+            ExtremePoints::State state;
+            ExtremePoints::Begin(pIn[0], state);
+
+            __m256 extremes[ExtremePoints::Slots];
+            __m256i indices[ExtremePoints::Slots];
+            for (unsigned int slot = 0; slot < ExtremePoints::Slots; ++slot)
+            {
+                extremes[slot] = _mm256_set1_ps(state.Value[slot]);
+                indices[slot] = _mm256_setzero_si256();
+            }
+
+            __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            const __m256i step = _mm256_set1_epi32(8);
+
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 components[3];
+                LoadVector3x8(pIn + i, components[0], components[1], components[2]);
+
+                for (unsigned int axis = 0; axis < 3; ++axis)
+                {
+                    UpdateExtremes(components[axis], index, extremes[axis * 2], indices[axis * 2], extremes[axis * 2 + 1], indices[axis * 2 + 1]);
+                }
+
+                index = _mm256_add_epi32(index, step);
+            }
+
+            for (unsigned int slot = 0; slot < ExtremePoints::Slots; ++slot)
+            {
+                float laneValues[8];
+                unsigned int laneIndices[8];
+                _mm256_storeu_ps(laneValues, extremes[slot]);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(laneIndices), indices[slot]);
+                ExtremePoints::MergeLanes(slot, laneValues, laneIndices, 8, state);
+            }
+
+            // The leftover points can't be handed to the SSE4.2 kernel since it would start over.
+            ExtremePoints::Update(pIn, i, count, state);
+            ExtremePoints::End(state, pOutIndices);
+        }
+
+        PHX_TARGET_AVX2 unsigned int IntersectOBBs(const OBB & box, const OBB * pBoxes, unsigned int * pOutIndices, unsigned int count)
+        {
+            // Same tests as Intersects(OBB, OBB) with box as box1, for 8 boxes at a time.
+
+            const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+            const __m256 epsilon = _mm256_set1_ps(OBBSeparatingAxes::Epsilon);
+
+            const __m256 center[3] = { _mm256_set1_ps(box.Center.X), _mm256_set1_ps(box.Center.Y), _mm256_set1_ps(box.Center.Z) };
+            const __m256 e1[3] = { _mm256_set1_ps(box.Extents.X), _mm256_set1_ps(box.Extents.Y), _mm256_set1_ps(box.Extents.Z) };
+
+            __m256 axes[3][3];
+            for (unsigned int r = 0; r < 3; ++r)
+            {
+                const Vector3 & axis = box.Axes.Row(r);
+                axes[r][0] = _mm256_set1_ps(axis.X);
+                axes[r][1] = _mm256_set1_ps(axis.Y);
+                axes[r][2] = _mm256_set1_ps(axis.Z);
+            }
+
+            // The fields of the 8 boxes are gathered, one register per float of the box.
+            const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(OBBSeparatingAxes::Floats));
+
+            unsigned int hitCount = 0;
+
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const float * p = &pBoxes[i].Center.X;
+
+                __m256 fields[OBBSeparatingAxes::Floats];
+                for (unsigned int f = 0; f < OBBSeparatingAxes::Floats; ++f)
+                {
+                    fields[f] = _mm256_i32gather_ps(p + f, offsets, 4);
+                }
+
+                const __m256 * e2 = fields + 3;
+                const __m256 d[3] = { _mm256_sub_ps(fields[0], center[0]), _mm256_sub_ps(fields[1], center[1]), _mm256_sub_ps(fields[2], center[2]) };
+
+                __m256 t[3];
+                __m256 R[3][3];
+                __m256 absR[3][3];
+                for (unsigned int r = 0; r < 3; ++r)
+                {
+                    t[r] = _mm256_fmadd_ps(d[2], axes[r][2], _mm256_fmadd_ps(d[1], axes[r][1], _mm256_mul_ps(d[0], axes[r][0])));
+
+                    for (unsigned int c = 0; c < 3; ++c)
+                    {
+                        const __m256 * axis = fields + 6 + c * 3;
+                        R[r][c] = _mm256_fmadd_ps(axis[2], axes[r][2], _mm256_fmadd_ps(axis[1], axes[r][1], _mm256_mul_ps(axis[0], axes[r][0])));
+                        absR[r][c] = _mm256_add_ps(_mm256_and_ps(R[r][c], absMask), epsilon);
+                    }
+                }
+
+                // Face axes, most of the separated pairs are found here.
+                __m256 separated = _mm256_setzero_ps();
+                for (unsigned int k = 0; k < 3; ++k)
+                {
+                    const __m256 r2 = _mm256_fmadd_ps(e2[2], absR[k][2], _mm256_fmadd_ps(e2[1], absR[k][1], _mm256_mul_ps(e2[0], absR[k][0])));
+                    separated = _mm256_or_ps(separated, _mm256_cmp_ps(_mm256_and_ps(t[k], absMask), _mm256_add_ps(e1[k], r2), _CMP_GT_OQ));
+
+                    const __m256 r1 = _mm256_fmadd_ps(e1[2], absR[2][k], _mm256_fmadd_ps(e1[1], absR[1][k], _mm256_mul_ps(e1[0], absR[0][k])));
+                    const __m256 distance = _mm256_fmadd_ps(t[2], R[2][k], _mm256_fmadd_ps(t[1], R[1][k], _mm256_mul_ps(t[0], R[0][k])));
+                    separated = _mm256_or_ps(separated, _mm256_cmp_ps(_mm256_and_ps(distance, absMask), _mm256_add_ps(r1, e2[k]), _CMP_GT_OQ));
+                }
+
+                if (_mm256_movemask_ps(separated) == 0xFF)
+                {
+                    continue;
+                }
+
+                // Edge cross products.
+                for (unsigned int a = 0; a < 3; ++a)
+                {
+                    const unsigned int a1 = (a + 1) % 3;
+                    const unsigned int a2 = (a + 2) % 3;
+
+                    for (unsigned int b = 0; b < 3; ++b)
+                    {
+                        const unsigned int b1 = (b + 1) % 3;
+                        const unsigned int b2 = (b + 2) % 3;
+
+                        const __m256 r1 = _mm256_fmadd_ps(e1[a2], absR[a1][b], _mm256_mul_ps(e1[a1], absR[a2][b]));
+                        const __m256 r2 = _mm256_fmadd_ps(e2[b2], absR[a][b1], _mm256_mul_ps(e2[b1], absR[a][b2]));
+                        const __m256 distance = _mm256_fmsub_ps(t[a2], R[a1][b], _mm256_mul_ps(t[a1], R[a2][b]));
+                        separated = _mm256_or_ps(separated, _mm256_cmp_ps(_mm256_and_ps(distance, absMask), _mm256_add_ps(r1, r2), _CMP_GT_OQ));
+                    }
+                }
+
+                // Branchless compaction, an index is always written but only kept when the boxes intersect.
+                const unsigned int hitMask = ~static_cast<unsigned int>(_mm256_movemask_ps(separated));
+                for (unsigned int k = 0; k < 8; ++k)
+                {
+                    pOutIndices[hitCount] = i + k;
+                    hitCount += (hitMask >> k) & 1;
+                }
+            }
+
+            const unsigned int tailCount = BatchKernelsSSE42.IntersectOBBs(box, pBoxes + i, pOutIndices + hitCount, count - i);
+            for (unsigned int k = 0; k < tailCount; ++k)
+            {
+                pOutIndices[hitCount + k] += i;
+            }
+
+            return hitCount + tailCount;
+        }
+
+        PHX_TARGET_AVX2 void AddVector3SoA(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count)
+        {
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                _mm256_storeu_ps(out.X + i, _mm256_add_ps(_mm256_loadu_ps(lhs.X + i), _mm256_loadu_ps(rhs.X + i)));
+                _mm256_storeu_ps(out.Y + i, _mm256_add_ps(_mm256_loadu_ps(lhs.Y + i), _mm256_loadu_ps(rhs.Y + i)));
+                _mm256_storeu_ps(out.Z + i, _mm256_add_ps(_mm256_loadu_ps(lhs.Z + i), _mm256_loadu_ps(rhs.Z + i)));
+            }
+
+            BatchKernelsSSE42.AddVector3SoA(Offset(lhs, i), Offset(rhs, i), Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_AVX2 void SubtractVector3SoA(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count)
+        {
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                _mm256_storeu_ps(out.X + i, _mm256_sub_ps(_mm256_loadu_ps(lhs.X + i), _mm256_loadu_ps(rhs.X + i)));
+                _mm256_storeu_ps(out.Y + i, _mm256_sub_ps(_mm256_loadu_ps(lhs.Y + i), _mm256_loadu_ps(rhs.Y + i)));
+                _mm256_storeu_ps(out.Z + i, _mm256_sub_ps(_mm256_loadu_ps(lhs.Z + i), _mm256_loadu_ps(rhs.Z + i)));
+            }
+
+            BatchKernelsSSE42.SubtractVector3SoA(Offset(lhs, i), Offset(rhs, i), Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_AVX2 void MultiplyVector3SoA(const Vector3SoA & lhs, float rhs, const Vector3SoA & out, unsigned int count)
+        {
+            const __m256 s = _mm256_set1_ps(rhs);
+
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                _mm256_storeu_ps(out.X + i, _mm256_mul_ps(_mm256_loadu_ps(lhs.X + i), s));
+                _mm256_storeu_ps(out.Y + i, _mm256_mul_ps(_mm256_loadu_ps(lhs.Y + i), s));
+                _mm256_storeu_ps(out.Z + i, _mm256_mul_ps(_mm256_loadu_ps(lhs.Z + i), s));
+            }
+
+            BatchKernelsSSE42.MultiplyVector3SoA(Offset(lhs, i), rhs, Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_AVX2 void DotVector3SoA(const Vector3SoA & lhs, const Vector3SoA & rhs, float * pOut, unsigned int count)
+        {
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 dot = _mm256_mul_ps(_mm256_loadu_ps(lhs.X + i), _mm256_loadu_ps(rhs.X + i));
+                dot = _mm256_fmadd_ps(_mm256_loadu_ps(lhs.Y + i), _mm256_loadu_ps(rhs.Y + i), dot);
+                dot = _mm256_fmadd_ps(_mm256_loadu_ps(lhs.Z + i), _mm256_loadu_ps(rhs.Z + i), dot);
+                _mm256_storeu_ps(pOut + i, dot);
+            }
+
+            BatchKernelsSSE42.DotVector3SoA(Offset(lhs, i), Offset(rhs, i), pOut + i, count - i);
+        }
+
+        PHX_TARGET_AVX2 void TransformVector3SoA(const Vector3SoA & in, const Matrix4x4 & m, const Vector3SoA & out, unsigned int count)
+        {
+            const __m256 m11 = _mm256_set1_ps(m.M11), m12 = _mm256_set1_ps(m.M12), m13 = _mm256_set1_ps(m.M13);
+            const __m256 m21 = _mm256_set1_ps(m.M21), m22 = _mm256_set1_ps(m.M22), m23 = _mm256_set1_ps(m.M23);
+            const __m256 m31 = _mm256_set1_ps(m.M31), m32 = _mm256_set1_ps(m.M32), m33 = _mm256_set1_ps(m.M33);
+            const __m256 m41 = _mm256_set1_ps(m.M41), m42 = _mm256_set1_ps(m.M42), m43 = _mm256_set1_ps(m.M43);
+
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 x = _mm256_loadu_ps(in.X + i);
+                const __m256 y = _mm256_loadu_ps(in.Y + i);
+                const __m256 z = _mm256_loadu_ps(in.Z + i);
+
+                _mm256_storeu_ps(out.X + i, _mm256_fmadd_ps(z, m31, _mm256_fmadd_ps(y, m21, _mm256_fmadd_ps(x, m11, m41))));
+                _mm256_storeu_ps(out.Y + i, _mm256_fmadd_ps(z, m32, _mm256_fmadd_ps(y, m22, _mm256_fmadd_ps(x, m12, m42))));
+                _mm256_storeu_ps(out.Z + i, _mm256_fmadd_ps(z, m33, _mm256_fmadd_ps(y, m23, _mm256_fmadd_ps(x, m13, m43))));
+            }
+
+            BatchKernelsSSE42.TransformVector3SoA(Offset(in, i), m, Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_AVX2 void NormalizeVector3SoA(const Vector3SoA & in, const Vector3SoA & out, unsigned int count)
+        {
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 zero = _mm256_setzero_ps();
+
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 x = _mm256_loadu_ps(in.X + i);
+                const __m256 y = _mm256_loadu_ps(in.Y + i);
+                const __m256 z = _mm256_loadu_ps(in.Z + i);
+
+                const __m256 lengthSquared = _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x)));
+                const __m256 invLength = _mm256_and_ps(_mm256_cmp_ps(lengthSquared, zero, _CMP_GT_OQ), _mm256_div_ps(one, _mm256_sqrt_ps(lengthSquared)));
+
+                _mm256_storeu_ps(out.X + i, _mm256_mul_ps(x, invLength));
+                _mm256_storeu_ps(out.Y + i, _mm256_mul_ps(y, invLength));
+                _mm256_storeu_ps(out.Z + i, _mm256_mul_ps(z, invLength));
+            }
+
+            BatchKernelsSSE42.NormalizeVector3SoA(Offset(in, i), Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_AVX2 void MultiplyQuaternionSoA(const QuaternionSoA & lhs, const QuaternionSoA & rhs, const QuaternionSoA & out, unsigned int count)
+        {
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 lx = _mm256_loadu_ps(lhs.X + i), ly = _mm256_loadu_ps(lhs.Y + i), lz = _mm256_loadu_ps(lhs.Z + i), lw = _mm256_loadu_ps(lhs.W + i);
+                const __m256 rx = _mm256_loadu_ps(rhs.X + i), ry = _mm256_loadu_ps(rhs.Y + i), rz = _mm256_loadu_ps(rhs.Z + i), rw = _mm256_loadu_ps(rhs.W + i);
+
+                const __m256 x = _mm256_fnmadd_ps(lz, ry, _mm256_fmadd_ps(ly, rz, _mm256_fmadd_ps(lw, rx, _mm256_mul_ps(rw, lx))));
+                const __m256 y = _mm256_fnmadd_ps(lx, rz, _mm256_fmadd_ps(lz, rx, _mm256_fmadd_ps(lw, ry, _mm256_mul_ps(rw, ly))));
+                const __m256 z = _mm256_fnmadd_ps(ly, rx, _mm256_fmadd_ps(lx, ry, _mm256_fmadd_ps(lw, rz, _mm256_mul_ps(rw, lz))));
+                const __m256 w = _mm256_fnmadd_ps(lz, rz, _mm256_fnmadd_ps(ly, ry, _mm256_fnmadd_ps(lx, rx, _mm256_mul_ps(rw, lw))));
+
+                _mm256_storeu_ps(out.X + i, x);
+                _mm256_storeu_ps(out.Y + i, y);
+                _mm256_storeu_ps(out.Z + i, z);
+                _mm256_storeu_ps(out.W + i, w);
+            }
+
+            BatchKernelsSSE42.MultiplyQuaternionSoA(Offset(lhs, i), Offset(rhs, i), Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_AVX2 void NormalizeQuaternionSoA(const QuaternionSoA & in, const QuaternionSoA & out, unsigned int count)
+        {
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 zero = _mm256_setzero_ps();
+
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 x = _mm256_loadu_ps(in.X + i);
+                const __m256 y = _mm256_loadu_ps(in.Y + i);
+                const __m256 z = _mm256_loadu_ps(in.Z + i);
+                const __m256 w = _mm256_loadu_ps(in.W + i);
+
+                const __m256 lengthSquared = _mm256_fmadd_ps(w, w, _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x))));
+                const __m256 invLength = _mm256_and_ps(_mm256_cmp_ps(lengthSquared, zero, _CMP_GT_OQ), _mm256_div_ps(one, _mm256_sqrt_ps(lengthSquared)));
+
+                _mm256_storeu_ps(out.X + i, _mm256_mul_ps(x, invLength));
+                _mm256_storeu_ps(out.Y + i, _mm256_mul_ps(y, invLength));
+                _mm256_storeu_ps(out.Z + i, _mm256_mul_ps(z, invLength));
+                _mm256_storeu_ps(out.W + i, _mm256_mul_ps(w, invLength));
+            }
+
+            BatchKernelsSSE42.NormalizeQuaternionSoA(Offset(in, i), Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_AVX2 void SlerpQuaternionSoA(const QuaternionSoA & q1, const QuaternionSoA & q2, float weight, const QuaternionSoA & out, unsigned int count)
+        {
+            SlerpWeights weights;
+            PrepareSlerp(weight, weights);
+
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 x1 = _mm256_loadu_ps(q1.X + i), y1 = _mm256_loadu_ps(q1.Y + i), z1 = _mm256_loadu_ps(q1.Z + i), w1 = _mm256_loadu_ps(q1.W + i);
+                const __m256 x2 = _mm256_loadu_ps(q2.X + i), y2 = _mm256_loadu_ps(q2.Y + i), z2 = _mm256_loadu_ps(q2.Z + i), w2 = _mm256_loadu_ps(q2.W + i);
+
+                const __m256 cosTheta = _mm256_fmadd_ps(w1, w2, _mm256_fmadd_ps(z1, z2, _mm256_fmadd_ps(y1, y2, _mm256_mul_ps(x1, x2))));
+
+                __m256 t1, t2;
+                GetSlerpWeights(weights, cosTheta, t1, t2);
+
+                _mm256_storeu_ps(out.X + i, _mm256_fmadd_ps(t2, x2, _mm256_mul_ps(t1, x1)));
+                _mm256_storeu_ps(out.Y + i, _mm256_fmadd_ps(t2, y2, _mm256_mul_ps(t1, y1)));
+                _mm256_storeu_ps(out.Z + i, _mm256_fmadd_ps(t2, z2, _mm256_mul_ps(t1, z1)));
+                _mm256_storeu_ps(out.W + i, _mm256_fmadd_ps(t2, w2, _mm256_mul_ps(t1, w1)));
+            }
+
+            BatchKernelsSSE42.SlerpQuaternionSoA(Offset(q1, i), Offset(q2, i), weight, Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_AVX2 void IntersectRaysAABB(const RaySoA & rays, const AABB & box, float * pOutT, unsigned int count)
+        {
+            const __m256 minX = _mm256_set1_ps(box.Min.X), minY = _mm256_set1_ps(box.Min.Y), minZ = _mm256_set1_ps(box.Min.Z);
+            const __m256 maxX = _mm256_set1_ps(box.Max.X), maxY = _mm256_set1_ps(box.Max.Y), maxZ = _mm256_set1_ps(box.Max.Z);
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 miss = _mm256_set1_ps(FLT_MAX);
+
+            // A packet of 8 rays, see the SSE4.2 version.
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 ox = _mm256_loadu_ps(rays.Origin.X + i);
+                const __m256 oy = _mm256_loadu_ps(rays.Origin.Y + i);
+                const __m256 oz = _mm256_loadu_ps(rays.Origin.Z + i);
+                const __m256 ix = _mm256_loadu_ps(rays.InvDirection.X + i);
+                const __m256 iy = _mm256_loadu_ps(rays.InvDirection.Y + i);
+                const __m256 iz = _mm256_loadu_ps(rays.InvDirection.Z + i);
+
+                const __m256 x1 = _mm256_mul_ps(_mm256_sub_ps(minX, ox), ix);
+                const __m256 x2 = _mm256_mul_ps(_mm256_sub_ps(maxX, ox), ix);
+                const __m256 y1 = _mm256_mul_ps(_mm256_sub_ps(minY, oy), iy);
+                const __m256 y2 = _mm256_mul_ps(_mm256_sub_ps(maxY, oy), iy);
+                const __m256 z1 = _mm256_mul_ps(_mm256_sub_ps(minZ, oz), iz);
+                const __m256 z2 = _mm256_mul_ps(_mm256_sub_ps(maxZ, oz), iz);
+
+                const __m256 tNear = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(x1, x2), _mm256_min_ps(y1, y2)), _mm256_max_ps(_mm256_min_ps(z1, z2), zero));
+                const __m256 tFar = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(x1, x2), _mm256_max_ps(y1, y2)), _mm256_max_ps(z1, z2));
+
+                _mm256_storeu_ps(pOutT + i, _mm256_blendv_ps(miss, tNear, _mm256_cmp_ps(tNear, tFar, _CMP_LE_OQ)));
+            }
+
+            BatchKernelsSSE42.IntersectRaysAABB(Offset(rays, i), box, pOutT + i, count - i);
+        }
+
+        PHX_TARGET_AVX2 void IntersectRaysTriangle(const RaySoA & rays, const Vector3 & v0, const Vector3 & v1, const Vector3 & v2, float * pOutT, unsigned int count)
+        {
+            const __m256 e1x = _mm256_set1_ps(v1.X - v0.X), e1y = _mm256_set1_ps(v1.Y - v0.Y), e1z = _mm256_set1_ps(v1.Z - v0.Z);
+            const __m256 e2x = _mm256_set1_ps(v2.X - v0.X), e2y = _mm256_set1_ps(v2.Y - v0.Y), e2z = _mm256_set1_ps(v2.Z - v0.Z);
+            const __m256 v0x = _mm256_set1_ps(v0.X), v0y = _mm256_set1_ps(v0.Y), v0z = _mm256_set1_ps(v0.Z);
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 miss = _mm256_set1_ps(FLT_MAX);
+
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 dx = _mm256_loadu_ps(rays.Direction.X + i);
+                const __m256 dy = _mm256_loadu_ps(rays.Direction.Y + i);
+                const __m256 dz = _mm256_loadu_ps(rays.Direction.Z + i);
+                const __m256 sx = _mm256_sub_ps(_mm256_loadu_ps(rays.Origin.X + i), v0x);
+                const __m256 sy = _mm256_sub_ps(_mm256_loadu_ps(rays.Origin.Y + i), v0y);
+                const __m256 sz = _mm256_sub_ps(_mm256_loadu_ps(rays.Origin.Z + i), v0z);
+
+                // p = direction x edge2, q = s x edge1
+                const __m256 px = _mm256_fmsub_ps(dy, e2z, _mm256_mul_ps(dz, e2y));
+                const __m256 py = _mm256_fmsub_ps(dz, e2x, _mm256_mul_ps(dx, e2z));
+                const __m256 pz = _mm256_fmsub_ps(dx, e2y, _mm256_mul_ps(dy, e2x));
+                const __m256 qx = _mm256_fmsub_ps(sy, e1z, _mm256_mul_ps(sz, e1y));
+                const __m256 qy = _mm256_fmsub_ps(sz, e1x, _mm256_mul_ps(sx, e1z));
+                const __m256 qz = _mm256_fmsub_ps(sx, e1y, _mm256_mul_ps(sy, e1x));
+
+                const __m256 det = _mm256_fmadd_ps(e1z, pz, _mm256_fmadd_ps(e1y, py, _mm256_mul_ps(e1x, px)));
+                const __m256 invDet = _mm256_div_ps(one, det);
+
+                const __m256 u = _mm256_mul_ps(_mm256_fmadd_ps(sz, pz, _mm256_fmadd_ps(sy, py, _mm256_mul_ps(sx, px))), invDet);
+                const __m256 v = _mm256_mul_ps(_mm256_fmadd_ps(dz, qz, _mm256_fmadd_ps(dy, qy, _mm256_mul_ps(dx, qx))), invDet);
+                const __m256 t = _mm256_mul_ps(_mm256_fmadd_ps(e2z, qz, _mm256_fmadd_ps(e2y, qy, _mm256_mul_ps(e2x, qx))), invDet);
+
+                __m256 hit = _mm256_cmp_ps(det, zero, _CMP_NEQ_OQ);
+                hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_GE_OQ), _mm256_cmp_ps(u, one, _CMP_LE_OQ)));
+                hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(v, zero, _CMP_GE_OQ), _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ)));
+                hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, zero, _CMP_GE_OQ));
+
+                _mm256_storeu_ps(pOutT + i, _mm256_blendv_ps(miss, t, hit));
+            }
+
+            BatchKernelsSSE42.IntersectRaysTriangle(Offset(rays, i), v0, v1, v2, pOutT + i, count - i);
+        }
+
+        PHX_TARGET_AVX2 void SignedDistanceVector3SoA(const Plane & plane, const Vector3SoA & points, float * pOut, unsigned int count)
+        {
+            const __m256 nx = _mm256_set1_ps(plane.Normal.X);
+            const __m256 ny = _mm256_set1_ps(plane.Normal.Y);
+            const __m256 nz = _mm256_set1_ps(plane.Normal.Z);
+            const __m256 d = _mm256_set1_ps(plane.D);
+
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 distance = _mm256_fmadd_ps(_mm256_loadu_ps(points.X + i), nx, d);
+                distance = _mm256_fmadd_ps(_mm256_loadu_ps(points.Y + i), ny, distance);
+                distance = _mm256_fmadd_ps(_mm256_loadu_ps(points.Z + i), nz, distance);
+                _mm256_storeu_ps(pOut + i, distance);
+            }
+
+            BatchKernelsSSE42.SignedDistanceVector3SoA(plane, Offset(points, i), pOut + i, count - i);
+        }
+
+        PHX_TARGET_AVX2 unsigned int ClassifyVector3SoA(const Plane & plane, const Vector3SoA & points, float epsilon, uint32_t * pOutFront, uint32_t * pOutBack, unsigned int count)
+        {
+            const __m256 nx = _mm256_set1_ps(plane.Normal.X);
+            const __m256 ny = _mm256_set1_ps(plane.Normal.Y);
+            const __m256 nz = _mm256_set1_ps(plane.Normal.Z);
+            const __m256 d = _mm256_set1_ps(plane.D);
+            const __m256 frontLimit = _mm256_set1_ps(epsilon);
+            const __m256 backLimit = _mm256_set1_ps(-epsilon);
+
+            unsigned int sides = 0;
+            uint32_t frontBits = 0;
+            uint32_t backBits = 0;
+
+            // The bits of each word are gathered in registers and stored once the word is full.
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 distance = _mm256_fmadd_ps(_mm256_loadu_ps(points.X + i), nx, d);
+                distance = _mm256_fmadd_ps(_mm256_loadu_ps(points.Y + i), ny, distance);
+                distance = _mm256_fmadd_ps(_mm256_loadu_ps(points.Z + i), nz, distance);
+
+                frontBits |= static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(distance, frontLimit, _CMP_GT_OQ))) << (i & 31);
+                backBits |= static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(distance, backLimit, _CMP_LT_OQ))) << (i & 31);
+
+                if (((i + 8) & 31) == 0)
+                {
+                    sides |= PlaneMasks::StoreWord(frontBits, backBits, pOutFront + (i >> 5), pOutBack + (i >> 5));
+                    frontBits = 0;
+                    backBits = 0;
+                }
+            }
+
+            // The scalar loop adds the leftover points to the last word, which may already be partly filled.
+            if ((i & 31) != 0)
+            {
+                sides |= PlaneMasks::StoreWord(frontBits, backBits, pOutFront + (i >> 5), pOutBack + (i >> 5));
+            }
+
+            return sides | PlaneMasks::Classify(plane, points, epsilon, pOutFront, pOutBack, i, count);
+        }
+
+        PHX_TARGET_AVX2 void PackHalf(const float * pIn, uint16_t * pOut, unsigned int count)
+        {
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(pIn + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(pOut + i), h);
+            }
+
+            BatchKernelsScalar.PackHalf(pIn + i, pOut + i, count - i);
+        }
+
+        PHX_TARGET_AVX2 void UnpackHalf(const uint16_t * pIn, float * pOut, unsigned int count)
+        {
+            unsigned int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pIn + i));
+                _mm256_storeu_ps(pOut + i, _mm256_cvtph_ps(h));
+            }
+
+            BatchKernelsScalar.UnpackHalf(pIn + i, pOut + i, count - i);
+        }
+    }
+
+    const BatchKernels BatchKernelsAVX2 =
+    {
+        TransformVector3,
+        TransformVector4,
+        TransformVector2,
+        TransformRect,
+        NormalizeVector3,
+        SlerpQuaternion,
+        MultiplyMatrix4x4,
+        MultiplyMatrix4x4ByMatrix,
+        NormalMatrix4x4,
+        CullSpheresByPlanes,
+        ExtremePointsVector3,
+        IntersectOBBs,
+
+        AddVector3SoA,
+        SubtractVector3SoA,
+        MultiplyVector3SoA,
+        DotVector3SoA,
+        TransformVector3SoA,
+        NormalizeVector3SoA,
+        MultiplyQuaternionSoA,
+        NormalizeQuaternionSoA,
+        SlerpQuaternionSoA,
+        IntersectRaysAABB,
+        IntersectRaysTriangle,
+        SignedDistanceVector3SoA,
+        ClassifyVector3SoA,
+
+        PackHalf,
+        UnpackHalf,
+    };
+
+} //namespace Math
+} //namespace Phx
+
+#endif //PHX_MATH_X86
@@ -0,0 +1,947 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathBatchKernels.h"
+
+#if PHX_MATH_X86
+
+#include <immintrin.h>
+
+#define PHX_TARGET_AVX512 PHX_TARGET("avx512f,avx512vl,avx512bw,avx512dq,avx2,fma,f16c")
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// The AVX-512 kernels handle the last partial register with masked loads
+// and stores instead of handing the leftover elements to a narrower tier.
+// Masked out lanes are loaded as zero and never written, and the masked
+// loads don't fault on memory past the end of the arrays.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // GCC 12 builds the unmasked permute, shuffle, unpack, broadcast, min/max and half conversion
+        // intrinsics on _mm512_undefined_ps and warns that it may be uninitialized. The zero masked
+        // forms with every lane set are the same instruction without the undefined source.
+        const __mmask16 AllLanes = static_cast<__mmask16>(0xFFFF);
+
+        // Mask of the first count lanes (all 16 when count >= 16).
+        inline __mmask16 TailMask(unsigned int count)
+        {
+            return (count >= 16) ? static_cast<__mmask16>(0xFFFF) : static_cast<__mmask16>((1u << count) - 1);
+        }
+
+        // Masks of the 3 registers holding the floats of count Vector3s (up to 16).
+        inline void Vector3x16Masks(unsigned int count, __mmask16 outMasks[3])
+        {
+            const unsigned int floats = (count >= 16) ? 48 : count * 3;
+            outMasks[0] = TailMask(floats);
+            outMasks[1] = TailMask(floats > 16 ? floats - 16 : 0);
+            outMasks[2] = TailMask(floats > 32 ? floats - 32 : 0);
+        }
+
+        // Masks of the 4 registers holding the floats of count Vector4s/Quaternions (up to 16).
+        inline void Float4x16Masks(unsigned int count, __mmask16 outMasks[4])
+        {
+            const unsigned int floats = (count >= 16) ? 64 : count * 4;
+            outMasks[0] = TailMask(floats);
+            outMasks[1] = TailMask(floats > 16 ? floats - 16 : 0);
+            outMasks[2] = TailMask(floats > 32 ? floats - 32 : 0);
+            outMasks[3] = TailMask(floats > 48 ? floats - 48 : 0);
+        }
+
+        // 16 Vector3s are 48 floats, held in registers a, b and c. Component k of vector i is float 3i + k,
+        // which is gathered in two steps: the floats in a and b (< 32) first, then the ones in c.
+        PHX_TARGET_AVX512 inline void LoadVector3x16(const Vector3 * p, const __mmask16 masks[3], __m512 & outX, __m512 & outY, __m512 & outZ)
+        {
+            const float * pSrc = &p->X;
+            const __m512 a = _mm512_maskz_loadu_ps(masks[0], pSrc);
+            const __m512 b = _mm512_maskz_loadu_ps(masks[1], pSrc + 16);
+            const __m512 c = _mm512_maskz_loadu_ps(masks[2], pSrc + 32);
+
+            const __m512i xFromAB = _mm512_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 0, 0, 0, 0, 0);
+            const __m512i xFromC  = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 17, 20, 23, 26, 29);
+            const __m512i yFromAB = _mm512_setr_epi32(1, 4, 7, 10, 13, 16, 19, 22, 25, 28, 31, 0, 0, 0, 0, 0);
+            const __m512i yFromC  = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 18, 21, 24, 27, 30);
+            const __m512i zFromAB = _mm512_setr_epi32(2, 5, 8, 11, 14, 17, 20, 23, 26, 29, 0, 0, 0, 0, 0, 0);
+            const __m512i zFromC  = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 16, 19, 22, 25, 28, 31);
+
+            outX = _mm512_permutex2var_ps(_mm512_permutex2var_ps(a, xFromAB, b), xFromC, c);
+            outY = _mm512_permutex2var_ps(_mm512_permutex2var_ps(a, yFromAB, b), yFromC, c);
+            outZ = _mm512_permutex2var_ps(_mm512_permutex2var_ps(a, zFromAB, b), zFromC, c);
+        }
+
+        // The reverse of LoadVector3x16: each output register takes its X and Y floats first, then its Z floats.
+        PHX_TARGET_AVX512 inline void StoreVector3x16(__m512 x, __m512 y, __m512 z, const __mmask16 masks[3], Vector3 * p)
+        {
+            const __m512i aFromXY = _mm512_setr_epi32(0, 16, 0, 1, 17, 0, 2, 18, 0, 3, 19, 0, 4, 20, 0, 5);
+            const __m512i aFromZ  = _mm512_setr_epi32(0, 1, 16, 3, 4, 17, 6, 7, 18, 9, 10, 19, 12, 13, 20, 15);
+            const __m512i bFromXY = _mm512_setr_epi32(21, 0, 6, 22, 0, 7, 23, 0, 8, 24, 0, 9, 25, 0, 10, 26);
+            const __m512i bFromZ  = _mm512_setr_epi32(0, 21, 2, 3, 22, 5, 6, 23, 8, 9, 24, 11, 12, 25, 14, 15);
+            const __m512i cFromXY = _mm512_setr_epi32(0, 11, 27, 0, 12, 28, 0, 13, 29, 0, 14, 30, 0, 15, 31, 0);
+            const __m512i cFromZ  = _mm512_setr_epi32(26, 1, 2, 27, 4, 5, 28, 7, 8, 29, 10, 11, 30, 13, 14, 31);
+
+            float * pDst = &p->X;
+            _mm512_mask_storeu_ps(pDst, masks[0], _mm512_permutex2var_ps(_mm512_permutex2var_ps(x, aFromXY, y), aFromZ, z));
+            _mm512_mask_storeu_ps(pDst + 16, masks[1], _mm512_permutex2var_ps(_mm512_permutex2var_ps(x, bFromXY, y), bFromZ, z));
+            _mm512_mask_storeu_ps(pDst + 32, masks[2], _mm512_permutex2var_ps(_mm512_permutex2var_ps(x, cFromXY, y), cFromZ, z));
+        }
+
+        // 16 consecutive 4 float elements as one register per component. Each register is transposed within its
+        // 128 bit lanes, so the elements end up out of order (lane e holds element 4 * (e % 4) + e / 4), which
+        // doesn't matter for per element math as StoreFloat4x16 puts them back.
+        PHX_TARGET_AVX512 inline void LoadFloat4x16(const float * pSrc, const __mmask16 masks[4], __m512 & outX, __m512 & outY, __m512 & outZ, __m512 & outW)
+        {
+            const __m512 r0 = _mm512_maskz_loadu_ps(masks[0], pSrc);
+            const __m512 r1 = _mm512_maskz_loadu_ps(masks[1], pSrc + 16);
+            const __m512 r2 = _mm512_maskz_loadu_ps(masks[2], pSrc + 32);
+            const __m512 r3 = _mm512_maskz_loadu_ps(masks[3], pSrc + 48);
+
+            const __m512 t0 = _mm512_maskz_unpacklo_ps(AllLanes, r0, r1);
+            const __m512 t1 = _mm512_maskz_unpackhi_ps(AllLanes, r0, r1);
+            const __m512 t2 = _mm512_maskz_unpacklo_ps(AllLanes, r2, r3);
+            const __m512 t3 = _mm512_maskz_unpackhi_ps(AllLanes, r2, r3);
+
+            outX = _mm512_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            outY = _mm512_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            outZ = _mm512_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            outW = _mm512_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        }
+
+        PHX_TARGET_AVX512 inline void StoreFloat4x16(__m512 x, __m512 y, __m512 z, __m512 w, const __mmask16 masks[4], float * pDst)
+        {
+            const __m512 t0 = _mm512_maskz_unpacklo_ps(AllLanes, x, y);
+            const __m512 t1 = _mm512_maskz_unpackhi_ps(AllLanes, x, y);
+            const __m512 t2 = _mm512_maskz_unpacklo_ps(AllLanes, z, w);
+            const __m512 t3 = _mm512_maskz_unpackhi_ps(AllLanes, z, w);
+
+            _mm512_mask_storeu_ps(pDst, masks[0], _mm512_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)));
+            _mm512_mask_storeu_ps(pDst + 16, masks[1], _mm512_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)));
+            _mm512_mask_storeu_ps(pDst + 32, masks[2], _mm512_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)));
+            _mm512_mask_storeu_ps(pDst + 48, masks[3], _mm512_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2)));
+        }
+
+        // Four rows (one per 128 bit lane) transformed by m, m0-m3 hold each row of m in every lane.
+        PHX_TARGET_AVX512 inline __m512 TransformRows(__m512 rows, __m512 m0, __m512 m1, __m512 m2, __m512 m3)
+        {
+            __m512 r = _mm512_mul_ps(_mm512_maskz_permute_ps(AllLanes, rows, _MM_SHUFFLE(0, 0, 0, 0)), m0);
+            r = _mm512_fmadd_ps(_mm512_maskz_permute_ps(AllLanes, rows, _MM_SHUFFLE(1, 1, 1, 1)), m1, r);
+            r = _mm512_fmadd_ps(_mm512_maskz_permute_ps(AllLanes, rows, _MM_SHUFFLE(2, 2, 2, 2)), m2, r);
+            r = _mm512_fmadd_ps(_mm512_maskz_permute_ps(AllLanes, rows, _MM_SHUFFLE(3, 3, 3, 3)), m3, r);
+            return r;
+        }
+
+        PHX_TARGET_AVX512 inline __m512 InvLengthOrZero(__m512 lengthSquared)
+        {
+            const __mmask16 nonZero = _mm512_cmp_ps_mask(lengthSquared, _mm512_setzero_ps(), _CMP_GT_OQ);
+            return _mm512_maskz_div_ps(nonZero, _mm512_set1_ps(1.0f), _mm512_maskz_sqrt_ps(nonZero, lengthSquared));
+        }
+
+        PHX_TARGET_AVX512 void TransformVector3(const Vector3 * pIn, const Matrix4x4 & m, Vector3 * pOut, unsigned int count)
+        {
+            const __m512 m11 = _mm512_set1_ps(m.M11), m12 = _mm512_set1_ps(m.M12), m13 = _mm512_set1_ps(m.M13);
+            const __m512 m21 = _mm512_set1_ps(m.M21), m22 = _mm512_set1_ps(m.M22), m23 = _mm512_set1_ps(m.M23);
+            const __m512 m31 = _mm512_set1_ps(m.M31), m32 = _mm512_set1_ps(m.M32), m33 = _mm512_set1_ps(m.M33);
+            const __m512 m41 = _mm512_set1_ps(m.M41), m42 = _mm512_set1_ps(m.M42), m43 = _mm512_set1_ps(m.M43);
+
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                __mmask16 masks[3];
+                Vector3x16Masks(count - i, masks);
+
+                __m512 x, y, z;
+                LoadVector3x16(pIn + i, masks, x, y, z);
+
+                const __m512 outX = _mm512_fmadd_ps(z, m31, _mm512_fmadd_ps(y, m21, _mm512_fmadd_ps(x, m11, m41)));
+                const __m512 outY = _mm512_fmadd_ps(z, m32, _mm512_fmadd_ps(y, m22, _mm512_fmadd_ps(x, m12, m42)));
+                const __m512 outZ = _mm512_fmadd_ps(z, m33, _mm512_fmadd_ps(y, m23, _mm512_fmadd_ps(x, m13, m43)));
+
+                StoreVector3x16(outX, outY, outZ, masks, pOut + i);
+            }
+        }
+
+        PHX_TARGET_AVX512 void TransformVector4(const Vector4 * pIn, const Matrix4x4 & m, Vector4 * pOut, unsigned int count)
+        {
+            const __m512 m0 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_loadu_ps(&m.M11));
+            const __m512 m1 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_loadu_ps(&m.M21));
+            const __m512 m2 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_loadu_ps(&m.M31));
+            const __m512 m3 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_loadu_ps(&m.M41));
+
+            for (unsigned int i = 0; i < count; i += 4)
+            {
+                const __mmask16 mask = TailMask((count - i >= 4) ? 16 : (count - i) * 4);
+
+                const __m512 v = _mm512_maskz_loadu_ps(mask, &pIn[i].X);
+                _mm512_mask_storeu_ps(&pOut[i].X, mask, TransformRows(v, m0, m1, m2, m3));
+            }
+        }
+
+        PHX_TARGET_AVX512 void TransformVector2(const Vector2 * pIn, const Matrix3x2 & m, Vector2 * pOut, unsigned int count)
+        {
+            const __m512 m1 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_setr_ps(m.M11, m.M12, m.M11, m.M12));
+            const __m512 m2 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_setr_ps(m.M21, m.M22, m.M21, m.M22));
+            const __m512 m3 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_setr_ps(m.M31, m.M32, m.M31, m.M32));
+
+            for (unsigned int i = 0; i < count; i += 8)
+            {
+                const __mmask16 mask = TailMask((count - i >= 8) ? 16 : (count - i) * 2);
+
+                const __m512 v = _mm512_maskz_loadu_ps(mask, &pIn[i].X);
+                const __m512 x = _mm512_maskz_permute_ps(AllLanes, v, _MM_SHUFFLE(2, 2, 0, 0));
+                const __m512 y = _mm512_maskz_permute_ps(AllLanes, v, _MM_SHUFFLE(3, 3, 1, 1));
+
+                _mm512_mask_storeu_ps(&pOut[i].X, mask, _mm512_fmadd_ps(y, m2, _mm512_fmadd_ps(x, m1, m3)));
+            }
+        }
+
+        PHX_TARGET_AVX512 void TransformRect(const Rect * pIn, const Matrix3x2 & m, Rect * pOut, unsigned int count)
+        {
+            // See the SSE4.2 version, one rect per 128 bit block.
+            const __m512 m1 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_setr_ps(m.M11, m.M12, m.M11, m.M12));
+            const __m512 m2 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_setr_ps(m.M21, m.M22, m.M21, m.M22));
+            const __m512 m3 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_setr_ps(m.M31, m.M32, 0.0f, 0.0f));
+            const __m512 zero = _mm512_setzero_ps();
+
+            for (unsigned int i = 0; i < count; i += 4)
+            {
+                const __mmask16 mask = TailMask((count - i >= 4) ? 16 : (count - i) * 4);
+
+                const __m512 r = _mm512_maskz_loadu_ps(mask, &pIn[i].X);
+                const __m512 a = _mm512_mul_ps(_mm512_maskz_permute_ps(AllLanes, r, _MM_SHUFFLE(2, 2, 0, 0)), m1);
+                const __m512 b = _mm512_mul_ps(_mm512_maskz_permute_ps(AllLanes, r, _MM_SHUFFLE(3, 3, 1, 1)), m2);
+
+                const __m512 negative = _mm512_add_ps(_mm512_maskz_min_ps(AllLanes, a, zero), _mm512_maskz_min_ps(AllLanes, b, zero));
+                const __m512 position = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(a, b), m3), _mm512_maskz_permute_ps(AllLanes, negative, _MM_SHUFFLE(3, 2, 3, 2)));
+                const __m512 size = _mm512_add_ps(_mm512_abs_ps(a), _mm512_abs_ps(b));
+
+                _mm512_mask_storeu_ps(&pOut[i].X, mask, _mm512_mask_blend_ps(0xCCCC, position, size));
+            }
+        }
+
+        PHX_TARGET_AVX512 void NormalizeVector3(const Vector3 * pIn, Vector3 * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                __mmask16 masks[3];
+                Vector3x16Masks(count - i, masks);
+
+                __m512 x, y, z;
+                LoadVector3x16(pIn + i, masks, x, y, z);
+
+                const __m512 invLength = InvLengthOrZero(_mm512_fmadd_ps(z, z, _mm512_fmadd_ps(y, y, _mm512_mul_ps(x, x))));
+
+                StoreVector3x16(_mm512_mul_ps(x, invLength), _mm512_mul_ps(y, invLength), _mm512_mul_ps(z, invLength), masks, pOut + i);
+            }
+        }
+
+        struct SlerpWeights
+        {
+            float T;
+            float D;
+            float CoefficientsT[SlerpPolynomial::Terms];
+            float CoefficientsD[SlerpPolynomial::Terms];
+        };
+
+        inline void PrepareSlerp(float weight, SlerpWeights & out)
+        {
+            out.T = weight;
+            out.D = 1.0f - weight;
+            SlerpPolynomial::Prepare(out.T, out.CoefficientsT);
+            SlerpPolynomial::Prepare(out.D, out.CoefficientsD);
+        }
+
+        PHX_TARGET_AVX512 inline __m512 EvaluateSlerpPolynomial(const float coefficients[SlerpPolynomial::Terms], __m512 xm1)
+        {
+            const __m512 one = _mm512_set1_ps(1.0f);
+
+            __m512 poly = one;
+            for (int j = SlerpPolynomial::Terms - 1; j >= 0; --j)
+            {
+                poly = _mm512_fmadd_ps(_mm512_mul_ps(_mm512_set1_ps(coefficients[j]), xm1), poly, one);
+            }
+            return poly;
+        }
+
+        PHX_TARGET_AVX512 inline void GetSlerpWeights(const SlerpWeights & weights, __m512 cosTheta, __m512 & t1, __m512 & t2)
+        {
+            // Shortest arc: use |cos(theta)| and flip the sign of the q2 weight.
+            const __m512 absCosTheta = _mm512_abs_ps(cosTheta);
+            const __m512 xm1 = _mm512_sub_ps(absCosTheta, _mm512_set1_ps(1.0f));
+
+            t1 = _mm512_mul_ps(_mm512_set1_ps(weights.D), EvaluateSlerpPolynomial(weights.CoefficientsD, xm1));
+            t2 = _mm512_mul_ps(_mm512_set1_ps(weights.T), EvaluateSlerpPolynomial(weights.CoefficientsT, xm1));
+
+            const __mmask16 negative = _mm512_cmp_ps_mask(cosTheta, _mm512_setzero_ps(), _CMP_LT_OQ);
+            t2 = _mm512_mask_sub_ps(t2, negative, _mm512_setzero_ps(), t2);
+        }
+
+        PHX_TARGET_AVX512 void SlerpQuaternion(const Quaternion * pQ1, const Quaternion * pQ2, float weight, Quaternion * pOut, unsigned int count)
+        {
+            SlerpWeights weights;
+            PrepareSlerp(weight, weights);
+
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                __mmask16 masks[4];
+                Float4x16Masks(count - i, masks);
+
+                __m512 x1, y1, z1, w1;
+                LoadFloat4x16(&pQ1[i].X, masks, x1, y1, z1, w1);
+
+                __m512 x2, y2, z2, w2;
+                LoadFloat4x16(&pQ2[i].X, masks, x2, y2, z2, w2);
+
+                const __m512 cosTheta = _mm512_fmadd_ps(w1, w2, _mm512_fmadd_ps(z1, z2, _mm512_fmadd_ps(y1, y2, _mm512_mul_ps(x1, x2))));
+
+                __m512 t1, t2;
+                GetSlerpWeights(weights, cosTheta, t1, t2);
+
+                const __m512 x = _mm512_fmadd_ps(t2, x2, _mm512_mul_ps(t1, x1));
+                const __m512 y = _mm512_fmadd_ps(t2, y2, _mm512_mul_ps(t1, y1));
+                const __m512 z = _mm512_fmadd_ps(t2, z2, _mm512_mul_ps(t1, z1));
+                const __m512 w = _mm512_fmadd_ps(t2, w2, _mm512_mul_ps(t1, w1));
+
+                StoreFloat4x16(x, y, z, w, masks, &pOut[i].X);
+            }
+        }
+
+        PHX_TARGET_AVX512 inline void MultiplyMatrix(const Matrix4x4 & lhs, __m512 m0, __m512 m1, __m512 m2, __m512 m3, Matrix4x4 & out)
+        {
+            // The whole of lhs is one register.
+            _mm512_storeu_ps(&out.M11, TransformRows(_mm512_loadu_ps(&lhs.M11), m0, m1, m2, m3));
+        }
+
+        PHX_TARGET_AVX512 void MultiplyMatrix4x4(const Matrix4x4 * pLhs, const Matrix4x4 * pRhs, Matrix4x4 * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Matrix4x4 & rhs = pRhs[i];
+                const __m512 m0 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_loadu_ps(&rhs.M11));
+                const __m512 m1 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_loadu_ps(&rhs.M21));
+                const __m512 m2 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_loadu_ps(&rhs.M31));
+                const __m512 m3 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_loadu_ps(&rhs.M41));
+
+                MultiplyMatrix(pLhs[i], m0, m1, m2, m3, pOut[i]);
+            }
+        }
+
+        PHX_TARGET_AVX512 void MultiplyMatrix4x4ByMatrix(const Matrix4x4 * pLhs, const Matrix4x4 & rhs, Matrix4x4 * pOut, unsigned int count)
+        {
+            const __m512 m0 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_loadu_ps(&rhs.M11));
+            const __m512 m1 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_loadu_ps(&rhs.M21));
+            const __m512 m2 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_loadu_ps(&rhs.M31));
+            const __m512 m3 = _mm512_maskz_broadcast_f32x4(AllLanes, _mm_loadu_ps(&rhs.M41));
+
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                MultiplyMatrix(pLhs[i], m0, m1, m2, m3, pOut[i]);
+            }
+        }
+
+        // Swaps the 128 bit blocks of 4 registers the same way _MM_TRANSPOSE4_PS swaps floats.
+        PHX_TARGET_AVX512 inline void TransposeBlocks(__m512 & a, __m512 & b, __m512 & c, __m512 & d)
+        {
+            const __m512 t0 = _mm512_maskz_shuffle_f32x4(AllLanes, a, b, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m512 t1 = _mm512_maskz_shuffle_f32x4(AllLanes, a, b, _MM_SHUFFLE(3, 2, 3, 2));
+            const __m512 t2 = _mm512_maskz_shuffle_f32x4(AllLanes, c, d, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m512 t3 = _mm512_maskz_shuffle_f32x4(AllLanes, c, d, _MM_SHUFFLE(3, 2, 3, 2));
+
+            a = _mm512_maskz_shuffle_f32x4(AllLanes, t0, t2, _MM_SHUFFLE(2, 0, 2, 0));
+            b = _mm512_maskz_shuffle_f32x4(AllLanes, t0, t2, _MM_SHUFFLE(3, 1, 3, 1));
+            c = _mm512_maskz_shuffle_f32x4(AllLanes, t1, t3, _MM_SHUFFLE(2, 0, 2, 0));
+            d = _mm512_maskz_shuffle_f32x4(AllLanes, t1, t3, _MM_SHUFFLE(3, 1, 3, 1));
+        }
+
+        // (a.yzx * b - a * b.yzx).yzx in each block, the w lanes are 0.
+        PHX_TARGET_AVX512 inline __m512 Cross(__m512 a, __m512 b)
+        {
+            const __m512 aYZX = _mm512_maskz_permute_ps(AllLanes, a, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m512 bYZX = _mm512_maskz_permute_ps(AllLanes, b, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m512 c = _mm512_fmsub_ps(aYZX, b, _mm512_mul_ps(a, bYZX));
+            return _mm512_maskz_permute_ps(AllLanes, c, _MM_SHUFFLE(3, 0, 2, 1));
+        }
+
+        PHX_TARGET_AVX512 void NormalMatrix4x4(const Matrix4x4 * pIn, Matrix3x3 * pOut, unsigned int count)
+        {
+            const __m512 zero = _mm512_setzero_ps();
+            const __m512 one = _mm512_set1_ps(1.0f);
+
+            // Four matrices at a time, one per 128 bit block. Missing matrices in the
+            // last iteration are zero, which the singular case turns into zero again.
+            for (unsigned int i = 0; i < count; i += 4)
+            {
+                const unsigned int n = (count - i >= 4) ? 4 : (count - i);
+
+                __m512 r0 = _mm512_loadu_ps(&pIn[i].M11);
+                __m512 r1 = (n > 1) ? _mm512_loadu_ps(&pIn[i + 1].M11) : zero;
+                __m512 r2 = (n > 2) ? _mm512_loadu_ps(&pIn[i + 2].M11) : zero;
+                __m512 r3 = (n > 3) ? _mm512_loadu_ps(&pIn[i + 3].M11) : zero;
+
+                // Block j of rk is now row k of matrix j.
+                TransposeBlocks(r0, r1, r2, r3);
+
+                __m512 c0 = Cross(r1, r2);
+                __m512 c1 = Cross(r2, r0);
+                __m512 c2 = Cross(r0, r1);
+
+                const __m512 p = _mm512_mul_ps(r0, c0);
+                const __m512 det = _mm512_add_ps(_mm512_add_ps(_mm512_maskz_permute_ps(AllLanes, p, 0x00), _mm512_maskz_permute_ps(AllLanes, p, 0x55)), _mm512_maskz_permute_ps(AllLanes, p, 0xAA));
+                const __m512 invDet = _mm512_maskz_div_ps(_mm512_cmp_ps_mask(det, zero, _CMP_NEQ_UQ), one, det);
+
+                c0 = _mm512_mul_ps(c0, invDet);
+                c1 = _mm512_mul_ps(c1, invDet);
+                c2 = _mm512_mul_ps(c2, invDet);
+                __m512 c3 = zero;
+
+                // Back to one matrix per register, then squeeze out the w lanes.
+                TransposeBlocks(c0, c1, c2, c3);
+
+                const __m512 out[4] = { c0, c1, c2, c3 };
+                for (unsigned int j = 0; j < n; ++j)
+                {
+                    _mm512_mask_storeu_ps(&pOut[i + j].M11, 0x01FF, _mm512_maskz_compress_ps(0x0777, out[j]));
+                }
+            }
+        }
+
+        unsigned int CullSpheresByPlanes(const Vector4 * pSpheres, const Vector4 * pPlanes, unsigned int planeCount, unsigned int * pOutIndices, unsigned int count)
+        {
+            // No 16 wide version yet, the compaction of the visible indices would need compress stores.
+            return BatchKernelsAVX2.CullSpheres(pSpheres, pPlanes, planeCount, pOutIndices, count);
+        }
+
+        PHX_TARGET_AVX512 void ExtremePointsVector3(const Vector3 * pIn, unsigned int count, unsigned int * pOutIndices)
+        {
+            ExtremePoints::State state;
+            ExtremePoints::Begin(pIn[0], state);
+
+            __m512 extremes[ExtremePoints::Slots];
+            __m512i indices[ExtremePoints::Slots];
+            for (unsigned int slot = 0; slot < ExtremePoints::Slots; ++slot)
+            {
+                extremes[slot] = _mm512_set1_ps(state.Value[slot]);
+                indices[slot] = _mm512_setzero_si512();
+            }
+
+            __m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            const __m512i step = _mm512_set1_epi32(16);
+
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                __mmask16 masks[3];
+                Vector3x16Masks(count - i, masks);
+
+                // The compares are limited to the lanes holding points, so the tail needs no special case.
+                const __mmask16 lanes = TailMask(count - i);
+
+                __m512 components[3];
+                LoadVector3x16(pIn + i, masks, components[0], components[1], components[2]);
+
+                for (unsigned int axis = 0; axis < 3; ++axis)
+                {
+                    __m512 & min = extremes[axis * 2];
+                    __m512 & max = extremes[axis * 2 + 1];
+
+                    const __mmask16 less = _mm512_mask_cmp_ps_mask(lanes, components[axis], min, _CMP_LT_OQ);
+                    const __mmask16 greater = _mm512_mask_cmp_ps_mask(lanes, components[axis], max, _CMP_GT_OQ);
+
+                    min = _mm512_mask_mov_ps(min, less, components[axis]);
+                    max = _mm512_mask_mov_ps(max, greater, components[axis]);
+                    indices[axis * 2] = _mm512_mask_mov_epi32(indices[axis * 2], less, index);
+                    indices[axis * 2 + 1] = _mm512_mask_mov_epi32(indices[axis * 2 + 1], greater, index);
+                }
+
+                index = _mm512_add_epi32(index, step);
+            }
+
+            for (unsigned int slot = 0; slot < ExtremePoints::Slots; ++slot)
+            {
+                float laneValues[16];
+                unsigned int laneIndices[16];
+                _mm512_storeu_ps(laneValues, extremes[slot]);
+                _mm512_storeu_si512(laneIndices, indices[slot]);
+                ExtremePoints::MergeLanes(slot, laneValues, laneIndices, 16, state);
+            }
+
+            ExtremePoints::End(state, pOutIndices);
+        }
+
+        PHX_TARGET_AVX512 unsigned int IntersectOBBs(const OBB & box, const OBB * pBoxes, unsigned int * pOutIndices, unsigned int count)
+        {
+            // Same tests as Intersects(OBB, OBB) with box as box1, for 16 boxes at a time.
+
+            const __m512 epsilon = _mm512_set1_ps(OBBSeparatingAxes::Epsilon);
+
+            const __m512 center[3] = { _mm512_set1_ps(box.Center.X), _mm512_set1_ps(box.Center.Y), _mm512_set1_ps(box.Center.Z) };
+            const __m512 e1[3] = { _mm512_set1_ps(box.Extents.X), _mm512_set1_ps(box.Extents.Y), _mm512_set1_ps(box.Extents.Z) };
+
+            __m512 axes[3][3];
+            for (unsigned int r = 0; r < 3; ++r)
+            {
+                const Vector3 & axis = box.Axes.Row(r);
+                axes[r][0] = _mm512_set1_ps(axis.X);
+                axes[r][1] = _mm512_set1_ps(axis.Y);
+                axes[r][2] = _mm512_set1_ps(axis.Z);
+            }
+
+            // The fields of the 16 boxes are gathered, one register per float of the box.
+            const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            const __m512i offsets = _mm512_mullo_epi32(lanes, _mm512_set1_epi32(OBBSeparatingAxes::Floats));
+
+            unsigned int hitCount = 0;
+
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+                const float * p = &pBoxes[i].Center.X;
+
+                __m512 fields[OBBSeparatingAxes::Floats];
+                for (unsigned int f = 0; f < OBBSeparatingAxes::Floats; ++f)
+                {
+                    fields[f] = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, offsets, p + f, 4);
+                }
+
+                const __m512 * e2 = fields + 3;
+                const __m512 d[3] = { _mm512_sub_ps(fields[0], center[0]), _mm512_sub_ps(fields[1], center[1]), _mm512_sub_ps(fields[2], center[2]) };
+
+                __m512 t[3];
+                __m512 R[3][3];
+                __m512 absR[3][3];
+                for (unsigned int r = 0; r < 3; ++r)
+                {
+                    t[r] = _mm512_fmadd_ps(d[2], axes[r][2], _mm512_fmadd_ps(d[1], axes[r][1], _mm512_mul_ps(d[0], axes[r][0])));
+
+                    for (unsigned int c = 0; c < 3; ++c)
+                    {
+                        const __m512 * axis = fields + 6 + c * 3;
+                        R[r][c] = _mm512_fmadd_ps(axis[2], axes[r][2], _mm512_fmadd_ps(axis[1], axes[r][1], _mm512_mul_ps(axis[0], axes[r][0])));
+                        absR[r][c] = _mm512_add_ps(_mm512_abs_ps(R[r][c]), epsilon);
+                    }
+                }
+
+                // Face axes, most of the separated pairs are found here.
+                // The lanes past the end of the array start out separated.
+                __mmask16 separated = static_cast<__mmask16>(~mask);
+                for (unsigned int k = 0; k < 3; ++k)
+                {
+                    const __m512 r2 = _mm512_fmadd_ps(e2[2], absR[k][2], _mm512_fmadd_ps(e2[1], absR[k][1], _mm512_mul_ps(e2[0], absR[k][0])));
+                    separated |= _mm512_cmp_ps_mask(_mm512_abs_ps(t[k]), _mm512_add_ps(e1[k], r2), _CMP_GT_OQ);
+
+                    const __m512 r1 = _mm512_fmadd_ps(e1[2], absR[2][k], _mm512_fmadd_ps(e1[1], absR[1][k], _mm512_mul_ps(e1[0], absR[0][k])));
+                    const __m512 distance = _mm512_fmadd_ps(t[2], R[2][k], _mm512_fmadd_ps(t[1], R[1][k], _mm512_mul_ps(t[0], R[0][k])));
+                    separated |= _mm512_cmp_ps_mask(_mm512_abs_ps(distance), _mm512_add_ps(r1, e2[k]), _CMP_GT_OQ);
+                }
+
+                if (separated == 0xFFFF)
+                {
+                    continue;
+                }
+
+                // Edge cross products.
+                for (unsigned int a = 0; a < 3; ++a)
+                {
+                    const unsigned int a1 = (a + 1) % 3;
+                    const unsigned int a2 = (a + 2) % 3;
+
+                    for (unsigned int b = 0; b < 3; ++b)
+                    {
+                        const unsigned int b1 = (b + 1) % 3;
+                        const unsigned int b2 = (b + 2) % 3;
+
+                        const __m512 r1 = _mm512_fmadd_ps(e1[a2], absR[a1][b], _mm512_mul_ps(e1[a1], absR[a2][b]));
+                        const __m512 r2 = _mm512_fmadd_ps(e2[b2], absR[a][b1], _mm512_mul_ps(e2[b1], absR[a][b2]));
+                        const __m512 distance = _mm512_fmsub_ps(t[a2], R[a1][b], _mm512_mul_ps(t[a1], R[a2][b]));
+                        separated |= _mm512_cmp_ps_mask(_mm512_abs_ps(distance), _mm512_add_ps(r1, r2), _CMP_GT_OQ);
+                    }
+                }
+
+                const __mmask16 hits = static_cast<__mmask16>(~separated);
+                _mm512_mask_compressstoreu_epi32(pOutIndices + hitCount, hits, _mm512_add_epi32(lanes, _mm512_set1_epi32(static_cast<int>(i))));
+                hitCount += static_cast<unsigned int>(_mm_popcnt_u32(hits));
+            }
+
+            return hitCount;
+        }
+
+        PHX_TARGET_AVX512 void AddVector3SoA(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+
+                _mm512_mask_storeu_ps(out.X + i, mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, lhs.X + i), _mm512_maskz_loadu_ps(mask, rhs.X + i)));
+                _mm512_mask_storeu_ps(out.Y + i, mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, lhs.Y + i), _mm512_maskz_loadu_ps(mask, rhs.Y + i)));
+                _mm512_mask_storeu_ps(out.Z + i, mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, lhs.Z + i), _mm512_maskz_loadu_ps(mask, rhs.Z + i)));
+            }
+        }
+
+        PHX_TARGET_AVX512 void SubtractVector3SoA(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+
+                _mm512_mask_storeu_ps(out.X + i, mask, _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, lhs.X + i), _mm512_maskz_loadu_ps(mask, rhs.X + i)));
+                _mm512_mask_storeu_ps(out.Y + i, mask, _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, lhs.Y + i), _mm512_maskz_loadu_ps(mask, rhs.Y + i)));
+                _mm512_mask_storeu_ps(out.Z + i, mask, _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, lhs.Z + i), _mm512_maskz_loadu_ps(mask, rhs.Z + i)));
+            }
+        }
+
+        PHX_TARGET_AVX512 void MultiplyVector3SoA(const Vector3SoA & lhs, float rhs, const Vector3SoA & out, unsigned int count)
+        {
+            const __m512 s = _mm512_set1_ps(rhs);
+
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+
+                _mm512_mask_storeu_ps(out.X + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, lhs.X + i), s));
+                _mm512_mask_storeu_ps(out.Y + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, lhs.Y + i), s));
+                _mm512_mask_storeu_ps(out.Z + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, lhs.Z + i), s));
+            }
+        }
+
+        PHX_TARGET_AVX512 void DotVector3SoA(const Vector3SoA & lhs, const Vector3SoA & rhs, float * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+
+                __m512 dot = _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, lhs.X + i), _mm512_maskz_loadu_ps(mask, rhs.X + i));
+                dot = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, lhs.Y + i), _mm512_maskz_loadu_ps(mask, rhs.Y + i), dot);
+                dot = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, lhs.Z + i), _mm512_maskz_loadu_ps(mask, rhs.Z + i), dot);
+                _mm512_mask_storeu_ps(pOut + i, mask, dot);
+            }
+        }
+
+        PHX_TARGET_AVX512 void TransformVector3SoA(const Vector3SoA & in, const Matrix4x4 & m, const Vector3SoA & out, unsigned int count)
+        {
+            const __m512 m11 = _mm512_set1_ps(m.M11), m12 = _mm512_set1_ps(m.M12), m13 = _mm512_set1_ps(m.M13);
+            const __m512 m21 = _mm512_set1_ps(m.M21), m22 = _mm512_set1_ps(m.M22), m23 = _mm512_set1_ps(m.M23);
+            const __m512 m31 = _mm512_set1_ps(m.M31), m32 = _mm512_set1_ps(m.M32), m33 = _mm512_set1_ps(m.M33);
+            const __m512 m41 = _mm512_set1_ps(m.M41), m42 = _mm512_set1_ps(m.M42), m43 = _mm512_set1_ps(m.M43);
+
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+
+                const __m512 x = _mm512_maskz_loadu_ps(mask, in.X + i);
+                const __m512 y = _mm512_maskz_loadu_ps(mask, in.Y + i);
+                const __m512 z = _mm512_maskz_loadu_ps(mask, in.Z + i);
+
+                _mm512_mask_storeu_ps(out.X + i, mask, _mm512_fmadd_ps(z, m31, _mm512_fmadd_ps(y, m21, _mm512_fmadd_ps(x, m11, m41))));
+                _mm512_mask_storeu_ps(out.Y + i, mask, _mm512_fmadd_ps(z, m32, _mm512_fmadd_ps(y, m22, _mm512_fmadd_ps(x, m12, m42))));
+                _mm512_mask_storeu_ps(out.Z + i, mask, _mm512_fmadd_ps(z, m33, _mm512_fmadd_ps(y, m23, _mm512_fmadd_ps(x, m13, m43))));
+            }
+        }
+
+        PHX_TARGET_AVX512 void NormalizeVector3SoA(const Vector3SoA & in, const Vector3SoA & out, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+
+                const __m512 x = _mm512_maskz_loadu_ps(mask, in.X + i);
+                const __m512 y = _mm512_maskz_loadu_ps(mask, in.Y + i);
+                const __m512 z = _mm512_maskz_loadu_ps(mask, in.Z + i);
+
+                const __m512 invLength = InvLengthOrZero(_mm512_fmadd_ps(z, z, _mm512_fmadd_ps(y, y, _mm512_mul_ps(x, x))));
+
+                _mm512_mask_storeu_ps(out.X + i, mask, _mm512_mul_ps(x, invLength));
+                _mm512_mask_storeu_ps(out.Y + i, mask, _mm512_mul_ps(y, invLength));
+                _mm512_mask_storeu_ps(out.Z + i, mask, _mm512_mul_ps(z, invLength));
+            }
+        }
+
+        PHX_TARGET_AVX512 void MultiplyQuaternionSoA(const QuaternionSoA & lhs, const QuaternionSoA & rhs, const QuaternionSoA & out, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+
+                const __m512 lx = _mm512_maskz_loadu_ps(mask, lhs.X + i), ly = _mm512_maskz_loadu_ps(mask, lhs.Y + i);
+                const __m512 lz = _mm512_maskz_loadu_ps(mask, lhs.Z + i), lw = _mm512_maskz_loadu_ps(mask, lhs.W + i);
+                const __m512 rx = _mm512_maskz_loadu_ps(mask, rhs.X + i), ry = _mm512_maskz_loadu_ps(mask, rhs.Y + i);
+                const __m512 rz = _mm512_maskz_loadu_ps(mask, rhs.Z + i), rw = _mm512_maskz_loadu_ps(mask, rhs.W + i);
+
+                const __m512 x = _mm512_fnmadd_ps(lz, ry, _mm512_fmadd_ps(ly, rz, _mm512_fmadd_ps(lw, rx, _mm512_mul_ps(rw, lx))));
+                const __m512 y = _mm512_fnmadd_ps(lx, rz, _mm512_fmadd_ps(lz, rx, _mm512_fmadd_ps(lw, ry, _mm512_mul_ps(rw, ly))));
+                const __m512 z = _mm512_fnmadd_ps(ly, rx, _mm512_fmadd_ps(lx, ry, _mm512_fmadd_ps(lw, rz, _mm512_mul_ps(rw, lz))));
+                const __m512 w = _mm512_fnmadd_ps(lz, rz, _mm512_fnmadd_ps(ly, ry, _mm512_fnmadd_ps(lx, rx, _mm512_mul_ps(rw, lw))));
+
+                _mm512_mask_storeu_ps(out.X + i, mask, x);
+                _mm512_mask_storeu_ps(out.Y + i, mask, y);
+                _mm512_mask_storeu_ps(out.Z + i, mask, z);
+                _mm512_mask_storeu_ps(out.W + i, mask, w);
+            }
+        }
+
+        PHX_TARGET_AVX512 void NormalizeQuaternionSoA(const QuaternionSoA & in, const QuaternionSoA & out, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+
+                const __m512 x = _mm512_maskz_loadu_ps(mask, in.X + i);
+                const __m512 y = _mm512_maskz_loadu_ps(mask, in.Y + i);
+                const __m512 z = _mm512_maskz_loadu_ps(mask, in.Z + i);
+                const __m512 w = _mm512_maskz_loadu_ps(mask, in.W + i);
+
+                const __m512 invLength = InvLengthOrZero(_mm512_fmadd_ps(w, w, _mm512_fmadd_ps(z, z, _mm512_fmadd_ps(y, y, _mm512_mul_ps(x, x)))));
+
+                _mm512_mask_storeu_ps(out.X + i, mask, _mm512_mul_ps(x, invLength));
+                _mm512_mask_storeu_ps(out.Y + i, mask, _mm512_mul_ps(y, invLength));
+                _mm512_mask_storeu_ps(out.Z + i, mask, _mm512_mul_ps(z, invLength));
+                _mm512_mask_storeu_ps(out.W + i, mask, _mm512_mul_ps(w, invLength));
+            }
+        }
+
+        PHX_TARGET_AVX512 void SlerpQuaternionSoA(const QuaternionSoA & q1, const QuaternionSoA & q2, float weight, const QuaternionSoA & out, unsigned int count)
+        {
+            SlerpWeights weights;
+            PrepareSlerp(weight, weights);
+
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+
+                const __m512 x1 = _mm512_maskz_loadu_ps(mask, q1.X + i), y1 = _mm512_maskz_loadu_ps(mask, q1.Y + i);
+                const __m512 z1 = _mm512_maskz_loadu_ps(mask, q1.Z + i), w1 = _mm512_maskz_loadu_ps(mask, q1.W + i);
+                const __m512 x2 = _mm512_maskz_loadu_ps(mask, q2.X + i), y2 = _mm512_maskz_loadu_ps(mask, q2.Y + i);
+                const __m512 z2 = _mm512_maskz_loadu_ps(mask, q2.Z + i), w2 = _mm512_maskz_loadu_ps(mask, q2.W + i);
+
+                const __m512 cosTheta = _mm512_fmadd_ps(w1, w2, _mm512_fmadd_ps(z1, z2, _mm512_fmadd_ps(y1, y2, _mm512_mul_ps(x1, x2))));
+
+                __m512 t1, t2;
+                GetSlerpWeights(weights, cosTheta, t1, t2);
+
+                _mm512_mask_storeu_ps(out.X + i, mask, _mm512_fmadd_ps(t2, x2, _mm512_mul_ps(t1, x1)));
+                _mm512_mask_storeu_ps(out.Y + i, mask, _mm512_fmadd_ps(t2, y2, _mm512_mul_ps(t1, y1)));
+                _mm512_mask_storeu_ps(out.Z + i, mask, _mm512_fmadd_ps(t2, z2, _mm512_mul_ps(t1, z1)));
+                _mm512_mask_storeu_ps(out.W + i, mask, _mm512_fmadd_ps(t2, w2, _mm512_mul_ps(t1, w1)));
+            }
+        }
+
+        PHX_TARGET_AVX512 void IntersectRaysAABB(const RaySoA & rays, const AABB & box, float * pOutT, unsigned int count)
+        {
+            const __m512 minX = _mm512_set1_ps(box.Min.X), minY = _mm512_set1_ps(box.Min.Y), minZ = _mm512_set1_ps(box.Min.Z);
+            const __m512 maxX = _mm512_set1_ps(box.Max.X), maxY = _mm512_set1_ps(box.Max.Y), maxZ = _mm512_set1_ps(box.Max.Z);
+            const __m512 zero = _mm512_setzero_ps();
+            const __m512 miss = _mm512_set1_ps(FLT_MAX);
+
+            // A packet of 16 rays, see the SSE4.2 version.
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+
+                const __m512 ox = _mm512_maskz_loadu_ps(mask, rays.Origin.X + i);
+                const __m512 oy = _mm512_maskz_loadu_ps(mask, rays.Origin.Y + i);
+                const __m512 oz = _mm512_maskz_loadu_ps(mask, rays.Origin.Z + i);
+                const __m512 ix = _mm512_maskz_loadu_ps(mask, rays.InvDirection.X + i);
+                const __m512 iy = _mm512_maskz_loadu_ps(mask, rays.InvDirection.Y + i);
+                const __m512 iz = _mm512_maskz_loadu_ps(mask, rays.InvDirection.Z + i);
+
+                const __m512 x1 = _mm512_mul_ps(_mm512_sub_ps(minX, ox), ix);
+                const __m512 x2 = _mm512_mul_ps(_mm512_sub_ps(maxX, ox), ix);
+                const __m512 y1 = _mm512_mul_ps(_mm512_sub_ps(minY, oy), iy);
+                const __m512 y2 = _mm512_mul_ps(_mm512_sub_ps(maxY, oy), iy);
+                const __m512 z1 = _mm512_mul_ps(_mm512_sub_ps(minZ, oz), iz);
+                const __m512 z2 = _mm512_mul_ps(_mm512_sub_ps(maxZ, oz), iz);
+
+                const __m512 tNear = _mm512_maskz_max_ps(AllLanes, _mm512_maskz_max_ps(AllLanes, _mm512_maskz_min_ps(AllLanes, x1, x2), _mm512_maskz_min_ps(AllLanes, y1, y2)), _mm512_maskz_max_ps(AllLanes, _mm512_maskz_min_ps(AllLanes, z1, z2), zero));
+                const __m512 tFar = _mm512_maskz_min_ps(AllLanes, _mm512_maskz_min_ps(AllLanes, _mm512_maskz_max_ps(AllLanes, x1, x2), _mm512_maskz_max_ps(AllLanes, y1, y2)), _mm512_maskz_max_ps(AllLanes, z1, z2));
+
+                const __mmask16 hit = _mm512_cmp_ps_mask(tNear, tFar, _CMP_LE_OQ);
+                _mm512_mask_storeu_ps(pOutT + i, mask, _mm512_mask_blend_ps(hit, miss, tNear));
+            }
+        }
+
+        PHX_TARGET_AVX512 void IntersectRaysTriangle(const RaySoA & rays, const Vector3 & v0, const Vector3 & v1, const Vector3 & v2, float * pOutT, unsigned int count)
+        {
+            const __m512 e1x = _mm512_set1_ps(v1.X - v0.X), e1y = _mm512_set1_ps(v1.Y - v0.Y), e1z = _mm512_set1_ps(v1.Z - v0.Z);
+            const __m512 e2x = _mm512_set1_ps(v2.X - v0.X), e2y = _mm512_set1_ps(v2.Y - v0.Y), e2z = _mm512_set1_ps(v2.Z - v0.Z);
+            const __m512 v0x = _mm512_set1_ps(v0.X), v0y = _mm512_set1_ps(v0.Y), v0z = _mm512_set1_ps(v0.Z);
+            const __m512 zero = _mm512_setzero_ps();
+            const __m512 one = _mm512_set1_ps(1.0f);
+            const __m512 miss = _mm512_set1_ps(FLT_MAX);
+
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+
+                const __m512 dx = _mm512_maskz_loadu_ps(mask, rays.Direction.X + i);
+                const __m512 dy = _mm512_maskz_loadu_ps(mask, rays.Direction.Y + i);
+                const __m512 dz = _mm512_maskz_loadu_ps(mask, rays.Direction.Z + i);
+                const __m512 sx = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, rays.Origin.X + i), v0x);
+                const __m512 sy = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, rays.Origin.Y + i), v0y);
+                const __m512 sz = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, rays.Origin.Z + i), v0z);
+
+                // p = direction x edge2, q = s x edge1
+                const __m512 px = _mm512_fmsub_ps(dy, e2z, _mm512_mul_ps(dz, e2y));
+                const __m512 py = _mm512_fmsub_ps(dz, e2x, _mm512_mul_ps(dx, e2z));
+                const __m512 pz = _mm512_fmsub_ps(dx, e2y, _mm512_mul_ps(dy, e2x));
+                const __m512 qx = _mm512_fmsub_ps(sy, e1z, _mm512_mul_ps(sz, e1y));
+                const __m512 qy = _mm512_fmsub_ps(sz, e1x, _mm512_mul_ps(sx, e1z));
+                const __m512 qz = _mm512_fmsub_ps(sx, e1y, _mm512_mul_ps(sy, e1x));
+
+                const __m512 det = _mm512_fmadd_ps(e1z, pz, _mm512_fmadd_ps(e1y, py, _mm512_mul_ps(e1x, px)));
+
+                // Zero determinants (and the lanes past the end) are left out of the divide.
+                const __mmask16 valid = _mm512_mask_cmp_ps_mask(mask, det, zero, _CMP_NEQ_OQ);
+                const __m512 invDet = _mm512_maskz_div_ps(valid, one, det);
+
+                const __m512 u = _mm512_mul_ps(_mm512_fmadd_ps(sz, pz, _mm512_fmadd_ps(sy, py, _mm512_mul_ps(sx, px))), invDet);
+                const __m512 v = _mm512_mul_ps(_mm512_fmadd_ps(dz, qz, _mm512_fmadd_ps(dy, qy, _mm512_mul_ps(dx, qx))), invDet);
+                const __m512 t = _mm512_mul_ps(_mm512_fmadd_ps(e2z, qz, _mm512_fmadd_ps(e2y, qy, _mm512_mul_ps(e2x, qx))), invDet);
+
+                __mmask16 hit = valid;
+                hit = _mm512_mask_cmp_ps_mask(hit, u, zero, _CMP_GE_OQ);
+                hit = _mm512_mask_cmp_ps_mask(hit, u, one, _CMP_LE_OQ);
+                hit = _mm512_mask_cmp_ps_mask(hit, v, zero, _CMP_GE_OQ);
+                hit = _mm512_mask_cmp_ps_mask(hit, _mm512_add_ps(u, v), one, _CMP_LE_OQ);
+                hit = _mm512_mask_cmp_ps_mask(hit, t, zero, _CMP_GE_OQ);
+
+                _mm512_mask_storeu_ps(pOutT + i, mask, _mm512_mask_blend_ps(hit, miss, t));
+            }
+        }
+
+        PHX_TARGET_AVX512 void SignedDistanceVector3SoA(const Plane & plane, const Vector3SoA & points, float * pOut, unsigned int count)
+        {
+            const __m512 nx = _mm512_set1_ps(plane.Normal.X);
+            const __m512 ny = _mm512_set1_ps(plane.Normal.Y);
+            const __m512 nz = _mm512_set1_ps(plane.Normal.Z);
+            const __m512 d = _mm512_set1_ps(plane.D);
+
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+
+                __m512 distance = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, points.X + i), nx, d);
+                distance = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, points.Y + i), ny, distance);
+                distance = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, points.Z + i), nz, distance);
+                _mm512_mask_storeu_ps(pOut + i, mask, distance);
+            }
+        }
+
+        PHX_TARGET_AVX512 unsigned int ClassifyVector3SoA(const Plane & plane, const Vector3SoA & points, float epsilon, uint32_t * pOutFront, uint32_t * pOutBack, unsigned int count)
+        {
+            const __m512 nx = _mm512_set1_ps(plane.Normal.X);
+            const __m512 ny = _mm512_set1_ps(plane.Normal.Y);
+            const __m512 nz = _mm512_set1_ps(plane.Normal.Z);
+            const __m512 d = _mm512_set1_ps(plane.D);
+            const __m512 frontLimit = _mm512_set1_ps(epsilon);
+            const __m512 backLimit = _mm512_set1_ps(-epsilon);
+
+            unsigned int sides = 0;
+
+            // Two masks make a word, the last word is stored half full when count ends in its first half.
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+
+                __m512 distance = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, points.X + i), nx, d);
+                distance = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, points.Y + i), ny, distance);
+                distance = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, points.Z + i), nz, distance);
+
+                const uint32_t frontBits = _mm512_mask_cmp_ps_mask(mask, distance, frontLimit, _CMP_GT_OQ);
+                const uint32_t backBits = _mm512_mask_cmp_ps_mask(mask, distance, backLimit, _CMP_LT_OQ);
+
+                if ((i & 31) == 0)
+                {
+                    pOutFront[i >> 5] = frontBits;
+                    pOutBack[i >> 5] = backBits;
+                }
+                else
+                {
+                    pOutFront[i >> 5] |= frontBits << 16;
+                    pOutBack[i >> 5] |= backBits << 16;
+                }
+
+                sides |= ((frontBits != 0) ? PlaneSide::Front : 0) | ((backBits != 0) ? PlaneSide::Back : 0);
+            }
+
+            return sides;
+        }
+
+        PHX_TARGET_AVX512 void PackHalf(const float * pIn, uint16_t * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+                const __m256i h = _mm512_maskz_cvtps_ph(AllLanes, _mm512_maskz_loadu_ps(mask, pIn + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm256_mask_storeu_epi16(pOut + i, mask, h);
+            }
+        }
+
+        PHX_TARGET_AVX512 void UnpackHalf(const uint16_t * pIn, float * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; i += 16)
+            {
+                const __mmask16 mask = TailMask(count - i);
+                const __m256i h = _mm256_maskz_loadu_epi16(mask, pIn + i);
+                _mm512_mask_storeu_ps(pOut + i, mask, _mm512_maskz_cvtph_ps(AllLanes, h));
+            }
+        }
+    }
+
+    const BatchKernels BatchKernelsAVX512 =
+    {
+        TransformVector3,
+        TransformVector4,
+        TransformVector2,
+        TransformRect,
+        NormalizeVector3,
+        SlerpQuaternion,
+        MultiplyMatrix4x4,
+        MultiplyMatrix4x4ByMatrix,
+        NormalMatrix4x4,
+        CullSpheresByPlanes,
+        ExtremePointsVector3,
+        IntersectOBBs,
+
+        AddVector3SoA,
+        SubtractVector3SoA,
+        MultiplyVector3SoA,
+        DotVector3SoA,
+        TransformVector3SoA,
+        NormalizeVector3SoA,
+        MultiplyQuaternionSoA,
+        NormalizeQuaternionSoA,
+        SlerpQuaternionSoA,
+        IntersectRaysAABB,
+        IntersectRaysTriangle,
+        SignedDistanceVector3SoA,
+        ClassifyVector3SoA,
+
+        PackHalf,
+        UnpackHalf,
+    };
+
+} //namespace Math
+} //namespace Phx
+
+#endif //PHX_MATH_X86
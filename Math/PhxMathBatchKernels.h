@@ -0,0 +1,219 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_BATCH_KERNELS_H_
+#define _PHX_MATH_BATCH_KERNELS_H_
+
+#include "PhxMathBatch.h"
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Internal to the batch kernel files, not part of the public interface.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    // Kernel tables, one per tier file.
+    // The SIMD tiers only exist on x86 and hand their leftover elements to the scalar kernels.
+    extern const BatchKernels BatchKernelsScalar;
+#if PHX_MATH_X86
+    extern const BatchKernels BatchKernelsSSE42;
+    extern const BatchKernels BatchKernelsAVX2;
+    extern const BatchKernels BatchKernelsAVX512;
+#endif
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Polynomial slerp, shared by every tier so they all give the same result.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // sin(t * theta) / sin(theta) is approximated by t * P(t^2, cos(theta) - 1)
+    // where P = 1 + b0 * (1 + b1 * (... (1 + b7))) and
+    //   b[i] = (U[i] * t^2 - V[i]) * (cos(theta) - 1)
+    // The last term is scaled by Mu to minimize the error, the maximum error is
+    // about 2e-5 for cos(theta) in [0, 1] (theta up to 90 degrees), which is why the
+    // shortest arc is always taken.
+    // No acos, sin or divides, and no special case when the quaternions are aligned.
+    //
+    // Ref: David Eberly, A Fast and Accurate Algorithm for Computing SLERP
+    //      http://www.geometrictools.com/Documentation/FastAndAccurateSlerp.pdf
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    namespace SlerpPolynomial
+    {
+        const unsigned int Terms = 8;
+        const float Mu = 1.85298109240830f;
+
+        // U[i] = 1 / ((i + 1) * (2i + 3)), V[i] = (i + 1) / (2i + 3)
+        const float U[Terms] =
+        {
+            1.0f / (1.0f * 3.0f), 1.0f / (2.0f * 5.0f), 1.0f / (3.0f * 7.0f), 1.0f / (4.0f * 9.0f),
+            1.0f / (5.0f * 11.0f), 1.0f / (6.0f * 13.0f), 1.0f / (7.0f * 15.0f), Mu / (8.0f * 17.0f),
+        };
+
+        const float V[Terms] =
+        {
+            1.0f / 3.0f, 2.0f / 5.0f, 3.0f / 7.0f, 4.0f / 9.0f,
+            5.0f / 11.0f, 6.0f / 13.0f, 7.0f / 15.0f, Mu * 8.0f / 17.0f,
+        };
+
+        // The weight is the same for the whole batch, so (U[i] * t^2 - V[i]) is only found once.
+        inline void Prepare(float t, float outCoefficients[Terms])
+        {
+            const float tt = t * t;
+            for (unsigned int i = 0; i < Terms; ++i)
+            {
+                outCoefficients[i] = U[i] * tt - V[i];
+            }
+        }
+    }
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Extreme points, shared by every tier so they all pick the same points.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Slots are min X, max X, min Y, max Y, min Z, max Z. Every lane of the
+    // SIMD tiers starts from the first point and only moves on a strictly
+    // better value, so on a tie the lanes are merged by the smaller index,
+    // which gives the same indices as the scalar loop.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    namespace ExtremePoints
+    {
+        const unsigned int Slots = 6;
+
+        struct State
+        {
+            float Value[Slots];
+            unsigned int Index[Slots];
+        };
+
+        inline void Begin(const Vector3 & p, State & out)
+        {
+            const float values[Slots] = { p.X, p.X, p.Y, p.Y, p.Z, p.Z };
+            for (unsigned int slot = 0; slot < Slots; ++slot)
+            {
+                out.Value[slot] = values[slot];
+                out.Index[slot] = 0;
+            }
+        }
+
+        // Even slots keep the smallest value, odd slots the largest.
+        inline void MergeLanes(unsigned int slot, const float * pValues, const unsigned int * pIndices, unsigned int lanes, State & state)
+        {
+            const bool isMax = ((slot & 1) != 0);
+
+            for (unsigned int i = 0; i < lanes; ++i)
+            {
+                const float value = pValues[i];
+                const float current = state.Value[slot];
+                const bool better = isMax ? (value > current) : (value < current);
+
+                if (better || ((value == current) && (pIndices[i] < state.Index[slot])))
+                {
+                    state.Value[slot] = value;
+                    state.Index[slot] = pIndices[i];
+                }
+            }
+        }
+
+        // Points [first, count), after any lanes have been merged.
+        inline void Update(const Vector3 * pIn, unsigned int first, unsigned int count, State & state)
+        {
+            for (unsigned int i = first; i < count; ++i)
+            {
+                const float values[Slots] = { pIn[i].X, pIn[i].X, pIn[i].Y, pIn[i].Y, pIn[i].Z, pIn[i].Z };
+                for (unsigned int slot = 0; slot < Slots; ++slot)
+                {
+                    const bool isMax = ((slot & 1) != 0);
+                    if (isMax ? (values[slot] > state.Value[slot]) : (values[slot] < state.Value[slot]))
+                    {
+                        state.Value[slot] = values[slot];
+                        state.Index[slot] = i;
+                    }
+                }
+            }
+        }
+
+        inline void End(const State & state, unsigned int * pOutIndices)
+        {
+            for (unsigned int slot = 0; slot < Slots; ++slot)
+            {
+                pOutIndices[slot] = state.Index[slot];
+            }
+        }
+    }
+
+    // Plane classification masks, see Classify in PhxMathBatch.h.
+    namespace PlaneMasks
+    {
+        // Stores one word of each mask, returns the sides found in it.
+        inline unsigned int StoreWord(uint32_t frontBits, uint32_t backBits, uint32_t * pOutFront, uint32_t * pOutBack)
+        {
+            *pOutFront = frontBits;
+            *pOutBack = backBits;
+            return ((frontBits != 0) ? PlaneSide::Front : 0) | ((backBits != 0) ? PlaneSide::Back : 0);
+        }
+
+        // Points [first, count), used by the scalar kernel and for the leftover points of the SIMD tiers.
+        // When first is in the middle of a word, the word already holds the bits of the points before it.
+        inline unsigned int Classify(const Plane & plane, const Vector3SoA & points, float epsilon, uint32_t * pOutFront, uint32_t * pOutBack, unsigned int first, unsigned int count)
+        {
+            unsigned int sides = 0;
+
+            unsigned int i = first;
+            while (i < count)
+            {
+                const unsigned int word = i >> 5;
+                const unsigned int end = (count - (i & ~31u) > 32) ? (i & ~31u) + 32 : count;
+
+                uint32_t frontBits = ((i & 31) == 0) ? 0 : pOutFront[word];
+                uint32_t backBits = ((i & 31) == 0) ? 0 : pOutBack[word];
+
+                for (; i < end; ++i)
+                {
+                    const float distance = points.X[i] * plane.Normal.X + points.Y[i] * plane.Normal.Y + points.Z[i] * plane.Normal.Z + plane.D;
+                    frontBits |= static_cast<uint32_t>(distance > epsilon) << (i & 31);
+                    backBits |= static_cast<uint32_t>(distance < -epsilon) << (i & 31);
+                }
+
+                sides |= StoreWord(frontBits, backBits, pOutFront + word, pOutBack + word);
+            }
+
+            return sides;
+        }
+    }
+
+    // Oriented boxes are read by the kernels as arrays of floats:
+    // center (0-2), extents (3-5) and the rows of the axes (6-14).
+    // The epsilon is the one Intersects(OBB, OBB) adds to the projected axes.
+    namespace OBBSeparatingAxes
+    {
+        const unsigned int Floats = 15;
+        const float Epsilon = 1e-6f;
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_BATCH_KERNELS_H_
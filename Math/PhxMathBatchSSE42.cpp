@@ -0,0 +1,927 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathBatchKernels.h"
+
+#if PHX_MATH_X86
+
+#include <nmmintrin.h>
+
+#define PHX_TARGET_SSE42 PHX_TARGET("sse4.2")
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3  ->  x0 x1 x2 x3 | y0 y1 y2 y3 | z0 z1 z2 z3
+        PHX_TARGET_SSE42 inline void LoadVector3x4(const Vector3 * p, __m128 & outX, __m128 & outY, __m128 & outZ)
+        {
+            const float * pSrc = &p->X;
+            const __m128 a = _mm_loadu_ps(pSrc);
+            const __m128 b = _mm_loadu_ps(pSrc + 4);
+            const __m128 c = _mm_loadu_ps(pSrc + 8);
+
+            const __m128 xy = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+            const __m128 yz = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+
+            outX = _mm_shuffle_ps(a, xy, _MM_SHUFFLE(2, 0, 3, 0));
+            outY = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+            outZ = _mm_shuffle_ps(yz, c, _MM_SHUFFLE(3, 0, 3, 1));
+        }
+
+        PHX_TARGET_SSE42 inline void StoreVector3x4(__m128 x, __m128 y, __m128 z, Vector3 * p)
+        {
+            const __m128 xy = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 yz = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+            const __m128 zx = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+
+            float * pDst = &p->X;
+            _mm_storeu_ps(pDst, _mm_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(pDst + 4, _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0)));
+            _mm_storeu_ps(pDst + 8, _mm_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+
+        // Four consecutive Vector4/Quaternion/rows <-> one register per component.
+        PHX_TARGET_SSE42 inline void Transpose4x4(__m128 & r0, __m128 & r1, __m128 & r2, __m128 & r3)
+        {
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        }
+
+        PHX_TARGET_SSE42 inline __m128 Splat(__m128 v, int idx)
+        {
+            switch (idx)
+            {
+            case 0: return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+            case 1: return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+            case 2: return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+            default: return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+        }
+
+        // row * m, where m is held as its 4 rows.
+        PHX_TARGET_SSE42 inline __m128 TransformRow(__m128 row, __m128 m0, __m128 m1, __m128 m2, __m128 m3)
+        {
+            __m128 r = _mm_mul_ps(Splat(row, 0), m0);
+            r = _mm_add_ps(r, _mm_mul_ps(Splat(row, 1), m1));
+            r = _mm_add_ps(r, _mm_mul_ps(Splat(row, 2), m2));
+            r = _mm_add_ps(r, _mm_mul_ps(Splat(row, 3), m3));
+            return r;
+        }
+
+        PHX_TARGET_SSE42 void TransformVector3(const Vector3 * pIn, const Matrix4x4 & m, Vector3 * pOut, unsigned int count)
+        {
+            const __m128 m11 = _mm_set1_ps(m.M11), m12 = _mm_set1_ps(m.M12), m13 = _mm_set1_ps(m.M13);
+            const __m128 m21 = _mm_set1_ps(m.M21), m22 = _mm_set1_ps(m.M22), m23 = _mm_set1_ps(m.M23);
+            const __m128 m31 = _mm_set1_ps(m.M31), m32 = _mm_set1_ps(m.M32), m33 = _mm_set1_ps(m.M33);
+            const __m128 m41 = _mm_set1_ps(m.M41), m42 = _mm_set1_ps(m.M42), m43 = _mm_set1_ps(m.M43);
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 x, y, z;
+                LoadVector3x4(pIn + i, x, y, z);
+
+                const __m128 outX = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m11), _mm_mul_ps(y, m21)), _mm_mul_ps(z, m31)), m41);
+                const __m128 outY = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m12), _mm_mul_ps(y, m22)), _mm_mul_ps(z, m32)), m42);
+                const __m128 outZ = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m13), _mm_mul_ps(y, m23)), _mm_mul_ps(z, m33)), m43);
+
+                StoreVector3x4(outX, outY, outZ, pOut + i);
+            }
+
+            BatchKernelsScalar.TransformVector3(pIn + i, m, pOut + i, count - i);
+        }
+
+        PHX_TARGET_SSE42 void TransformVector4(const Vector4 * pIn, const Matrix4x4 & m, Vector4 * pOut, unsigned int count)
+        {
+            const __m128 m0 = _mm_loadu_ps(&m.M11);
+            const __m128 m1 = _mm_loadu_ps(&m.M21);
+            const __m128 m2 = _mm_loadu_ps(&m.M31);
+            const __m128 m3 = _mm_loadu_ps(&m.M41);
+
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const __m128 v = _mm_loadu_ps(&pIn[i].X);
+                _mm_storeu_ps(&pOut[i].X, TransformRow(v, m0, m1, m2, m3));
+            }
+        }
+
+        PHX_TARGET_SSE42 void TransformVector2(const Vector2 * pIn, const Matrix3x2 & m, Vector2 * pOut, unsigned int count)
+        {
+            // Two vectors per register, each row of m twice.
+            const __m128 m1 = _mm_setr_ps(m.M11, m.M12, m.M11, m.M12);
+            const __m128 m2 = _mm_setr_ps(m.M21, m.M22, m.M21, m.M22);
+            const __m128 m3 = _mm_setr_ps(m.M31, m.M32, m.M31, m.M32);
+
+            unsigned int i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                const __m128 v = _mm_loadu_ps(&pIn[i].X);
+                const __m128 x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+                const __m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+
+                _mm_storeu_ps(&pOut[i].X, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m1), _mm_mul_ps(y, m2)), m3));
+            }
+
+            BatchKernelsScalar.TransformVector2(pIn + i, m, pOut + i, count - i);
+        }
+
+        PHX_TARGET_SSE42 void TransformRect(const Rect * pIn, const Matrix3x2 & m, Rect * pOut, unsigned int count)
+        {
+            // Same as the single Transform: with r = (x, y, width, height)
+            //   a = (x, x, width, width) * (row1, row1)
+            //   b = (y, y, height, height) * (row2, row2)
+            // the position is a.xy + b.xy + row3 + the negative parts of a.zw and b.zw,
+            // and the size is the absolute values of a.zw + b.zw.
+            const __m128 m1 = _mm_setr_ps(m.M11, m.M12, m.M11, m.M12);
+            const __m128 m2 = _mm_setr_ps(m.M21, m.M22, m.M21, m.M22);
+            const __m128 m3 = _mm_setr_ps(m.M31, m.M32, 0.0f, 0.0f);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 signBit = _mm_set1_ps(-0.0f);
+
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const __m128 r = _mm_loadu_ps(&pIn[i].X);
+                const __m128 a = _mm_mul_ps(_mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 2, 0, 0)), m1);
+                const __m128 b = _mm_mul_ps(_mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 1, 1)), m2);
+
+                const __m128 negative = _mm_add_ps(_mm_min_ps(a, zero), _mm_min_ps(b, zero));
+                const __m128 position = _mm_add_ps(_mm_add_ps(_mm_add_ps(a, b), m3), _mm_movehl_ps(negative, negative));
+                const __m128 size = _mm_add_ps(_mm_andnot_ps(signBit, a), _mm_andnot_ps(signBit, b));
+
+                _mm_storeu_ps(&pOut[i].X, _mm_blend_ps(position, size, 0xC));
+            }
+        }
+
+        PHX_TARGET_SSE42 void NormalizeVector3(const Vector3 * pIn, Vector3 * pOut, unsigned int count)
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 zero = _mm_setzero_ps();
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 x, y, z;
+                LoadVector3x4(pIn + i, x, y, z);
+
+                const __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+
+                // 1 / sqrt is exact (unlike rsqrt) so the result matches the scalar kernel, zero length vectors get a scale of 0.
+                const __m128 invLength = _mm_and_ps(_mm_cmpgt_ps(lengthSquared, zero), _mm_div_ps(one, _mm_sqrt_ps(lengthSquared)));
+
+                StoreVector3x4(_mm_mul_ps(x, invLength), _mm_mul_ps(y, invLength), _mm_mul_ps(z, invLength), pOut + i);
+            }
+
+            BatchKernelsScalar.NormalizeVector3(pIn + i, pOut + i, count - i);
+        }
+
+        PHX_TARGET_SSE42 inline __m128 EvaluateSlerpPolynomial(const float coefficients[SlerpPolynomial::Terms], __m128 xm1)
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+
+            __m128 poly = one;
+            for (int j = SlerpPolynomial::Terms - 1; j >= 0; --j)
+            {
+                poly = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(coefficients[j]), xm1), poly));
+            }
+            return poly;
+        }
+
+        struct SlerpWeights
+        {
+            float T;
+            float D;
+            float CoefficientsT[SlerpPolynomial::Terms];
+            float CoefficientsD[SlerpPolynomial::Terms];
+        };
+
+        inline void PrepareSlerp(float weight, SlerpWeights & out)
+        {
+            out.T = weight;
+            out.D = 1.0f - weight;
+            SlerpPolynomial::Prepare(out.T, out.CoefficientsT);
+            SlerpPolynomial::Prepare(out.D, out.CoefficientsD);
+        }
+
+        // Weights of q1 (t1) and q2 (t2) for 4 quaternions at once.
+        PHX_TARGET_SSE42 inline void GetSlerpWeights(const SlerpWeights & weights, __m128 cosTheta, __m128 & t1, __m128 & t2)
+        {
+            // Shortest arc: use |cos(theta)| and flip the sign of the q2 weight.
+            const __m128 sign = _mm_and_ps(cosTheta, _mm_set1_ps(-0.0f));
+            const __m128 xm1 = _mm_sub_ps(_mm_xor_ps(cosTheta, sign), _mm_set1_ps(1.0f));
+
+            t1 = _mm_mul_ps(_mm_set1_ps(weights.D), EvaluateSlerpPolynomial(weights.CoefficientsD, xm1));
+            t2 = _mm_xor_ps(_mm_mul_ps(_mm_set1_ps(weights.T), EvaluateSlerpPolynomial(weights.CoefficientsT, xm1)), sign);
+        }
+
+        PHX_TARGET_SSE42 void SlerpQuaternion(const Quaternion * pQ1, const Quaternion * pQ2, float weight, Quaternion * pOut, unsigned int count)
+        {
+            SlerpWeights weights;
+            PrepareSlerp(weight, weights);
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 x1 = _mm_loadu_ps(&pQ1[i + 0].X);
+                __m128 y1 = _mm_loadu_ps(&pQ1[i + 1].X);
+                __m128 z1 = _mm_loadu_ps(&pQ1[i + 2].X);
+                __m128 w1 = _mm_loadu_ps(&pQ1[i + 3].X);
+                Transpose4x4(x1, y1, z1, w1);
+
+                __m128 x2 = _mm_loadu_ps(&pQ2[i + 0].X);
+                __m128 y2 = _mm_loadu_ps(&pQ2[i + 1].X);
+                __m128 z2 = _mm_loadu_ps(&pQ2[i + 2].X);
+                __m128 w2 = _mm_loadu_ps(&pQ2[i + 3].X);
+                Transpose4x4(x2, y2, z2, w2);
+
+                const __m128 cosTheta = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x1, x2), _mm_mul_ps(y1, y2)), _mm_mul_ps(z1, z2)), _mm_mul_ps(w1, w2));
+
+                __m128 t1, t2;
+                GetSlerpWeights(weights, cosTheta, t1, t2);
+
+                __m128 x = _mm_add_ps(_mm_mul_ps(t1, x1), _mm_mul_ps(t2, x2));
+                __m128 y = _mm_add_ps(_mm_mul_ps(t1, y1), _mm_mul_ps(t2, y2));
+                __m128 z = _mm_add_ps(_mm_mul_ps(t1, z1), _mm_mul_ps(t2, z2));
+                __m128 w = _mm_add_ps(_mm_mul_ps(t1, w1), _mm_mul_ps(t2, w2));
+                Transpose4x4(x, y, z, w);
+
+                _mm_storeu_ps(&pOut[i + 0].X, x);
+                _mm_storeu_ps(&pOut[i + 1].X, y);
+                _mm_storeu_ps(&pOut[i + 2].X, z);
+                _mm_storeu_ps(&pOut[i + 3].X, w);
+            }
+
+            BatchKernelsScalar.SlerpQuaternion(pQ1 + i, pQ2 + i, weight, pOut + i, count - i);
+        }
+
+        PHX_TARGET_SSE42 inline void MultiplyMatrix(const Matrix4x4 & lhs, __m128 m0, __m128 m1, __m128 m2, __m128 m3, Matrix4x4 & out)
+        {
+            // All of lhs is loaded before out is written, so lhs and out can be the same matrix.
+            const __m128 l0 = _mm_loadu_ps(&lhs.M11);
+            const __m128 l1 = _mm_loadu_ps(&lhs.M21);
+            const __m128 l2 = _mm_loadu_ps(&lhs.M31);
+            const __m128 l3 = _mm_loadu_ps(&lhs.M41);
+
+            _mm_storeu_ps(&out.M11, TransformRow(l0, m0, m1, m2, m3));
+            _mm_storeu_ps(&out.M21, TransformRow(l1, m0, m1, m2, m3));
+            _mm_storeu_ps(&out.M31, TransformRow(l2, m0, m1, m2, m3));
+            _mm_storeu_ps(&out.M41, TransformRow(l3, m0, m1, m2, m3));
+        }
+
+        PHX_TARGET_SSE42 void MultiplyMatrix4x4(const Matrix4x4 * pLhs, const Matrix4x4 * pRhs, Matrix4x4 * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Matrix4x4 & rhs = pRhs[i];
+                MultiplyMatrix(pLhs[i], _mm_loadu_ps(&rhs.M11), _mm_loadu_ps(&rhs.M21), _mm_loadu_ps(&rhs.M31), _mm_loadu_ps(&rhs.M41), pOut[i]);
+            }
+        }
+
+        PHX_TARGET_SSE42 void MultiplyMatrix4x4ByMatrix(const Matrix4x4 * pLhs, const Matrix4x4 & rhs, Matrix4x4 * pOut, unsigned int count)
+        {
+            const __m128 m0 = _mm_loadu_ps(&rhs.M11);
+            const __m128 m1 = _mm_loadu_ps(&rhs.M21);
+            const __m128 m2 = _mm_loadu_ps(&rhs.M31);
+            const __m128 m3 = _mm_loadu_ps(&rhs.M41);
+
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                MultiplyMatrix(pLhs[i], m0, m1, m2, m3, pOut[i]);
+            }
+        }
+
+        // (a.yzx * b - a * b.yzx).yzx, the w lane is 0.
+        PHX_TARGET_SSE42 inline __m128 Cross(__m128 a, __m128 b)
+        {
+            const __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 c = _mm_sub_ps(_mm_mul_ps(aYZX, b), _mm_mul_ps(a, bYZX));
+            return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+        }
+
+        // Writes the xyz of 3 rows to 9 consecutive floats.
+        PHX_TARGET_SSE42 inline void StoreRows3x3(__m128 r0, __m128 r1, __m128 r2, float * pDst)
+        {
+            // Each row write spills one float into the next row, which the next write replaces.
+            _mm_storeu_ps(pDst, r0);
+            _mm_storeu_ps(pDst + 3, r1);
+            _mm_storel_pi(reinterpret_cast<__m64 *>(pDst + 6), r2);
+            _mm_store_ss(pDst + 8, _mm_movehl_ps(r2, r2));
+        }
+
+        PHX_TARGET_SSE42 void NormalMatrix4x4(const Matrix4x4 * pIn, Matrix3x3 * pOut, unsigned int count)
+        {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const __m128 r0 = _mm_loadu_ps(&pIn[i].M11);
+                const __m128 r1 = _mm_loadu_ps(&pIn[i].M21);
+                const __m128 r2 = _mm_loadu_ps(&pIn[i].M31);
+
+                // The cofactors of each row are the cross product of the other two.
+                const __m128 c0 = Cross(r1, r2);
+                const __m128 c1 = Cross(r2, r0);
+                const __m128 c2 = Cross(r0, r1);
+
+                // 1 / det in every lane, or 0 when the determinant is 0.
+                const __m128 det = _mm_dp_ps(r0, c0, 0x7F);
+                const __m128 invDet = _mm_and_ps(_mm_div_ps(one, det), _mm_cmpneq_ps(det, zero));
+
+                StoreRows3x3(_mm_mul_ps(c0, invDet), _mm_mul_ps(c1, invDet), _mm_mul_ps(c2, invDet), &pOut[i].M11);
+            }
+        }
+
+        PHX_TARGET_SSE42 unsigned int CullSpheresByPlanes(const Vector4 * pSpheres, const Vector4 * pPlanes, unsigned int planeCount, unsigned int * pOutIndices, unsigned int count)
+        {
+            const __m128 signBit = _mm_set1_ps(-0.0f);
+
+            unsigned int visibleCount = 0;
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 x = _mm_loadu_ps(&pSpheres[i + 0].X);
+                __m128 y = _mm_loadu_ps(&pSpheres[i + 1].X);
+                __m128 z = _mm_loadu_ps(&pSpheres[i + 2].X);
+                __m128 r = _mm_loadu_ps(&pSpheres[i + 3].X);
+                Transpose4x4(x, y, z, r);
+
+                const __m128 negRadius = _mm_xor_ps(r, signBit);
+
+                __m128 culled = _mm_setzero_ps();
+                for (unsigned int j = 0; j < planeCount; ++j)
+                {
+                    const Vector4 & plane = pPlanes[j];
+                    const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                        _mm_mul_ps(x, _mm_set1_ps(plane.X)), _mm_mul_ps(y, _mm_set1_ps(plane.Y))), _mm_mul_ps(z, _mm_set1_ps(plane.Z))), _mm_set1_ps(plane.W));
+
+                    culled = _mm_or_ps(culled, _mm_cmplt_ps(distance, negRadius));
+                    if (_mm_movemask_ps(culled) == 0xF)
+                    {
+                        break;
+                    }
+                }
+
+                // Branchless compaction, an index is always written but only kept when the sphere is visible.
+                const unsigned int visibleMask = ~static_cast<unsigned int>(_mm_movemask_ps(culled));
+                for (unsigned int k = 0; k < 4; ++k)
+                {
+                    pOutIndices[visibleCount] = i + k;
+                    visibleCount += (visibleMask >> k) & 1;
+                }
+            }
+
+            const unsigned int tailCount = BatchKernelsScalar.CullSpheres(pSpheres + i, pPlanes, planeCount, pOutIndices + visibleCount, count - i);
+            for (unsigned int k = 0; k < tailCount; ++k)
+            {
+                pOutIndices[visibleCount + k] += i;
+            }
+
+            return visibleCount + tailCount;
+        }
+
+        // Keeps v and its index in the lanes where v is strictly smaller than min, or strictly larger than max.
+        PHX_TARGET_SSE42 inline void UpdateExtremes(__m128 v, __m128i index, __m128 & min, __m128i & minIndex, __m128 & max, __m128i & maxIndex)
+        {
+            const __m128 less = _mm_cmplt_ps(v, min);
+            const __m128 greater = _mm_cmpgt_ps(v, max);
+
+            min = _mm_blendv_ps(min, v, less);
+            max = _mm_blendv_ps(max, v, greater);
+            minIndex = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(minIndex), _mm_castsi128_ps(index), less));
+            maxIndex = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(maxIndex), _mm_castsi128_ps(index), greater));
+        }
+
+        PHX_TARGET_SSE42 void ExtremePointsVector3(const Vector3 * pIn, unsigned int count, unsigned int * pOutIndices)
+        {
+            ExtremePoints::State state;
+            ExtremePoints::Begin(pIn[0], state);
+
+            __m128 extremes[ExtremePoints::Slots];
+            __m128i indices[ExtremePoints::Slots];
+            for (unsigned int slot = 0; slot < ExtremePoints::Slots; ++slot)
+            {
+                extremes[slot] = _mm_set1_ps(state.Value[slot]);
+                indices[slot] = _mm_setzero_si128();
+            }
+
+            __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+            const __m128i step = _mm_set1_epi32(4);
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 components[3];
+                LoadVector3x4(pIn + i, components[0], components[1], components[2]);
+
+                for (unsigned int axis = 0; axis < 3; ++axis)
+                {
+                    UpdateExtremes(components[axis], index, extremes[axis * 2], indices[axis * 2], extremes[axis * 2 + 1], indices[axis * 2 + 1]);
+                }
+
+                index = _mm_add_epi32(index, step);
+            }
+
+            for (unsigned int slot = 0; slot < ExtremePoints::Slots; ++slot)
+            {
+                float laneValues[4];
+                unsigned int laneIndices[4];
+                _mm_storeu_ps(laneValues, extremes[slot]);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(laneIndices), indices[slot]);
+                ExtremePoints::MergeLanes(slot, laneValues, laneIndices, 4, state);
+            }
+
+            // The leftover points can't be handed to the scalar kernel since it would start over.
+            ExtremePoints::Update(pIn, i, count, state);
+            ExtremePoints::End(state, pOutIndices);
+        }
+
+        PHX_TARGET_SSE42 unsigned int IntersectOBBs(const OBB & box, const OBB * pBoxes, unsigned int * pOutIndices, unsigned int count)
+        {
+            // Same tests as Intersects(OBB, OBB) with box as box1, for 4 boxes at a time.
+
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            const __m128 epsilon = _mm_set1_ps(OBBSeparatingAxes::Epsilon);
+
+            const __m128 center[3] = { _mm_set1_ps(box.Center.X), _mm_set1_ps(box.Center.Y), _mm_set1_ps(box.Center.Z) };
+            const __m128 e1[3] = { _mm_set1_ps(box.Extents.X), _mm_set1_ps(box.Extents.Y), _mm_set1_ps(box.Extents.Z) };
+
+            __m128 axes[3][3];
+            for (unsigned int r = 0; r < 3; ++r)
+            {
+                const Vector3 & axis = box.Axes.Row(r);
+                axes[r][0] = _mm_set1_ps(axis.X);
+                axes[r][1] = _mm_set1_ps(axis.Y);
+                axes[r][2] = _mm_set1_ps(axis.Z);
+            }
+
+            unsigned int hitCount = 0;
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const float * p = &pBoxes[i].Center.X;
+
+                __m128 fields[OBBSeparatingAxes::Floats];
+                for (unsigned int f = 0; f < OBBSeparatingAxes::Floats; ++f)
+                {
+                    fields[f] = _mm_setr_ps(p[f], p[f + OBBSeparatingAxes::Floats], p[f + OBBSeparatingAxes::Floats * 2], p[f + OBBSeparatingAxes::Floats * 3]);
+                }
+
+                const __m128 * e2 = fields + 3;
+                const __m128 d[3] = { _mm_sub_ps(fields[0], center[0]), _mm_sub_ps(fields[1], center[1]), _mm_sub_ps(fields[2], center[2]) };
+
+                __m128 t[3];
+                __m128 R[3][3];
+                __m128 absR[3][3];
+                for (unsigned int r = 0; r < 3; ++r)
+                {
+                    t[r] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(d[0], axes[r][0]), _mm_mul_ps(d[1], axes[r][1])), _mm_mul_ps(d[2], axes[r][2]));
+
+                    for (unsigned int c = 0; c < 3; ++c)
+                    {
+                        const __m128 * axis = fields + 6 + c * 3;
+                        R[r][c] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(axis[0], axes[r][0]), _mm_mul_ps(axis[1], axes[r][1])), _mm_mul_ps(axis[2], axes[r][2]));
+                        absR[r][c] = _mm_add_ps(_mm_and_ps(R[r][c], absMask), epsilon);
+                    }
+                }
+
+                // Face axes, most of the separated pairs are found here.
+                __m128 separated = _mm_setzero_ps();
+                for (unsigned int k = 0; k < 3; ++k)
+                {
+                    const __m128 r2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2[0], absR[k][0]), _mm_mul_ps(e2[1], absR[k][1])), _mm_mul_ps(e2[2], absR[k][2]));
+                    separated = _mm_or_ps(separated, _mm_cmpgt_ps(_mm_and_ps(t[k], absMask), _mm_add_ps(e1[k], r2)));
+
+                    const __m128 r1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1[0], absR[0][k]), _mm_mul_ps(e1[1], absR[1][k])), _mm_mul_ps(e1[2], absR[2][k]));
+                    const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(t[0], R[0][k]), _mm_mul_ps(t[1], R[1][k])), _mm_mul_ps(t[2], R[2][k]));
+                    separated = _mm_or_ps(separated, _mm_cmpgt_ps(_mm_and_ps(distance, absMask), _mm_add_ps(r1, e2[k])));
+                }
+
+                if (_mm_movemask_ps(separated) == 0xF)
+                {
+                    continue;
+                }
+
+                // Edge cross products.
+                for (unsigned int a = 0; a < 3; ++a)
+                {
+                    const unsigned int a1 = (a + 1) % 3;
+                    const unsigned int a2 = (a + 2) % 3;
+
+                    for (unsigned int b = 0; b < 3; ++b)
+                    {
+                        const unsigned int b1 = (b + 1) % 3;
+                        const unsigned int b2 = (b + 2) % 3;
+
+                        const __m128 r1 = _mm_add_ps(_mm_mul_ps(e1[a1], absR[a2][b]), _mm_mul_ps(e1[a2], absR[a1][b]));
+                        const __m128 r2 = _mm_add_ps(_mm_mul_ps(e2[b1], absR[a][b2]), _mm_mul_ps(e2[b2], absR[a][b1]));
+                        const __m128 distance = _mm_sub_ps(_mm_mul_ps(t[a2], R[a1][b]), _mm_mul_ps(t[a1], R[a2][b]));
+                        separated = _mm_or_ps(separated, _mm_cmpgt_ps(_mm_and_ps(distance, absMask), _mm_add_ps(r1, r2)));
+                    }
+                }
+
+                // Branchless compaction, an index is always written but only kept when the boxes intersect.
+                const unsigned int hitMask = ~static_cast<unsigned int>(_mm_movemask_ps(separated));
+                for (unsigned int k = 0; k < 4; ++k)
+                {
+                    pOutIndices[hitCount] = i + k;
+                    hitCount += (hitMask >> k) & 1;
+                }
+            }
+
+            const unsigned int tailCount = BatchKernelsScalar.IntersectOBBs(box, pBoxes + i, pOutIndices + hitCount, count - i);
+            for (unsigned int k = 0; k < tailCount; ++k)
+            {
+                pOutIndices[hitCount + k] += i;
+            }
+
+            return hitCount + tailCount;
+        }
+
+        PHX_TARGET_SSE42 void AddVector3SoA(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count)
+        {
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                _mm_storeu_ps(out.X + i, _mm_add_ps(_mm_loadu_ps(lhs.X + i), _mm_loadu_ps(rhs.X + i)));
+                _mm_storeu_ps(out.Y + i, _mm_add_ps(_mm_loadu_ps(lhs.Y + i), _mm_loadu_ps(rhs.Y + i)));
+                _mm_storeu_ps(out.Z + i, _mm_add_ps(_mm_loadu_ps(lhs.Z + i), _mm_loadu_ps(rhs.Z + i)));
+            }
+
+            BatchKernelsScalar.AddVector3SoA(Offset(lhs, i), Offset(rhs, i), Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_SSE42 void SubtractVector3SoA(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count)
+        {
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                _mm_storeu_ps(out.X + i, _mm_sub_ps(_mm_loadu_ps(lhs.X + i), _mm_loadu_ps(rhs.X + i)));
+                _mm_storeu_ps(out.Y + i, _mm_sub_ps(_mm_loadu_ps(lhs.Y + i), _mm_loadu_ps(rhs.Y + i)));
+                _mm_storeu_ps(out.Z + i, _mm_sub_ps(_mm_loadu_ps(lhs.Z + i), _mm_loadu_ps(rhs.Z + i)));
+            }
+
+            BatchKernelsScalar.SubtractVector3SoA(Offset(lhs, i), Offset(rhs, i), Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_SSE42 void MultiplyVector3SoA(const Vector3SoA & lhs, float rhs, const Vector3SoA & out, unsigned int count)
+        {
+            const __m128 s = _mm_set1_ps(rhs);
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                _mm_storeu_ps(out.X + i, _mm_mul_ps(_mm_loadu_ps(lhs.X + i), s));
+                _mm_storeu_ps(out.Y + i, _mm_mul_ps(_mm_loadu_ps(lhs.Y + i), s));
+                _mm_storeu_ps(out.Z + i, _mm_mul_ps(_mm_loadu_ps(lhs.Z + i), s));
+            }
+
+            BatchKernelsScalar.MultiplyVector3SoA(Offset(lhs, i), rhs, Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_SSE42 void DotVector3SoA(const Vector3SoA & lhs, const Vector3SoA & rhs, float * pOut, unsigned int count)
+        {
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 x = _mm_mul_ps(_mm_loadu_ps(lhs.X + i), _mm_loadu_ps(rhs.X + i));
+                const __m128 y = _mm_mul_ps(_mm_loadu_ps(lhs.Y + i), _mm_loadu_ps(rhs.Y + i));
+                const __m128 z = _mm_mul_ps(_mm_loadu_ps(lhs.Z + i), _mm_loadu_ps(rhs.Z + i));
+                _mm_storeu_ps(pOut + i, _mm_add_ps(_mm_add_ps(x, y), z));
+            }
+
+            BatchKernelsScalar.DotVector3SoA(Offset(lhs, i), Offset(rhs, i), pOut + i, count - i);
+        }
+
+        PHX_TARGET_SSE42 void TransformVector3SoA(const Vector3SoA & in, const Matrix4x4 & m, const Vector3SoA & out, unsigned int count)
+        {
+            const __m128 m11 = _mm_set1_ps(m.M11), m12 = _mm_set1_ps(m.M12), m13 = _mm_set1_ps(m.M13);
+            const __m128 m21 = _mm_set1_ps(m.M21), m22 = _mm_set1_ps(m.M22), m23 = _mm_set1_ps(m.M23);
+            const __m128 m31 = _mm_set1_ps(m.M31), m32 = _mm_set1_ps(m.M32), m33 = _mm_set1_ps(m.M33);
+            const __m128 m41 = _mm_set1_ps(m.M41), m42 = _mm_set1_ps(m.M42), m43 = _mm_set1_ps(m.M43);
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(in.X + i);
+                const __m128 y = _mm_loadu_ps(in.Y + i);
+                const __m128 z = _mm_loadu_ps(in.Z + i);
+
+                _mm_storeu_ps(out.X + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m11), _mm_mul_ps(y, m21)), _mm_mul_ps(z, m31)), m41));
+                _mm_storeu_ps(out.Y + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m12), _mm_mul_ps(y, m22)), _mm_mul_ps(z, m32)), m42));
+                _mm_storeu_ps(out.Z + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m13), _mm_mul_ps(y, m23)), _mm_mul_ps(z, m33)), m43));
+            }
+
+            BatchKernelsScalar.TransformVector3SoA(Offset(in, i), m, Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_SSE42 void NormalizeVector3SoA(const Vector3SoA & in, const Vector3SoA & out, unsigned int count)
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 zero = _mm_setzero_ps();
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(in.X + i);
+                const __m128 y = _mm_loadu_ps(in.Y + i);
+                const __m128 z = _mm_loadu_ps(in.Z + i);
+
+                const __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+                const __m128 invLength = _mm_and_ps(_mm_cmpgt_ps(lengthSquared, zero), _mm_div_ps(one, _mm_sqrt_ps(lengthSquared)));
+
+                _mm_storeu_ps(out.X + i, _mm_mul_ps(x, invLength));
+                _mm_storeu_ps(out.Y + i, _mm_mul_ps(y, invLength));
+                _mm_storeu_ps(out.Z + i, _mm_mul_ps(z, invLength));
+            }
+
+            BatchKernelsScalar.NormalizeVector3SoA(Offset(in, i), Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_SSE42 void MultiplyQuaternionSoA(const QuaternionSoA & lhs, const QuaternionSoA & rhs, const QuaternionSoA & out, unsigned int count)
+        {
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 lx = _mm_loadu_ps(lhs.X + i), ly = _mm_loadu_ps(lhs.Y + i), lz = _mm_loadu_ps(lhs.Z + i), lw = _mm_loadu_ps(lhs.W + i);
+                const __m128 rx = _mm_loadu_ps(rhs.X + i), ry = _mm_loadu_ps(rhs.Y + i), rz = _mm_loadu_ps(rhs.Z + i), rw = _mm_loadu_ps(rhs.W + i);
+
+                const __m128 x = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(rw, lx), _mm_mul_ps(lw, rx)), _mm_mul_ps(ly, rz)), _mm_mul_ps(lz, ry));
+                const __m128 y = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(rw, ly), _mm_mul_ps(lw, ry)), _mm_mul_ps(lz, rx)), _mm_mul_ps(lx, rz));
+                const __m128 z = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(rw, lz), _mm_mul_ps(lw, rz)), _mm_mul_ps(lx, ry)), _mm_mul_ps(ly, rx));
+                const __m128 w = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(rw, lw), _mm_mul_ps(lx, rx)), _mm_mul_ps(ly, ry)), _mm_mul_ps(lz, rz));
+
+                _mm_storeu_ps(out.X + i, x);
+                _mm_storeu_ps(out.Y + i, y);
+                _mm_storeu_ps(out.Z + i, z);
+                _mm_storeu_ps(out.W + i, w);
+            }
+
+            BatchKernelsScalar.MultiplyQuaternionSoA(Offset(lhs, i), Offset(rhs, i), Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_SSE42 void NormalizeQuaternionSoA(const QuaternionSoA & in, const QuaternionSoA & out, unsigned int count)
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 zero = _mm_setzero_ps();
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(in.X + i);
+                const __m128 y = _mm_loadu_ps(in.Y + i);
+                const __m128 z = _mm_loadu_ps(in.Z + i);
+                const __m128 w = _mm_loadu_ps(in.W + i);
+
+                const __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)), _mm_mul_ps(w, w));
+                const __m128 invLength = _mm_and_ps(_mm_cmpgt_ps(lengthSquared, zero), _mm_div_ps(one, _mm_sqrt_ps(lengthSquared)));
+
+                _mm_storeu_ps(out.X + i, _mm_mul_ps(x, invLength));
+                _mm_storeu_ps(out.Y + i, _mm_mul_ps(y, invLength));
+                _mm_storeu_ps(out.Z + i, _mm_mul_ps(z, invLength));
+                _mm_storeu_ps(out.W + i, _mm_mul_ps(w, invLength));
+            }
+
+            BatchKernelsScalar.NormalizeQuaternionSoA(Offset(in, i), Offset(out, i), count - i);
+        }
+
+        PHX_TARGET_SSE42 void SlerpQuaternionSoA(const QuaternionSoA & q1, const QuaternionSoA & q2, float weight, const QuaternionSoA & out, unsigned int count)
+        {
+            SlerpWeights weights;
+            PrepareSlerp(weight, weights);
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 x1 = _mm_loadu_ps(q1.X + i), y1 = _mm_loadu_ps(q1.Y + i), z1 = _mm_loadu_ps(q1.Z + i), w1 = _mm_loadu_ps(q1.W + i);
+                const __m128 x2 = _mm_loadu_ps(q2.X + i), y2 = _mm_loadu_ps(q2.Y + i), z2 = _mm_loadu_ps(q2.Z + i), w2 = _mm_loadu_ps(q2.W + i);
+
+                const __m128 cosTheta = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x1, x2), _mm_mul_ps(y1, y2)), _mm_mul_ps(z1, z2)), _mm_mul_ps(w1, w2));
+
+                __m128 t1, t2;
+                GetSlerpWeights(weights, cosTheta, t1, t2);
+
+                _mm_storeu_ps(out.X + i, _mm_add_ps(_mm_mul_ps(t1, x1), _mm_mul_ps(t2, x2)));
+                _mm_storeu_ps(out.Y + i, _mm_add_ps(_mm_mul_ps(t1, y1), _mm_mul_ps(t2, y2)));
+                _mm_storeu_ps(out.Z + i, _mm_add_ps(_mm_mul_ps(t1, z1), _mm_mul_ps(t2, z2)));
+                _mm_storeu_ps(out.W + i, _mm_add_ps(_mm_mul_ps(t1, w1), _mm_mul_ps(t2, w2)));
+            }
+
+            BatchKernelsScalar.SlerpQuaternionSoA(Offset(q1, i), Offset(q2, i), weight, Offset(out, i), count - i);
+        }
+
+        // F16C is not part of this tier.
+        PHX_TARGET_SSE42 void IntersectRaysAABB(const RaySoA & rays, const AABB & box, float * pOutT, unsigned int count)
+        {
+            const __m128 minX = _mm_set1_ps(box.Min.X), minY = _mm_set1_ps(box.Min.Y), minZ = _mm_set1_ps(box.Min.Z);
+            const __m128 maxX = _mm_set1_ps(box.Max.X), maxY = _mm_set1_ps(box.Max.Y), maxZ = _mm_set1_ps(box.Max.Z);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 miss = _mm_set1_ps(FLT_MAX);
+
+            // A packet of 4 rays, the same min/max order as the single Intersects.
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 ox = _mm_loadu_ps(rays.Origin.X + i);
+                const __m128 oy = _mm_loadu_ps(rays.Origin.Y + i);
+                const __m128 oz = _mm_loadu_ps(rays.Origin.Z + i);
+                const __m128 ix = _mm_loadu_ps(rays.InvDirection.X + i);
+                const __m128 iy = _mm_loadu_ps(rays.InvDirection.Y + i);
+                const __m128 iz = _mm_loadu_ps(rays.InvDirection.Z + i);
+
+                const __m128 x1 = _mm_mul_ps(_mm_sub_ps(minX, ox), ix);
+                const __m128 x2 = _mm_mul_ps(_mm_sub_ps(maxX, ox), ix);
+                const __m128 y1 = _mm_mul_ps(_mm_sub_ps(minY, oy), iy);
+                const __m128 y2 = _mm_mul_ps(_mm_sub_ps(maxY, oy), iy);
+                const __m128 z1 = _mm_mul_ps(_mm_sub_ps(minZ, oz), iz);
+                const __m128 z2 = _mm_mul_ps(_mm_sub_ps(maxZ, oz), iz);
+
+                const __m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(x1, x2), _mm_min_ps(y1, y2)), _mm_max_ps(_mm_min_ps(z1, z2), zero));
+                const __m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(x1, x2), _mm_max_ps(y1, y2)), _mm_max_ps(z1, z2));
+
+                _mm_storeu_ps(pOutT + i, _mm_blendv_ps(miss, tNear, _mm_cmple_ps(tNear, tFar)));
+            }
+
+            BatchKernelsScalar.IntersectRaysAABB(Offset(rays, i), box, pOutT + i, count - i);
+        }
+
+        PHX_TARGET_SSE42 void IntersectRaysTriangle(const RaySoA & rays, const Vector3 & v0, const Vector3 & v1, const Vector3 & v2, float * pOutT, unsigned int count)
+        {
+            const __m128 e1x = _mm_set1_ps(v1.X - v0.X), e1y = _mm_set1_ps(v1.Y - v0.Y), e1z = _mm_set1_ps(v1.Z - v0.Z);
+            const __m128 e2x = _mm_set1_ps(v2.X - v0.X), e2y = _mm_set1_ps(v2.Y - v0.Y), e2z = _mm_set1_ps(v2.Z - v0.Z);
+            const __m128 v0x = _mm_set1_ps(v0.X), v0y = _mm_set1_ps(v0.Y), v0z = _mm_set1_ps(v0.Z);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 miss = _mm_set1_ps(FLT_MAX);
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 dx = _mm_loadu_ps(rays.Direction.X + i);
+                const __m128 dy = _mm_loadu_ps(rays.Direction.Y + i);
+                const __m128 dz = _mm_loadu_ps(rays.Direction.Z + i);
+                const __m128 sx = _mm_sub_ps(_mm_loadu_ps(rays.Origin.X + i), v0x);
+                const __m128 sy = _mm_sub_ps(_mm_loadu_ps(rays.Origin.Y + i), v0y);
+                const __m128 sz = _mm_sub_ps(_mm_loadu_ps(rays.Origin.Z + i), v0z);
+
+                // p = direction x edge2, q = s x edge1
+                const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+                const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+                const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+                const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+                const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+                const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+
+                const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+                const __m128 invDet = _mm_div_ps(one, det);
+
+                const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), invDet);
+                const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+                const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+                __m128 hit = _mm_cmpneq_ps(det, zero);
+                hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+                hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+                hit = _mm_and_ps(hit, _mm_cmpge_ps(t, zero));
+
+                _mm_storeu_ps(pOutT + i, _mm_blendv_ps(miss, t, hit));
+            }
+
+            BatchKernelsScalar.IntersectRaysTriangle(Offset(rays, i), v0, v1, v2, pOutT + i, count - i);
+        }
+
+        PHX_TARGET_SSE42 void SignedDistanceVector3SoA(const Plane & plane, const Vector3SoA & points, float * pOut, unsigned int count)
+        {
+            const __m128 nx = _mm_set1_ps(plane.Normal.X);
+            const __m128 ny = _mm_set1_ps(plane.Normal.Y);
+            const __m128 nz = _mm_set1_ps(plane.Normal.Z);
+            const __m128 d = _mm_set1_ps(plane.D);
+
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 x = _mm_mul_ps(_mm_loadu_ps(points.X + i), nx);
+                const __m128 y = _mm_mul_ps(_mm_loadu_ps(points.Y + i), ny);
+                const __m128 z = _mm_mul_ps(_mm_loadu_ps(points.Z + i), nz);
+                _mm_storeu_ps(pOut + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(x, y), z), d));
+            }
+
+            BatchKernelsScalar.SignedDistanceVector3SoA(plane, Offset(points, i), pOut + i, count - i);
+        }
+
+        PHX_TARGET_SSE42 unsigned int ClassifyVector3SoA(const Plane & plane, const Vector3SoA & points, float epsilon, uint32_t * pOutFront, uint32_t * pOutBack, unsigned int count)
+        {
+            const __m128 nx = _mm_set1_ps(plane.Normal.X);
+            const __m128 ny = _mm_set1_ps(plane.Normal.Y);
+            const __m128 nz = _mm_set1_ps(plane.Normal.Z);
+            const __m128 d = _mm_set1_ps(plane.D);
+            const __m128 frontLimit = _mm_set1_ps(epsilon);
+            const __m128 backLimit = _mm_set1_ps(-epsilon);
+
+            unsigned int sides = 0;
+            uint32_t frontBits = 0;
+            uint32_t backBits = 0;
+
+            // The bits of each word are gathered in registers and stored once the word is full.
+            unsigned int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 x = _mm_mul_ps(_mm_loadu_ps(points.X + i), nx);
+                const __m128 y = _mm_mul_ps(_mm_loadu_ps(points.Y + i), ny);
+                const __m128 z = _mm_mul_ps(_mm_loadu_ps(points.Z + i), nz);
+                const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(x, y), z), d);
+
+                frontBits |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpgt_ps(distance, frontLimit))) << (i & 31);
+                backBits |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(distance, backLimit))) << (i & 31);
+
+                if (((i + 4) & 31) == 0)
+                {
+                    sides |= PlaneMasks::StoreWord(frontBits, backBits, pOutFront + (i >> 5), pOutBack + (i >> 5));
+                    frontBits = 0;
+                    backBits = 0;
+                }
+            }
+
+            // The scalar loop adds the leftover points to the last word, which may already be partly filled.
+            if ((i & 31) != 0)
+            {
+                sides |= PlaneMasks::StoreWord(frontBits, backBits, pOutFront + (i >> 5), pOutBack + (i >> 5));
+            }
+
+            return sides | PlaneMasks::Classify(plane, points, epsilon, pOutFront, pOutBack, i, count);
+        }
+
+        void PackHalf(const float * pIn, uint16_t * pOut, unsigned int count)
+        {
+            BatchKernelsScalar.PackHalf(pIn, pOut, count);
+        }
+
+        void UnpackHalf(const uint16_t * pIn, float * pOut, unsigned int count)
+        {
+            BatchKernelsScalar.UnpackHalf(pIn, pOut, count);
+        }
+    }
+
+    const BatchKernels BatchKernelsSSE42 =
+    {
+        TransformVector3,
+        TransformVector4,
+        TransformVector2,
+        TransformRect,
+        NormalizeVector3,
+        SlerpQuaternion,
+        MultiplyMatrix4x4,
+        MultiplyMatrix4x4ByMatrix,
+        NormalMatrix4x4,
+        CullSpheresByPlanes,
+        ExtremePointsVector3,
+        IntersectOBBs,
+
+        AddVector3SoA,
+        SubtractVector3SoA,
+        MultiplyVector3SoA,
+        DotVector3SoA,
+        TransformVector3SoA,
+        NormalizeVector3SoA,
+        MultiplyQuaternionSoA,
+        NormalizeQuaternionSoA,
+        SlerpQuaternionSoA,
+        IntersectRaysAABB,
+        IntersectRaysTriangle,
+        SignedDistanceVector3SoA,
+        ClassifyVector3SoA,
+
+        PackHalf,
+        UnpackHalf,
+    };
+
+} //namespace Math
+} //namespace Phx
+
+#endif //PHX_MATH_X86
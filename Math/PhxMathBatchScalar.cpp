@@ -0,0 +1,457 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathBatchKernels.h"
+#include "PhxMathPacked.h"
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        void TransformVector3(const Vector3 * pIn, const Matrix4x4 & m, Vector3 * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                Transform(pIn[i], m, pOut[i]);
+            }
+        }
+
+        void TransformVector4(const Vector4 * pIn, const Matrix4x4 & m, Vector4 * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                Transform(pIn[i], m, pOut[i]);
+            }
+        }
+
+        void TransformVector2(const Vector2 * pIn, const Matrix3x2 & m, Vector2 * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                Transform(pIn[i], m, pOut[i]);
+            }
+        }
+
+        void TransformRect(const Rect * pIn, const Matrix3x2 & m, Rect * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                Transform(pIn[i], m, pOut[i]);
+            }
+        }
+
+        void NormalizeVector3(const Vector3 * pIn, Vector3 * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const float lengthSquared = LengthSquared(pIn[i]);
+                if (lengthSquared > 0.0f)
+                {
+                    Multiply(pIn[i], 1.0f / sqrtf(lengthSquared), pOut[i]);
+                }
+                else
+                {
+                    pOut[i].Set(0.0f);
+                }
+            }
+        }
+
+        struct SlerpWeights
+        {
+            float T;
+            float D;
+            float CoefficientsT[SlerpPolynomial::Terms];
+            float CoefficientsD[SlerpPolynomial::Terms];
+        };
+
+        void PrepareSlerp(float weight, SlerpWeights & out)
+        {
+            out.T = weight;
+            out.D = 1.0f - weight;
+            SlerpPolynomial::Prepare(out.T, out.CoefficientsT);
+            SlerpPolynomial::Prepare(out.D, out.CoefficientsD);
+        }
+
+        // Finds the weights of q1 (t1) and q2 (t2) from the cosine of the angle between them.
+        inline void GetSlerpWeights(const SlerpWeights & weights, float cosTheta, float & t1, float & t2)
+        {
+            float sign = 1.0f;
+            if (cosTheta < 0.0f)
+            {
+                cosTheta = -cosTheta;
+                sign = -1.0f;
+            }
+
+            const float xm1 = cosTheta - 1.0f;
+
+            float polyT = 1.0f;
+            float polyD = 1.0f;
+            for (int j = SlerpPolynomial::Terms - 1; j >= 0; --j)
+            {
+                polyT = 1.0f + weights.CoefficientsT[j] * xm1 * polyT;
+                polyD = 1.0f + weights.CoefficientsD[j] * xm1 * polyD;
+            }
+
+            t1 = weights.D * polyD;
+            t2 = sign * weights.T * polyT;
+        }
+
+        void SlerpQuaternion(const Quaternion * pQ1, const Quaternion * pQ2, float weight, Quaternion * pOut, unsigned int count)
+        {
+            SlerpWeights weights;
+            PrepareSlerp(weight, weights);
+
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Quaternion & q1 = pQ1[i];
+                const Quaternion & q2 = pQ2[i];
+
+                float t1, t2;
+                GetSlerpWeights(weights, Dot(q1, q2), t1, t2);
+
+                const float x = t1 * q1.X + t2 * q2.X;
+                const float y = t1 * q1.Y + t2 * q2.Y;
+                const float z = t1 * q1.Z + t2 * q2.Z;
+                const float w = t1 * q1.W + t2 * q2.W;
+                pOut[i].Set(x, y, z, w);
+            }
+        }
+
+        void MultiplyMatrix4x4(const Matrix4x4 * pLhs, const Matrix4x4 * pRhs, Matrix4x4 * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                Multiply(pLhs[i], pRhs[i], pOut[i]);
+            }
+        }
+
+        void MultiplyMatrix4x4ByMatrix(const Matrix4x4 * pLhs, const Matrix4x4 & rhs, Matrix4x4 * pOut, unsigned int count)
+        {
+            // Copied in case rhs is one of the output matrices.
+            const Matrix4x4 m(rhs);
+
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                Multiply(pLhs[i], m, pOut[i]);
+            }
+        }
+
+        void NormalMatrix4x4(const Matrix4x4 * pIn, Matrix3x3 * pOut, unsigned int count)
+        {
+            // Same as NormalMatrix, without the assert.
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Matrix4x4 & m = pIn[i];
+
+                const float c11 = m.M22 * m.M33 - m.M23 * m.M32;
+                const float c12 = m.M23 * m.M31 - m.M21 * m.M33;
+                const float c13 = m.M21 * m.M32 - m.M22 * m.M31;
+
+                const float det = m.M11 * c11 + m.M12 * c12 + m.M13 * c13;
+                if (det == 0.0f)
+                {
+                    pOut[i].Set(0.0f);
+                    continue;
+                }
+
+                const float invDet = 1.0f / det;
+
+                pOut[i].Set(c11 * invDet,
+                            c12 * invDet,
+                            c13 * invDet,
+                            (m.M32 * m.M13 - m.M33 * m.M12) * invDet,
+                            (m.M33 * m.M11 - m.M31 * m.M13) * invDet,
+                            (m.M31 * m.M12 - m.M32 * m.M11) * invDet,
+                            (m.M12 * m.M23 - m.M13 * m.M22) * invDet,
+                            (m.M13 * m.M21 - m.M11 * m.M23) * invDet,
+                            (m.M11 * m.M22 - m.M12 * m.M21) * invDet);
+            }
+        }
+
+        unsigned int CullSpheresByPlanes(const Vector4 * pSpheres, const Vector4 * pPlanes, unsigned int planeCount, unsigned int * pOutIndices, unsigned int count)
+        {
+            unsigned int visibleCount = 0;
+
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Vector4 & sphere = pSpheres[i];
+
+                bool visible = true;
+                for (unsigned int j = 0; j < planeCount; ++j)
+                {
+                    const Vector4 & plane = pPlanes[j];
+                    const float distance = sphere.X * plane.X + sphere.Y * plane.Y + sphere.Z * plane.Z + plane.W;
+                    if (distance < -sphere.W)
+                    {
+                        visible = false;
+                        break;
+                    }
+                }
+
+                if (visible)
+                {
+                    pOutIndices[visibleCount++] = i;
+                }
+            }
+
+            return visibleCount;
+        }
+
+        void ExtremePointsVector3(const Vector3 * pIn, unsigned int count, unsigned int * pOutIndices)
+        {
+            ExtremePoints::State state;
+            ExtremePoints::Begin(pIn[0], state);
+            ExtremePoints::Update(pIn, 1, count, state);
+            ExtremePoints::End(state, pOutIndices);
+        }
+
+        unsigned int IntersectOBBs(const OBB & box, const OBB * pBoxes, unsigned int * pOutIndices, unsigned int count)
+        {
+            unsigned int hitCount = 0;
+
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                if (Intersects(box, pBoxes[i]))
+                {
+                    pOutIndices[hitCount++] = i;
+                }
+            }
+
+            return hitCount;
+        }
+
+        void AddVector3SoA(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                out.X[i] = lhs.X[i] + rhs.X[i];
+                out.Y[i] = lhs.Y[i] + rhs.Y[i];
+                out.Z[i] = lhs.Z[i] + rhs.Z[i];
+            }
+        }
+
+        void SubtractVector3SoA(const Vector3SoA & lhs, const Vector3SoA & rhs, const Vector3SoA & out, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                out.X[i] = lhs.X[i] - rhs.X[i];
+                out.Y[i] = lhs.Y[i] - rhs.Y[i];
+                out.Z[i] = lhs.Z[i] - rhs.Z[i];
+            }
+        }
+
+        void MultiplyVector3SoA(const Vector3SoA & lhs, float rhs, const Vector3SoA & out, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                out.X[i] = lhs.X[i] * rhs;
+                out.Y[i] = lhs.Y[i] * rhs;
+                out.Z[i] = lhs.Z[i] * rhs;
+            }
+        }
+
+        void DotVector3SoA(const Vector3SoA & lhs, const Vector3SoA & rhs, float * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                pOut[i] = lhs.X[i] * rhs.X[i] + lhs.Y[i] * rhs.Y[i] + lhs.Z[i] * rhs.Z[i];
+            }
+        }
+
+        void TransformVector3SoA(const Vector3SoA & in, const Matrix4x4 & m, const Vector3SoA & out, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const float x = in.X[i];
+                const float y = in.Y[i];
+                const float z = in.Z[i];
+
+                out.X[i] = x * m.M11 + y * m.M21 + z * m.M31 + m.M41;
+                out.Y[i] = x * m.M12 + y * m.M22 + z * m.M32 + m.M42;
+                out.Z[i] = x * m.M13 + y * m.M23 + z * m.M33 + m.M43;
+            }
+        }
+
+        void NormalizeVector3SoA(const Vector3SoA & in, const Vector3SoA & out, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const float x = in.X[i];
+                const float y = in.Y[i];
+                const float z = in.Z[i];
+
+                const float lengthSquared = x * x + y * y + z * z;
+                const float invLength = (lengthSquared > 0.0f) ? (1.0f / sqrtf(lengthSquared)) : 0.0f;
+
+                out.X[i] = x * invLength;
+                out.Y[i] = y * invLength;
+                out.Z[i] = z * invLength;
+            }
+        }
+
+        void MultiplyQuaternionSoA(const QuaternionSoA & lhs, const QuaternionSoA & rhs, const QuaternionSoA & out, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const float lx = lhs.X[i], ly = lhs.Y[i], lz = lhs.Z[i], lw = lhs.W[i];
+                const float rx = rhs.X[i], ry = rhs.Y[i], rz = rhs.Z[i], rw = rhs.W[i];
+
+                out.X[i] = (rw * lx) + (lw * rx) + (ly * rz) - (lz * ry);
+                out.Y[i] = (rw * ly) + (lw * ry) + (lz * rx) - (lx * rz);
+                out.Z[i] = (rw * lz) + (lw * rz) + (lx * ry) - (ly * rx);
+                out.W[i] = (rw * lw) - (lx * rx) - (ly * ry) - (lz * rz);
+            }
+        }
+
+        void NormalizeQuaternionSoA(const QuaternionSoA & in, const QuaternionSoA & out, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const float x = in.X[i];
+                const float y = in.Y[i];
+                const float z = in.Z[i];
+                const float w = in.W[i];
+
+                const float lengthSquared = x * x + y * y + z * z + w * w;
+                const float invLength = (lengthSquared > 0.0f) ? (1.0f / sqrtf(lengthSquared)) : 0.0f;
+
+                out.X[i] = x * invLength;
+                out.Y[i] = y * invLength;
+                out.Z[i] = z * invLength;
+                out.W[i] = w * invLength;
+            }
+        }
+
+        void SlerpQuaternionSoA(const QuaternionSoA & q1, const QuaternionSoA & q2, float weight, const QuaternionSoA & out, unsigned int count)
+        {
+            SlerpWeights weights;
+            PrepareSlerp(weight, weights);
+
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const float x1 = q1.X[i], y1 = q1.Y[i], z1 = q1.Z[i], w1 = q1.W[i];
+                const float x2 = q2.X[i], y2 = q2.Y[i], z2 = q2.Z[i], w2 = q2.W[i];
+
+                float t1, t2;
+                GetSlerpWeights(weights, x1 * x2 + y1 * y2 + z1 * z2 + w1 * w2, t1, t2);
+
+                out.X[i] = t1 * x1 + t2 * x2;
+                out.Y[i] = t1 * y1 + t2 * y2;
+                out.Z[i] = t1 * z1 + t2 * z2;
+                out.W[i] = t1 * w1 + t2 * w2;
+            }
+        }
+
+        void IntersectRaysAABB(const RaySoA & rays, const AABB & box, float * pOutT, unsigned int count)
+        {
+            Ray ray;
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                Get(rays, i, ray);
+
+                float t;
+                pOutT[i] = Intersects(ray, box, t) ? t : FLT_MAX;
+            }
+        }
+
+        void IntersectRaysTriangle(const RaySoA & rays, const Vector3 & v0, const Vector3 & v1, const Vector3 & v2, float * pOutT, unsigned int count)
+        {
+            Ray ray;
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                Get(rays, i, ray);
+
+                float t;
+                pOutT[i] = Intersects(ray, v0, v1, v2, t) ? t : FLT_MAX;
+            }
+        }
+
+        void SignedDistanceVector3SoA(const Plane & plane, const Vector3SoA & points, float * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                pOut[i] = points.X[i] * plane.Normal.X + points.Y[i] * plane.Normal.Y + points.Z[i] * plane.Normal.Z + plane.D;
+            }
+        }
+
+        unsigned int ClassifyVector3SoA(const Plane & plane, const Vector3SoA & points, float epsilon, uint32_t * pOutFront, uint32_t * pOutBack, unsigned int count)
+        {
+            return PlaneMasks::Classify(plane, points, epsilon, pOutFront, pOutBack, 0, count);
+        }
+
+        void PackHalf(const float * pIn, uint16_t * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                pOut[i] = FloatToHalf(pIn[i]);
+            }
+        }
+
+        void UnpackHalf(const uint16_t * pIn, float * pOut, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                pOut[i] = HalfToFloat(pIn[i]);
+            }
+        }
+    }
+
+    const BatchKernels BatchKernelsScalar =
+    {
+        TransformVector3,
+        TransformVector4,
+        TransformVector2,
+        TransformRect,
+        NormalizeVector3,
+        SlerpQuaternion,
+        MultiplyMatrix4x4,
+        MultiplyMatrix4x4ByMatrix,
+        NormalMatrix4x4,
+        CullSpheresByPlanes,
+        ExtremePointsVector3,
+        IntersectOBBs,
+
+        AddVector3SoA,
+        SubtractVector3SoA,
+        MultiplyVector3SoA,
+        DotVector3SoA,
+        TransformVector3SoA,
+        NormalizeVector3SoA,
+        MultiplyQuaternionSoA,
+        NormalizeQuaternionSoA,
+        SlerpQuaternionSoA,
+        IntersectRaysAABB,
+        IntersectRaysTriangle,
+        SignedDistanceVector3SoA,
+        ClassifyVector3SoA,
+
+        PackHalf,
+        UnpackHalf,
+    };
+
+} //namespace Math
+} //namespace Phx
@@ -0,0 +1,506 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathBinary.h"
+#include "PhxMathCpu.h"
+
+// C Standard Library Includes
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// C++ Standard Library Includes
+#include <atomic>
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# define NOMINMAX
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#if PHX_MATH_X86
+# include <nmmintrin.h>
+#endif
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // Numbers the temporary files of Write within the process.
+        std::atomic<unsigned int> s_nextTempFile(0);
+
+        unsigned long GetProcessIdentifier()
+        {
+#if defined(_WIN32)
+            return static_cast<unsigned long>(GetCurrentProcessId());
+#else
+            return static_cast<unsigned long>(getpid());
+#endif
+        }
+
+        bool IsLittleEndian()
+        {
+            const uint32_t one = 1;
+            uint8_t firstByte;
+            memcpy(&firstByte, &one, 1);
+            return (firstByte == 1);
+        }
+
+        uint64_t AlignOffset(uint64_t offset)
+        {
+            return (offset + (BinaryFormat::Alignment - 1)) & ~static_cast<uint64_t>(BinaryFormat::Alignment - 1);
+        }
+
+        //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+        // CRC-32C
+        //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+        // The Castagnoli polynomial is the one the SSE4.2 crc32 instruction
+        // implements, the table version gives the same result without it.
+        //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+        struct Crc32cTable
+        {
+            uint32_t Entries[256];
+
+            Crc32cTable()
+            {
+                const uint32_t polynomial = 0x82F63B78;     // Reflected 0x1EDC6F41
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    uint32_t crc = i;
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        crc = (crc & 1) ? ((crc >> 1) ^ polynomial) : (crc >> 1);
+                    }
+                    Entries[i] = crc;
+                }
+            }
+        };
+
+        uint32_t Crc32cScalar(uint32_t crc, const uint8_t * p, size_t bytes)
+        {
+            static const Crc32cTable s_table;
+
+            for (size_t i = 0; i < bytes; ++i)
+            {
+                crc = s_table.Entries[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+            }
+            return crc;
+        }
+
+#if PHX_MATH_X86
+        PHX_TARGET("sse4.2") uint32_t Crc32cSSE42(uint32_t crc, const uint8_t * p, size_t bytes)
+        {
+# if defined(_M_X64) || defined(__x86_64__)
+            uint64_t crc64 = crc;
+            for (; bytes >= 8; bytes -= 8, p += 8)
+            {
+                uint64_t value;
+                memcpy(&value, p, 8);
+                crc64 = _mm_crc32_u64(crc64, value);
+            }
+            crc = static_cast<uint32_t>(crc64);
+# else
+            for (; bytes >= 4; bytes -= 4, p += 4)
+            {
+                uint32_t value;
+                memcpy(&value, p, 4);
+                crc = _mm_crc32_u32(crc, value);
+            }
+# endif
+            for (; bytes > 0; --bytes, ++p)
+            {
+                crc = _mm_crc32_u8(crc, *p);
+            }
+            return crc;
+        }
+#endif
+
+        uint32_t ComputeHeaderChecksum(const BinaryFileHeader & header)
+        {
+            return ComputeChecksum(&header, offsetof(BinaryFileHeader, HeaderChecksum));
+        }
+
+        bool WriteZeros(FILE * pFile, uint64_t bytes)
+        {
+            static const uint8_t s_zeros[BinaryFormat::Alignment] = { 0 };
+
+            while (bytes > 0)
+            {
+                const size_t chunk = (bytes < sizeof(s_zeros)) ? static_cast<size_t>(bytes) : sizeof(s_zeros);
+                if (fwrite(s_zeros, 1, chunk, pFile) != chunk)
+                {
+                    return false;
+                }
+                bytes -= chunk;
+            }
+            return true;
+        }
+    }
+
+    uint32_t ComputeChecksum(const void * pData, size_t bytes)
+    {
+        const uint8_t * p = static_cast<const uint8_t *>(pData);
+
+#if PHX_MATH_X86
+        if (GetCpuFeatures().SSE42)
+        {
+            return ~Crc32cSSE42(0xFFFFFFFF, p, bytes);
+        }
+#endif
+        return ~Crc32cScalar(0xFFFFFFFF, p, bytes);
+    }
+
+    void BinaryWriter::Add(BinaryType::Type type, uint32_t stride, const void * pData, unsigned int count, uint32_t tag)
+    {
+        DebugAssert(type >= 0 && type < BinaryType::Count, "Invalid binary type (%d)!", type);
+        DebugAssert(pData != nullptr || count == 0, "Trying to add a null array with (%u) elements!", count);
+
+        Entry entry;
+        entry.Type = type;
+        entry.Stride = stride;
+        entry.pData = pData;
+        entry.Count = count;
+        entry.Tag = tag;
+        m_entries.PushBack(entry);
+    }
+
+    void BinaryWriter::Clear()
+    {
+        m_entries.Clear();
+    }
+
+    unsigned int BinaryWriter::GetArrayCount() const
+    {
+        return m_entries.GetCount();
+    }
+
+    BinaryResult::Type BinaryWriter::Write(const char * pPath) const
+    {
+        if (false == IsLittleEndian())
+        {
+            return BinaryResult::UnsupportedPlatform;
+        }
+
+        const unsigned int arrayCount = m_entries.GetCount();
+
+        // Lay out the file and checksum the data before anything is written.
+        AlignedArray<BinaryArrayHeader> arrayHeaders(arrayCount);
+
+        uint64_t offset = AlignOffset(sizeof(BinaryFileHeader) + static_cast<uint64_t>(arrayCount) * sizeof(BinaryArrayHeader));
+        for (unsigned int i = 0; i < arrayCount; ++i)
+        {
+            const Entry & entry = m_entries[i];
+            BinaryArrayHeader & arrayHeader = arrayHeaders[i];
+            memset(&arrayHeader, 0, sizeof(BinaryArrayHeader));
+
+            arrayHeader.Type = static_cast<uint32_t>(entry.Type);
+            arrayHeader.Stride = entry.Stride;
+            arrayHeader.Count = entry.Count;
+            arrayHeader.DataOffset = offset;
+            arrayHeader.DataSize = static_cast<uint64_t>(entry.Stride) * entry.Count;
+            arrayHeader.Tag = entry.Tag;
+            arrayHeader.Checksum = ComputeChecksum(entry.pData, static_cast<size_t>(arrayHeader.DataSize));
+
+            offset = AlignOffset(offset + arrayHeader.DataSize);
+        }
+
+        BinaryFileHeader header;
+        memset(&header, 0, sizeof(BinaryFileHeader));
+        header.Magic = BinaryFormat::Magic;
+        header.Version = BinaryFormat::Version;
+        header.HeaderSize = sizeof(BinaryFileHeader);
+        header.ArrayCount = arrayCount;
+        header.ArrayHeaderSize = sizeof(BinaryArrayHeader);
+        header.ArrayTableOffset = sizeof(BinaryFileHeader);
+        header.FileSize = offset;
+        header.ArrayTableChecksum = ComputeChecksum(arrayHeaders.GetData(), sizeof(BinaryArrayHeader) * arrayCount);
+        header.HeaderChecksum = ComputeHeaderChecksum(header);
+
+        // Write next to the target and rename over it at the end, so a file that is
+        // mapped from pPath never sees a truncated or half written file. The name is
+        // unique per process and call, so writers racing on the same path each write
+        // their own file and the last rename wins.
+        const unsigned int tempFile = s_nextTempFile.fetch_add(1, std::memory_order_relaxed);
+        const size_t tempPathSize = strlen(pPath) + 48;
+        AlignedArray<char> tempPath(static_cast<unsigned int>(tempPathSize));
+        snprintf(tempPath.GetData(), tempPathSize, "%s.%lu.%u.tmp", pPath, GetProcessIdentifier(), tempFile);
+        const char * pTempPath = tempPath.GetData();
+
+        FILE * pFile = nullptr;
+#if defined(_MSC_VER)
+        if (fopen_s(&pFile, pTempPath, "wb") != 0)
+        {
+            pFile = nullptr;
+        }
+#else
+        pFile = fopen(pTempPath, "wb");
+#endif
+        if (pFile == nullptr)
+        {
+            return BinaryResult::OpenFailed;
+        }
+
+        bool written = (fwrite(&header, sizeof(BinaryFileHeader), 1, pFile) == 1);
+        if (written && arrayCount > 0)
+        {
+            written = (fwrite(arrayHeaders.GetData(), sizeof(BinaryArrayHeader), arrayCount, pFile) == arrayCount);
+        }
+
+        uint64_t position = sizeof(BinaryFileHeader) + static_cast<uint64_t>(arrayCount) * sizeof(BinaryArrayHeader);
+        for (unsigned int i = 0; written && i < arrayCount; ++i)
+        {
+            const BinaryArrayHeader & arrayHeader = arrayHeaders[i];
+
+            written = WriteZeros(pFile, arrayHeader.DataOffset - position);
+            if (written && arrayHeader.DataSize > 0)
+            {
+                written = (fwrite(m_entries[i].pData, static_cast<size_t>(arrayHeader.DataSize), 1, pFile) == 1);
+            }
+            position = arrayHeader.DataOffset + arrayHeader.DataSize;
+        }
+
+        if (written)
+        {
+            written = WriteZeros(pFile, header.FileSize - position);
+        }
+
+        if (written && fflush(pFile) != 0)
+        {
+            written = false;
+        }
+#if !defined(_WIN32)
+        if (written && fsync(fileno(pFile)) != 0)
+        {
+            written = false;
+        }
+#endif
+        if (fclose(pFile) != 0)
+        {
+            written = false;
+        }
+
+        if (written)
+        {
+#if defined(_WIN32)
+            written = (MoveFileExA(pTempPath, pPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+#else
+            written = (rename(pTempPath, pPath) == 0);
+#endif
+        }
+
+        if (false == written)
+        {
+            remove(pTempPath);
+            return BinaryResult::WriteFailed;
+        }
+
+        return BinaryResult::Success;
+    }
+
+    BinaryResult::Type MappedBinaryFile::Open(const char * pPath, unsigned int flags)
+    {
+        Close();
+
+        if (false == IsLittleEndian())
+        {
+            return BinaryResult::UnsupportedPlatform;
+        }
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(pPath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return BinaryResult::OpenFailed;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) == FALSE || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(BinaryFileHeader)) ||
+            static_cast<unsigned long long>(fileSize.QuadPart) > static_cast<size_t>(-1))
+        {
+            CloseHandle(file);
+            return BinaryResult::InvalidFile;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr)
+        {
+            return BinaryResult::MapFailed;
+        }
+
+        // The view keeps the mapping alive.
+        const void * pView = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (pView == nullptr)
+        {
+            return BinaryResult::MapFailed;
+        }
+
+        m_pBase = static_cast<const uint8_t *>(pView);
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        const int file = open(pPath, O_RDONLY);
+        if (file < 0)
+        {
+            return BinaryResult::OpenFailed;
+        }
+
+        struct stat fileStat;
+        if (fstat(file, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(sizeof(BinaryFileHeader)))
+        {
+            close(file);
+            return BinaryResult::InvalidFile;
+        }
+
+        // The mapping stays valid after the file is closed.
+        void * pView = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (pView == MAP_FAILED)
+        {
+            return BinaryResult::MapFailed;
+        }
+
+        m_pBase = static_cast<const uint8_t *>(pView);
+        m_size = static_cast<size_t>(fileStat.st_size);
+
+        if (flags & BinaryOpen::Prefetch)
+        {
+            madvise(pView, m_size, MADV_WILLNEED);
+        }
+#endif
+
+        const BinaryResult::Type result = Validate(flags);
+        if (result != BinaryResult::Success)
+        {
+            Close();
+        }
+        return result;
+    }
+
+    void MappedBinaryFile::Close()
+    {
+        if (m_pBase == nullptr)
+        {
+            return;
+        }
+
+#if defined(_WIN32)
+        UnmapViewOfFile(m_pBase);
+#else
+        munmap(const_cast<uint8_t *>(m_pBase), m_size);
+#endif
+
+        m_pBase = nullptr;
+        m_size = 0;
+    }
+
+    int MappedBinaryFile::FindArray(uint32_t tag) const
+    {
+        const unsigned int arrayCount = GetArrayCount();
+        for (unsigned int i = 0; i < arrayCount; ++i)
+        {
+            if (GetArrayHeader(i).Tag == tag)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    BinaryResult::Type MappedBinaryFile::VerifyArray(unsigned int idx) const
+    {
+        const BinaryArrayHeader & arrayHeader = GetArrayHeader(idx);
+        if (ComputeChecksum(m_pBase + arrayHeader.DataOffset, static_cast<size_t>(arrayHeader.DataSize)) != arrayHeader.Checksum)
+        {
+            return BinaryResult::ChecksumMismatch;
+        }
+        return BinaryResult::Success;
+    }
+
+    BinaryResult::Type MappedBinaryFile::Validate(unsigned int flags) const
+    {
+        const BinaryFileHeader & header = *reinterpret_cast<const BinaryFileHeader *>(m_pBase);
+
+        if (header.Magic != BinaryFormat::Magic)
+        {
+            return BinaryResult::InvalidFile;
+        }
+        if (header.Version != BinaryFormat::Version)
+        {
+            return BinaryResult::UnsupportedVersion;
+        }
+        if (header.HeaderSize != sizeof(BinaryFileHeader) || header.ArrayHeaderSize != sizeof(BinaryArrayHeader) ||
+            header.HeaderChecksum != ComputeHeaderChecksum(header) || header.FileSize != m_size)
+        {
+            return BinaryResult::InvalidFile;
+        }
+
+        // The table has to fit in the file, written so none of the math can overflow.
+        const uint64_t tableSize = static_cast<uint64_t>(header.ArrayCount) * sizeof(BinaryArrayHeader);
+        if (header.ArrayTableOffset != sizeof(BinaryFileHeader) || tableSize > m_size - header.ArrayTableOffset)
+        {
+            return BinaryResult::InvalidFile;
+        }
+        if (ComputeChecksum(m_pBase + header.ArrayTableOffset, static_cast<size_t>(tableSize)) != header.ArrayTableChecksum)
+        {
+            return BinaryResult::InvalidFile;
+        }
+
+        for (unsigned int i = 0; i < header.ArrayCount; ++i)
+        {
+            const BinaryArrayHeader & arrayHeader = GetArrayHeader(i);
+
+            if (arrayHeader.Type >= BinaryType::Count || arrayHeader.Stride == 0 ||
+                arrayHeader.Count > static_cast<unsigned int>(-1) ||
+                arrayHeader.DataOffset % BinaryFormat::Alignment != 0 ||
+                arrayHeader.DataOffset > m_size || arrayHeader.DataSize > m_size - arrayHeader.DataOffset ||
+                arrayHeader.Count != arrayHeader.DataSize / arrayHeader.Stride || arrayHeader.DataSize % arrayHeader.Stride != 0)
+            {
+                return BinaryResult::InvalidFile;
+            }
+
+            if (flags & BinaryOpen::VerifyData)
+            {
+                const BinaryResult::Type result = VerifyArray(i);
+                if (result != BinaryResult::Success)
+                {
+                    return result;
+                }
+            }
+        }
+
+        return BinaryResult::Success;
+    }
+
+} //namespace Math
+} //namespace Phx
@@ -0,0 +1,242 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_BINARY_H_
+#define _PHX_MATH_BINARY_H_
+
+#include "PhxMathArena.h"
+
+// C Standard Library Includes
+#include <stdint.h>
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Binary Array Container
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// A file holding any number of arrays of PhxMath types, laid out so it
+// can be memory mapped and used in place:
+//
+//   BinaryFileHeader                       64 bytes
+//   BinaryArrayHeader * ArrayCount         64 bytes each
+//   array data                             each array starts on a 64 byte boundary
+//
+// Everything is little endian. The array data is the raw memory of the
+// types, so on a little endian machine a mapped array is directly usable
+// as a Span<const T> and loading is just page faults. Big endian hosts
+// are refused rather than byte swapped.
+//
+// Each array header stores the type, element size (stride), count, a
+// user tag to look the array up by, and a CRC-32C of the data. The
+// headers are always validated on Open, checking the data means reading
+// all of it, so it is only done with BinaryOpen::VerifyData or VerifyArray.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    namespace BinaryFormat
+    {
+        const uint32_t Magic = 0x42585850;     // "PHXB"
+        const uint16_t Version = 1;
+        const uint32_t Alignment = 64;
+    }
+
+    namespace BinaryType
+    {
+        enum Type
+        {
+            Float,
+            Vector2,
+            Vector3,
+            Vector4,
+            Quaternion,
+            Matrix4x4,
+            Vector3d,
+            Rect,
+
+            Count
+        };
+    }
+
+    namespace BinaryResult
+    {
+        enum Type
+        {
+            Success,
+            OpenFailed,             // The file couldn't be opened or created.
+            MapFailed,
+            WriteFailed,
+            InvalidFile,            // Not a PhxMath binary file, or the headers are damaged.
+            UnsupportedVersion,
+            ChecksumMismatch,
+            UnsupportedPlatform,    // Big endian host.
+        };
+    }
+
+    namespace BinaryOpen
+    {
+        enum Flags
+        {
+            None = 0,
+            VerifyData = 1 << 0,    // Check the checksum of every array on open (reads the whole file).
+            Prefetch = 1 << 1,      // Ask the OS to start reading the whole file in the background.
+        };
+    }
+
+    struct BinaryFileHeader
+    {
+        uint32_t Magic;
+        uint16_t Version;
+        uint16_t HeaderSize;
+        uint32_t ArrayCount;
+        uint32_t ArrayHeaderSize;
+        uint64_t ArrayTableOffset;
+        uint64_t FileSize;
+        uint32_t ArrayTableChecksum;
+        uint32_t HeaderChecksum;        // Of the bytes before this member.
+        uint8_t Reserved[24];
+    };
+
+    struct BinaryArrayHeader
+    {
+        uint32_t Type;
+        uint32_t Stride;
+        uint64_t Count;
+        uint64_t DataOffset;
+        uint64_t DataSize;
+        uint32_t Tag;
+        uint32_t Checksum;
+        uint8_t Reserved[24];
+    };
+
+    static_assert(sizeof(BinaryFileHeader) == 64, "The binary file header layout is part of the file format.");
+    static_assert(sizeof(BinaryArrayHeader) == 64, "The binary array header layout is part of the file format.");
+
+    // Maps the PhxMath types to their BinaryType.
+    template <class T> struct BinaryTypeOf;
+    template <> struct BinaryTypeOf<float> { static const BinaryType::Type Value = BinaryType::Float; };
+    template <> struct BinaryTypeOf<Vector2> { static const BinaryType::Type Value = BinaryType::Vector2; };
+    template <> struct BinaryTypeOf<Vector3> { static const BinaryType::Type Value = BinaryType::Vector3; };
+    template <> struct BinaryTypeOf<Vector4> { static const BinaryType::Type Value = BinaryType::Vector4; };
+    template <> struct BinaryTypeOf<Quaternion> { static const BinaryType::Type Value = BinaryType::Quaternion; };
+    template <> struct BinaryTypeOf<Matrix4x4> { static const BinaryType::Type Value = BinaryType::Matrix4x4; };
+    template <> struct BinaryTypeOf<Vector3d> { static const BinaryType::Type Value = BinaryType::Vector3d; };
+    template <> struct BinaryTypeOf<Rect> { static const BinaryType::Type Value = BinaryType::Rect; };
+
+    // CRC-32C (Castagnoli), uses the SSE4.2 crc32 instruction when the cpu has it.
+    uint32_t ComputeChecksum(const void * pData, size_t bytes);
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Collects arrays and writes them out as one file.
+    // The arrays are not copied, they must stay alive until Write returns.
+    // Write goes to a temporary file next to pPath (pPath.<pid>.<n>.tmp) and
+    // renames it over pPath, so concurrent writers never share a file and, on
+    // POSIX, readers that still map the old file keep seeing it whole.
+    // On Windows a mapped file can't be replaced: Write returns WriteFailed
+    // until every MappedBinaryFile open on pPath is closed.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    class BinaryWriter
+    {
+    public:
+        inline BinaryWriter() { }
+        inline ~BinaryWriter() { }
+
+        template <class T>
+        inline void Add(const T * pData, unsigned int count, uint32_t tag = 0);
+        void Add(BinaryType::Type type, uint32_t stride, const void * pData, unsigned int count, uint32_t tag);
+
+        void Clear();
+
+        unsigned int GetArrayCount() const;
+
+        BinaryResult::Type Write(const char * pPath) const;
+
+    private:
+        // Non-copyable.
+        BinaryWriter(const BinaryWriter &);
+        BinaryWriter & operator=(const BinaryWriter &);
+
+    private:
+        struct Entry
+        {
+            BinaryType::Type Type;
+            uint32_t Stride;
+            const void * pData;
+            unsigned int Count;
+            uint32_t Tag;
+        };
+
+        AlignedArray<Entry> m_entries;
+    };
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Read only memory mapping of a binary file.
+    // Spans handed out point into the mapping and are invalid after Close.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    class MappedBinaryFile
+    {
+    public:
+        inline MappedBinaryFile();
+        inline ~MappedBinaryFile();
+
+        BinaryResult::Type Open(const char * pPath, unsigned int flags = BinaryOpen::None);
+        void Close();
+
+        inline bool IsOpen() const;
+
+        inline unsigned int GetArrayCount() const;
+        inline const BinaryArrayHeader & GetArrayHeader(unsigned int idx) const;
+
+        // Index of the first array with the tag, -1 if there isn't one.
+        int FindArray(uint32_t tag) const;
+
+        // False if the array holds a different type.
+        template <class T>
+        inline bool GetArray(unsigned int idx, Span<const T> & out) const;
+        template <class T>
+        inline bool GetArrayByTag(uint32_t tag, Span<const T> & out) const;
+
+        BinaryResult::Type VerifyArray(unsigned int idx) const;
+
+    private:
+        // Non-copyable.
+        MappedBinaryFile(const MappedBinaryFile &);
+        MappedBinaryFile & operator=(const MappedBinaryFile &);
+
+        BinaryResult::Type Validate(unsigned int flags) const;
+
+    private:
+        const uint8_t * m_pBase;
+        size_t m_size;
+    };
+
+} //namespace Math
+} //namespace Phx
+
+#include "PhxMathBinary.inl"
+
+#endif //_PHX_MATH_BINARY_H_
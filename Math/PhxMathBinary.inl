@@ -0,0 +1,99 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_BINARY_INL_
+#define _PHX_MATH_BINARY_INL_
+
+namespace Phx {
+namespace Math {
+
+    template <class T>
+    inline void BinaryWriter::Add(const T * pData, unsigned int count, uint32_t tag)
+    {
+        Add(BinaryTypeOf<T>::Value, static_cast<uint32_t>(sizeof(T)), pData, count, tag);
+    }
+
+    inline MappedBinaryFile::MappedBinaryFile()
+        : m_pBase(nullptr)
+        , m_size(0)
+    { }
+
+    inline MappedBinaryFile::~MappedBinaryFile()
+    {
+        Close();
+    }
+
+    inline bool MappedBinaryFile::IsOpen() const
+    {
+        return (m_pBase != nullptr);
+    }
+
+    inline unsigned int MappedBinaryFile::GetArrayCount() const
+    {
+        if (m_pBase == nullptr)
+        {
+            return 0;
+        }
+        return reinterpret_cast<const BinaryFileHeader *>(m_pBase)->ArrayCount;
+    }
+
+    inline const BinaryArrayHeader & MappedBinaryFile::GetArrayHeader(unsigned int idx) const
+    {
+        DebugAssert(idx < GetArrayCount(), "Invalid index (%u) into a binary file with (%u) arrays!", idx, GetArrayCount());
+
+        const BinaryFileHeader * pHeader = reinterpret_cast<const BinaryFileHeader *>(m_pBase);
+        return reinterpret_cast<const BinaryArrayHeader *>(m_pBase + pHeader->ArrayTableOffset)[idx];
+    }
+
+    template <class T>
+    inline bool MappedBinaryFile::GetArray(unsigned int idx, Span<const T> & out) const
+    {
+        const BinaryArrayHeader & header = GetArrayHeader(idx);
+        if (header.Type != static_cast<uint32_t>(BinaryTypeOf<T>::Value) || header.Stride != sizeof(T))
+        {
+            return false;
+        }
+
+        // Open checked the count fits in an unsigned int and the data is inside the file.
+        out = Span<const T>(reinterpret_cast<const T *>(m_pBase + header.DataOffset), static_cast<unsigned int>(header.Count));
+        return true;
+    }
+
+    template <class T>
+    inline bool MappedBinaryFile::GetArrayByTag(uint32_t tag, Span<const T> & out) const
+    {
+        const int idx = FindArray(tag);
+        if (idx < 0)
+        {
+            return false;
+        }
+        return GetArray(static_cast<unsigned int>(idx), out);
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_BINARY_INL_
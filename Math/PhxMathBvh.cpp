@@ -0,0 +1,508 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathBvh.h"
+#include "PhxMathMorton.h"
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // Deepest tree: one level per bit of the 30 bit codes and of the 32 bit indices that break ties.
+        const unsigned int MaxTraversalDepth = 64;
+
+        unsigned int CountLeadingZeros(uint32_t v)
+        {
+            DebugAssert(v != 0, "No leading one in 0.");
+#if defined(_MSC_VER)
+            unsigned long idx;
+            _BitScanReverse(&idx, v);
+            return 31 - idx;
+#else
+            return __builtin_clz(v);
+#endif
+        }
+
+        // Length of the prefix shared by the codes at i and j, -1 when j is outside the array.
+        // Equal codes are told apart by their positions, as if the position was appended to the code.
+        int CommonPrefix(const uint32_t * pCodes, unsigned int count, unsigned int i, long long j)
+        {
+            if (j < 0 || j >= static_cast<long long>(count))
+            {
+                return -1;
+            }
+
+            const uint32_t a = pCodes[i];
+            const uint32_t b = pCodes[j];
+            if (a != b)
+            {
+                return static_cast<int>(CountLeadingZeros(a ^ b));
+            }
+            return 32 + static_cast<int>(CountLeadingZeros(i ^ static_cast<uint32_t>(j)));
+        }
+
+        struct BoxTest
+        {
+            const AABB * pBox;
+
+            bool Test(const AABB & bounds) const
+            {
+                return Intersects(*pBox, bounds);
+            }
+        };
+
+        struct SphereTest
+        {
+            const Sphere * pSphere;
+
+            bool Test(const AABB & bounds) const
+            {
+                return Intersects(*pSphere, bounds);
+            }
+        };
+
+        struct FrustumTest
+        {
+            const Vector4 * pPlanes;
+            unsigned int PlaneCount;
+
+            bool Test(const AABB & bounds) const
+            {
+                for (unsigned int i = 0; i < PlaneCount; ++i)
+                {
+                    const Vector4 & plane = pPlanes[i];
+
+                    // The corner farthest along the normal. Unlike the center and extents this can't round a node
+                    // out while one of its boxes stays in, a box inside a node never has a corner farther along.
+                    const float x = (plane.X >= 0.0f) ? bounds.Max.X : bounds.Min.X;
+                    const float y = (plane.Y >= 0.0f) ? bounds.Max.Y : bounds.Min.Y;
+                    const float z = (plane.Z >= 0.0f) ? bounds.Max.Z : bounds.Min.Z;
+
+                    if (plane.X * x + plane.Y * y + plane.Z * z + plane.W < 0.0f)
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+        };
+
+        struct RayTest
+        {
+            const Ray * pRay;
+            float MaxDistance;
+
+            bool Test(const AABB & bounds) const
+            {
+                float t;
+                return Intersects(*pRay, bounds, t) && (t <= MaxDistance);
+            }
+        };
+    }
+
+    struct LinearBvh::BuildContext
+    {
+        LinearBvh * pBvh;
+        const AABB * pBoxes;
+
+        // Bounds of the centers, one per range, merged once the ranges are done.
+        AABB CenterBounds[MaxParallelTasks];
+        std::atomic<unsigned int> CenterBoundsCount;
+    };
+
+    LinearBvh::LinearBvh()
+        : m_count(0)
+        , m_pNodeVisits(nullptr)
+        , m_nodeVisitCapacity(0)
+    {
+    }
+
+    LinearBvh::~LinearBvh()
+    {
+        delete[] m_pNodeVisits;
+    }
+
+    void LinearBvh::Build(const AABB * pBoxes, unsigned int count)
+    {
+        Build(ExecutionPolicy::CreateSequential(), pBoxes, count);
+    }
+
+    void LinearBvh::Build(const ExecutionPolicy & policy, const AABB * pBoxes, unsigned int count)
+    {
+        DebugAssert(count < LeafFlag, "Too many boxes (%u) for a bvh.", count);
+
+        m_count = count;
+        const unsigned int nodeCount = (count > 0) ? (count - 1) : 0;
+
+        m_nodes.Resize(nodeCount);
+        m_nodeParents.Resize(nodeCount);
+        m_nodeRangeEnds.Resize(nodeCount);
+        if (nodeCount > m_nodeVisitCapacity)
+        {
+            // Nothing to keep, every node's count is reset when the node is emitted.
+            delete[] m_pNodeVisits;
+            m_pNodeVisits = nullptr;
+            m_nodeVisitCapacity = 0;
+
+            m_pNodeVisits = new std::atomic<unsigned int>[nodeCount];
+            m_nodeVisitCapacity = nodeCount;
+        }
+        m_leafBoxes.Resize(count);
+        m_leafIds.Resize(count);
+        m_leafParents.Resize(count);
+        m_centers.Resize(count);
+        m_codes.Resize(count);
+        m_sortedCodes.Resize(count);
+
+        if (count == 0)
+        {
+            return;
+        }
+
+        BuildContext context;
+        context.pBvh = this;
+        context.pBoxes = pBoxes;
+        context.CenterBoundsCount.store(0, std::memory_order_relaxed);
+
+        ParallelFor(policy, count, sizeof(Vector3), ComputeCentersRange, &context);
+
+        AABB centerBounds = AABB::Empty;
+        const unsigned int rangeCount = context.CenterBoundsCount.load(std::memory_order_relaxed);
+        for (unsigned int i = 0; i < rangeCount; ++i)
+        {
+            centerBounds.Merge(context.CenterBounds[i]);
+        }
+
+        // Leaves in Morton order, m_leafIds is the permutation.
+        EncodeMorton(policy, m_centers.GetData(), centerBounds, m_codes.GetData(), count);
+        SortMorton(policy, m_codes.GetData(), count, m_sortedCodes.GetData(), m_leafIds.GetData());
+
+        if (nodeCount > 0)
+        {
+            m_nodeParents[0] = InvalidIndex;
+            ParallelFor(policy, nodeCount, sizeof(Node), EmitNodesRange, &context);
+        }
+        else
+        {
+            m_leafParents[0] = InvalidIndex;
+        }
+
+        Refit(policy, pBoxes);
+    }
+
+    void LinearBvh::Refit(const AABB * pBoxes)
+    {
+        Refit(ExecutionPolicy::CreateSequential(), pBoxes);
+    }
+
+    void LinearBvh::Refit(const ExecutionPolicy & policy, const AABB * pBoxes)
+    {
+        BuildContext context;
+        context.pBvh = this;
+        context.pBoxes = pBoxes;
+
+        ParallelFor(policy, m_count, sizeof(AABB), RefitRange, &context);
+    }
+
+    void LinearBvh::ComputeCentersRange(void * pContext, unsigned int first, unsigned int count)
+    {
+        BuildContext & context = *static_cast<BuildContext *>(pContext);
+        Vector3 * pCenters = context.pBvh->m_centers.GetData();
+
+        AABB bounds = AABB::Empty;
+        for (unsigned int i = first; i < first + count; ++i)
+        {
+            pCenters[i] = context.pBoxes[i].GetCenter();
+            bounds.Merge(pCenters[i]);
+        }
+
+        context.CenterBounds[context.CenterBoundsCount.fetch_add(1, std::memory_order_relaxed)].Set(bounds);
+    }
+
+    void LinearBvh::EmitNodesRange(void * pContext, unsigned int first, unsigned int count)
+    {
+        BuildContext & context = *static_cast<BuildContext *>(pContext);
+        for (unsigned int i = first; i < first + count; ++i)
+        {
+            context.pBvh->EmitNode(i);
+        }
+    }
+
+    void LinearBvh::RefitRange(void * pContext, unsigned int first, unsigned int count)
+    {
+        BuildContext & context = *static_cast<BuildContext *>(pContext);
+        LinearBvh & bvh = *context.pBvh;
+
+        for (unsigned int leaf = first; leaf < first + count; ++leaf)
+        {
+            bvh.RefitLeaf(leaf, context.pBoxes[bvh.m_leafIds[leaf]], first, first + count);
+        }
+    }
+
+    void LinearBvh::EmitNode(unsigned int idx)
+    {
+        // Ref: Karras 2012, Figure 4 (the internal nodes are numbered so that node i starts or ends at leaf i).
+
+        const uint32_t * pCodes = m_sortedCodes.GetData();
+        const unsigned int count = m_count;
+        const long long i = idx;
+
+        // The node's range goes towards the neighbor that shares the longer prefix.
+        const int direction = (CommonPrefix(pCodes, count, idx, i + 1) - CommonPrefix(pCodes, count, idx, i - 1) > 0) ? 1 : -1;
+
+        // Every leaf in the range shares more than this with leaf i, find the other end.
+        const int minPrefix = CommonPrefix(pCodes, count, idx, i - direction);
+
+        long long maxLength = 2;
+        while (CommonPrefix(pCodes, count, idx, i + maxLength * direction) > minPrefix)
+        {
+            maxLength *= 2;
+        }
+
+        long long length = 0;
+        for (long long step = maxLength / 2; step > 0; step /= 2)
+        {
+            if (CommonPrefix(pCodes, count, idx, i + (length + step) * direction) > minPrefix)
+            {
+                length += step;
+            }
+        }
+
+        const long long j = i + length * direction;
+
+        // The split is the last leaf that shares more than the whole range does with leaf i.
+        const int nodePrefix = CommonPrefix(pCodes, count, idx, j);
+
+        long long split = 0;
+        long long step = length;
+        do
+        {
+            step = (step + 1) / 2;
+            if (CommonPrefix(pCodes, count, idx, i + (split + step) * direction) > nodePrefix)
+            {
+                split += step;
+            }
+        } while (step > 1);
+
+        const unsigned int gamma = static_cast<unsigned int>(i + split * direction + ((direction < 0) ? -1 : 0));
+        const unsigned int rangeFirst = static_cast<unsigned int>((direction > 0) ? i : j);
+        const unsigned int rangeLast = static_cast<unsigned int>((direction > 0) ? j : i);
+
+        Node & node = m_nodes[idx];
+        m_nodeRangeEnds[idx] = static_cast<unsigned int>(j);
+
+        if (rangeFirst == gamma)
+        {
+            node.Left = gamma | LeafFlag;
+            m_leafParents[gamma] = idx;
+        }
+        else
+        {
+            node.Left = gamma;
+            m_nodeParents[gamma] = idx;
+        }
+
+        if (rangeLast == gamma + 1)
+        {
+            node.Right = (gamma + 1) | LeafFlag;
+            m_leafParents[gamma + 1] = idx;
+        }
+        else
+        {
+            node.Right = gamma + 1;
+            m_nodeParents[gamma + 1] = idx;
+        }
+
+        m_pNodeVisits[idx].store(0, std::memory_order_relaxed);
+    }
+
+    void LinearBvh::RefitLeaf(unsigned int leaf, const AABB & box, unsigned int rangeFirst, unsigned int rangeEnd)
+    {
+        m_leafBoxes[leaf].Set(box);
+
+        // Every node is reached twice per refit, so the count is even before it starts and odd after the first child.
+        // The first child stops there, the second one merges both and goes up.
+        //
+        // Only the thread refitting [rangeFirst, rangeEnd) reaches the nodes whose leaves are all in it, those
+        // don't need the locked add. Most nodes are, only the ones above the ranges are shared between threads.
+        const bool wholeTree = (rangeFirst == 0 && rangeEnd == m_count);
+
+        unsigned int idx = m_leafParents[leaf];
+        while (idx != InvalidIndex)
+        {
+            bool shared = false;
+            if (false == wholeTree)
+            {
+                const unsigned int otherEnd = m_nodeRangeEnds[idx];
+                shared = (idx < otherEnd) ? (idx < rangeFirst || otherEnd >= rangeEnd) : (otherEnd < rangeFirst || idx >= rangeEnd);
+            }
+
+            std::atomic<unsigned int> & visits = m_pNodeVisits[idx];
+            unsigned int previous;
+            if (shared)
+            {
+                previous = visits.fetch_add(1, std::memory_order_acq_rel);
+            }
+            else
+            {
+                previous = visits.load(std::memory_order_relaxed);
+                visits.store(previous + 1, std::memory_order_relaxed);
+            }
+
+            if ((previous & 1) == 0)
+            {
+                return;
+            }
+
+            Node & node = m_nodes[idx];
+            const AABB & left = (node.Left & LeafFlag) ? m_leafBoxes[node.Left & ~LeafFlag] : m_nodes[node.Left].Bounds;
+            const AABB & right = (node.Right & LeafFlag) ? m_leafBoxes[node.Right & ~LeafFlag] : m_nodes[node.Right].Bounds;
+            Merge(left, right, node.Bounds);
+
+            idx = m_nodeParents[idx];
+        }
+    }
+
+    unsigned int LinearBvh::Query(const AABB & box, unsigned int * pOutIds, unsigned int maxCount) const
+    {
+        BoxTest test = { &box };
+        return Traverse(test, pOutIds, maxCount);
+    }
+
+    unsigned int LinearBvh::Query(const Sphere & sphere, unsigned int * pOutIds, unsigned int maxCount) const
+    {
+        SphereTest test = { &sphere };
+        return Traverse(test, pOutIds, maxCount);
+    }
+
+    unsigned int LinearBvh::Query(const Vector4 * pPlanes, unsigned int planeCount, unsigned int * pOutIds, unsigned int maxCount) const
+    {
+        FrustumTest test = { pPlanes, planeCount };
+        return Traverse(test, pOutIds, maxCount);
+    }
+
+    unsigned int LinearBvh::Query(const Ray & ray, float maxDistance, unsigned int * pOutIds, unsigned int maxCount) const
+    {
+        RayTest test = { &ray, maxDistance };
+        return Traverse(test, pOutIds, maxCount);
+    }
+
+    template <class Test>
+    unsigned int LinearBvh::Traverse(const Test & test, unsigned int * pOutIds, unsigned int maxCount) const
+    {
+        if (m_count == 0 || maxCount == 0)
+        {
+            return 0;
+        }
+
+        // With a single box the root is the leaf.
+        unsigned int stack[MaxTraversalDepth + 1];
+        unsigned int stackSize = 1;
+        stack[0] = (m_count == 1) ? LeafFlag : 0;
+
+        unsigned int written = 0;
+
+        while (stackSize > 0)
+        {
+            const unsigned int child = stack[--stackSize];
+
+            if (child & LeafFlag)
+            {
+                const unsigned int leaf = child & ~LeafFlag;
+                if (test.Test(m_leafBoxes[leaf]))
+                {
+                    pOutIds[written++] = m_leafIds[leaf];
+                    if (written == maxCount)
+                    {
+                        break;
+                    }
+                }
+                continue;
+            }
+
+            const Node & node = m_nodes[child];
+            if (false == test.Test(node.Bounds))
+            {
+                continue;
+            }
+
+            DebugAssert(stackSize + 2 <= MaxTraversalDepth + 1, "Bvh deeper than expected.");
+            stack[stackSize++] = node.Right;
+            stack[stackSize++] = node.Left;
+        }
+
+        return written;
+    }
+
+    unsigned int LinearBvh::GetCount() const
+    {
+        return m_count;
+    }
+
+    unsigned int LinearBvh::GetNodeCount() const
+    {
+        return m_nodes.GetCount();
+    }
+
+    void LinearBvh::GetBounds(AABB & out) const
+    {
+        if (m_count == 0)
+        {
+            out.Set(AABB::Empty);
+        }
+        else if (m_count == 1)
+        {
+            out.Set(m_leafBoxes[0]);
+        }
+        else
+        {
+            out.Set(m_nodes[0].Bounds);
+        }
+    }
+
+    const LinearBvh::Node * LinearBvh::GetNodes() const
+    {
+        return m_nodes.GetData();
+    }
+
+    const AABB * LinearBvh::GetLeafBoxes() const
+    {
+        return m_leafBoxes.GetData();
+    }
+
+    const unsigned int * LinearBvh::GetLeafIds() const
+    {
+        return m_leafIds.GetData();
+    }
+
+} //namespace Math
+} //namespace Phx
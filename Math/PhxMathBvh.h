@@ -0,0 +1,159 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_BVH_H_
+#define _PHX_MATH_BVH_H_
+
+#include "PhxMathExecution.h"
+
+// C Standard Library Includes
+#include <stdint.h>
+
+// C++ Standard Library Includes
+#include <atomic>
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Linear Bounding Volume Hierarchy
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Binary BVH over boxes, built fast enough to be rebuilt every frame for
+// scenes where everything moves. The boxes are sorted by the Morton code
+// of their centers (PhxMathMorton.h) and the tree is the binary radix
+// tree of the sorted codes: every internal node splits its range of boxes
+// where the highest bit that differs between its codes changes.
+//
+// Every step is parallel: the codes, the radix sort, the internal nodes
+// (each one finds its own range and split from the codes around it, so
+// they are all written at once) and the bounds, which are merged from the
+// leaves up with one counter per node, the second child to arrive merges
+// the node and goes on to the parent.
+//
+// The tree is only as good as the Morton order, queries visit more nodes
+// than in a SAH tree. Refit keeps the tree and only recomputes the bounds,
+// for boxes that moved a little since the build.
+//
+// Ref: Tero Karras, Maximizing Parallelism in the Construction of BVHs,
+//      Octrees, and k-d Trees (HPG 2012)
+//
+// Boxes are identified by their index in the array passed to Build,
+// queries write the indices of the boxes they find in no particular
+// order, stop after maxCount and return the number written.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    class LinearBvh
+    {
+    public:
+        static const unsigned int InvalidIndex = 0xFFFFFFFF;
+
+        // Set on a child index when the child is a leaf (a box), the rest is the leaf index.
+        static const unsigned int LeafFlag = 0x80000000;
+
+        // Internal node, there are count - 1 of them and node 0 is the root.
+        struct Node
+        {
+            AABB Bounds;
+            unsigned int Left;
+            unsigned int Right;
+        };
+
+    public:
+        LinearBvh();
+        ~LinearBvh();
+
+        // The boxes are copied, pBoxes does not have to outlive the build.
+        // The tree does not depend on the policy.
+        void Build(const AABB * pBoxes, unsigned int count);
+        void Build(const ExecutionPolicy & policy, const AABB * pBoxes, unsigned int count);
+
+        // Same boxes as the last Build (same count, same order) at new positions.
+        void Refit(const AABB * pBoxes);
+        void Refit(const ExecutionPolicy & policy, const AABB * pBoxes);
+
+        // Boxes that touch the volume.
+        unsigned int Query(const AABB & box, unsigned int * pOutIds, unsigned int maxCount) const;
+        unsigned int Query(const Sphere & sphere, unsigned int * pOutIds, unsigned int maxCount) const;
+
+        // Planes are (normal, d) with the normals pointing inside the volume, see LooseOctree.
+        unsigned int Query(const Vector4 * pPlanes, unsigned int planeCount, unsigned int * pOutIds, unsigned int maxCount) const;
+
+        // Boxes the ray hits within maxDistance (in multiples of the ray direction length).
+        unsigned int Query(const Ray & ray, float maxDistance, unsigned int * pOutIds, unsigned int maxCount) const;
+
+        unsigned int GetCount() const;
+        unsigned int GetNodeCount() const;
+
+        // Bounds of every box, empty when there are none.
+        void GetBounds(AABB & out) const;
+
+        // For custom traversals. Leaf i is the box GetLeafIds()[i] of the build, with bounds GetLeafBoxes()[i].
+        const Node * GetNodes() const;
+        const AABB * GetLeafBoxes() const;
+        const unsigned int * GetLeafIds() const;
+
+    private:
+        // Non-copyable.
+        LinearBvh(const LinearBvh &);
+        LinearBvh & operator=(const LinearBvh &);
+
+        struct BuildContext;
+        static void ComputeCentersRange(void * pContext, unsigned int first, unsigned int count);
+        static void EmitNodesRange(void * pContext, unsigned int first, unsigned int count);
+        static void RefitRange(void * pContext, unsigned int first, unsigned int count);
+
+        void EmitNode(unsigned int idx);
+        void RefitLeaf(unsigned int leaf, const AABB & box, unsigned int rangeFirst, unsigned int rangeEnd);
+
+        template <class Test>
+        unsigned int Traverse(const Test & test, unsigned int * pOutIds, unsigned int maxCount) const;
+
+    private:
+        unsigned int m_count;
+
+        AlignedArray<Node> m_nodes;
+        AlignedArray<unsigned int> m_nodeParents;       // InvalidIndex for the root.
+        AlignedArray<unsigned int> m_nodeRangeEnds;     // Node i covers the leaves from i to this one (either way).
+
+        // Children that reached the node in a refit, the parity tells the first from the second. Allocated with
+        // new[] rather than as an AlignedArray, which only holds plain data and would copy the atomics with memcpy.
+        std::atomic<unsigned int> * m_pNodeVisits;
+        unsigned int m_nodeVisitCapacity;
+
+        AlignedArray<AABB> m_leafBoxes;                 // In Morton order.
+        AlignedArray<unsigned int> m_leafIds;           // Index of the box in the build.
+        AlignedArray<unsigned int> m_leafParents;
+
+        // Build scratch.
+        AlignedArray<Vector3> m_centers;
+        AlignedArray<uint32_t> m_codes;
+        AlignedArray<uint32_t> m_sortedCodes;
+    };
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_BVH_H_
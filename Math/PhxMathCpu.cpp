@@ -0,0 +1,270 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathCpu.h"
+
+#if PHX_MATH_X86
+# if defined(_MSC_VER)
+#  include <intrin.h>
+# else
+#  include <cpuid.h>
+# endif
+#endif
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+#if PHX_MATH_X86
+        void CpuId(unsigned int leaf, unsigned int subLeaf, unsigned int outRegisters[4])
+        {
+# if defined(_MSC_VER)
+            int registers[4];
+            __cpuidex(registers, static_cast<int>(leaf), static_cast<int>(subLeaf));
+            for (unsigned int i = 0; i < 4; ++i)
+            {
+                outRegisters[i] = static_cast<unsigned int>(registers[i]);
+            }
+# else
+            __cpuid_count(leaf, subLeaf, outRegisters[0], outRegisters[1], outRegisters[2], outRegisters[3]);
+# endif
+        }
+
+        unsigned long long ReadXCR0()
+        {
+# if defined(_MSC_VER)
+            return _xgetbv(0);
+# else
+            unsigned int eax, edx;
+            __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (static_cast<unsigned long long>(edx) << 32) | eax;
+# endif
+        }
+#endif
+
+        CpuFeatures DetectCpuFeatures()
+        {
+            CpuFeatures features;
+            memset(&features, 0, sizeof(CpuFeatures));
+
+#if PHX_MATH_X86
+            // Ref: Intel 64 and IA-32 Architectures Software Developer's Manual, Vol 2A, CPUID
+            //      Intel 64 and IA-32 Architectures Software Developer's Manual, Vol 1, 13.2 (XSAVE supported features)
+
+            unsigned int registers[4];
+
+            CpuId(0, 0, registers);
+            const unsigned int maxLeaf = registers[0];
+            if (maxLeaf < 1)
+            {
+                return features;
+            }
+
+            CpuId(1, 0, registers);
+            const unsigned int ecx1 = registers[2];
+
+            features.SSE42 = (ecx1 & (1u << 20)) != 0;
+
+            // The OS has to save the wider registers on a context switch, otherwise the instructions can't be used.
+            const bool osxsave = (ecx1 & (1u << 27)) != 0;
+            const unsigned long long xcr0 = osxsave ? ReadXCR0() : 0;
+            const bool osAVX = (xcr0 & 0x06) == 0x06;          // XMM and YMM state
+            const bool osAVX512 = (xcr0 & 0xE6) == 0xE6;       // XMM, YMM, opmask, ZMM_Hi256 and Hi16_ZMM state
+
+            features.AVX = osAVX && (ecx1 & (1u << 28)) != 0;
+            features.FMA = osAVX && (ecx1 & (1u << 12)) != 0;
+            features.F16C = osAVX && (ecx1 & (1u << 29)) != 0;
+
+            if (maxLeaf >= 7)
+            {
+                CpuId(7, 0, registers);
+                const unsigned int ebx7 = registers[1];
+
+                features.AVX2 = osAVX && (ebx7 & (1u << 5)) != 0;
+                features.BMI2 = (ebx7 & (1u << 8)) != 0;
+                features.AVX512F = osAVX512 && (ebx7 & (1u << 16)) != 0;
+                features.AVX512DQ = osAVX512 && (ebx7 & (1u << 17)) != 0;
+                features.AVX512BW = osAVX512 && (ebx7 & (1u << 30)) != 0;
+                features.AVX512VL = osAVX512 && (ebx7 & (1u << 31)) != 0;
+            }
+#endif
+
+            return features;
+        }
+
+        CpuCacheSizes DetectCpuCacheSizes()
+        {
+            CpuCacheSizes sizes;
+            sizes.L1Data = 32 * 1024;
+            sizes.L2 = 256 * 1024;
+
+#if PHX_MATH_X86
+            // Ref: Intel 64 and IA-32 Architectures Software Developer's Manual, Vol 2A, CPUID leaf 04H
+            //      AMD64 Architecture Programmer's Manual, Vol 3, CPUID Fn8000_001D (same layout as leaf 04H)
+
+            unsigned int registers[4];
+
+            CpuId(0, 0, registers);
+            const unsigned int maxLeaf = registers[0];
+            CpuId(0x80000000, 0, registers);
+            const unsigned int maxExtendedLeaf = registers[0];
+
+            unsigned int cacheLeaf = 0;
+            if (maxLeaf >= 4)
+            {
+                CpuId(4, 0, registers);
+                if ((registers[0] & 0x1F) != 0)
+                {
+                    cacheLeaf = 4;
+                }
+            }
+            if (cacheLeaf == 0 && maxExtendedLeaf >= 0x8000001D)
+            {
+                CpuId(0x8000001D, 0, registers);
+                if ((registers[0] & 0x1F) != 0)
+                {
+                    cacheLeaf = 0x8000001D;
+                }
+            }
+            if (cacheLeaf == 0)
+            {
+                return sizes;
+            }
+
+            for (unsigned int subLeaf = 0; subLeaf < 16; ++subLeaf)
+            {
+                CpuId(cacheLeaf, subLeaf, registers);
+
+                const unsigned int type = registers[0] & 0x1F;     // 1 = data, 2 = instruction, 3 = unified
+                if (type == 0)
+                {
+                    break;
+                }
+
+                const unsigned int level = (registers[0] >> 5) & 0x7;
+                const unsigned int ways = ((registers[1] >> 22) & 0x3FF) + 1;
+                const unsigned int partitions = ((registers[1] >> 12) & 0x3FF) + 1;
+                const unsigned int lineSize = (registers[1] & 0xFFF) + 1;
+                const unsigned int sets = registers[2] + 1;
+                const unsigned int size = ways * partitions * lineSize * sets;
+
+                if (level == 1 && type == 1)
+                {
+                    sizes.L1Data = size;
+                }
+                else if (level == 2 && type != 2)
+                {
+                    sizes.L2 = size;
+                }
+            }
+#endif
+
+            return sizes;
+        }
+
+        const char * const s_tierNames[CpuTier::Count] =
+        {
+            "scalar",
+            "sse42",
+            "avx2",
+            "avx512",
+        };
+    }
+
+    const CpuFeatures & GetCpuFeatures()
+    {
+        static const CpuFeatures s_features = DetectCpuFeatures();
+        return s_features;
+    }
+
+    const CpuCacheSizes & GetCpuCacheSizes()
+    {
+        static const CpuCacheSizes s_sizes = DetectCpuCacheSizes();
+        return s_sizes;
+    }
+
+    CpuTier::Type GetHighestCpuTier()
+    {
+        const CpuFeatures & features = GetCpuFeatures();
+
+        if (features.AVX512F && features.AVX512VL && features.AVX512BW && features.AVX512DQ && features.AVX2 && features.FMA && features.F16C)
+        {
+            return CpuTier::AVX512;
+        }
+        if (features.AVX2 && features.FMA && features.F16C)
+        {
+            return CpuTier::AVX2;
+        }
+        if (features.SSE42)
+        {
+            return CpuTier::SSE42;
+        }
+        return CpuTier::Scalar;
+    }
+
+    bool IsCpuTierSupported(CpuTier::Type tier)
+    {
+        return (tier >= CpuTier::Scalar && tier <= GetHighestCpuTier());
+    }
+
+    const char * GetCpuTierName(CpuTier::Type tier)
+    {
+        DebugAssert(tier >= CpuTier::Scalar && tier < CpuTier::Count, "Invalid cpu tier (%d)!", tier);
+        return s_tierNames[tier];
+    }
+
+    bool ParseCpuTier(const char * pName, CpuTier::Type & outTier)
+    {
+        if (pName == nullptr)
+        {
+            return false;
+        }
+
+        for (int i = 0; i < CpuTier::Count; ++i)
+        {
+            const char * pTierName = s_tierNames[i];
+
+            // Case insensitive compare, tier names are all lower case.
+            const char * p = pName;
+            while (*p != '\0' && *pTierName != '\0' && (*p | 0x20) == *pTierName)
+            {
+                ++p;
+                ++pTierName;
+            }
+
+            if (*p == '\0' && *pTierName == '\0')
+            {
+                outTier = static_cast<CpuTier::Type>(i);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+} //namespace Math
+} //namespace Phx
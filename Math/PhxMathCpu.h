@@ -0,0 +1,108 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_CPU_H_
+#define _PHX_MATH_CPU_H_
+
+#include "PhxMath.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+# define PHX_MATH_X86 1
+#else
+# define PHX_MATH_X86 0
+#endif
+
+// Marks a function as being compiled for an instruction set above the one the file is built with.
+// Only the functions that are called after a runtime check use this, so one binary can run on every tier.
+// MSVC allows any intrinsic without a flag, gcc and clang need the target attribute.
+#if defined(__GNUC__) || defined(__clang__)
+# define PHX_TARGET(features) __attribute__((target(features)))
+#else
+# define PHX_TARGET(features)
+#endif
+
+namespace Phx {
+namespace Math {
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Instruction set tiers the batch kernels are built for.
+    // Each tier implies all of the tiers below it.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    //   Scalar - Plain C++, runs everywhere.
+    //   SSE42  - SSE up to SSE4.2.
+    //   AVX2   - AVX2 + FMA3 + F16C.
+    //   AVX512 - AVX-512 F, VL, BW and DQ.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    namespace CpuTier
+    {
+        enum Type
+        {
+            Scalar,
+            SSE42,
+            AVX2,
+            AVX512,
+
+            Count
+        };
+    }
+
+    struct CpuFeatures
+    {
+        bool SSE42;
+        bool AVX;
+        bool AVX2;
+        bool FMA;
+        bool F16C;
+        bool BMI2;
+        bool AVX512F;
+        bool AVX512VL;
+        bool AVX512BW;
+        bool AVX512DQ;
+    };
+
+    // Per core cache sizes in bytes.
+    struct CpuCacheSizes
+    {
+        unsigned int L1Data;
+        unsigned int L2;
+    };
+
+    const CpuFeatures & GetCpuFeatures();
+
+    // Falls back to 32KB L1 and 256KB L2 when the sizes can't be read.
+    const CpuCacheSizes & GetCpuCacheSizes();
+
+    CpuTier::Type GetHighestCpuTier();
+    bool IsCpuTierSupported(CpuTier::Type tier);
+
+    const char * GetCpuTierName(CpuTier::Type tier);
+    bool ParseCpuTier(const char * pName, CpuTier::Type & outTier);
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_CPU_H_
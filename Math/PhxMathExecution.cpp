@@ -0,0 +1,285 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathExecution.h"
+
+// C++ Standard Library Includes
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // Set on the pool worker threads, and on the calling thread while it runs tasks.
+        thread_local bool t_runningPoolTask = false;
+
+        // More tasks than threads so a thread that gets descheduled doesn't hold up the whole range.
+        const unsigned int TasksPerThread = 4;
+
+        struct ParallelForContext
+        {
+            ParallelRangeFunction Function;
+            void * pContext;
+            unsigned int Count;
+            unsigned int ElementsPerTask;
+        };
+
+        void RunParallelForTask(void * pContext, unsigned int taskIndex)
+        {
+            const ParallelForContext & context = *static_cast<const ParallelForContext *>(pContext);
+
+            const unsigned int first = taskIndex * context.ElementsPerTask;
+            const unsigned int remaining = context.Count - first;
+            context.Function(context.pContext, first, (remaining < context.ElementsPerTask) ? remaining : context.ElementsPerTask);
+        }
+
+        size_t GreatestCommonDivisor(size_t a, size_t b)
+        {
+            while (b != 0)
+            {
+                const size_t r = a % b;
+                a = b;
+                b = r;
+            }
+            return a;
+        }
+    }
+
+    struct ThreadPool::State
+    {
+        std::vector<std::thread> Workers;
+
+        std::mutex RunMutex;                // Held for the whole of a Run.
+
+        std::mutex Mutex;                   // Guards everything below.
+        std::condition_variable WakeWorkers;
+        std::condition_variable WorkersDone;
+        unsigned long long Generation;
+        unsigned int WorkersFinished;
+        bool Stop;
+
+        ParallelTaskFunction Task;
+        void * pContext;
+        unsigned int TaskCount;
+        std::atomic<unsigned int> NextTask;
+
+        void RunTasks()
+        {
+            for (;;)
+            {
+                const unsigned int taskIndex = NextTask.fetch_add(1, std::memory_order_relaxed);
+                if (taskIndex >= TaskCount)
+                {
+                    return;
+                }
+                Task(pContext, taskIndex);
+            }
+        }
+
+        void WorkerLoop()
+        {
+            t_runningPoolTask = true;
+
+            unsigned long long seenGeneration = 0;
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(Mutex);
+                    WakeWorkers.wait(lock, [&] { return Stop || Generation != seenGeneration; });
+                    if (Stop)
+                    {
+                        return;
+                    }
+                    seenGeneration = Generation;
+                }
+
+                RunTasks();
+
+                // Every worker checks in for every Run, so the job can't change under a worker still in RunTasks.
+                std::lock_guard<std::mutex> lock(Mutex);
+                if (++WorkersFinished == Workers.size())
+                {
+                    WorkersDone.notify_one();
+                }
+            }
+        }
+    };
+
+    ThreadPool::ThreadPool(unsigned int threadCount)
+        : m_pState(new State())
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::thread::hardware_concurrency();
+        }
+
+        m_pState->Generation = 0;
+        m_pState->WorkersFinished = 0;
+        m_pState->Stop = false;
+        m_pState->Task = nullptr;
+        m_pState->pContext = nullptr;
+        m_pState->TaskCount = 0;
+        m_pState->NextTask.store(0);
+
+        for (unsigned int i = 1; i < threadCount; ++i)
+        {
+            m_pState->Workers.push_back(std::thread(&State::WorkerLoop, m_pState));
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_pState->Mutex);
+            m_pState->Stop = true;
+        }
+        m_pState->WakeWorkers.notify_all();
+
+        for (size_t i = 0; i < m_pState->Workers.size(); ++i)
+        {
+            m_pState->Workers[i].join();
+        }
+
+        delete m_pState;
+    }
+
+    void ThreadPool::Run(ParallelTaskFunction task, void * pContext, unsigned int taskCount)
+    {
+        if (t_runningPoolTask || m_pState->Workers.empty() || taskCount <= 1)
+        {
+            for (unsigned int i = 0; i < taskCount; ++i)
+            {
+                task(pContext, i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> runLock(m_pState->RunMutex);
+
+        {
+            std::lock_guard<std::mutex> lock(m_pState->Mutex);
+            m_pState->Task = task;
+            m_pState->pContext = pContext;
+            m_pState->TaskCount = taskCount;
+            m_pState->NextTask.store(0, std::memory_order_relaxed);
+            m_pState->WorkersFinished = 0;
+            ++m_pState->Generation;
+        }
+        m_pState->WakeWorkers.notify_all();
+
+        t_runningPoolTask = true;
+        m_pState->RunTasks();
+        t_runningPoolTask = false;
+
+        std::unique_lock<std::mutex> lock(m_pState->Mutex);
+        m_pState->WorkersDone.wait(lock, [&] { return m_pState->WorkersFinished == m_pState->Workers.size(); });
+    }
+
+    unsigned int ThreadPool::GetThreadCount() const
+    {
+        return static_cast<unsigned int>(m_pState->Workers.size()) + 1;
+    }
+
+    ThreadPool & GetDefaultThreadPool()
+    {
+        static ThreadPool s_threadPool;
+        return s_threadPool;
+    }
+
+    void ParallelFor(const ExecutionPolicy & policy, unsigned int count, size_t outputElementSize, ParallelRangeFunction function, void * pContext)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        ThreadPool * pThreadPool = nullptr;
+        unsigned int threadCount = 1;
+
+        switch (policy.Mode)
+        {
+        case ExecutionMode::Sequential:
+            break;
+
+        case ExecutionMode::ThreadPool:
+            pThreadPool = (policy.pThreadPool != nullptr) ? policy.pThreadPool : &GetDefaultThreadPool();
+            threadCount = pThreadPool->GetThreadCount();
+            break;
+
+        case ExecutionMode::Executor:
+            DebugAssert(policy.Executor != nullptr, "Executor execution policy without an executor!");
+            threadCount = policy.ExecutorThreadCount;
+            break;
+        }
+
+        const unsigned int minElementsPerTask = (policy.MinElementsPerTask > 0) ? policy.MinElementsPerTask : 1;
+        if (threadCount <= 1 || count / 2 < minElementsPerTask)
+        {
+            function(pContext, 0, count);
+            return;
+        }
+
+        unsigned int taskCount = threadCount * TasksPerThread;
+        if (taskCount > count / minElementsPerTask)
+        {
+            taskCount = count / minElementsPerTask;
+        }
+        if (taskCount > MaxParallelTasks)
+        {
+            taskCount = MaxParallelTasks;
+        }
+
+        // Round the task size up to a whole number of cache lines worth of output elements.
+        const size_t elementSize = (outputElementSize > 0) ? outputElementSize : 1;
+        const unsigned int granularity = static_cast<unsigned int>(PHX_CACHE_LINE_SIZE / GreatestCommonDivisor(elementSize, PHX_CACHE_LINE_SIZE));
+
+        unsigned int elementsPerTask = (count + taskCount - 1) / taskCount;
+        elementsPerTask = ((elementsPerTask + granularity - 1) / granularity) * granularity;
+        taskCount = (count + elementsPerTask - 1) / elementsPerTask;
+
+        ParallelForContext context;
+        context.Function = function;
+        context.pContext = pContext;
+        context.Count = count;
+        context.ElementsPerTask = elementsPerTask;
+
+        if (pThreadPool != nullptr)
+        {
+            pThreadPool->Run(RunParallelForTask, &context, taskCount);
+        }
+        else
+        {
+            policy.Executor(policy.pExecutorData, RunParallelForTask, &context, taskCount);
+        }
+    }
+
+} //namespace Math
+} //namespace Phx
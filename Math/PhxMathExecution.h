@@ -0,0 +1,135 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_EXECUTION_H_
+#define _PHX_MATH_EXECUTION_H_
+
+#include "PhxMathMemory.h"
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Execution Policies
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Selects how an array operation is spread over threads:
+//
+//   Sequential - On the calling thread.
+//   ThreadPool - On a PhxMath ThreadPool, the calling thread works too.
+//   Executor   - Through the caller's own job system, see ExecutorFunction.
+//
+// The range is split into tasks that start on a cache line boundary of the
+// output array, so as long as the output array is cache line aligned
+// (AlignedAlloc, AlignedArray) no two tasks write to the same cache line.
+// Ranges smaller than two tasks worth of elements run on the calling thread.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    class ThreadPool;
+
+    namespace ExecutionMode
+    {
+        enum Type
+        {
+            Sequential,
+            ThreadPool,
+            Executor,
+        };
+    }
+
+    // Runs elements [first, first + count).
+    typedef void (*ParallelRangeFunction)(void * pContext, unsigned int first, unsigned int count);
+
+    // Task taskIndex of a ParallelFor.
+    typedef void (*ParallelTaskFunction)(void * pContext, unsigned int taskIndex);
+
+    // Has to run task(pTaskContext, i) for every i in [0, taskCount), in any order and on any threads,
+    // and only return once they have all finished.
+    typedef void (*ExecutorFunction)(void * pExecutorData, ParallelTaskFunction task, void * pTaskContext, unsigned int taskCount);
+
+    struct ExecutionPolicy
+    {
+        ExecutionMode::Type Mode;
+
+        ThreadPool * pThreadPool;           // ThreadPool, nullptr for the default pool.
+
+        ExecutorFunction Executor;          // Executor
+        void * pExecutorData;
+        unsigned int ExecutorThreadCount;   // Threads the executor runs tasks on, used to pick the number of tasks.
+
+        unsigned int MinElementsPerTask;
+
+        static inline ExecutionPolicy CreateSequential();
+        static inline ExecutionPolicy CreateThreadPool(ThreadPool * pThreadPool = nullptr);
+        static inline ExecutionPolicy CreateExecutor(ExecutorFunction executor, void * pExecutorData, unsigned int threadCount);
+    };
+
+    const unsigned int DefaultMinElementsPerTask = 1024;
+
+    // A ParallelFor never splits a range into more tasks than this.
+    const unsigned int MaxParallelTasks = 256;
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Fixed set of worker threads that run one ParallelFor at a time.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Run calls from different threads are serialized. A Run started from a
+    // task already running on a pool runs its tasks on the calling thread
+    // instead of waiting on the pool.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    class ThreadPool
+    {
+    public:
+        // 0 uses every hardware thread. The calling thread is one of the threads, so threadCount - 1 workers are started.
+        explicit ThreadPool(unsigned int threadCount = 0);
+        ~ThreadPool();
+
+        void Run(ParallelTaskFunction task, void * pContext, unsigned int taskCount);
+
+        // Includes the thread calling Run.
+        unsigned int GetThreadCount() const;
+
+    private:
+        // Non-copyable.
+        ThreadPool(const ThreadPool &);
+        ThreadPool & operator=(const ThreadPool &);
+
+    private:
+        struct State;
+        State * m_pState;
+    };
+
+    // Created on first use with every hardware thread.
+    ThreadPool & GetDefaultThreadPool();
+
+    // Splits [0, count) into at most MaxParallelTasks cache line aligned ranges of the output array (elements of outputElementSize bytes).
+    void ParallelFor(const ExecutionPolicy & policy, unsigned int count, size_t outputElementSize, ParallelRangeFunction function, void * pContext);
+
+} //namespace Math
+} //namespace Phx
+
+#include "PhxMathExecution.inl"
+
+#endif //_PHX_MATH_EXECUTION_H_
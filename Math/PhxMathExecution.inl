@@ -0,0 +1,68 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_EXECUTION_INL_
+#define _PHX_MATH_EXECUTION_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline ExecutionPolicy ExecutionPolicy::CreateSequential()
+    {
+        ExecutionPolicy policy;
+        policy.Mode = ExecutionMode::Sequential;
+        policy.pThreadPool = nullptr;
+        policy.Executor = nullptr;
+        policy.pExecutorData = nullptr;
+        policy.ExecutorThreadCount = 1;
+        policy.MinElementsPerTask = DefaultMinElementsPerTask;
+        return policy;
+    }
+
+    inline ExecutionPolicy ExecutionPolicy::CreateThreadPool(ThreadPool * pThreadPool)
+    {
+        ExecutionPolicy policy = CreateSequential();
+        policy.Mode = ExecutionMode::ThreadPool;
+        policy.pThreadPool = pThreadPool;
+        return policy;
+    }
+
+    inline ExecutionPolicy ExecutionPolicy::CreateExecutor(ExecutorFunction executor, void * pExecutorData, unsigned int threadCount)
+    {
+        DebugAssert(executor != nullptr, "Trying to create an execution policy without an executor!");
+
+        ExecutionPolicy policy = CreateSequential();
+        policy.Mode = ExecutionMode::Executor;
+        policy.Executor = executor;
+        policy.pExecutorData = pExecutorData;
+        policy.ExecutorThreadCount = threadCount;
+        return policy;
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_EXECUTION_INL_
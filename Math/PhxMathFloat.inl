@@ -68,11 +68,15 @@ namespace Math {
 
     inline float Sin(float radians)
     {
+        PHX_MATH_SHADOW_CALL(Sin, ShadowSin(radians));
+
         return sinf(radians);
     }
 
     inline float Cos(float radians)
     {
+        PHX_MATH_SHADOW_CALL(Cos, ShadowCos(radians));
+
         return cosf(radians);
     }
 
@@ -84,11 +88,15 @@ namespace Math {
 
     inline float Tan(float radians)
     {
+        PHX_MATH_SHADOW_CALL(Tan, ShadowTan(radians));
+
         return tanf(radians);
     }
 
     inline float ASin(float f)
     {
+        PHX_MATH_SHADOW_CALL(ASin, ShadowASin(f));
+
         if (f < 1.0f)
         {
             if (f > -1.0f)
@@ -108,6 +116,8 @@ namespace Math {
 
     inline float ACos(float f)
     {
+        PHX_MATH_SHADOW_CALL(ACos, ShadowACos(f));
+
         if (f < 1.0f)
         {
             if (f > -1.0f)
@@ -127,11 +137,15 @@ namespace Math {
     
     inline float ATan(float f)
     {
+        PHX_MATH_SHADOW_CALL(ATan, ShadowATan(f));
+
         return atanf(f);
     }
 
     inline float ATan2(float y, float x)
     {
+        PHX_MATH_SHADOW_CALL(ATan2, ShadowATan2(y, x));
+
         if (y == 0.0f && x == 0.0f)
         {
             DebugAssert(false, "Atan2(0,0) is undefined!");
@@ -186,6 +200,8 @@ namespace Math {
 
     inline float InvSqrt(float f)
     {
+        PHX_MATH_SHADOW_CALL(InvSqrt, ShadowInvSqrt(f));
+
         // TODO: perhaps implement something like this
         // http://stackoverflow.com/questions/17789928/fast-inverse-square-root-algorithm-in-modern-c
 
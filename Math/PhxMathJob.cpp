@@ -0,0 +1,260 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathJob.h"
+
+namespace Phx {
+namespace Math {
+
+    BatchJob::BatchJob()
+        : m_type(JobCustom)
+        , m_function(nullptr)
+        , m_pContext(nullptr)
+        , m_pIn(nullptr)
+        , m_pOut(nullptr)
+        , m_count(0)
+        , m_chunkSize(DefaultChunkSize)
+        , m_progressFunction(nullptr)
+        , m_pProgressData(nullptr)
+        , m_processed(0)
+        , m_failed(0)
+        , m_status(JobStatus::Empty)
+        , m_cancelRequested(false)
+    {
+        m_scheduler.Post = nullptr;
+        m_scheduler.pSchedulerData = nullptr;
+    }
+
+    void BatchJob::Initialize(JobType type, const void * pIn, void * pOut, unsigned int count)
+    {
+        DebugAssert(false == (GetStatus() == JobStatus::Running), "Trying to initialize a job that is running!");
+
+        m_type = type;
+        m_pIn = pIn;
+        m_pOut = pOut;
+        m_count = count;
+        m_processed.store(0, std::memory_order_relaxed);
+        m_failed.store(0, std::memory_order_relaxed);
+        m_cancelRequested.store(false, std::memory_order_relaxed);
+        m_status.store(JobStatus::Pending, std::memory_order_release);
+    }
+
+    void BatchJob::InitializeCustom(ChunkFunction function, void * pContext, unsigned int count)
+    {
+        DebugAssert(function != nullptr, "Trying to initialize a job without a function!");
+
+        m_function = function;
+        m_pContext = pContext;
+        Initialize(JobCustom, nullptr, nullptr, count);
+    }
+
+    void BatchJob::InitializeTransform(const Vector3 * pIn, const Matrix4x4 & m, Vector3 * pOut, unsigned int count)
+    {
+        m_matrix = m;
+        Initialize(JobTransformVector3, pIn, pOut, count);
+    }
+
+    void BatchJob::InitializeTransform(const Vector4 * pIn, const Matrix4x4 & m, Vector4 * pOut, unsigned int count)
+    {
+        m_matrix = m;
+        Initialize(JobTransformVector4, pIn, pOut, count);
+    }
+
+    void BatchJob::InitializeDecompose(const Matrix4x4 * pIn, TransformSRT * pOut, unsigned int count)
+    {
+        Initialize(JobDecompose, pIn, pOut, count);
+    }
+
+    void BatchJob::InitializePack(const Vector3 * pIn, Vector3h * pOut, unsigned int count)
+    {
+        Initialize(JobPackVector3Half, pIn, pOut, count);
+    }
+
+    void BatchJob::InitializePack(const Vector4 * pIn, Vector4h * pOut, unsigned int count)
+    {
+        Initialize(JobPackVector4Half, pIn, pOut, count);
+    }
+
+    void BatchJob::InitializePack(const Vector3 * pNormals, OctahedralNormal * pOut, unsigned int count)
+    {
+        Initialize(JobPackOctahedral, pNormals, pOut, count);
+    }
+
+    void BatchJob::SetChunkSize(unsigned int chunkSize)
+    {
+        DebugAssert(chunkSize > 0, "A job's chunk size can't be zero!");
+        m_chunkSize = chunkSize;
+    }
+
+    void BatchJob::SetProgressCallback(ProgressFunction function, void * pUserData)
+    {
+        m_progressFunction = function;
+        m_pProgressData = pUserData;
+    }
+
+    bool BatchJob::Step()
+    {
+        const JobStatus::Type status = GetStatus();
+        DebugAssert(status != JobStatus::Empty, "Trying to run a job that wasn't initialized!");
+        if (status == JobStatus::Empty || status == JobStatus::Completed || status == JobStatus::Cancelled)
+        {
+            return false;
+        }
+
+        if (m_cancelRequested.load(std::memory_order_acquire))
+        {
+            m_status.store(JobStatus::Cancelled, std::memory_order_release);
+            return false;
+        }
+
+        m_status.store(JobStatus::Running, std::memory_order_relaxed);
+
+        const unsigned int first = m_processed.load(std::memory_order_relaxed);
+        const unsigned int remaining = m_count - first;
+        const unsigned int count = (remaining < m_chunkSize) ? remaining : m_chunkSize;
+
+        RunChunk(first, count);
+        m_processed.store(first + count, std::memory_order_relaxed);
+
+        if (m_progressFunction != nullptr)
+        {
+            m_progressFunction(m_pProgressData, *this);
+        }
+
+        if (first + count == m_count)
+        {
+            m_status.store(JobStatus::Completed, std::memory_order_release);
+            return false;
+        }
+        return true;
+    }
+
+    void BatchJob::Run()
+    {
+        while (Step())
+        {
+        }
+    }
+
+    void BatchJob::Cancel()
+    {
+        m_cancelRequested.store(true, std::memory_order_release);
+    }
+
+    void BatchJob::RunChunk(unsigned int first, unsigned int count)
+    {
+        switch (m_type)
+        {
+        case JobCustom:
+            m_function(m_pContext, first, count);
+            break;
+
+        case JobTransformVector3:
+            Transform(static_cast<const Vector3 *>(m_pIn) + first, m_matrix, static_cast<Vector3 *>(m_pOut) + first, count);
+            break;
+
+        case JobTransformVector4:
+            Transform(static_cast<const Vector4 *>(m_pIn) + first, m_matrix, static_cast<Vector4 *>(m_pOut) + first, count);
+            break;
+
+        case JobDecompose:
+            {
+                const Matrix4x4 * pIn = static_cast<const Matrix4x4 *>(m_pIn) + first;
+                TransformSRT * pOut = static_cast<TransformSRT *>(m_pOut) + first;
+
+                unsigned int failed = 0;
+                for (unsigned int i = 0; i < count; ++i)
+                {
+                    if (false == ToTransformSRT(pIn[i], pOut[i]))
+                    {
+                        ++failed;
+                    }
+                }
+                m_failed.fetch_add(failed, std::memory_order_relaxed);
+            }
+            break;
+
+        case JobPackVector3Half:
+            Pack(static_cast<const Vector3 *>(m_pIn) + first, static_cast<Vector3h *>(m_pOut) + first, count);
+            break;
+
+        case JobPackVector4Half:
+            Pack(static_cast<const Vector4 *>(m_pIn) + first, static_cast<Vector4h *>(m_pOut) + first, count);
+            break;
+
+        case JobPackOctahedral:
+            Pack(static_cast<const Vector3 *>(m_pIn) + first, static_cast<OctahedralNormal *>(m_pOut) + first, count);
+            break;
+        }
+    }
+
+    void BatchJob::RunScheduledChunk(void * pJob)
+    {
+        BatchJob & job = *static_cast<BatchJob *>(pJob);
+        if (job.Step())
+        {
+            job.m_scheduler.Post(job.m_scheduler.pSchedulerData, RunScheduledChunk, &job);
+        }
+    }
+
+    void StartJob(BatchJob & job, const JobScheduler & scheduler)
+    {
+        DebugAssert(scheduler.Post != nullptr, "Trying to start a job without a scheduler!");
+
+        job.m_scheduler = scheduler;
+        scheduler.Post(scheduler.pSchedulerData, BatchJob::RunScheduledChunk, &job);
+    }
+
+#if PHX_MATH_COROUTINES
+    namespace
+    {
+        struct YieldToScheduler
+        {
+            const JobScheduler & Scheduler;
+
+            static void Resume(void * pAddress)
+            {
+                std::coroutine_handle<>::from_address(pAddress).resume();
+            }
+
+            bool await_ready() const { return false; }
+            void await_suspend(std::coroutine_handle<> handle) const { Scheduler.Post(Scheduler.pSchedulerData, Resume, handle.address()); }
+            void await_resume() const { }
+        };
+    }
+
+    JobTask RunJobAsync(BatchJob & job, JobScheduler scheduler)
+    {
+        // The first chunk runs on the calling thread, every chunk after that wherever the scheduler resumes it.
+        while (job.Step())
+        {
+            co_await YieldToScheduler { scheduler };
+        }
+    }
+#endif
+
+} //namespace Math
+} //namespace Phx
@@ -0,0 +1,248 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_JOB_H_
+#define _PHX_MATH_JOB_H_
+
+#include "PhxMathBatch.h"
+#include "PhxMathPacked.h"
+#include "PhxMathTransformStore.h"
+
+// C++ Standard Library Includes
+#include <atomic>
+
+// C++20 coroutine support for BatchJob, see RunJobAsync.
+#if !defined(PHX_MATH_COROUTINES)
+# if defined(__cpp_impl_coroutine) && defined(__has_include)
+#  if __has_include(<coroutine>)
+#   define PHX_MATH_COROUTINES 1
+#  endif
+# endif
+#endif
+#if !defined(PHX_MATH_COROUTINES)
+# define PHX_MATH_COROUTINES 0
+#endif
+
+#if PHX_MATH_COROUTINES
+# include <coroutine>
+#endif
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Resumable Batch Jobs
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// A batch operation over a very large array (bake and import jobs) split
+// into chunks that run one at a time, so the work can be spread out and
+// interleaved with other work on the same threads:
+//
+//   Step          - Runs the next chunk on the calling thread.
+//   StartJob      - Posts one chunk at a time to the caller's scheduler, each
+//                   chunk posts the next one when it finishes.
+//   RunJobAsync   - C++20 coroutine that runs a chunk and then suspends back
+//                   to the scheduler, and can be co_awaited.
+//
+// Cancel and the progress queries can be called from any thread, a
+// cancelled job stops before its next chunk. Only one thread may step a
+// job at a time, and the arrays and the job itself must stay alive until
+// the job is done.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    class BatchJob;
+
+    namespace JobStatus
+    {
+        enum Type
+        {
+            Empty,          // Not initialized.
+            Pending,        // Initialized, no chunk has run yet.
+            Running,
+            Completed,
+            Cancelled,
+        };
+    }
+
+    typedef void (*JobTaskFunction)(void * pArg);
+
+    // Post has to call task(pArg) later on some thread, it must not call it before returning.
+    struct JobScheduler
+    {
+        void (*Post)(void * pSchedulerData, JobTaskFunction task, void * pArg);
+        void * pSchedulerData;
+    };
+
+    class BatchJob
+    {
+    public:
+        // Processes elements [first, first + count).
+        typedef void (*ChunkFunction)(void * pContext, unsigned int first, unsigned int count);
+
+        // Called after every chunk, on the thread that ran it.
+        typedef void (*ProgressFunction)(void * pUserData, const BatchJob & job);
+
+        // Big enough that the per chunk overhead disappears, small enough for a chunk to take around a millisecond.
+        static const unsigned int DefaultChunkSize = 64 * 1024;
+
+    public:
+        BatchJob();
+        ~BatchJob() { }
+
+        void InitializeCustom(ChunkFunction function, void * pContext, unsigned int count);
+        void InitializeTransform(const Vector3 * pIn, const Matrix4x4 & m, Vector3 * pOut, unsigned int count);
+        void InitializeTransform(const Vector4 * pIn, const Matrix4x4 & m, Vector4 * pOut, unsigned int count);
+
+        // Matrices that can't be decomposed give identity scale and orientation and are counted in GetFailedCount.
+        void InitializeDecompose(const Matrix4x4 * pIn, TransformSRT * pOut, unsigned int count);
+
+        void InitializePack(const Vector3 * pIn, Vector3h * pOut, unsigned int count);
+        void InitializePack(const Vector4 * pIn, Vector4h * pOut, unsigned int count);
+        void InitializePack(const Vector3 * pNormals, OctahedralNormal * pOut, unsigned int count);
+
+        void SetChunkSize(unsigned int chunkSize);
+        inline unsigned int GetChunkSize() const;
+
+        void SetProgressCallback(ProgressFunction function, void * pUserData);
+
+        // Runs the next chunk, returns false once the job is completed or cancelled.
+        bool Step();
+        void Run();
+
+        void Cancel();
+
+        inline JobStatus::Type GetStatus() const;
+        inline bool IsDone() const;
+
+        inline unsigned int GetCount() const;
+        inline unsigned int GetProcessedCount() const;
+        inline unsigned int GetFailedCount() const;
+        inline float GetProgress() const;
+
+    private:
+        // Non-copyable.
+        BatchJob(const BatchJob &);
+        BatchJob & operator=(const BatchJob &);
+
+        enum JobType
+        {
+            JobCustom,
+            JobTransformVector3,
+            JobTransformVector4,
+            JobDecompose,
+            JobPackVector3Half,
+            JobPackVector4Half,
+            JobPackOctahedral,
+        };
+
+        void Initialize(JobType type, const void * pIn, void * pOut, unsigned int count);
+        void RunChunk(unsigned int first, unsigned int count);
+
+        friend void StartJob(BatchJob & job, const JobScheduler & scheduler);
+        static void RunScheduledChunk(void * pJob);
+
+    private:
+        Matrix4x4 m_matrix;
+        JobType m_type;
+        ChunkFunction m_function;
+        void * m_pContext;
+        const void * m_pIn;
+        void * m_pOut;
+        unsigned int m_count;
+        unsigned int m_chunkSize;
+        ProgressFunction m_progressFunction;
+        void * m_pProgressData;
+        JobScheduler m_scheduler;
+        std::atomic<unsigned int> m_processed;
+        std::atomic<unsigned int> m_failed;
+        std::atomic<int> m_status;
+        std::atomic<bool> m_cancelRequested;
+    };
+
+    // Keeps posting the job's chunks to the scheduler until it is done.
+    void StartJob(BatchJob & job, const JobScheduler & scheduler);
+
+#if PHX_MATH_COROUTINES
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Coroutine returned by RunJobAsync.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Starts running right away and suspends after every chunk, the
+    // scheduler resumes it. A coroutine that does co_await on the task is
+    // resumed once the job is done. The task must not be destroyed before it is done.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    class JobTask
+    {
+    public:
+        struct promise_type
+        {
+            // Address of the coroutine awaiting the task, or of the promise itself once the task is done.
+            std::atomic<void *> Continuation;
+
+            promise_type() : Continuation(nullptr) { }
+
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept { return false; }
+                inline std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+                void await_resume() noexcept { }
+            };
+
+            JobTask get_return_object() { return JobTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_never initial_suspend() noexcept { return std::suspend_never(); }
+            FinalAwaiter final_suspend() noexcept { return FinalAwaiter(); }
+            void return_void() { }
+            void unhandled_exception() { throw; }
+        };
+
+    public:
+        inline JobTask(JobTask && other) noexcept;
+        inline ~JobTask();
+
+        inline bool IsDone() const;
+
+        inline bool await_ready() const;
+        inline bool await_suspend(std::coroutine_handle<> awaiting);
+        inline void await_resume() const { }
+
+    private:
+        inline explicit JobTask(std::coroutine_handle<promise_type> handle);
+
+        JobTask(const JobTask &) = delete;
+        JobTask & operator=(const JobTask &) = delete;
+
+    private:
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    JobTask RunJobAsync(BatchJob & job, JobScheduler scheduler);
+#endif
+
+} //namespace Math
+} //namespace Phx
+
+#include "PhxMathJob.inl"
+
+#endif //_PHX_MATH_JOB_H_
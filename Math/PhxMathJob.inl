@@ -0,0 +1,124 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_JOB_INL_
+#define _PHX_MATH_JOB_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline unsigned int BatchJob::GetChunkSize() const
+    {
+        return m_chunkSize;
+    }
+
+    inline JobStatus::Type BatchJob::GetStatus() const
+    {
+        return static_cast<JobStatus::Type>(m_status.load(std::memory_order_acquire));
+    }
+
+    inline bool BatchJob::IsDone() const
+    {
+        const JobStatus::Type status = GetStatus();
+        return (status == JobStatus::Completed || status == JobStatus::Cancelled);
+    }
+
+    inline unsigned int BatchJob::GetCount() const
+    {
+        return m_count;
+    }
+
+    inline unsigned int BatchJob::GetProcessedCount() const
+    {
+        return m_processed.load(std::memory_order_relaxed);
+    }
+
+    inline unsigned int BatchJob::GetFailedCount() const
+    {
+        return m_failed.load(std::memory_order_relaxed);
+    }
+
+    inline float BatchJob::GetProgress() const
+    {
+        return (m_count > 0) ? (static_cast<float>(GetProcessedCount()) / static_cast<float>(m_count)) : 1.0f;
+    }
+
+#if PHX_MATH_COROUTINES
+    inline std::coroutine_handle<> JobTask::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+    {
+        // Whoever gets to the continuation second resumes the awaiting coroutine, see JobTask::await_suspend.
+        promise_type & promise = handle.promise();
+        void * pAwaiting = promise.Continuation.exchange(&promise, std::memory_order_acq_rel);
+        return (pAwaiting != nullptr) ? std::coroutine_handle<>::from_address(pAwaiting) : std::noop_coroutine();
+    }
+
+    inline JobTask::JobTask(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+    { }
+
+    inline JobTask::JobTask(JobTask && other) noexcept
+        : m_handle(other.m_handle)
+    {
+        other.m_handle = nullptr;
+    }
+
+    inline JobTask::~JobTask()
+    {
+        if (m_handle)
+        {
+            DebugAssert(IsDone(), "Destroying a job task that is still running!");
+            m_handle.destroy();
+        }
+    }
+
+    inline bool JobTask::IsDone() const
+    {
+        return (m_handle.promise().Continuation.load(std::memory_order_acquire) == &m_handle.promise());
+    }
+
+    inline bool JobTask::await_ready() const
+    {
+        return IsDone();
+    }
+
+    inline bool JobTask::await_suspend(std::coroutine_handle<> awaiting)
+    {
+        // If the job finished since await_ready, don't suspend.
+        promise_type & promise = m_handle.promise();
+        void * pPrevious = promise.Continuation.exchange(awaiting.address(), std::memory_order_acq_rel);
+        if (pPrevious != nullptr)
+        {
+            promise.Continuation.store(pPrevious, std::memory_order_release);
+            return false;
+        }
+        return true;
+    }
+#endif
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_JOB_INL_
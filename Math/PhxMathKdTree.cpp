@@ -0,0 +1,495 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathKdTree.h"
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // The top levels are split one level at a time with every range of the level in parallel, until there are
+        // enough subtrees to build them in parallel. Ranges smaller than this are not worth a task of their own.
+        const unsigned int MinSubtreeSize = 4096;
+        const unsigned int SubtreeCount = 64;
+
+        // Deeper than any tree of 2^32 points, each level of a search pushes at most one subtree.
+        const unsigned int MaxSearchDepth = 64;
+
+        struct SearchEntry
+        {
+            unsigned int Begin;
+            unsigned int End;
+            float DistanceSquared;      // Lower bound on the distance from the query to the points of the range.
+        };
+
+        // Keeps the k nearest sorted, k is usually small enough that inserting into a sorted array beats a heap.
+        unsigned int InsertNearest(unsigned int * pIndices, float * pDistances, unsigned int found, unsigned int k, unsigned int index, float distanceSquared)
+        {
+            unsigned int i = (found < k) ? found++ : k - 1;
+
+            while (i > 0 && pDistances[i - 1] > distanceSquared)
+            {
+                pDistances[i] = pDistances[i - 1];
+                pIndices[i] = pIndices[i - 1];
+                --i;
+            }
+
+            pDistances[i] = distanceSquared;
+            pIndices[i] = index;
+            return found;
+        }
+
+        struct QueryNearestArgs
+        {
+            const KdTree * pTree;
+            const Vector3 * pQueries;
+            unsigned int K;
+            float MaxRadius;
+            float Epsilon;
+            unsigned int * pOutIndices;
+            float * pOutDistancesSquared;
+            unsigned int * pOutCounts;
+        };
+
+        void QueryNearestRange(void * pContext, unsigned int first, unsigned int count)
+        {
+            const QueryNearestArgs & args = *static_cast<const QueryNearestArgs *>(pContext);
+
+            for (unsigned int i = first; i < first + count; ++i)
+            {
+                const size_t offset = static_cast<size_t>(i) * args.K;
+                args.pOutCounts[i] = args.pTree->QueryNearest(args.pQueries[i], args.K, args.MaxRadius, args.pOutIndices + offset, args.pOutDistancesSquared + offset, args.Epsilon);
+            }
+        }
+
+        struct QueryRadiusArgs
+        {
+            const KdTree * pTree;
+            const Vector3 * pCenters;
+            float Radius;
+            unsigned int MaxNeighbors;
+            unsigned int * pOutIndices;
+            unsigned int * pOutCounts;
+        };
+
+        void QueryRadiusRange(void * pContext, unsigned int first, unsigned int count)
+        {
+            const QueryRadiusArgs & args = *static_cast<const QueryRadiusArgs *>(pContext);
+
+            for (unsigned int i = first; i < first + count; ++i)
+            {
+                unsigned int * pIndices = args.pOutIndices + static_cast<size_t>(i) * args.MaxNeighbors;
+                args.pOutCounts[i] = args.pTree->QueryRadius(args.pCenters[i], args.Radius, pIndices, args.MaxNeighbors);
+            }
+        }
+    }
+
+    struct KdTree::BuildContext
+    {
+        KdTree * pTree;
+    };
+
+    KdTree::KdTree()
+    {
+    }
+
+    KdTree::~KdTree()
+    {
+    }
+
+    void KdTree::Build(const Vector3 * pPoints, unsigned int count)
+    {
+        Build(ExecutionPolicy::CreateSequential(), pPoints, count);
+    }
+
+    void KdTree::Build(const ExecutionPolicy & policy, const Vector3 * pPoints, unsigned int count)
+    {
+        m_points.Resize(count);
+        m_axes.Resize(count);
+
+        AABB bounds = AABB::Empty;
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            m_points[i].Position.Set(pPoints[i]);
+            m_points[i].Index = i;
+            bounds.Merge(pPoints[i]);
+        }
+
+        BuildContext context;
+        context.pTree = this;
+
+        // Each range is one task, the policy's task size is in points.
+        ExecutionPolicy rangePolicy = policy;
+        rangePolicy.MinElementsPerTask = 1;
+
+        m_ranges.Resize(1);
+        m_ranges[0].Begin = 0;
+        m_ranges[0].End = count;
+        m_ranges[0].Bounds.Set(bounds);
+
+        while (m_ranges.GetCount() < SubtreeCount && count / m_ranges.GetCount() >= 2 * MinSubtreeSize)
+        {
+            m_nextRanges.Resize(m_ranges.GetCount() * 2);
+            ParallelFor(rangePolicy, m_ranges.GetCount(), PHX_CACHE_LINE_SIZE, SplitRange, &context);
+            m_ranges.Swap(m_nextRanges);
+        }
+
+        ParallelFor(rangePolicy, m_ranges.GetCount(), PHX_CACHE_LINE_SIZE, BuildSubtreeRange, &context);
+    }
+
+    void KdTree::SplitRange(void * pContext, unsigned int first, unsigned int count)
+    {
+        KdTree & tree = *static_cast<BuildContext *>(pContext)->pTree;
+
+        for (unsigned int i = first; i < first + count; ++i)
+        {
+            tree.Split(tree.m_ranges[i], tree.m_nextRanges[2 * i], tree.m_nextRanges[2 * i + 1]);
+        }
+    }
+
+    void KdTree::BuildSubtreeRange(void * pContext, unsigned int first, unsigned int count)
+    {
+        KdTree & tree = *static_cast<BuildContext *>(pContext)->pTree;
+
+        for (unsigned int i = first; i < first + count; ++i)
+        {
+            tree.BuildSubtree(tree.m_ranges[i]);
+        }
+    }
+
+    void KdTree::Split(const Range & range, Range & outLeft, Range & outRight)
+    {
+        Point * pPoints = m_points.GetData();
+
+        // Split on the longest axis of the cell. Tighter bounds would take another pass over the points.
+        const Vector3 size = range.Bounds.GetSize();
+        const unsigned int axis = (size.X >= size.Y && size.X >= size.Z) ? 0 : ((size.Y >= size.Z) ? 1 : 2);
+
+        // Quickselect the median: afterwards no point before it is greater on the axis and no point after it is less.
+        const unsigned int median = range.Begin + (range.End - range.Begin) / 2;
+
+        // The partitions swap unconditionally and only advance the boundary by the comparison, so there are no
+        // branches to mispredict on the (random) coordinates. Points equal to the pivot are gathered in a second
+        // pass, so ranges with a lot of duplicates still shrink every step.
+        unsigned int low = range.Begin;
+        unsigned int high = range.End;
+
+        while (median < high && high - low > 1)
+        {
+            // Median of three pivot.
+            const float a = pPoints[low].Position[axis];
+            const float b = pPoints[low + (high - low) / 2].Position[axis];
+            const float c = pPoints[high - 1].Position[axis];
+            const float pivot = Math::Max(Math::Min(a, b), Math::Min(Math::Max(a, b), c));
+
+            // Nothing compares less or equal to a NaN pivot, so the partitions below would make no progress.
+            // The NaN coordinates are moved to the end instead and left out of the selection, they sort after
+            // every number (or take the median if there are that many of them).
+            if (pivot != pivot)
+            {
+                unsigned int numbers = low;
+                for (unsigned int i = low; i < high; ++i)
+                {
+                    const bool isNumber = (pPoints[i].Position[axis] == pPoints[i].Position[axis]);
+                    const Point point = pPoints[i];
+                    pPoints[i] = pPoints[numbers];
+                    pPoints[numbers] = point;
+                    numbers += isNumber ? 1 : 0;
+                }
+
+                high = numbers;
+                continue;
+            }
+
+            // [low, less) < pivot
+            unsigned int less = low;
+            for (unsigned int i = low; i < high; ++i)
+            {
+                const bool isLess = (pPoints[i].Position[axis] < pivot);
+                const Point point = pPoints[i];
+                pPoints[i] = pPoints[less];
+                pPoints[less] = point;
+                less += isLess ? 1 : 0;
+            }
+
+            if (median < less)
+            {
+                high = less;
+                continue;
+            }
+
+            // [less, equal) == pivot
+            unsigned int equal = less;
+            for (unsigned int i = less; i < high; ++i)
+            {
+                const bool isEqual = (pPoints[i].Position[axis] <= pivot);
+                const Point point = pPoints[i];
+                pPoints[i] = pPoints[equal];
+                pPoints[equal] = point;
+                equal += isEqual ? 1 : 0;
+            }
+
+            if (median < equal)
+            {
+                break;
+            }
+
+            low = equal;
+        }
+
+        m_axes[median] = static_cast<unsigned char>(axis);
+
+        outLeft.Begin = range.Begin;
+        outLeft.End = median;
+        outLeft.Bounds.Set(range.Bounds);
+        outLeft.Bounds.Max[axis] = pPoints[median].Position[axis];
+
+        outRight.Begin = median + 1;
+        outRight.End = range.End;
+        outRight.Bounds.Set(range.Bounds);
+        outRight.Bounds.Min[axis] = pPoints[median].Position[axis];
+    }
+
+    void KdTree::BuildSubtree(const Range & range)
+    {
+        if (range.End - range.Begin <= LeafSize)
+        {
+            return;
+        }
+
+        Range left;
+        Range right;
+        Split(range, left, right);
+
+        BuildSubtree(left);
+        BuildSubtree(right);
+    }
+
+    unsigned int KdTree::QueryNearest(const Vector3 & p, unsigned int k, float maxRadius, unsigned int * pOutIndices, float * pOutDistancesSquared, float epsilon) const
+    {
+        DebugAssert(maxRadius >= 0.0f, "Negative query radius (%f).", maxRadius);
+        DebugAssert(epsilon >= 0.0f, "Negative approximation error (%f).", epsilon);
+
+        if (m_points.IsEmpty() || k == 0)
+        {
+            return 0;
+        }
+
+        const Point * pPoints = m_points.GetData();
+        const unsigned char * pAxes = m_axes.GetData();
+
+        // Once k points are found, a subtree is skipped unless its lower bound times this is below the k-th distance.
+        const float errorScale = (1.0f + epsilon) * (1.0f + epsilon);
+        const float maxRadiusSquared = maxRadius * maxRadius;
+
+        // worst is the distance a point has to beat to be kept, limit the one a subtree has to beat to be searched.
+        unsigned int found = 0;
+        float worst = maxRadiusSquared;
+        float limit = maxRadiusSquared;
+
+        SearchEntry stack[MaxSearchDepth];
+        unsigned int stackSize = 1;
+        stack[0].Begin = 0;
+        stack[0].End = m_points.GetCount();
+        stack[0].DistanceSquared = 0.0f;
+
+        while (stackSize > 0)
+        {
+            --stackSize;
+            unsigned int begin = stack[stackSize].Begin;
+            unsigned int end = stack[stackSize].End;
+            const float bound = stack[stackSize].DistanceSquared;
+
+            if (bound > limit)
+            {
+                continue;
+            }
+
+            // Walk down to the leaf on the query's side, leaving the other sides on the stack.
+            while (end - begin > LeafSize)
+            {
+                const unsigned int median = begin + (end - begin) / 2;
+                const unsigned int axis = pAxes[median];
+
+                const float distanceSquared = DistanceSquared(pPoints[median].Position, p);
+                if (distanceSquared <= worst && (found < k || distanceSquared < worst))
+                {
+                    found = InsertNearest(pOutIndices, pOutDistancesSquared, found, k, pPoints[median].Index, distanceSquared);
+                    worst = (found == k) ? pOutDistancesSquared[k - 1] : maxRadiusSquared;
+                    limit = (found == k) ? worst / errorScale : worst;
+                }
+
+                // A NaN split point gives a NaN offset, Max then keeps bound so the far side is still searched.
+                const float offset = p[axis] - pPoints[median].Position[axis];
+                const float farBound = Math::Max(offset * offset, bound);
+
+                if (farBound <= limit)
+                {
+                    SearchEntry & far = stack[stackSize++];
+                    far.Begin = (offset < 0.0f) ? median + 1 : begin;
+                    far.End = (offset < 0.0f) ? end : median;
+                    far.DistanceSquared = farBound;
+                }
+
+                if (offset < 0.0f)
+                {
+                    end = median;
+                }
+                else
+                {
+                    begin = median + 1;
+                }
+            }
+
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                const float distanceSquared = DistanceSquared(pPoints[i].Position, p);
+                if (distanceSquared <= worst && (found < k || distanceSquared < worst))
+                {
+                    found = InsertNearest(pOutIndices, pOutDistancesSquared, found, k, pPoints[i].Index, distanceSquared);
+                    worst = (found == k) ? pOutDistancesSquared[k - 1] : maxRadiusSquared;
+                    limit = (found == k) ? worst / errorScale : worst;
+                }
+            }
+        }
+
+        return found;
+    }
+
+    void KdTree::QueryNearest(const ExecutionPolicy & policy, const Vector3 * pQueries, unsigned int count, unsigned int k, float maxRadius, unsigned int * pOutIndices, float * pOutDistancesSquared, unsigned int * pOutCounts, float epsilon) const
+    {
+        QueryNearestArgs args;
+        args.pTree = this;
+        args.pQueries = pQueries;
+        args.K = k;
+        args.MaxRadius = maxRadius;
+        args.Epsilon = epsilon;
+        args.pOutIndices = pOutIndices;
+        args.pOutDistancesSquared = pOutDistancesSquared;
+        args.pOutCounts = pOutCounts;
+
+        ParallelFor(policy, count, sizeof(unsigned int), QueryNearestRange, &args);
+    }
+
+    unsigned int KdTree::QueryRadius(const Vector3 & center, float radius, unsigned int * pOutIndices, unsigned int maxCount) const
+    {
+        DebugAssert(radius >= 0.0f, "Negative query radius (%f).", radius);
+
+        if (m_points.IsEmpty() || maxCount == 0)
+        {
+            return 0;
+        }
+
+        const Point * pPoints = m_points.GetData();
+        const unsigned char * pAxes = m_axes.GetData();
+        const float radiusSquared = radius * radius;
+
+        unsigned int written = 0;
+
+        SearchEntry stack[MaxSearchDepth];
+        unsigned int stackSize = 1;
+        stack[0].Begin = 0;
+        stack[0].End = m_points.GetCount();
+        stack[0].DistanceSquared = 0.0f;
+
+        while (stackSize > 0)
+        {
+            --stackSize;
+            unsigned int begin = stack[stackSize].Begin;
+            unsigned int end = stack[stackSize].End;
+
+            while (end - begin > LeafSize)
+            {
+                const unsigned int median = begin + (end - begin) / 2;
+                const unsigned int axis = pAxes[median];
+
+                if (DistanceSquared(pPoints[median].Position, center) <= radiusSquared)
+                {
+                    pOutIndices[written++] = pPoints[median].Index;
+                    if (written == maxCount)
+                    {
+                        return written;
+                    }
+                }
+
+                const float offset = center[axis] - pPoints[median].Position[axis];
+
+                // Only the side the center is on when the sphere doesn't reach the split plane (or the split point is NaN).
+                if (false == (offset * offset > radiusSquared))
+                {
+                    SearchEntry & far = stack[stackSize++];
+                    far.Begin = (offset < 0.0f) ? median + 1 : begin;
+                    far.End = (offset < 0.0f) ? end : median;
+                    far.DistanceSquared = offset * offset;
+                }
+
+                if (offset < 0.0f)
+                {
+                    end = median;
+                }
+                else
+                {
+                    begin = median + 1;
+                }
+            }
+
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                if (DistanceSquared(pPoints[i].Position, center) <= radiusSquared)
+                {
+                    pOutIndices[written++] = pPoints[i].Index;
+                    if (written == maxCount)
+                    {
+                        return written;
+                    }
+                }
+            }
+        }
+
+        return written;
+    }
+
+    void KdTree::QueryRadius(const ExecutionPolicy & policy, const Vector3 * pCenters, unsigned int count, float radius, unsigned int maxNeighbors, unsigned int * pOutIndices, unsigned int * pOutCounts) const
+    {
+        QueryRadiusArgs args;
+        args.pTree = this;
+        args.pCenters = pCenters;
+        args.Radius = radius;
+        args.MaxNeighbors = maxNeighbors;
+        args.pOutIndices = pOutIndices;
+        args.pOutCounts = pOutCounts;
+
+        ParallelFor(policy, count, sizeof(unsigned int), QueryRadiusRange, &args);
+    }
+
+    unsigned int KdTree::GetCount() const
+    {
+        return m_points.GetCount();
+    }
+
+} //namespace Math
+} //namespace Phx
@@ -0,0 +1,126 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_KD_TREE_H_
+#define _PHX_MATH_KD_TREE_H_
+
+#include "PhxMathExecution.h"
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// k-d Tree
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Nearest neighbor and radius searches over a static point cloud.
+//
+// The tree is implicit: Build reorders a copy of the points so that every
+// node is a range of the array, split at its median point. The median is
+// the node's split point, the points before it form the left child and the
+// points after it the right child, and ranges of LeafSize points or less
+// are leaves that are searched linearly. The only data besides the points
+// is the split axis of each node (the longest axis of the node's cell),
+// one byte per point, so there are no child pointers to follow and a
+// subtree is always one contiguous block of memory.
+//
+// The searches take an epsilon for approximate results: subtrees are
+// skipped unless they could hold a point closer than the current k-th
+// nearest distance divided by (1 + epsilon). Every point returned is then
+// within (1 + epsilon) times the distance of the true neighbor of the same
+// rank. 0 gives the exact neighbors.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    class KdTree
+    {
+    public:
+        static const unsigned int LeafSize = 8;
+
+    public:
+        KdTree();
+        ~KdTree();
+
+        // Queries return indices into pPoints. The points are copied, pPoints does not have to outlive the build.
+        // The result does not depend on the policy.
+        // Points with a NaN coordinate are kept in the tree but are never returned by a query.
+        void Build(const Vector3 * pPoints, unsigned int count);
+        void Build(const ExecutionPolicy & policy, const Vector3 * pPoints, unsigned int count);
+
+        // Writes the indices of the (up to) k nearest points within maxRadius of p, nearest first, and their
+        // squared distances. Both arrays need room for k elements. Returns the number of points written.
+        unsigned int QueryNearest(const Vector3 & p, unsigned int k, float maxRadius, unsigned int * pOutIndices, float * pOutDistancesSquared, float epsilon = 0.0f) const;
+
+        // QueryNearest for every point in pQueries. The results of pQueries[i] are written at i * k in pOutIndices
+        // and pOutDistancesSquared, and their number to pOutCounts[i].
+        void QueryNearest(const ExecutionPolicy & policy, const Vector3 * pQueries, unsigned int count, unsigned int k, float maxRadius, unsigned int * pOutIndices, float * pOutDistancesSquared, unsigned int * pOutCounts, float epsilon = 0.0f) const;
+
+        // Writes the indices of the points with DistanceSquared(point, center) <= radius * radius, in no particular order.
+        // Stops after maxCount points and returns the number of indices written.
+        unsigned int QueryRadius(const Vector3 & center, float radius, unsigned int * pOutIndices, unsigned int maxCount) const;
+
+        // QueryRadius for every center. The neighbors of pCenters[i] are written to pOutIndices + i * maxNeighbors
+        // and their number to pOutCounts[i].
+        void QueryRadius(const ExecutionPolicy & policy, const Vector3 * pCenters, unsigned int count, float radius, unsigned int maxNeighbors, unsigned int * pOutIndices, unsigned int * pOutCounts) const;
+
+        unsigned int GetCount() const;
+
+    private:
+        // Non-copyable.
+        KdTree(const KdTree &);
+        KdTree & operator=(const KdTree &);
+
+        struct Point
+        {
+            Vector3 Position;
+            unsigned int Index;     // In the array passed to Build.
+        };
+
+        struct Range
+        {
+            unsigned int Begin;
+            unsigned int End;
+            AABB Bounds;            // Cell of the node, the root's bounds cut by the splits above it.
+        };
+
+        struct BuildContext;
+        static void SplitRange(void * pContext, unsigned int first, unsigned int count);
+        static void BuildSubtreeRange(void * pContext, unsigned int first, unsigned int count);
+
+        void Split(const Range & range, Range & outLeft, Range & outRight);
+        void BuildSubtree(const Range & range);
+
+    private:
+        AlignedArray<Point> m_points;
+        AlignedArray<unsigned char> m_axes;     // Split axis of the node whose median is at the same position.
+
+        // Build scratch.
+        AlignedArray<Range> m_ranges;
+        AlignedArray<Range> m_nextRanges;
+    };
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_KD_TREE_H_
@@ -0,0 +1,174 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_MATRIX3X2_H_
+#define _PHX_MATH_MATRIX3X2_H_
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// Row Major Matrix
+// Row Vectors
+// Pre-multiplication
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// 2D affine transform, same conventions as
+// Matrix4x4. Rows 1 and 2 hold the rotation,
+// scale and skew, row 3 is the translation.
+// The third column is always (0, 0, 1) and
+// isn't stored.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+namespace Phx {
+namespace Math {
+
+    class Matrix3x2
+    {
+    public:
+        float M11;
+        float M12;
+        float M21;
+        float M22;
+        float M31;
+        float M32;
+
+    public:
+        static const Matrix3x2 Zero;
+        static const Matrix3x2 Identity;
+
+    public:
+        static inline Matrix3x2 CreateIdentity();
+        static inline void CreateIdentity(Matrix3x2 & out);
+
+        // Counter clockwise rotation (x + is right, y + is up like Rect).
+        static inline Matrix3x2 CreateRotation(float radians);
+        static inline Matrix3x2 CreateRotation(float radians, const Vector2 & center);
+        static inline void CreateRotation(float radians, Matrix3x2 & out);
+        static inline void CreateRotation(float radians, const Vector2 & center, Matrix3x2 & out);
+
+        static inline Matrix3x2 CreateScale(float scale);
+        static inline Matrix3x2 CreateScale(const Vector2 & scale);
+        static inline Matrix3x2 CreateScale(const Vector2 & scale, const Vector2 & center);
+        static inline void CreateScale(float scale, Matrix3x2 & out);
+        static inline void CreateScale(const Vector2 & scale, Matrix3x2 & out);
+        static inline void CreateScale(const Vector2 & scale, const Vector2 & center, Matrix3x2 & out);
+
+        // Skews x by tan(radiansX) * y and y by tan(radiansY) * x.
+        static inline Matrix3x2 CreateSkew(float radiansX, float radiansY);
+        static inline void CreateSkew(float radiansX, float radiansY, Matrix3x2 & out);
+
+        static inline Matrix3x2 CreateTranslation(const Vector2 & position);
+        static inline Matrix3x2 CreateTranslation(float x, float y);
+        static inline void CreateTranslation(const Vector2 & position, Matrix3x2 & out);
+        static inline void CreateTranslation(float x, float y, Matrix3x2 & out);
+
+        // Scale, then rotation, then translation.
+        static inline Matrix3x2 CreateTransform(const Vector2 & scale, float radians, const Vector2 & position);
+        static inline void CreateTransform(const Vector2 & scale, float radians, const Vector2 & position, Matrix3x2 & out);
+
+    public:
+        inline Matrix3x2()
+        {
+            // Do nothing in the default ctor.
+            // So we don't have to pay for arrays or matrices initialized as an out parameter.
+        }
+
+        inline explicit Matrix3x2(const Vector2 & row1,
+                                  const Vector2 & row2,
+                                  const Vector2 & row3);
+
+        inline explicit Matrix3x2(float m11, float m12,
+                                  float m21, float m22,
+                                  float m31, float m32);
+
+        inline Matrix3x2(const Matrix3x2 & src);
+
+        inline ~Matrix3x2() { }
+
+        inline Matrix3x2 & operator=(const Matrix3x2 & rhs);
+
+        inline float & operator[](unsigned int idx);
+        inline const float & operator[](unsigned int idx) const;
+
+        inline Matrix3x2 & operator*=(const Matrix3x2 & rhs);
+
+        inline float Determinant() const;
+
+        inline void Inverse();
+
+        inline Vector2 & GetTranslation();
+        inline const Vector2 & GetTranslation() const;
+
+        inline void Set(const Matrix3x2 & src);
+        inline void Set(const float * pSrc);
+        inline void Set(const Vector2 & row1,
+                        const Vector2 & row2,
+                        const Vector2 & row3);
+        inline void Set(float m11, float m12,
+                        float m21, float m22,
+                        float m31, float m32);
+        inline void Set(float f);
+
+        inline Vector2 & Row(unsigned int idx);
+        inline const Vector2 & Row(unsigned int idx) const;
+
+        inline float * ToArray();
+        inline const float * ToArray() const;
+    };
+
+    inline bool operator==(const Matrix3x2 & lhs, const Matrix3x2 & rhs);
+    inline bool operator!=(const Matrix3x2 & lhs, const Matrix3x2 & rhs);
+
+    inline Matrix3x2 operator*(const Matrix3x2 & lhs, const Matrix3x2 & rhs);
+
+    inline bool ExactlyEqual(const Matrix3x2 & lhs, const Matrix3x2 & rhs);
+    inline bool NearlyEqual(const Matrix3x2 & lhs, const Matrix3x2 & rhs);
+
+    inline Matrix3x2 Multiply(const Matrix3x2 & lhs, const Matrix3x2 & rhs);
+    inline void Multiply(const Matrix3x2 & lhs, const Matrix3x2 & rhs, Matrix3x2 & out);
+
+    // Points, with the translation.
+    inline Vector2 Transform(const Vector2 & v, const Matrix3x2 & m);
+    inline void Transform(const Vector2 & v, const Matrix3x2 & m, Vector2 & out);
+
+    // Directions, without the translation.
+    inline Vector2 TransformNormal(const Vector2 & v, const Matrix3x2 & m);
+    inline void TransformNormal(const Vector2 & v, const Matrix3x2 & m, Vector2 & out);
+
+    // Smallest rect containing the 4 transformed corners of r, so rotated rects grow.
+    inline Rect Transform(const Rect & r, const Matrix3x2 & m);
+    inline void Transform(const Rect & r, const Matrix3x2 & m, Rect & out);
+
+    inline float Determinant(const Matrix3x2 & m);
+
+    inline Matrix3x2 Inverse(const Matrix3x2 & m);
+    inline void Inverse(const Matrix3x2 & m, Matrix3x2 & out);
+
+    // The same transform in a Matrix4x4 (in the xy plane), for handing off to 3D code.
+    inline Matrix4x4 ToMatrix4x4(const Matrix3x2 & m);
+    inline void ToMatrix4x4(const Matrix3x2 & m, Matrix4x4 & out);
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_MATRIX3X2_H_
@@ -0,0 +1,490 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_MATRIX3X2_INL_
+#define _PHX_MATH_MATRIX3X2_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline Matrix3x2 Matrix3x2::CreateIdentity()
+    {
+        Matrix3x2 out;
+        CreateIdentity(out);
+        return out;
+    }
+
+    inline void Matrix3x2::CreateIdentity(Matrix3x2 & out)
+    {
+        out.Set(Matrix3x2::Identity);
+    }
+
+    inline Matrix3x2 Matrix3x2::CreateRotation(float radians)
+    {
+        Matrix3x2 out;
+        CreateRotation(radians, out);
+        return out;
+    }
+
+    inline Matrix3x2 Matrix3x2::CreateRotation(float radians, const Vector2 & center)
+    {
+        Matrix3x2 out;
+        CreateRotation(radians, center, out);
+        return out;
+    }
+
+    inline void Matrix3x2::CreateRotation(float radians, Matrix3x2 & out)
+    {
+        float sinTheta, cosTheta;
+        SinCos(radians, &sinTheta, &cosTheta);
+
+        out.Set( cosTheta, sinTheta,
+                -sinTheta, cosTheta,
+                 0.0f,     0.0f);
+    }
+
+    inline void Matrix3x2::CreateRotation(float radians, const Vector2 & center, Matrix3x2 & out)
+    {
+        // Translate center to the origin, rotate, and translate back.
+
+        float sinTheta, cosTheta;
+        SinCos(radians, &sinTheta, &cosTheta);
+
+        const float x = center.X * (1.0f - cosTheta) + center.Y * sinTheta;
+        const float y = center.Y * (1.0f - cosTheta) - center.X * sinTheta;
+
+        out.Set( cosTheta, sinTheta,
+                -sinTheta, cosTheta,
+                 x,        y);
+    }
+
+    inline Matrix3x2 Matrix3x2::CreateScale(float scale)
+    {
+        Matrix3x2 out;
+        CreateScale(scale, out);
+        return out;
+    }
+
+    inline Matrix3x2 Matrix3x2::CreateScale(const Vector2 & scale)
+    {
+        Matrix3x2 out;
+        CreateScale(scale, out);
+        return out;
+    }
+
+    inline Matrix3x2 Matrix3x2::CreateScale(const Vector2 & scale, const Vector2 & center)
+    {
+        Matrix3x2 out;
+        CreateScale(scale, center, out);
+        return out;
+    }
+
+    inline void Matrix3x2::CreateScale(float scale, Matrix3x2 & out)
+    {
+        out.Set(scale, 0.0f,
+                0.0f,  scale,
+                0.0f,  0.0f);
+    }
+
+    inline void Matrix3x2::CreateScale(const Vector2 & scale, Matrix3x2 & out)
+    {
+        out.Set(scale.X, 0.0f,
+                0.0f,    scale.Y,
+                0.0f,    0.0f);
+    }
+
+    inline void Matrix3x2::CreateScale(const Vector2 & scale, const Vector2 & center, Matrix3x2 & out)
+    {
+        out.Set(scale.X,                         0.0f,
+                0.0f,                            scale.Y,
+                center.X * (1.0f - scale.X),     center.Y * (1.0f - scale.Y));
+    }
+
+    inline Matrix3x2 Matrix3x2::CreateSkew(float radiansX, float radiansY)
+    {
+        Matrix3x2 out;
+        CreateSkew(radiansX, radiansY, out);
+        return out;
+    }
+
+    inline void Matrix3x2::CreateSkew(float radiansX, float radiansY, Matrix3x2 & out)
+    {
+        out.Set(1.0f,          Tan(radiansY),
+                Tan(radiansX), 1.0f,
+                0.0f,          0.0f);
+    }
+
+    inline Matrix3x2 Matrix3x2::CreateTranslation(const Vector2 & position)
+    {
+        Matrix3x2 out;
+        CreateTranslation(position.X, position.Y, out);
+        return out;
+    }
+
+    inline Matrix3x2 Matrix3x2::CreateTranslation(float x, float y)
+    {
+        Matrix3x2 out;
+        CreateTranslation(x, y, out);
+        return out;
+    }
+
+    inline void Matrix3x2::CreateTranslation(const Vector2 & position, Matrix3x2 & out)
+    {
+        CreateTranslation(position.X, position.Y, out);
+    }
+
+    inline void Matrix3x2::CreateTranslation(float x, float y, Matrix3x2 & out)
+    {
+        out.Set(1.0f, 0.0f,
+                0.0f, 1.0f,
+                x,    y);
+    }
+
+    inline Matrix3x2 Matrix3x2::CreateTransform(const Vector2 & scale, float radians, const Vector2 & position)
+    {
+        Matrix3x2 out;
+        CreateTransform(scale, radians, position, out);
+        return out;
+    }
+
+    inline void Matrix3x2::CreateTransform(const Vector2 & scale, float radians, const Vector2 & position, Matrix3x2 & out)
+    {
+        // Scale * Rotation * Translation without the multiplies.
+
+        float sinTheta, cosTheta;
+        SinCos(radians, &sinTheta, &cosTheta);
+
+        out.Set( scale.X * cosTheta, scale.X * sinTheta,
+                -scale.Y * sinTheta, scale.Y * cosTheta,
+                 position.X,         position.Y);
+    }
+
+    inline Matrix3x2::Matrix3x2(const Vector2 & row1, const Vector2 & row2, const Vector2 & row3)
+    {
+        Set(row1, row2, row3);
+    }
+
+    inline Matrix3x2::Matrix3x2(float m11, float m12,
+                                float m21, float m22,
+                                float m31, float m32)
+    {
+        Set(m11, m12,
+            m21, m22,
+            m31, m32);
+    }
+
+    inline Matrix3x2::Matrix3x2(const Matrix3x2 & src)
+    {
+        Set(src);
+    }
+
+    inline Matrix3x2 & Matrix3x2::operator=(const Matrix3x2 & rhs)
+    {
+        Set(rhs);
+        return *this;
+    }
+
+    inline float & Matrix3x2::operator[](unsigned int idx)
+    {
+        DebugAssert(idx < 6, "Invalid index (%u) into a matrix 3x2!", idx);
+        return ToArray()[idx];
+    }
+
+    inline const float & Matrix3x2::operator[](unsigned int idx) const
+    {
+        DebugAssert(idx < 6, "Invalid index (%u) into a matrix 3x2!", idx);
+        return ToArray()[idx];
+    }
+
+    inline Matrix3x2 & Matrix3x2::operator*=(const Matrix3x2 & rhs)
+    {
+        Math::Multiply(*this, rhs, *this);
+        return *this;
+    }
+
+    inline float Matrix3x2::Determinant() const
+    {
+        return Math::Determinant(*this);
+    }
+
+    inline void Matrix3x2::Inverse()
+    {
+        Math::Inverse(*this, *this);
+    }
+
+    inline Vector2 & Matrix3x2::GetTranslation()
+    {
+        return Row(2);
+    }
+
+    inline const Vector2 & Matrix3x2::GetTranslation() const
+    {
+        return Row(2);
+    }
+
+    inline void Matrix3x2::Set(const Matrix3x2 & src)
+    {
+        this->M11 = src.M11;
+        this->M12 = src.M12;
+        this->M21 = src.M21;
+        this->M22 = src.M22;
+        this->M31 = src.M31;
+        this->M32 = src.M32;
+    }
+
+    inline void Matrix3x2::Set(const float * pSrc)
+    {
+        DebugAssert(pSrc != nullptr, "Trying to set a matrix 3x2 from a null array!");
+        memcpy(ToArray(), pSrc, sizeof(float) * 6);
+    }
+
+    inline void Matrix3x2::Set(const Vector2 & row1, const Vector2 & row2, const Vector2 & row3)
+    {
+        Set(row1.X, row1.Y,
+            row2.X, row2.Y,
+            row3.X, row3.Y);
+    }
+
+    inline void Matrix3x2::Set(float m11, float m12,
+                               float m21, float m22,
+                               float m31, float m32)
+    {
+        this->M11 = m11;
+        this->M12 = m12;
+        this->M21 = m21;
+        this->M22 = m22;
+        this->M31 = m31;
+        this->M32 = m32;
+    }
+
+    inline void Matrix3x2::Set(float f)
+    {
+        this->M11 = f;
+        this->M12 = f;
+        this->M21 = f;
+        this->M22 = f;
+        this->M31 = f;
+        this->M32 = f;
+    }
+
+    inline Vector2 & Matrix3x2::Row(unsigned int idx)
+    {
+        DebugAssert(idx < 3, "Invalid row index (%u) into a matrix 3x2!", idx);
+        return *reinterpret_cast<Vector2 *>(this->ToArray() + (idx * 2));
+    }
+
+    inline const Vector2 & Matrix3x2::Row(unsigned int idx) const
+    {
+        DebugAssert(idx < 3, "Invalid row index (%u) into a matrix 3x2!", idx);
+        return *reinterpret_cast<const Vector2 *>(this->ToArray() + (idx * 2));
+    }
+
+    inline float * Matrix3x2::ToArray()
+    {
+        return &(this->M11);
+    }
+
+    inline const float * Matrix3x2::ToArray() const
+    {
+        return &(this->M11);
+    }
+
+    inline bool operator==(const Matrix3x2 & lhs, const Matrix3x2 & rhs)
+    {
+        return ExactlyEqual(lhs, rhs);
+    }
+
+    inline bool operator!=(const Matrix3x2 & lhs, const Matrix3x2 & rhs)
+    {
+        return (false == ExactlyEqual(lhs, rhs));
+    }
+
+    inline Matrix3x2 operator*(const Matrix3x2 & lhs, const Matrix3x2 & rhs)
+    {
+        Matrix3x2 out;
+        Multiply(lhs, rhs, out);
+        return out;
+    }
+
+    inline bool ExactlyEqual(const Matrix3x2 & lhs, const Matrix3x2 & rhs)
+    {
+        return (ExactlyEqual(lhs.M11, rhs.M11) &&
+                ExactlyEqual(lhs.M12, rhs.M12) &&
+                ExactlyEqual(lhs.M21, rhs.M21) &&
+                ExactlyEqual(lhs.M22, rhs.M22) &&
+                ExactlyEqual(lhs.M31, rhs.M31) &&
+                ExactlyEqual(lhs.M32, rhs.M32));
+    }
+
+    inline bool NearlyEqual(const Matrix3x2 & lhs, const Matrix3x2 & rhs)
+    {
+        return (NearlyEqual(lhs.M11, rhs.M11) &&
+                NearlyEqual(lhs.M12, rhs.M12) &&
+                NearlyEqual(lhs.M21, rhs.M21) &&
+                NearlyEqual(lhs.M22, rhs.M22) &&
+                NearlyEqual(lhs.M31, rhs.M31) &&
+                NearlyEqual(lhs.M32, rhs.M32));
+    }
+
+    inline Matrix3x2 Multiply(const Matrix3x2 & lhs, const Matrix3x2 & rhs)
+    {
+        Matrix3x2 out;
+        Multiply(lhs, rhs, out);
+        return out;
+    }
+
+    inline void Multiply(const Matrix3x2 & lhs, const Matrix3x2 & rhs, Matrix3x2 & out)
+    {
+        // Pre multiplication: lhs * rhs = lhs transformed by rhs.
+        // Same as the 3x3 multiply with the implicit (0, 0, 1) column.
+
+        const float m11 = lhs.M11 * rhs.M11 + lhs.M12 * rhs.M21;
+        const float m12 = lhs.M11 * rhs.M12 + lhs.M12 * rhs.M22;
+
+        const float m21 = lhs.M21 * rhs.M11 + lhs.M22 * rhs.M21;
+        const float m22 = lhs.M21 * rhs.M12 + lhs.M22 * rhs.M22;
+
+        const float m31 = lhs.M31 * rhs.M11 + lhs.M32 * rhs.M21 + rhs.M31;
+        const float m32 = lhs.M31 * rhs.M12 + lhs.M32 * rhs.M22 + rhs.M32;
+
+        out.Set(m11, m12,
+                m21, m22,
+                m31, m32);
+    }
+
+    inline Vector2 Transform(const Vector2 & v, const Matrix3x2 & m)
+    {
+        Vector2 out;
+        Transform(v, m, out);
+        return out;
+    }
+
+    inline void Transform(const Vector2 & v, const Matrix3x2 & m, Vector2 & out)
+    {
+        const float x = v.X * m.M11 + v.Y * m.M21 + m.M31;
+        const float y = v.X * m.M12 + v.Y * m.M22 + m.M32;
+        out.Set(x, y);
+    }
+
+    inline Vector2 TransformNormal(const Vector2 & v, const Matrix3x2 & m)
+    {
+        Vector2 out;
+        TransformNormal(v, m, out);
+        return out;
+    }
+
+    inline void TransformNormal(const Vector2 & v, const Matrix3x2 & m, Vector2 & out)
+    {
+        const float x = v.X * m.M11 + v.Y * m.M21;
+        const float y = v.X * m.M12 + v.Y * m.M22;
+        out.Set(x, y);
+    }
+
+    inline Rect Transform(const Rect & r, const Matrix3x2 & m)
+    {
+        Rect out;
+        Transform(r, m, out);
+        return out;
+    }
+
+    inline void Transform(const Rect & r, const Matrix3x2 & m, Rect & out)
+    {
+        // The corners are position + (0 or width) * row1 + (0 or height) * row2, so instead of
+        // transforming all 4, each axis of the bounds takes the negative (min) or absolute (size)
+        // parts of the width and height terms.
+
+        const float wx = r.Width * m.M11;
+        const float wy = r.Width * m.M12;
+        const float hx = r.Height * m.M21;
+        const float hy = r.Height * m.M22;
+
+        const float x = r.X * m.M11 + r.Y * m.M21 + m.M31 + Min(wx, 0.0f) + Min(hx, 0.0f);
+        const float y = r.X * m.M12 + r.Y * m.M22 + m.M32 + Min(wy, 0.0f) + Min(hy, 0.0f);
+
+        out.Set(x, y, Abs(wx) + Abs(hx), Abs(wy) + Abs(hy));
+    }
+
+    inline float Determinant(const Matrix3x2 & m)
+    {
+        return m.M11 * m.M22 - m.M12 * m.M21;
+    }
+
+    inline Matrix3x2 Inverse(const Matrix3x2 & m)
+    {
+        Matrix3x2 out;
+        Inverse(m, out);
+        return out;
+    }
+
+    inline void Inverse(const Matrix3x2 & m, Matrix3x2 & out)
+    {
+        // Inverse of the 2x2 part, and the translation moved back through it.
+
+        const float det = Determinant(m);
+
+        // Only an exact zero fails, ui and map transforms are often scaled well below 1.
+        if (ExactlyZero(det))
+        {
+            // Not possible to invert
+            DebugAssert(false, "Trying to invert a matrix that has no inverse (0 determinant).");
+            out.Set(Matrix3x2::Zero);
+            return;
+        }
+
+        const float invDet = 1.0f / det;
+
+        const float m11 =  m.M22 * invDet;
+        const float m12 = -m.M12 * invDet;
+        const float m21 = -m.M21 * invDet;
+        const float m22 =  m.M11 * invDet;
+
+        const float m31 = -(m.M31 * m11 + m.M32 * m21);
+        const float m32 = -(m.M31 * m12 + m.M32 * m22);
+
+        out.Set(m11, m12,
+                m21, m22,
+                m31, m32);
+    }
+
+    inline Matrix4x4 ToMatrix4x4(const Matrix3x2 & m)
+    {
+        Matrix4x4 out;
+        ToMatrix4x4(m, out);
+        return out;
+    }
+
+    inline void ToMatrix4x4(const Matrix3x2 & m, Matrix4x4 & out)
+    {
+        out.Set(m.M11, m.M12, 0.0f, 0.0f,
+                m.M21, m.M22, 0.0f, 0.0f,
+                0.0f,  0.0f,  1.0f, 0.0f,
+                m.M31, m.M32, 0.0f, 1.0f);
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_MATRIX3X2_INL_
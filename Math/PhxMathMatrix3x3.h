@@ -0,0 +1,167 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_MATRIX3X3_H_
+#define _PHX_MATH_MATRIX3X3_H_
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// Row Major Matrix
+// Row Vectors
+// Pre-multiplication
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// Same conventions as Matrix4x4, holds the
+// rotation and scale (upper 3x3) part of one.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+namespace Phx {
+namespace Math {
+
+    class Matrix3x3
+    {
+    public:
+        float M11;
+        float M12;
+        float M13;
+        float M21;
+        float M22;
+        float M23;
+        float M31;
+        float M32;
+        float M33;
+
+    public:
+        static const Matrix3x3 Zero;
+        static const Matrix3x3 Identity;
+
+    public:
+        static inline Matrix3x3 CreateIdentity();
+        static inline void CreateIdentity(Matrix3x3 & out);
+
+        static inline Matrix3x3 CreateFromQuaternion(const Quaternion & q);
+        static inline void CreateFromQuaternion(const Quaternion & q, Matrix3x3 & out);
+
+        static inline Matrix3x3 CreateFromAxisAngle(const Vector3 & axis, float radians);
+        static inline void CreateFromAxisAngle(const Vector3 & axis, float radians, Matrix3x3 & out);
+
+        // The upper 3x3 of m, translation and projection are dropped.
+        static inline Matrix3x3 CreateFromMatrix4x4(const Matrix4x4 & m);
+        static inline void CreateFromMatrix4x4(const Matrix4x4 & m, Matrix3x3 & out);
+
+        static inline Matrix3x3 CreateRotationX(float radians);
+        static inline void CreateRotationX(float radians, Matrix3x3 & out);
+
+        static inline Matrix3x3 CreateRotationY(float radians);
+        static inline void CreateRotationY(float radians, Matrix3x3 & out);
+
+        static inline Matrix3x3 CreateRotationZ(float radians);
+        static inline void CreateRotationZ(float radians, Matrix3x3 & out);
+
+        static inline Matrix3x3 CreateScale(const Vector3 & scale);
+        static inline void CreateScale(const Vector3 & scale, Matrix3x3 & out);
+
+    public:
+        inline Matrix3x3()
+        {
+            // Do nothing in the default ctor.
+            // So we don't have to pay for arrays or matrices initialized as an out parameter.
+        }
+
+        inline explicit Matrix3x3(const Vector3 & row1,
+                                  const Vector3 & row2,
+                                  const Vector3 & row3);
+
+        inline explicit Matrix3x3(float m11, float m12, float m13,
+                                  float m21, float m22, float m23,
+                                  float m31, float m32, float m33);
+
+        inline Matrix3x3(const Matrix3x3 & src);
+
+        inline ~Matrix3x3() { }
+
+        inline Matrix3x3 & operator=(const Matrix3x3 & rhs);
+
+        inline float & operator[](unsigned int idx);
+        inline const float & operator[](unsigned int idx) const;
+
+        inline Matrix3x3 & operator*=(const Matrix3x3 & rhs);
+        inline Matrix3x3 & operator*=(float rhs);
+
+        inline float Determinant() const;
+
+        inline void Inverse();
+        inline void Transpose();
+
+        inline void Set(const Matrix3x3 & src);
+        inline void Set(const float * pSrc);
+        inline void Set(const Vector3 & row1,
+                        const Vector3 & row2,
+                        const Vector3 & row3);
+        inline void Set(float m11, float m12, float m13,
+                        float m21, float m22, float m23,
+                        float m31, float m32, float m33);
+        inline void Set(float f);
+
+        inline Vector3 & Row(unsigned int idx);
+        inline const Vector3 & Row(unsigned int idx) const;
+
+        inline float * ToArray();
+        inline const float * ToArray() const;
+    };
+
+    inline bool operator==(const Matrix3x3 & lhs, const Matrix3x3 & rhs);
+    inline bool operator!=(const Matrix3x3 & lhs, const Matrix3x3 & rhs);
+
+    inline Matrix3x3 operator*(const Matrix3x3 & lhs, const Matrix3x3 & rhs);
+    inline Matrix3x3 operator*(const Matrix3x3 & lhs, float rhs);
+
+    inline bool ExactlyEqual(const Matrix3x3 & lhs, const Matrix3x3 & rhs);
+    inline bool NearlyEqual(const Matrix3x3 & lhs, const Matrix3x3 & rhs);
+
+    inline Matrix3x3 Multiply(const Matrix3x3 & lhs, const Matrix3x3 & rhs);
+    inline Matrix3x3 Multiply(const Matrix3x3 & lhs, float rhs);
+    inline void Multiply(const Matrix3x3 & lhs, const Matrix3x3 & rhs, Matrix3x3 & out);
+    inline void Multiply(const Matrix3x3 & lhs, float rhs, Matrix3x3 & out);
+
+    inline Vector3 Transform(const Vector3 & v, const Matrix3x3 & m);
+    inline void Transform(const Vector3 & v, const Matrix3x3 & m, Vector3 & out);
+
+    inline float Determinant(const Matrix3x3 & m);
+
+    inline Matrix3x3 Inverse(const Matrix3x3 & m);
+    inline void Inverse(const Matrix3x3 & m, Matrix3x3 & out);
+
+    inline Matrix3x3 Transpose(const Matrix3x3 & m);
+    inline void Transpose(const Matrix3x3 & m, Matrix3x3 & out);
+
+    // Inverse transpose of the upper 3x3 of m, transforms normals (and other directions
+    // that must stay perpendicular to surfaces) by m. Renormalize the results if m has scale.
+    inline Matrix3x3 NormalMatrix(const Matrix4x4 & m);
+    inline void NormalMatrix(const Matrix4x4 & m, Matrix3x3 & out);
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_MATRIX3X3_H_
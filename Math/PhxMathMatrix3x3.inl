@@ -0,0 +1,572 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_MATRIX3X3_INL_
+#define _PHX_MATH_MATRIX3X3_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline Matrix3x3 Matrix3x3::CreateIdentity()
+    {
+        Matrix3x3 out;
+        CreateIdentity(out);
+        return out;
+    }
+
+    inline void Matrix3x3::CreateIdentity(Matrix3x3 & out)
+    {
+        out.Set(Matrix3x3::Identity);
+    }
+
+    inline Matrix3x3 Matrix3x3::CreateFromQuaternion(const Quaternion & q)
+    {
+        Matrix3x3 out;
+        CreateFromQuaternion(q, out);
+        return out;
+    }
+
+    inline void Matrix3x3::CreateFromQuaternion(const Quaternion & q, Matrix3x3 & out)
+    {
+        // Same conversion as Matrix4x4::CreateFromQuaternion.
+        //
+        // [ 1 - 2yy - 2zz, 2xy + 2wz,     2xz - 2wy     ]
+        // [ 2xy - 2wz,     1 - 2xx - 2zz, 2yz + 2wx     ]
+        // [ 2xz + 2wy,     2yz - 2wx,     1 - 2xx - 2yy ]
+
+        DebugAssert(IsNormalized(q), "Quaternion must be normalized to create a matrix.");
+
+        const float s = 2.0f;
+
+        const float x = s * q.X;
+        const float y = s * q.Y;
+        const float z = s * q.Z;
+
+        const float xx = x * q.X;
+        const float yy = y * q.Y;
+        const float zz = z * q.Z;
+
+        const float wx = x * q.W;
+        const float wy = y * q.W;
+        const float wz = z * q.W;
+
+        const float xy = x * q.Y;
+        const float xz = x * q.Z;
+        const float yz = y * q.Z;
+
+        out.Set(1.0f - yy - zz, xy + wz,        xz - wy,
+                xy - wz,        1.0f - xx - zz, yz + wx,
+                xz + wy,        yz - wx,        1.0f - xx - yy);
+    }
+
+    inline Matrix3x3 Matrix3x3::CreateFromAxisAngle(const Vector3 & axis, float radians)
+    {
+        Matrix3x3 out;
+        CreateFromAxisAngle(axis, radians, out);
+        return out;
+    }
+
+    inline void Matrix3x3::CreateFromAxisAngle(const Vector3 & axis, float radians, Matrix3x3 & out)
+    {
+        // Same rotation as Matrix4x4::CreateFromAxisAngle.
+        //
+        // [ txx + c,  txy + sz, txz - sy ]
+        // [ txy - sz, tyy + c,  tyz + sx ]
+        // [ txz + sy, tyz - sx, tzz + c  ]
+        //
+        // Where c = cos(theta), s = sin(theta), t = 1 - cos(theta)
+
+        DebugAssert(IsNormalized(axis), "Invalid param: axis vector needs to be normalized.");
+
+        float s, c;
+        SinCos(radians, &s, &c);
+
+        const float t = 1.0f - c;
+
+        const float xy = axis.X * axis.Y;
+        const float xz = axis.X * axis.Z;
+        const float yz = axis.Y * axis.Z;
+
+        out.Set(t * axis.X * axis.X + c, t * xy + s * axis.Z,     t * xz - s * axis.Y,
+                t * xy - s * axis.Z,     t * axis.Y * axis.Y + c, t * yz + s * axis.X,
+                t * xz + s * axis.Y,     t * yz - s * axis.X,     t * axis.Z * axis.Z + c);
+    }
+
+    inline Matrix3x3 Matrix3x3::CreateFromMatrix4x4(const Matrix4x4 & m)
+    {
+        Matrix3x3 out;
+        CreateFromMatrix4x4(m, out);
+        return out;
+    }
+
+    inline void Matrix3x3::CreateFromMatrix4x4(const Matrix4x4 & m, Matrix3x3 & out)
+    {
+        out.Set(m.M11, m.M12, m.M13,
+                m.M21, m.M22, m.M23,
+                m.M31, m.M32, m.M33);
+    }
+
+    inline Matrix3x3 Matrix3x3::CreateRotationX(float radians)
+    {
+        Matrix3x3 out;
+        CreateRotationX(radians, out);
+        return out;
+    }
+
+    inline void Matrix3x3::CreateRotationX(float radians, Matrix3x3 & out)
+    {
+        float sinTheta, cosTheta;
+        SinCos(radians, &sinTheta, &cosTheta);
+
+        out.Set(1.0f,  0.0f,     0.0f,
+                0.0f,  cosTheta, sinTheta,
+                0.0f, -sinTheta, cosTheta);
+    }
+
+    inline Matrix3x3 Matrix3x3::CreateRotationY(float radians)
+    {
+        Matrix3x3 out;
+        CreateRotationY(radians, out);
+        return out;
+    }
+
+    inline void Matrix3x3::CreateRotationY(float radians, Matrix3x3 & out)
+    {
+        float sinTheta, cosTheta;
+        SinCos(radians, &sinTheta, &cosTheta);
+
+        out.Set(cosTheta, 0.0f, -sinTheta,
+                0.0f,     1.0f,  0.0f,
+                sinTheta, 0.0f,  cosTheta);
+    }
+
+    inline Matrix3x3 Matrix3x3::CreateRotationZ(float radians)
+    {
+        Matrix3x3 out;
+        CreateRotationZ(radians, out);
+        return out;
+    }
+
+    inline void Matrix3x3::CreateRotationZ(float radians, Matrix3x3 & out)
+    {
+        float sinTheta, cosTheta;
+        SinCos(radians, &sinTheta, &cosTheta);
+
+        out.Set( cosTheta, sinTheta, 0.0f,
+                -sinTheta, cosTheta, 0.0f,
+                 0.0f,     0.0f,     1.0f);
+    }
+
+    inline Matrix3x3 Matrix3x3::CreateScale(const Vector3 & scale)
+    {
+        Matrix3x3 out;
+        CreateScale(scale, out);
+        return out;
+    }
+
+    inline void Matrix3x3::CreateScale(const Vector3 & scale, Matrix3x3 & out)
+    {
+        out.Set(scale.X, 0.0f,    0.0f,
+                0.0f,    scale.Y, 0.0f,
+                0.0f,    0.0f,    scale.Z);
+    }
+
+    inline Matrix3x3::Matrix3x3(const Vector3 & row1, const Vector3 & row2, const Vector3 & row3)
+    {
+        Set(row1, row2, row3);
+    }
+
+    inline Matrix3x3::Matrix3x3(float m11, float m12, float m13,
+                                float m21, float m22, float m23,
+                                float m31, float m32, float m33)
+    {
+        Set(m11, m12, m13,
+            m21, m22, m23,
+            m31, m32, m33);
+    }
+
+    inline Matrix3x3::Matrix3x3(const Matrix3x3 & src)
+    {
+        Set(src);
+    }
+
+    inline Matrix3x3 & Matrix3x3::operator=(const Matrix3x3 & rhs)
+    {
+        Set(rhs);
+        return *this;
+    }
+
+    inline float & Matrix3x3::operator[](unsigned int idx)
+    {
+        DebugAssert(idx < 9, "Invalid index (%u) into a matrix 3x3!", idx);
+        return ToArray()[idx];
+    }
+
+    inline const float & Matrix3x3::operator[](unsigned int idx) const
+    {
+        DebugAssert(idx < 9, "Invalid index (%u) into a matrix 3x3!", idx);
+        return ToArray()[idx];
+    }
+
+    inline Matrix3x3 & Matrix3x3::operator*=(const Matrix3x3 & rhs)
+    {
+        Math::Multiply(*this, rhs, *this);
+        return *this;
+    }
+
+    inline Matrix3x3 & Matrix3x3::operator*=(float rhs)
+    {
+        Math::Multiply(*this, rhs, *this);
+        return *this;
+    }
+
+    inline float Matrix3x3::Determinant() const
+    {
+        return Math::Determinant(*this);
+    }
+
+    inline void Matrix3x3::Inverse()
+    {
+        Math::Inverse(*this, *this);
+    }
+
+    inline void Matrix3x3::Transpose()
+    {
+        Math::Transpose(*this, *this);
+    }
+
+    inline void Matrix3x3::Set(const Matrix3x3 & src)
+    {
+        this->M11 = src.M11;
+        this->M12 = src.M12;
+        this->M13 = src.M13;
+        this->M21 = src.M21;
+        this->M22 = src.M22;
+        this->M23 = src.M23;
+        this->M31 = src.M31;
+        this->M32 = src.M32;
+        this->M33 = src.M33;
+    }
+
+    inline void Matrix3x3::Set(const float * pSrc)
+    {
+        DebugAssert(pSrc != nullptr, "Trying to set a matrix 3x3 from a null array!");
+        memcpy(ToArray(), pSrc, sizeof(float) * 9);
+    }
+
+    inline void Matrix3x3::Set(const Vector3 & row1, const Vector3 & row2, const Vector3 & row3)
+    {
+        Set(row1.X, row1.Y, row1.Z,
+            row2.X, row2.Y, row2.Z,
+            row3.X, row3.Y, row3.Z);
+    }
+
+    inline void Matrix3x3::Set(float m11, float m12, float m13,
+                               float m21, float m22, float m23,
+                               float m31, float m32, float m33)
+    {
+        this->M11 = m11;
+        this->M12 = m12;
+        this->M13 = m13;
+        this->M21 = m21;
+        this->M22 = m22;
+        this->M23 = m23;
+        this->M31 = m31;
+        this->M32 = m32;
+        this->M33 = m33;
+    }
+
+    inline void Matrix3x3::Set(float f)
+    {
+        this->M11 = f;
+        this->M12 = f;
+        this->M13 = f;
+        this->M21 = f;
+        this->M22 = f;
+        this->M23 = f;
+        this->M31 = f;
+        this->M32 = f;
+        this->M33 = f;
+    }
+
+    inline Vector3 & Matrix3x3::Row(unsigned int idx)
+    {
+        DebugAssert(idx < 3, "Invalid row index (%u) into a matrix 3x3!", idx);
+        return *reinterpret_cast<Vector3 *>(this->ToArray() + (idx * 3));
+    }
+
+    inline const Vector3 & Matrix3x3::Row(unsigned int idx) const
+    {
+        DebugAssert(idx < 3, "Invalid row index (%u) into a matrix 3x3!", idx);
+        return *reinterpret_cast<const Vector3 *>(this->ToArray() + (idx * 3));
+    }
+
+    inline float * Matrix3x3::ToArray()
+    {
+        return &(this->M11);
+    }
+
+    inline const float * Matrix3x3::ToArray() const
+    {
+        return &(this->M11);
+    }
+
+    inline bool operator==(const Matrix3x3 & lhs, const Matrix3x3 & rhs)
+    {
+        return ExactlyEqual(lhs, rhs);
+    }
+
+    inline bool operator!=(const Matrix3x3 & lhs, const Matrix3x3 & rhs)
+    {
+        return (false == ExactlyEqual(lhs, rhs));
+    }
+
+    inline Matrix3x3 operator*(const Matrix3x3 & lhs, const Matrix3x3 & rhs)
+    {
+        Matrix3x3 out;
+        Multiply(lhs, rhs, out);
+        return out;
+    }
+
+    inline Matrix3x3 operator*(const Matrix3x3 & lhs, float rhs)
+    {
+        Matrix3x3 out;
+        Multiply(lhs, rhs, out);
+        return out;
+    }
+
+    inline bool ExactlyEqual(const Matrix3x3 & lhs, const Matrix3x3 & rhs)
+    {
+        return (ExactlyEqual(lhs.M11, rhs.M11) &&
+                ExactlyEqual(lhs.M12, rhs.M12) &&
+                ExactlyEqual(lhs.M13, rhs.M13) &&
+                ExactlyEqual(lhs.M21, rhs.M21) &&
+                ExactlyEqual(lhs.M22, rhs.M22) &&
+                ExactlyEqual(lhs.M23, rhs.M23) &&
+                ExactlyEqual(lhs.M31, rhs.M31) &&
+                ExactlyEqual(lhs.M32, rhs.M32) &&
+                ExactlyEqual(lhs.M33, rhs.M33));
+    }
+
+    inline bool NearlyEqual(const Matrix3x3 & lhs, const Matrix3x3 & rhs)
+    {
+        return (NearlyEqual(lhs.M11, rhs.M11) &&
+                NearlyEqual(lhs.M12, rhs.M12) &&
+                NearlyEqual(lhs.M13, rhs.M13) &&
+                NearlyEqual(lhs.M21, rhs.M21) &&
+                NearlyEqual(lhs.M22, rhs.M22) &&
+                NearlyEqual(lhs.M23, rhs.M23) &&
+                NearlyEqual(lhs.M31, rhs.M31) &&
+                NearlyEqual(lhs.M32, rhs.M32) &&
+                NearlyEqual(lhs.M33, rhs.M33));
+    }
+
+    inline Matrix3x3 Multiply(const Matrix3x3 & lhs, const Matrix3x3 & rhs)
+    {
+        Matrix3x3 out;
+        Multiply(lhs, rhs, out);
+        return out;
+    }
+
+    inline Matrix3x3 Multiply(const Matrix3x3 & lhs, float rhs)
+    {
+        Matrix3x3 out;
+        Multiply(lhs, rhs, out);
+        return out;
+    }
+
+    inline void Multiply(const Matrix3x3 & lhs, const Matrix3x3 & rhs, Matrix3x3 & out)
+    {
+        // Pre multiplication: lhs * rhs = lhs transformed by rhs.
+
+        const float m11 = lhs.M11 * rhs.M11 + lhs.M12 * rhs.M21 + lhs.M13 * rhs.M31;
+        const float m12 = lhs.M11 * rhs.M12 + lhs.M12 * rhs.M22 + lhs.M13 * rhs.M32;
+        const float m13 = lhs.M11 * rhs.M13 + lhs.M12 * rhs.M23 + lhs.M13 * rhs.M33;
+
+        const float m21 = lhs.M21 * rhs.M11 + lhs.M22 * rhs.M21 + lhs.M23 * rhs.M31;
+        const float m22 = lhs.M21 * rhs.M12 + lhs.M22 * rhs.M22 + lhs.M23 * rhs.M32;
+        const float m23 = lhs.M21 * rhs.M13 + lhs.M22 * rhs.M23 + lhs.M23 * rhs.M33;
+
+        const float m31 = lhs.M31 * rhs.M11 + lhs.M32 * rhs.M21 + lhs.M33 * rhs.M31;
+        const float m32 = lhs.M31 * rhs.M12 + lhs.M32 * rhs.M22 + lhs.M33 * rhs.M32;
+        const float m33 = lhs.M31 * rhs.M13 + lhs.M32 * rhs.M23 + lhs.M33 * rhs.M33;
+
+        out.Set(m11, m12, m13,
+                m21, m22, m23,
+                m31, m32, m33);
+    }
+
+    inline void Multiply(const Matrix3x3 & lhs, float rhs, Matrix3x3 & out)
+    {
+        out.M11 = lhs.M11 * rhs;
+        out.M12 = lhs.M12 * rhs;
+        out.M13 = lhs.M13 * rhs;
+        out.M21 = lhs.M21 * rhs;
+        out.M22 = lhs.M22 * rhs;
+        out.M23 = lhs.M23 * rhs;
+        out.M31 = lhs.M31 * rhs;
+        out.M32 = lhs.M32 * rhs;
+        out.M33 = lhs.M33 * rhs;
+    }
+
+    inline Vector3 Transform(const Vector3 & v, const Matrix3x3 & m)
+    {
+        Vector3 out;
+        Transform(v, m, out);
+        return out;
+    }
+
+    inline void Transform(const Vector3 & v, const Matrix3x3 & m, Vector3 & out)
+    {
+        const float x = v.X * m.M11 + v.Y * m.M21 + v.Z * m.M31;
+        const float y = v.X * m.M12 + v.Y * m.M22 + v.Z * m.M32;
+        const float z = v.X * m.M13 + v.Y * m.M23 + v.Z * m.M33;
+        out.Set(x, y, z);
+    }
+
+    inline float Determinant(const Matrix3x3 & m)
+    {
+        // Row 1 dotted with the cross product of rows 2 and 3.
+        return m.M11 * (m.M22 * m.M33 - m.M23 * m.M32) +
+               m.M12 * (m.M23 * m.M31 - m.M21 * m.M33) +
+               m.M13 * (m.M21 * m.M32 - m.M22 * m.M31);
+    }
+
+    inline Matrix3x3 Inverse(const Matrix3x3 & m)
+    {
+        Matrix3x3 out;
+        Inverse(m, out);
+        return out;
+    }
+
+    inline void Inverse(const Matrix3x3 & m, Matrix3x3 & out)
+    {
+        // Adjugate / determinant. The cofactors of row i are the cross product of the other
+        // two rows, and the adjugate is the transpose of the cofactors, so they are written
+        // as the columns of the result.
+
+        const float c11 = m.M22 * m.M33 - m.M23 * m.M32;
+        const float c12 = m.M23 * m.M31 - m.M21 * m.M33;
+        const float c13 = m.M21 * m.M32 - m.M22 * m.M31;
+
+        const float det = m.M11 * c11 + m.M12 * c12 + m.M13 * c13;
+
+        if (NearlyZero(det))
+        {
+            // Not possible to invert
+            DebugAssert(false, "Trying to invert a matrix that has no inverse (0 determinant).");
+            out.Set(Matrix3x3::Zero);
+            return;
+        }
+
+        const float invDet = 1.0f / det;
+
+        const float c21 = m.M13 * m.M32 - m.M12 * m.M33;
+        const float c22 = m.M11 * m.M33 - m.M13 * m.M31;
+        const float c23 = m.M12 * m.M31 - m.M11 * m.M32;
+
+        const float c31 = m.M12 * m.M23 - m.M13 * m.M22;
+        const float c32 = m.M13 * m.M21 - m.M11 * m.M23;
+        const float c33 = m.M11 * m.M22 - m.M12 * m.M21;
+
+        out.Set(c11 * invDet, c21 * invDet, c31 * invDet,
+                c12 * invDet, c22 * invDet, c32 * invDet,
+                c13 * invDet, c23 * invDet, c33 * invDet);
+    }
+
+    inline Matrix3x3 Transpose(const Matrix3x3 & m)
+    {
+        Matrix3x3 out;
+        Transpose(m, out);
+        return out;
+    }
+
+    inline void Transpose(const Matrix3x3 & m, Matrix3x3 & out)
+    {
+        out.M11 = m.M11;
+
+        float swap = m.M12;
+        out.M12 = m.M21;
+        out.M21 = swap;
+
+        swap = m.M13;
+        out.M13 = m.M31;
+        out.M31 = swap;
+
+        out.M22 = m.M22;
+
+        swap = m.M23;
+        out.M23 = m.M32;
+        out.M32 = swap;
+
+        out.M33 = m.M33;
+    }
+
+    inline Matrix3x3 NormalMatrix(const Matrix4x4 & m)
+    {
+        Matrix3x3 out;
+        NormalMatrix(m, out);
+        return out;
+    }
+
+    inline void NormalMatrix(const Matrix4x4 & m, Matrix3x3 & out)
+    {
+        // The inverse transpose is the cofactor matrix / determinant, and the cofactors of each
+        // row are the cross product of the other two rows, so no transpose or full inverse is needed.
+
+        const float c11 = m.M22 * m.M33 - m.M23 * m.M32;
+        const float c12 = m.M23 * m.M31 - m.M21 * m.M33;
+        const float c13 = m.M21 * m.M32 - m.M22 * m.M31;
+
+        const float det = m.M11 * c11 + m.M12 * c12 + m.M13 * c13;
+
+        // Only an exact zero fails, a small uniform scale gives a small determinant but a fine normal matrix.
+        if (ExactlyZero(det))
+        {
+            DebugAssert(false, "Trying to create a normal matrix from a matrix that has no inverse (0 determinant).");
+            out.Set(Matrix3x3::Zero);
+            return;
+        }
+
+        const float invDet = 1.0f / det;
+
+        out.M11 = c11 * invDet;
+        out.M12 = c12 * invDet;
+        out.M13 = c13 * invDet;
+
+        out.M21 = (m.M32 * m.M13 - m.M33 * m.M12) * invDet;
+        out.M22 = (m.M33 * m.M11 - m.M31 * m.M13) * invDet;
+        out.M23 = (m.M31 * m.M12 - m.M32 * m.M11) * invDet;
+
+        out.M31 = (m.M12 * m.M23 - m.M13 * m.M22) * invDet;
+        out.M32 = (m.M13 * m.M21 - m.M11 * m.M23) * invDet;
+        out.M33 = (m.M11 * m.M22 - m.M12 * m.M21) * invDet;
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_MATRIX3X3_INL_
@@ -51,7 +51,7 @@ THE SOFTWARE
 namespace Phx {
 namespace Math {
 
-    class Matrix4x4
+    class PHX_ALIGN(64) Matrix4x4
     {
     public:
         float M11;
@@ -1251,6 +1251,9 @@ namespace Math {
         //
         // Ref: http://www.geometrictools.com/Documentation/LaplaceExpansionTheorem.pdf
 
+        PHX_MATH_SHADOW_CALL(MatrixInverse, ShadowInverse(m, out));
+        PHX_MATH_STAT_TIMED(MatrixInverse);
+
         // 2x2 Determinants
         const float s0 = (m.M11 * m.M22) - (m.M12 * m.M21);
         const float s1 = (m.M11 * m.M23) - (m.M13 * m.M21);
@@ -1273,6 +1276,7 @@ namespace Math {
         {
             // Not possible to invert
             DebugAssert(false, "Trying to invert a matrix that has no inverse (0 determinant).");
+            PHX_MATH_STAT_COUNT(MatrixInverseSingular);
             out.Set(Matrix4x4::Zero);
             return;
         }
@@ -1427,6 +1431,9 @@ namespace Math {
         // This isn't the most robust implementation of matrix decomposition (more roboust methods are prohibitively expensive).
         // It will fail sometimes if m was created by a series of Scale Rotation Translation concatenations (object hierarchies: SRT2 * SRT1 * SRT0).
 
+        PHX_MATH_SHADOW_CALL(MatrixDecompose, ShadowDecompose(m, outScale, outOrientation, outTranslation));
+        PHX_MATH_STAT_TIMED(MatrixDecompose);
+
         outTranslation.Set(m.M41, m.M42, m.M43);
 
         float x = m.M11 * m.M11 + m.M12 * m.M12 + m.M13 * m.M13;
@@ -1435,6 +1442,7 @@ namespace Math {
 
         if (NearlyZero(x) || NearlyZero(y) || NearlyZero(z))
         {
+            PHX_MATH_STAT_COUNT(MatrixDecomposeFailed);
             outScale.Set(Vector3::One);
             outOrientation.Set(Quaternion::Identity);
             return false;
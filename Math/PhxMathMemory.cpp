@@ -0,0 +1,69 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathMemory.h"
+
+#if defined(_MSC_VER)
+# include <malloc.h>
+#else
+# include <stdlib.h>
+#endif
+
+namespace Phx {
+namespace Math {
+
+    void * AlignedAlloc(size_t bytes, size_t alignment)
+    {
+        DebugAssert((alignment & (alignment - 1)) == 0, "Alignment (%u) must be a power of two.", alignment);
+
+        if (alignment < sizeof(void *))
+        {
+            alignment = sizeof(void *);
+        }
+
+#if defined(_MSC_VER)
+        return _aligned_malloc(bytes, alignment);
+#else
+        void * p = nullptr;
+        if (posix_memalign(&p, alignment, bytes) != 0)
+        {
+            return nullptr;
+        }
+        return p;
+#endif
+    }
+
+    void AlignedFree(void * p)
+    {
+#if defined(_MSC_VER)
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+    }
+
+} //namespace Math
+} //namespace Phx
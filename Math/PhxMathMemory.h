@@ -0,0 +1,157 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_MEMORY_H_
+#define _PHX_MATH_MEMORY_H_
+
+#include "PhxMath.h"
+
+// C Standard Library Includes
+#include <stddef.h>
+
+// C++ Standard Library Includes
+#include <new>
+
+// Size of a cache line on the platforms we care about.
+// Used as the default alignment for arrays so 16 and 64 byte elements (Vector4, Matrix4x4)
+// never straddle two cache lines, and so arrays written by different threads don't share a
+// cache line. The batch kernels still use unaligned loads and stores: they take any pointer
+// (and PHX_ALIGN can be defined empty), and on aligned addresses the unaligned instructions
+// run as fast as the aligned ones.
+#ifndef PHX_CACHE_LINE_SIZE
+# define PHX_CACHE_LINE_SIZE 64
+#endif
+
+namespace Phx {
+namespace Math {
+
+    void * AlignedAlloc(size_t bytes, size_t alignment);
+    void AlignedFree(void * p);
+
+    inline bool IsAligned(const void * p, size_t alignment);
+
+    template <class T>
+    inline T * AlignedAllocArray(unsigned int count, size_t alignment = PHX_CACHE_LINE_SIZE);
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Aligned allocator that can be used with the standard containers.
+    //   std::vector<Matrix4x4, AlignedAllocator<Matrix4x4> > matrices;
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    template <class T, size_t Alignment = PHX_CACHE_LINE_SIZE>
+    class AlignedAllocator
+    {
+    public:
+        typedef T value_type;
+        typedef T * pointer;
+        typedef const T * const_pointer;
+        typedef T & reference;
+        typedef const T & const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template <class U>
+        struct rebind
+        {
+            typedef AlignedAllocator<U, Alignment> other;
+        };
+
+    public:
+        inline AlignedAllocator() { }
+        inline AlignedAllocator(const AlignedAllocator &) { }
+        template <class U>
+        inline AlignedAllocator(const AlignedAllocator<U, Alignment> &) { }
+
+        inline T * allocate(size_t count);
+        inline void deallocate(T * p, size_t count);
+    };
+
+    template <class T, class U, size_t Alignment>
+    inline bool operator==(const AlignedAllocator<T, Alignment> & lhs, const AlignedAllocator<U, Alignment> & rhs);
+    template <class T, class U, size_t Alignment>
+    inline bool operator!=(const AlignedAllocator<T, Alignment> & lhs, const AlignedAllocator<U, Alignment> & rhs);
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Growable array with aligned storage.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Meant for the PhxMath types and other plain data: elements are moved
+    // with memcpy and no constructors or destructors are run, the same way
+    // the math types leave their members uninitialized in the default ctor.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    template <class T, size_t Alignment = PHX_CACHE_LINE_SIZE>
+    class AlignedArray
+    {
+    public:
+        inline AlignedArray();
+        inline explicit AlignedArray(unsigned int count);
+        inline ~AlignedArray();
+
+        inline T & operator[](unsigned int idx);
+        inline const T & operator[](unsigned int idx) const;
+
+        inline void Reserve(unsigned int capacity);
+        inline void Resize(unsigned int count);
+        inline void Clear();
+        inline void Release();
+
+        inline T & PushBack(const T & value);
+        inline void PopBack();
+
+        inline void Swap(AlignedArray & other);
+
+        inline unsigned int GetCount() const;
+        inline unsigned int GetCapacity() const;
+        inline bool IsEmpty() const;
+
+        inline T * GetData();
+        inline const T * GetData() const;
+
+        inline T * begin();
+        inline const T * begin() const;
+        inline T * end();
+        inline const T * end() const;
+
+    private:
+        // Non-copyable, use Swap to move the contents.
+        AlignedArray(const AlignedArray &);
+        AlignedArray & operator=(const AlignedArray &);
+
+        // Throws std::bad_alloc when out of memory.
+        static inline T * Allocate(unsigned int capacity);
+
+    private:
+        T * m_pData;
+        unsigned int m_count;
+        unsigned int m_capacity;
+    };
+
+} //namespace Math
+} //namespace Phx
+
+#include "PhxMathMemory.inl"
+
+#endif //_PHX_MATH_MEMORY_H_
@@ -0,0 +1,280 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_MEMORY_INL_
+#define _PHX_MATH_MEMORY_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline bool IsAligned(const void * p, size_t alignment)
+    {
+        DebugAssert((alignment & (alignment - 1)) == 0, "Alignment (%u) must be a power of two.", alignment);
+        return ((reinterpret_cast<size_t>(p) & (alignment - 1)) == 0);
+    }
+
+    template <class T>
+    inline T * AlignedAllocArray(unsigned int count, size_t alignment)
+    {
+        DebugAssert(alignment >= alignof(T), "Alignment (%u) is less than the alignment of the type (%u).", alignment, alignof(T));
+        return static_cast<T *>(AlignedAlloc(sizeof(T) * count, alignment));
+    }
+
+    template <class T, size_t Alignment>
+    inline T * AlignedAllocator<T, Alignment>::allocate(size_t count)
+    {
+        void * p = AlignedAlloc(sizeof(T) * count, (Alignment < alignof(T)) ? alignof(T) : Alignment);
+        if (p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(p);
+    }
+
+    template <class T, size_t Alignment>
+    inline void AlignedAllocator<T, Alignment>::deallocate(T * p, size_t)
+    {
+        AlignedFree(p);
+    }
+
+    template <class T, class U, size_t Alignment>
+    inline bool operator==(const AlignedAllocator<T, Alignment> &, const AlignedAllocator<U, Alignment> &)
+    {
+        return true;
+    }
+
+    template <class T, class U, size_t Alignment>
+    inline bool operator!=(const AlignedAllocator<T, Alignment> &, const AlignedAllocator<U, Alignment> &)
+    {
+        return false;
+    }
+
+    template <class T, size_t Alignment>
+    inline AlignedArray<T, Alignment>::AlignedArray()
+        : m_pData(nullptr)
+        , m_count(0)
+        , m_capacity(0)
+    { }
+
+    template <class T, size_t Alignment>
+    inline AlignedArray<T, Alignment>::AlignedArray(unsigned int count)
+        : m_pData(nullptr)
+        , m_count(0)
+        , m_capacity(0)
+    {
+        Resize(count);
+    }
+
+    template <class T, size_t Alignment>
+    inline AlignedArray<T, Alignment>::~AlignedArray()
+    {
+        Release();
+    }
+
+    template <class T, size_t Alignment>
+    inline T & AlignedArray<T, Alignment>::operator[](unsigned int idx)
+    {
+        DebugAssert(idx < m_count, "Invalid index (%u) into an aligned array of size (%u)!", idx, m_count);
+        return m_pData[idx];
+    }
+
+    template <class T, size_t Alignment>
+    inline const T & AlignedArray<T, Alignment>::operator[](unsigned int idx) const
+    {
+        DebugAssert(idx < m_count, "Invalid index (%u) into an aligned array of size (%u)!", idx, m_count);
+        return m_pData[idx];
+    }
+
+    template <class T, size_t Alignment>
+    inline void AlignedArray<T, Alignment>::Reserve(unsigned int capacity)
+    {
+        if (capacity <= m_capacity)
+        {
+            return;
+        }
+
+        T * pData = Allocate(capacity);
+
+        if (m_pData != nullptr)
+        {
+            memcpy(static_cast<void *>(pData), m_pData, sizeof(T) * m_count);
+            AlignedFree(m_pData);
+        }
+
+        m_pData = pData;
+        m_capacity = capacity;
+    }
+
+    template <class T, size_t Alignment>
+    inline void AlignedArray<T, Alignment>::Resize(unsigned int count)
+    {
+        // New elements are left uninitialized.
+        Reserve(count);
+        m_count = count;
+    }
+
+    template <class T, size_t Alignment>
+    inline void AlignedArray<T, Alignment>::Clear()
+    {
+        // Keeps the memory around to be reused.
+        m_count = 0;
+    }
+
+    template <class T, size_t Alignment>
+    inline void AlignedArray<T, Alignment>::Release()
+    {
+        AlignedFree(m_pData);
+        m_pData = nullptr;
+        m_count = 0;
+        m_capacity = 0;
+    }
+
+    template <class T, size_t Alignment>
+    inline T * AlignedArray<T, Alignment>::Allocate(unsigned int capacity)
+    {
+        // Same as AlignedAllocator::allocate, running out of memory throws.
+        void * p = AlignedAlloc(sizeof(T) * static_cast<size_t>(capacity), (Alignment < alignof(T)) ? alignof(T) : Alignment);
+        if (p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(p);
+    }
+
+    template <class T, size_t Alignment>
+    inline T & AlignedArray<T, Alignment>::PushBack(const T & value)
+    {
+        if (m_count == m_capacity)
+        {
+            // value can be an element of this array, it is copied into the new buffer before the old one is freed.
+            if (m_capacity == 0xFFFFFFFF)
+            {
+                throw std::bad_alloc();
+            }
+
+            // Doubles, up to the largest count an unsigned int holds.
+            const unsigned int capacity = (m_capacity < 16) ? 16 : ((m_capacity < 0x80000000) ? m_capacity * 2 : 0xFFFFFFFF);
+            T * pData = Allocate(capacity);
+
+            memcpy(static_cast<void *>(pData + m_count), &value, sizeof(T));
+            if (m_pData != nullptr)
+            {
+                memcpy(static_cast<void *>(pData), m_pData, sizeof(T) * m_count);
+                AlignedFree(m_pData);
+            }
+
+            m_pData = pData;
+            m_capacity = capacity;
+        }
+        else
+        {
+            memcpy(static_cast<void *>(m_pData + m_count), &value, sizeof(T));
+        }
+
+        return m_pData[m_count++];
+    }
+
+    template <class T, size_t Alignment>
+    inline void AlignedArray<T, Alignment>::PopBack()
+    {
+        DebugAssert(m_count > 0, "Trying to pop an element off an empty aligned array!");
+        --m_count;
+    }
+
+    template <class T, size_t Alignment>
+    inline void AlignedArray<T, Alignment>::Swap(AlignedArray & other)
+    {
+        T * pData = m_pData;
+        m_pData = other.m_pData;
+        other.m_pData = pData;
+
+        unsigned int count = m_count;
+        m_count = other.m_count;
+        other.m_count = count;
+
+        unsigned int capacity = m_capacity;
+        m_capacity = other.m_capacity;
+        other.m_capacity = capacity;
+    }
+
+    template <class T, size_t Alignment>
+    inline unsigned int AlignedArray<T, Alignment>::GetCount() const
+    {
+        return m_count;
+    }
+
+    template <class T, size_t Alignment>
+    inline unsigned int AlignedArray<T, Alignment>::GetCapacity() const
+    {
+        return m_capacity;
+    }
+
+    template <class T, size_t Alignment>
+    inline bool AlignedArray<T, Alignment>::IsEmpty() const
+    {
+        return (m_count == 0);
+    }
+
+    template <class T, size_t Alignment>
+    inline T * AlignedArray<T, Alignment>::GetData()
+    {
+        return m_pData;
+    }
+
+    template <class T, size_t Alignment>
+    inline const T * AlignedArray<T, Alignment>::GetData() const
+    {
+        return m_pData;
+    }
+
+    template <class T, size_t Alignment>
+    inline T * AlignedArray<T, Alignment>::begin()
+    {
+        return m_pData;
+    }
+
+    template <class T, size_t Alignment>
+    inline const T * AlignedArray<T, Alignment>::begin() const
+    {
+        return m_pData;
+    }
+
+    template <class T, size_t Alignment>
+    inline T * AlignedArray<T, Alignment>::end()
+    {
+        return m_pData + m_count;
+    }
+
+    template <class T, size_t Alignment>
+    inline const T * AlignedArray<T, Alignment>::end() const
+    {
+        return m_pData + m_count;
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_MEMORY_INL_
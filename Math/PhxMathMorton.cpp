@@ -0,0 +1,763 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathMorton.h"
+#include "PhxMathBatch.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+# define PHX_MATH_MORTON_BMI2 1
+# include <immintrin.h>
+#else
+# define PHX_MATH_MORTON_BMI2 0
+#endif
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+        // Encoding
+        //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+        // Bounds turned into the min and scale of every axis once for the whole array.
+        struct Quantizer3
+        {
+            Vector3 Min;
+            Vector3 Scale;
+        };
+
+        struct Quantizer2
+        {
+            Vector2 Min;
+            Vector2 Scale;
+        };
+
+        void GetQuantizer(const AABB & bounds, unsigned int bits, Quantizer3 & out)
+        {
+            const Vector3 size = bounds.GetSize();
+            out.Min = bounds.Min;
+            out.Scale.Set(GetMortonScale(size.X, bits), GetMortonScale(size.Y, bits), GetMortonScale(size.Z, bits));
+        }
+
+        void GetQuantizer(const Rect & bounds, unsigned int bits, Quantizer2 & out)
+        {
+            out.Min.Set(bounds.X, bounds.Y);
+            out.Scale.Set(GetMortonScale(bounds.Width, bits), GetMortonScale(bounds.Height, bits));
+        }
+
+        void Encode30(const Vector3 * pPoints, const Quantizer3 & q, uint32_t * pOutCodes, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Vector3 & p = pPoints[i];
+                pOutCodes[i] = EncodeMorton(
+                    QuantizeMorton(p.X, q.Min.X, q.Scale.X, 10),
+                    QuantizeMorton(p.Y, q.Min.Y, q.Scale.Y, 10),
+                    QuantizeMorton(p.Z, q.Min.Z, q.Scale.Z, 10));
+            }
+        }
+
+        void Encode63(const Vector3 * pPoints, const Quantizer3 & q, uint64_t * pOutCodes, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Vector3 & p = pPoints[i];
+                pOutCodes[i] = EncodeMorton64(
+                    QuantizeMorton(p.X, q.Min.X, q.Scale.X, 21),
+                    QuantizeMorton(p.Y, q.Min.Y, q.Scale.Y, 21),
+                    QuantizeMorton(p.Z, q.Min.Z, q.Scale.Z, 21));
+            }
+        }
+
+        void Encode32(const Vector2 * pPoints, const Quantizer2 & q, uint32_t * pOutCodes, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Vector2 & p = pPoints[i];
+                pOutCodes[i] = EncodeMorton(
+                    QuantizeMorton(p.X, q.Min.X, q.Scale.X, 16),
+                    QuantizeMorton(p.Y, q.Min.Y, q.Scale.Y, 16));
+            }
+        }
+
+        void Encode64(const Vector2 * pPoints, const Quantizer2 & q, uint64_t * pOutCodes, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Vector2 & p = pPoints[i];
+                pOutCodes[i] = EncodeMorton64(
+                    QuantizeMorton(p.X, q.Min.X, q.Scale.X, 32),
+                    QuantizeMorton(p.Y, q.Min.Y, q.Scale.Y, 32));
+            }
+        }
+
+#if PHX_MATH_MORTON_BMI2
+        // pdep scatters the low bits of its first operand to the bits set in the mask, a whole SpreadBits in one instruction.
+        // Ref: Intel 64 and IA-32 Architectures Software Developer's Manual, Vol 2B, PDEP
+
+#define PHX_TARGET_BMI2 PHX_TARGET("bmi2")
+
+        PHX_TARGET_BMI2 void Encode30BMI2(const Vector3 * pPoints, const Quantizer3 & q, uint32_t * pOutCodes, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Vector3 & p = pPoints[i];
+                pOutCodes[i] =
+                    _pdep_u32(QuantizeMorton(p.X, q.Min.X, q.Scale.X, 10), 0x09249249) |
+                    _pdep_u32(QuantizeMorton(p.Y, q.Min.Y, q.Scale.Y, 10), 0x12492492) |
+                    _pdep_u32(QuantizeMorton(p.Z, q.Min.Z, q.Scale.Z, 10), 0x24924924);
+            }
+        }
+
+        PHX_TARGET_BMI2 void Encode63BMI2(const Vector3 * pPoints, const Quantizer3 & q, uint64_t * pOutCodes, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Vector3 & p = pPoints[i];
+                pOutCodes[i] =
+                    _pdep_u64(QuantizeMorton(p.X, q.Min.X, q.Scale.X, 21), 0x1249249249249249ull) |
+                    _pdep_u64(QuantizeMorton(p.Y, q.Min.Y, q.Scale.Y, 21), 0x2492492492492492ull) |
+                    _pdep_u64(QuantizeMorton(p.Z, q.Min.Z, q.Scale.Z, 21), 0x4924924924924924ull);
+            }
+        }
+
+        PHX_TARGET_BMI2 void Encode32BMI2(const Vector2 * pPoints, const Quantizer2 & q, uint32_t * pOutCodes, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Vector2 & p = pPoints[i];
+                pOutCodes[i] =
+                    _pdep_u32(QuantizeMorton(p.X, q.Min.X, q.Scale.X, 16), 0x55555555) |
+                    _pdep_u32(QuantizeMorton(p.Y, q.Min.Y, q.Scale.Y, 16), 0xAAAAAAAA);
+            }
+        }
+
+        PHX_TARGET_BMI2 void Encode64BMI2(const Vector2 * pPoints, const Quantizer2 & q, uint64_t * pOutCodes, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const Vector2 & p = pPoints[i];
+                pOutCodes[i] =
+                    _pdep_u64(QuantizeMorton(p.X, q.Min.X, q.Scale.X, 32), 0x5555555555555555ull) |
+                    _pdep_u64(QuantizeMorton(p.Y, q.Min.Y, q.Scale.Y, 32), 0xAAAAAAAAAAAAAAAAull);
+            }
+        }
+
+#undef PHX_TARGET_BMI2
+#endif
+
+        bool UseBMI2()
+        {
+#if PHX_MATH_MORTON_BMI2
+            return GetCpuFeatures().BMI2 && GetBatchTier() >= CpuTier::AVX2;
+#else
+            return false;
+#endif
+        }
+
+        // Arguments of the encoders split over threads, one range function each.
+        template <class Point, class Quantizer, class Code>
+        struct EncodeArgs
+        {
+            const Point * pPoints;
+            Quantizer Quantize;
+            Code * pOutCodes;
+            bool BMI2;
+        };
+
+        typedef EncodeArgs<Vector3, Quantizer3, uint32_t> Encode30Args;
+        typedef EncodeArgs<Vector3, Quantizer3, uint64_t> Encode63Args;
+        typedef EncodeArgs<Vector2, Quantizer2, uint32_t> Encode32Args;
+        typedef EncodeArgs<Vector2, Quantizer2, uint64_t> Encode64Args;
+
+        void Encode30Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const Encode30Args & args = *static_cast<const Encode30Args *>(pContext);
+#if PHX_MATH_MORTON_BMI2
+            if (args.BMI2)
+            {
+                Encode30BMI2(args.pPoints + first, args.Quantize, args.pOutCodes + first, count);
+                return;
+            }
+#endif
+            Encode30(args.pPoints + first, args.Quantize, args.pOutCodes + first, count);
+        }
+
+        void Encode63Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const Encode63Args & args = *static_cast<const Encode63Args *>(pContext);
+#if PHX_MATH_MORTON_BMI2
+            if (args.BMI2)
+            {
+                Encode63BMI2(args.pPoints + first, args.Quantize, args.pOutCodes + first, count);
+                return;
+            }
+#endif
+            Encode63(args.pPoints + first, args.Quantize, args.pOutCodes + first, count);
+        }
+
+        void Encode32Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const Encode32Args & args = *static_cast<const Encode32Args *>(pContext);
+#if PHX_MATH_MORTON_BMI2
+            if (args.BMI2)
+            {
+                Encode32BMI2(args.pPoints + first, args.Quantize, args.pOutCodes + first, count);
+                return;
+            }
+#endif
+            Encode32(args.pPoints + first, args.Quantize, args.pOutCodes + first, count);
+        }
+
+        void Encode64Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const Encode64Args & args = *static_cast<const Encode64Args *>(pContext);
+#if PHX_MATH_MORTON_BMI2
+            if (args.BMI2)
+            {
+                Encode64BMI2(args.pPoints + first, args.Quantize, args.pOutCodes + first, count);
+                return;
+            }
+#endif
+            Encode64(args.pPoints + first, args.Quantize, args.pOutCodes + first, count);
+        }
+
+        //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+        // Decoding
+        //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+        void Decode30(const uint32_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, uint32_t * pOutZ, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                DecodeMorton(pCodes[i], pOutX[i], pOutY[i], pOutZ[i]);
+            }
+        }
+
+        void Decode63(const uint64_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, uint32_t * pOutZ, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                DecodeMorton64(pCodes[i], pOutX[i], pOutY[i], pOutZ[i]);
+            }
+        }
+
+        void Decode32(const uint32_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                DecodeMorton(pCodes[i], pOutX[i], pOutY[i]);
+            }
+        }
+
+        void Decode64(const uint64_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                DecodeMorton64(pCodes[i], pOutX[i], pOutY[i]);
+            }
+        }
+
+#if PHX_MATH_MORTON_BMI2
+        // pext gathers the bits set in the mask to the low bits, a whole CompactBits in one instruction.
+        // Ref: Intel 64 and IA-32 Architectures Software Developer's Manual, Vol 2B, PEXT
+
+#define PHX_TARGET_BMI2 PHX_TARGET("bmi2")
+
+        PHX_TARGET_BMI2 void Decode30BMI2(const uint32_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, uint32_t * pOutZ, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                pOutX[i] = _pext_u32(pCodes[i], 0x09249249);
+                pOutY[i] = _pext_u32(pCodes[i], 0x12492492);
+                pOutZ[i] = _pext_u32(pCodes[i], 0x24924924);
+            }
+        }
+
+        PHX_TARGET_BMI2 void Decode63BMI2(const uint64_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, uint32_t * pOutZ, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                pOutX[i] = static_cast<uint32_t>(_pext_u64(pCodes[i], 0x1249249249249249ull));
+                pOutY[i] = static_cast<uint32_t>(_pext_u64(pCodes[i], 0x2492492492492492ull));
+                pOutZ[i] = static_cast<uint32_t>(_pext_u64(pCodes[i], 0x4924924924924924ull));
+            }
+        }
+
+        PHX_TARGET_BMI2 void Decode32BMI2(const uint32_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                pOutX[i] = _pext_u32(pCodes[i], 0x55555555);
+                pOutY[i] = _pext_u32(pCodes[i], 0xAAAAAAAA);
+            }
+        }
+
+        PHX_TARGET_BMI2 void Decode64BMI2(const uint64_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                pOutX[i] = static_cast<uint32_t>(_pext_u64(pCodes[i], 0x5555555555555555ull));
+                pOutY[i] = static_cast<uint32_t>(_pext_u64(pCodes[i], 0xAAAAAAAAAAAAAAAAull));
+            }
+        }
+
+#undef PHX_TARGET_BMI2
+#endif
+
+        // Arguments of the decoders split over threads, pOutZ is unused for 2D codes.
+        template <class Code>
+        struct DecodeArgs
+        {
+            const Code * pCodes;
+            uint32_t * pOutX;
+            uint32_t * pOutY;
+            uint32_t * pOutZ;
+            bool BMI2;
+        };
+
+        void Decode30Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const DecodeArgs<uint32_t> & args = *static_cast<const DecodeArgs<uint32_t> *>(pContext);
+#if PHX_MATH_MORTON_BMI2
+            if (args.BMI2)
+            {
+                Decode30BMI2(args.pCodes + first, args.pOutX + first, args.pOutY + first, args.pOutZ + first, count);
+                return;
+            }
+#endif
+            Decode30(args.pCodes + first, args.pOutX + first, args.pOutY + first, args.pOutZ + first, count);
+        }
+
+        void Decode63Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const DecodeArgs<uint64_t> & args = *static_cast<const DecodeArgs<uint64_t> *>(pContext);
+#if PHX_MATH_MORTON_BMI2
+            if (args.BMI2)
+            {
+                Decode63BMI2(args.pCodes + first, args.pOutX + first, args.pOutY + first, args.pOutZ + first, count);
+                return;
+            }
+#endif
+            Decode63(args.pCodes + first, args.pOutX + first, args.pOutY + first, args.pOutZ + first, count);
+        }
+
+        void Decode32Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const DecodeArgs<uint32_t> & args = *static_cast<const DecodeArgs<uint32_t> *>(pContext);
+#if PHX_MATH_MORTON_BMI2
+            if (args.BMI2)
+            {
+                Decode32BMI2(args.pCodes + first, args.pOutX + first, args.pOutY + first, count);
+                return;
+            }
+#endif
+            Decode32(args.pCodes + first, args.pOutX + first, args.pOutY + first, count);
+        }
+
+        void Decode64Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const DecodeArgs<uint64_t> & args = *static_cast<const DecodeArgs<uint64_t> *>(pContext);
+#if PHX_MATH_MORTON_BMI2
+            if (args.BMI2)
+            {
+                Decode64BMI2(args.pCodes + first, args.pOutX + first, args.pOutY + first, count);
+                return;
+            }
+#endif
+            Decode64(args.pCodes + first, args.pOutX + first, args.pOutY + first, count);
+        }
+
+        //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+        // Sorting
+        //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+        // Least significant digit radix sort, 11 bits per pass. The array is
+        // cut into blocks, each pass counts the digits of every block, turns
+        // the counts into the position each block writes its first element
+        // of every digit to, then every block moves its elements in order.
+        // The blocks don't depend on each other within a count or a move, so
+        // those run in parallel, and since a block always writes its
+        // elements after the ones of the blocks before it the sort is stable.
+        //
+        // The first count gathers the digits of every pass at once, a pass
+        // whose digit is the same for every code wouldn't change the order
+        // and is skipped (the high bits of codes that are all small).
+        //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+        const unsigned int RadixBits = 11;
+        const unsigned int RadixSize = 1 << RadixBits;
+        const unsigned int MinSortBlockSize = 8192;
+        const unsigned int MaxSortBlocks = 64;
+
+        template <class Code>
+        struct SortArgs
+        {
+            static const unsigned int PassCount = (sizeof(Code) * 8 + RadixBits - 1) / RadixBits;
+
+            const Code * pSrcCodes;
+            const unsigned int * pSrcIndices;       // nullptr when the indices are the positions in pSrcCodes.
+            Code * pDstCodes;
+            unsigned int * pDstIndices;
+
+            unsigned int Count;
+            unsigned int BlockSize;
+            unsigned int Pass;
+
+            // RadixSize counts per pass per block, made into write positions before each move.
+            unsigned int * pCounts;
+        };
+
+        template <class Code>
+        void CountAllRange(void * pContext, unsigned int first, unsigned int count)
+        {
+            const SortArgs<Code> & args = *static_cast<const SortArgs<Code> *>(pContext);
+            const unsigned int passCount = SortArgs<Code>::PassCount;
+
+            for (unsigned int block = first; block < first + count; ++block)
+            {
+                unsigned int * pCounts = args.pCounts + block * passCount * RadixSize;
+                memset(pCounts, 0, sizeof(unsigned int) * passCount * RadixSize);
+
+                const unsigned int begin = block * args.BlockSize;
+                const unsigned int end = (args.Count - begin > args.BlockSize) ? begin + args.BlockSize : args.Count;
+                for (unsigned int i = begin; i < end; ++i)
+                {
+                    const Code code = args.pSrcCodes[i];
+                    for (unsigned int pass = 0; pass < passCount; ++pass)
+                    {
+                        ++pCounts[pass * RadixSize + static_cast<unsigned int>((code >> (pass * RadixBits)) & (RadixSize - 1))];
+                    }
+                }
+            }
+        }
+
+        template <class Code>
+        void CountRange(void * pContext, unsigned int first, unsigned int count)
+        {
+            const SortArgs<Code> & args = *static_cast<const SortArgs<Code> *>(pContext);
+            const unsigned int shift = args.Pass * RadixBits;
+
+            for (unsigned int block = first; block < first + count; ++block)
+            {
+                unsigned int * pCounts = args.pCounts + (block * SortArgs<Code>::PassCount + args.Pass) * RadixSize;
+                memset(pCounts, 0, sizeof(unsigned int) * RadixSize);
+
+                const unsigned int begin = block * args.BlockSize;
+                const unsigned int end = (args.Count - begin > args.BlockSize) ? begin + args.BlockSize : args.Count;
+                for (unsigned int i = begin; i < end; ++i)
+                {
+                    ++pCounts[static_cast<unsigned int>((args.pSrcCodes[i] >> shift) & (RadixSize - 1))];
+                }
+            }
+        }
+
+        template <class Code>
+        void MoveRange(void * pContext, unsigned int first, unsigned int count)
+        {
+            const SortArgs<Code> & args = *static_cast<const SortArgs<Code> *>(pContext);
+            const unsigned int shift = args.Pass * RadixBits;
+
+            for (unsigned int block = first; block < first + count; ++block)
+            {
+                unsigned int * pPositions = args.pCounts + (block * SortArgs<Code>::PassCount + args.Pass) * RadixSize;
+
+                const unsigned int begin = block * args.BlockSize;
+                const unsigned int end = (args.Count - begin > args.BlockSize) ? begin + args.BlockSize : args.Count;
+                for (unsigned int i = begin; i < end; ++i)
+                {
+                    const Code code = args.pSrcCodes[i];
+                    const unsigned int position = pPositions[static_cast<unsigned int>((code >> shift) & (RadixSize - 1))]++;
+                    args.pDstCodes[position] = code;
+                    args.pDstIndices[position] = (args.pSrcIndices != nullptr) ? args.pSrcIndices[i] : i;
+                }
+            }
+        }
+
+        template <class Code>
+        void SortCodes(const ExecutionPolicy & policy, const Code * pCodes, unsigned int count, Code * pOutSortedCodes, unsigned int * pOutPermutation)
+        {
+            DebugAssert(pCodes + count <= pOutSortedCodes || pOutSortedCodes + count <= pCodes, "The sorted codes must not overlap the codes!");
+
+            const unsigned int passCount = SortArgs<Code>::PassCount;
+
+            const unsigned int spreadBlockSize = count / MaxSortBlocks + 1;
+            const unsigned int blockSize = (spreadBlockSize > MinSortBlockSize) ? spreadBlockSize : MinSortBlockSize;
+            const unsigned int blockCount = count / blockSize + ((count % blockSize != 0) ? 1 : 0);
+
+            AlignedArray<unsigned int> counts;
+            counts.Resize(blockCount * passCount * RadixSize);
+
+            SortArgs<Code> args;
+            args.pSrcCodes = pCodes;
+            args.pSrcIndices = nullptr;
+            args.Count = count;
+            args.BlockSize = blockSize;
+            args.Pass = 0;
+            args.pCounts = counts.GetData();
+
+            // One task per block.
+            ExecutionPolicy blockPolicy = policy;
+            blockPolicy.MinElementsPerTask = 1;
+
+            ParallelFor(blockPolicy, blockCount, PHX_CACHE_LINE_SIZE, CountAllRange<Code>, &args);
+
+            // Passes that move something, a digit that every code has leaves the order as it is.
+            unsigned int passes[passCount];
+            unsigned int activePassCount = 0;
+            for (unsigned int pass = 0; pass < passCount; ++pass)
+            {
+                bool sameDigit = false;
+                for (unsigned int digit = 0; digit < RadixSize; ++digit)
+                {
+                    unsigned int total = 0;
+                    for (unsigned int block = 0; block < blockCount; ++block)
+                    {
+                        total += counts[(block * passCount + pass) * RadixSize + digit];
+                    }
+
+                    if (total != 0)
+                    {
+                        sameDigit = (total == count);
+                        break;
+                    }
+                }
+
+                if (false == sameDigit)
+                {
+                    passes[activePassCount++] = pass;
+                }
+            }
+
+            if (activePassCount == 0)
+            {
+                // Empty, or every code is the same.
+                for (unsigned int i = 0; i < count; ++i)
+                {
+                    pOutSortedCodes[i] = pCodes[i];
+                    pOutPermutation[i] = i;
+                }
+                return;
+            }
+
+            AlignedArray<Code> scratchCodes;
+            AlignedArray<unsigned int> scratchIndices;
+            if (activePassCount > 1)
+            {
+                scratchCodes.Resize(count);
+                scratchIndices.Resize(count);
+            }
+
+            for (unsigned int i = 0; i < activePassCount; ++i)
+            {
+                args.Pass = passes[i];
+
+                // Ping pong so the last pass lands in the output.
+                const bool toOutput = ((activePassCount - 1 - i) % 2) == 0;
+                args.pDstCodes = toOutput ? pOutSortedCodes : scratchCodes.GetData();
+                args.pDstIndices = toOutput ? pOutPermutation : scratchIndices.GetData();
+
+                // The first count already has the digits of the first pass.
+                if (i != 0)
+                {
+                    ParallelFor(blockPolicy, blockCount, PHX_CACHE_LINE_SIZE, CountRange<Code>, &args);
+                }
+
+                // Digit by digit, block by block, the elements go after those of the smaller digits and of the blocks before.
+                unsigned int position = 0;
+                for (unsigned int digit = 0; digit < RadixSize; ++digit)
+                {
+                    for (unsigned int block = 0; block < blockCount; ++block)
+                    {
+                        unsigned int & slot = counts[(block * passCount + args.Pass) * RadixSize + digit];
+                        const unsigned int digitCount = slot;
+                        slot = position;
+                        position += digitCount;
+                    }
+                }
+
+                ParallelFor(blockPolicy, blockCount, PHX_CACHE_LINE_SIZE, MoveRange<Code>, &args);
+
+                args.pSrcCodes = args.pDstCodes;
+                args.pSrcIndices = args.pDstIndices;
+            }
+        }
+    }
+
+    void EncodeMorton(const Vector3 * pPoints, const AABB & bounds, uint32_t * pOutCodes, unsigned int count)
+    {
+        EncodeMorton(ExecutionPolicy::CreateSequential(), pPoints, bounds, pOutCodes, count);
+    }
+
+    void EncodeMorton64(const Vector3 * pPoints, const AABB & bounds, uint64_t * pOutCodes, unsigned int count)
+    {
+        EncodeMorton64(ExecutionPolicy::CreateSequential(), pPoints, bounds, pOutCodes, count);
+    }
+
+    void EncodeMorton(const Vector2 * pPoints, const Rect & bounds, uint32_t * pOutCodes, unsigned int count)
+    {
+        EncodeMorton(ExecutionPolicy::CreateSequential(), pPoints, bounds, pOutCodes, count);
+    }
+
+    void EncodeMorton64(const Vector2 * pPoints, const Rect & bounds, uint64_t * pOutCodes, unsigned int count)
+    {
+        EncodeMorton64(ExecutionPolicy::CreateSequential(), pPoints, bounds, pOutCodes, count);
+    }
+
+    void EncodeMorton(const ExecutionPolicy & policy, const Vector3 * pPoints, const AABB & bounds, uint32_t * pOutCodes, unsigned int count)
+    {
+        Encode30Args args;
+        args.pPoints = pPoints;
+        GetQuantizer(bounds, 10, args.Quantize);
+        args.pOutCodes = pOutCodes;
+        args.BMI2 = UseBMI2();
+
+        ParallelFor(policy, count, sizeof(uint32_t), Encode30Range, &args);
+    }
+
+    void EncodeMorton64(const ExecutionPolicy & policy, const Vector3 * pPoints, const AABB & bounds, uint64_t * pOutCodes, unsigned int count)
+    {
+        Encode63Args args;
+        args.pPoints = pPoints;
+        GetQuantizer(bounds, 21, args.Quantize);
+        args.pOutCodes = pOutCodes;
+        args.BMI2 = UseBMI2();
+
+        ParallelFor(policy, count, sizeof(uint64_t), Encode63Range, &args);
+    }
+
+    void EncodeMorton(const ExecutionPolicy & policy, const Vector2 * pPoints, const Rect & bounds, uint32_t * pOutCodes, unsigned int count)
+    {
+        Encode32Args args;
+        args.pPoints = pPoints;
+        GetQuantizer(bounds, 16, args.Quantize);
+        args.pOutCodes = pOutCodes;
+        args.BMI2 = UseBMI2();
+
+        ParallelFor(policy, count, sizeof(uint32_t), Encode32Range, &args);
+    }
+
+    void EncodeMorton64(const ExecutionPolicy & policy, const Vector2 * pPoints, const Rect & bounds, uint64_t * pOutCodes, unsigned int count)
+    {
+        Encode64Args args;
+        args.pPoints = pPoints;
+        GetQuantizer(bounds, 32, args.Quantize);
+        args.pOutCodes = pOutCodes;
+        args.BMI2 = UseBMI2();
+
+        ParallelFor(policy, count, sizeof(uint64_t), Encode64Range, &args);
+    }
+
+    void DecodeMorton(const uint32_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, uint32_t * pOutZ, unsigned int count)
+    {
+        DecodeMorton(ExecutionPolicy::CreateSequential(), pCodes, pOutX, pOutY, pOutZ, count);
+    }
+
+    void DecodeMorton64(const uint64_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, uint32_t * pOutZ, unsigned int count)
+    {
+        DecodeMorton64(ExecutionPolicy::CreateSequential(), pCodes, pOutX, pOutY, pOutZ, count);
+    }
+
+    void DecodeMorton(const uint32_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, unsigned int count)
+    {
+        DecodeMorton(ExecutionPolicy::CreateSequential(), pCodes, pOutX, pOutY, count);
+    }
+
+    void DecodeMorton64(const uint64_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, unsigned int count)
+    {
+        DecodeMorton64(ExecutionPolicy::CreateSequential(), pCodes, pOutX, pOutY, count);
+    }
+
+    void DecodeMorton(const ExecutionPolicy & policy, const uint32_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, uint32_t * pOutZ, unsigned int count)
+    {
+        DecodeArgs<uint32_t> args;
+        args.pCodes = pCodes;
+        args.pOutX = pOutX;
+        args.pOutY = pOutY;
+        args.pOutZ = pOutZ;
+        args.BMI2 = UseBMI2();
+
+        ParallelFor(policy, count, sizeof(uint32_t), Decode30Range, &args);
+    }
+
+    void DecodeMorton64(const ExecutionPolicy & policy, const uint64_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, uint32_t * pOutZ, unsigned int count)
+    {
+        DecodeArgs<uint64_t> args;
+        args.pCodes = pCodes;
+        args.pOutX = pOutX;
+        args.pOutY = pOutY;
+        args.pOutZ = pOutZ;
+        args.BMI2 = UseBMI2();
+
+        ParallelFor(policy, count, sizeof(uint32_t), Decode63Range, &args);
+    }
+
+    void DecodeMorton(const ExecutionPolicy & policy, const uint32_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, unsigned int count)
+    {
+        DecodeArgs<uint32_t> args;
+        args.pCodes = pCodes;
+        args.pOutX = pOutX;
+        args.pOutY = pOutY;
+        args.pOutZ = nullptr;
+        args.BMI2 = UseBMI2();
+
+        ParallelFor(policy, count, sizeof(uint32_t), Decode32Range, &args);
+    }
+
+    void DecodeMorton64(const ExecutionPolicy & policy, const uint64_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, unsigned int count)
+    {
+        DecodeArgs<uint64_t> args;
+        args.pCodes = pCodes;
+        args.pOutX = pOutX;
+        args.pOutY = pOutY;
+        args.pOutZ = nullptr;
+        args.BMI2 = UseBMI2();
+
+        ParallelFor(policy, count, sizeof(uint32_t), Decode64Range, &args);
+    }
+
+    void SortMorton(const uint32_t * pCodes, unsigned int count, uint32_t * pOutSortedCodes, unsigned int * pOutPermutation)
+    {
+        SortCodes(ExecutionPolicy::CreateSequential(), pCodes, count, pOutSortedCodes, pOutPermutation);
+    }
+
+    void SortMorton(const uint64_t * pCodes, unsigned int count, uint64_t * pOutSortedCodes, unsigned int * pOutPermutation)
+    {
+        SortCodes(ExecutionPolicy::CreateSequential(), pCodes, count, pOutSortedCodes, pOutPermutation);
+    }
+
+    void SortMorton(const ExecutionPolicy & policy, const uint32_t * pCodes, unsigned int count, uint32_t * pOutSortedCodes, unsigned int * pOutPermutation)
+    {
+        SortCodes(policy, pCodes, count, pOutSortedCodes, pOutPermutation);
+    }
+
+    void SortMorton(const ExecutionPolicy & policy, const uint64_t * pCodes, unsigned int count, uint64_t * pOutSortedCodes, unsigned int * pOutPermutation)
+    {
+        SortCodes(policy, pCodes, count, pOutSortedCodes, pOutPermutation);
+    }
+
+} //namespace Math
+} //namespace Phx
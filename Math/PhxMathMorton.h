@@ -0,0 +1,154 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_MORTON_H_
+#define _PHX_MATH_MORTON_H_
+
+#include "PhxMathExecution.h"
+#include "PhxMathSoA.h"
+
+// C Standard Library Includes
+#include <stdint.h>
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Morton Codes
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// A Morton (Z-order) code interleaves the bits of the cell coordinates of
+// a point, x in bit 0, y in bit 1 (and z in bit 2), then the next bit of
+// each. Points that are close in space mostly have close codes, so sorting
+// an array by code puts neighbors next to each other in memory, and the
+// sorted codes are what an LBVH is built from.
+//
+//   Codes             Bits per axis   Code bits
+//   EncodeMorton      10 (3D)         30
+//   EncodeMorton64    21 (3D)         63
+//   EncodeMorton      16 (2D)         32
+//   EncodeMorton64    32 (2D)         64
+//
+// Positions are quantized over bounds one axis at a time: each axis of the
+// bounds is cut into 2^bits cells, and points outside the bounds go to the
+// border cells.
+//
+// The array encoders use the BMI2 pdep instruction on x64 cpus that have
+// it, when the batch tier (PhxMathBatch.h) is AVX2 or higher, and shifts
+// and masks otherwise. The array decoders do the same with pext. Both give
+// the same results, PHX_MATH_CPU_TIER=sse42 forces the shifts (pdep and
+// pext are microcoded and slower than the shifts on AMD cpus before Zen 3).
+//
+// SortMorton is a stable radix sort, codes that are equal keep their
+// order, so the result does not depend on the policy. It returns the
+// permutation along with the sorted codes, Permute applies it to the
+// arrays that go with the codes.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    // The low bits of v moved to every third bit (10 and 21 bits, for 3D codes)
+    // or every second bit (16 and 32 bits, for 2D codes). Higher bits of v are ignored.
+    inline uint32_t SpreadBits10(uint32_t v);
+    inline uint64_t SpreadBits21(uint64_t v);
+    inline uint32_t SpreadBits16(uint32_t v);
+    inline uint64_t SpreadBits32(uint64_t v);
+
+    // Inverse of the SpreadBits, gathers every third (second) bit starting at bit 0.
+    inline uint32_t CompactBits10(uint32_t code);
+    inline uint32_t CompactBits21(uint64_t code);
+    inline uint32_t CompactBits16(uint32_t code);
+    inline uint32_t CompactBits32(uint64_t code);
+
+    // Cell coordinates to codes, only the low 10 (21) bits of x, y and z and 16 (32) bits of x and y are used.
+    inline uint32_t EncodeMorton(uint32_t x, uint32_t y, uint32_t z);
+    inline uint64_t EncodeMorton64(uint32_t x, uint32_t y, uint32_t z);
+    inline uint32_t EncodeMorton(uint32_t x, uint32_t y);
+    inline uint64_t EncodeMorton64(uint32_t x, uint32_t y);
+
+    inline void DecodeMorton(uint32_t code, uint32_t & outX, uint32_t & outY, uint32_t & outZ);
+    inline void DecodeMorton64(uint64_t code, uint32_t & outX, uint32_t & outY, uint32_t & outZ);
+    inline void DecodeMorton(uint32_t code, uint32_t & outX, uint32_t & outY);
+    inline void DecodeMorton64(uint64_t code, uint32_t & outX, uint32_t & outY);
+
+    // Cells per unit along an axis of the given size cut into 2^bits cells, 0 for an empty axis.
+    inline float GetMortonScale(float size, unsigned int bits);
+
+    // Cell of value along an axis that starts at min, clamped to [0, 2^bits - 1] (NaN goes to cell 0).
+    // bits is 10, 16, 21 or 32. Above 24 bits not every cell is a float, 32 bit axes stop at 2^32 - 256.
+    inline uint32_t QuantizeMorton(float value, float min, float scale, unsigned int bits);
+
+    // Positions quantized over bounds.
+    inline uint32_t EncodeMorton(const Vector3 & p, const AABB & bounds);
+    inline uint64_t EncodeMorton64(const Vector3 & p, const AABB & bounds);
+    inline uint32_t EncodeMorton(const Vector2 & p, const Rect & bounds);
+    inline uint64_t EncodeMorton64(const Vector2 & p, const Rect & bounds);
+
+    // Arrays, same codes as the single versions.
+    void EncodeMorton(const Vector3 * pPoints, const AABB & bounds, uint32_t * pOutCodes, unsigned int count);
+    void EncodeMorton64(const Vector3 * pPoints, const AABB & bounds, uint64_t * pOutCodes, unsigned int count);
+    void EncodeMorton(const Vector2 * pPoints, const Rect & bounds, uint32_t * pOutCodes, unsigned int count);
+    void EncodeMorton64(const Vector2 * pPoints, const Rect & bounds, uint64_t * pOutCodes, unsigned int count);
+
+    void EncodeMorton(const ExecutionPolicy & policy, const Vector3 * pPoints, const AABB & bounds, uint32_t * pOutCodes, unsigned int count);
+    void EncodeMorton64(const ExecutionPolicy & policy, const Vector3 * pPoints, const AABB & bounds, uint64_t * pOutCodes, unsigned int count);
+    void EncodeMorton(const ExecutionPolicy & policy, const Vector2 * pPoints, const Rect & bounds, uint32_t * pOutCodes, unsigned int count);
+    void EncodeMorton64(const ExecutionPolicy & policy, const Vector2 * pPoints, const Rect & bounds, uint64_t * pOutCodes, unsigned int count);
+
+    // Codes back to cell coordinates, the cells of pCodes[i] go to pOutX[i], pOutY[i] (and pOutZ[i]).
+    void DecodeMorton(const uint32_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, uint32_t * pOutZ, unsigned int count);
+    void DecodeMorton64(const uint64_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, uint32_t * pOutZ, unsigned int count);
+    void DecodeMorton(const uint32_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, unsigned int count);
+    void DecodeMorton64(const uint64_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, unsigned int count);
+
+    void DecodeMorton(const ExecutionPolicy & policy, const uint32_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, uint32_t * pOutZ, unsigned int count);
+    void DecodeMorton64(const ExecutionPolicy & policy, const uint64_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, uint32_t * pOutZ, unsigned int count);
+    void DecodeMorton(const ExecutionPolicy & policy, const uint32_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, unsigned int count);
+    void DecodeMorton64(const ExecutionPolicy & policy, const uint64_t * pCodes, uint32_t * pOutX, uint32_t * pOutY, unsigned int count);
+
+    // Writes the codes in increasing order to pOutSortedCodes and the index each one had in pCodes to
+    // pOutPermutation, so pOutSortedCodes[i] == pCodes[pOutPermutation[i]]. Both need room for count
+    // elements and must not overlap pCodes.
+    void SortMorton(const uint32_t * pCodes, unsigned int count, uint32_t * pOutSortedCodes, unsigned int * pOutPermutation);
+    void SortMorton(const uint64_t * pCodes, unsigned int count, uint64_t * pOutSortedCodes, unsigned int * pOutPermutation);
+
+    void SortMorton(const ExecutionPolicy & policy, const uint32_t * pCodes, unsigned int count, uint32_t * pOutSortedCodes, unsigned int * pOutPermutation);
+    void SortMorton(const ExecutionPolicy & policy, const uint64_t * pCodes, unsigned int count, uint64_t * pOutSortedCodes, unsigned int * pOutPermutation);
+
+    // pOut[i] = pIn[pPermutation[i]], reorders an array the same way as the codes. pIn and pOut must not overlap.
+    template <class T>
+    inline void Permute(const unsigned int * pPermutation, const T * pIn, T * pOut, unsigned int count);
+    template <class T>
+    inline void Permute(const ExecutionPolicy & policy, const unsigned int * pPermutation, const T * pIn, T * pOut, unsigned int count);
+
+    inline void Permute(const unsigned int * pPermutation, const Vector3SoA & in, const Vector3SoA & out, unsigned int count);
+    inline void Permute(const unsigned int * pPermutation, const QuaternionSoA & in, const QuaternionSoA & out, unsigned int count);
+    inline void Permute(const ExecutionPolicy & policy, const unsigned int * pPermutation, const Vector3SoA & in, const Vector3SoA & out, unsigned int count);
+    inline void Permute(const ExecutionPolicy & policy, const unsigned int * pPermutation, const QuaternionSoA & in, const QuaternionSoA & out, unsigned int count);
+
+} //namespace Math
+} //namespace Phx
+
+#include "PhxMathMorton.inl"
+
+#endif //_PHX_MATH_MORTON_H_
@@ -0,0 +1,281 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_MORTON_INL_
+#define _PHX_MATH_MORTON_INL_
+
+namespace Phx {
+namespace Math {
+
+    // Ref: Fabian Giesen, Decoding Morton Codes
+    //      https://fgiesen.wordpress.com/2009/12/13/decoding-morton-codes/
+
+    inline uint32_t SpreadBits10(uint32_t v)
+    {
+        v &= 0x000003FF;
+        v = (v | (v << 16)) & 0x030000FF;
+        v = (v | (v << 8)) & 0x0300F00F;
+        v = (v | (v << 4)) & 0x030C30C3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    }
+
+    inline uint64_t SpreadBits21(uint64_t v)
+    {
+        v &= 0x00000000001FFFFFull;
+        v = (v | (v << 32)) & 0x001F00000000FFFFull;
+        v = (v | (v << 16)) & 0x001F0000FF0000FFull;
+        v = (v | (v << 8)) & 0x100F00F00F00F00Full;
+        v = (v | (v << 4)) & 0x10C30C30C30C30C3ull;
+        v = (v | (v << 2)) & 0x1249249249249249ull;
+        return v;
+    }
+
+    inline uint32_t SpreadBits16(uint32_t v)
+    {
+        v &= 0x0000FFFF;
+        v = (v | (v << 8)) & 0x00FF00FF;
+        v = (v | (v << 4)) & 0x0F0F0F0F;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    }
+
+    inline uint64_t SpreadBits32(uint64_t v)
+    {
+        v &= 0x00000000FFFFFFFFull;
+        v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+        v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+        v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+        v = (v | (v << 2)) & 0x3333333333333333ull;
+        v = (v | (v << 1)) & 0x5555555555555555ull;
+        return v;
+    }
+
+    inline uint32_t CompactBits10(uint32_t code)
+    {
+        code &= 0x09249249;
+        code = (code | (code >> 2)) & 0x030C30C3;
+        code = (code | (code >> 4)) & 0x0300F00F;
+        code = (code | (code >> 8)) & 0x030000FF;
+        code = (code | (code >> 16)) & 0x000003FF;
+        return code;
+    }
+
+    inline uint32_t CompactBits21(uint64_t code)
+    {
+        code &= 0x1249249249249249ull;
+        code = (code | (code >> 2)) & 0x10C30C30C30C30C3ull;
+        code = (code | (code >> 4)) & 0x100F00F00F00F00Full;
+        code = (code | (code >> 8)) & 0x001F0000FF0000FFull;
+        code = (code | (code >> 16)) & 0x001F00000000FFFFull;
+        code = (code | (code >> 32)) & 0x00000000001FFFFFull;
+        return static_cast<uint32_t>(code);
+    }
+
+    inline uint32_t CompactBits16(uint32_t code)
+    {
+        code &= 0x55555555;
+        code = (code | (code >> 1)) & 0x33333333;
+        code = (code | (code >> 2)) & 0x0F0F0F0F;
+        code = (code | (code >> 4)) & 0x00FF00FF;
+        code = (code | (code >> 8)) & 0x0000FFFF;
+        return code;
+    }
+
+    inline uint32_t CompactBits32(uint64_t code)
+    {
+        code &= 0x5555555555555555ull;
+        code = (code | (code >> 1)) & 0x3333333333333333ull;
+        code = (code | (code >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+        code = (code | (code >> 4)) & 0x00FF00FF00FF00FFull;
+        code = (code | (code >> 8)) & 0x0000FFFF0000FFFFull;
+        code = (code | (code >> 16)) & 0x00000000FFFFFFFFull;
+        return static_cast<uint32_t>(code);
+    }
+
+    inline uint32_t EncodeMorton(uint32_t x, uint32_t y, uint32_t z)
+    {
+        return SpreadBits10(x) | (SpreadBits10(y) << 1) | (SpreadBits10(z) << 2);
+    }
+
+    inline uint64_t EncodeMorton64(uint32_t x, uint32_t y, uint32_t z)
+    {
+        return SpreadBits21(x) | (SpreadBits21(y) << 1) | (SpreadBits21(z) << 2);
+    }
+
+    inline uint32_t EncodeMorton(uint32_t x, uint32_t y)
+    {
+        return SpreadBits16(x) | (SpreadBits16(y) << 1);
+    }
+
+    inline uint64_t EncodeMorton64(uint32_t x, uint32_t y)
+    {
+        return SpreadBits32(x) | (SpreadBits32(y) << 1);
+    }
+
+    inline void DecodeMorton(uint32_t code, uint32_t & outX, uint32_t & outY, uint32_t & outZ)
+    {
+        outX = CompactBits10(code);
+        outY = CompactBits10(code >> 1);
+        outZ = CompactBits10(code >> 2);
+    }
+
+    inline void DecodeMorton64(uint64_t code, uint32_t & outX, uint32_t & outY, uint32_t & outZ)
+    {
+        outX = CompactBits21(code);
+        outY = CompactBits21(code >> 1);
+        outZ = CompactBits21(code >> 2);
+    }
+
+    inline void DecodeMorton(uint32_t code, uint32_t & outX, uint32_t & outY)
+    {
+        outX = CompactBits16(code);
+        outY = CompactBits16(code >> 1);
+    }
+
+    inline void DecodeMorton64(uint64_t code, uint32_t & outX, uint32_t & outY)
+    {
+        outX = CompactBits32(code);
+        outY = CompactBits32(code >> 1);
+    }
+
+    inline float GetMortonScale(float size, unsigned int bits)
+    {
+        return (size > 0.0f) ? (static_cast<float>(1ull << bits) / size) : 0.0f;
+    }
+
+    inline uint32_t QuantizeMorton(float value, float min, float scale, unsigned int bits)
+    {
+        DebugAssert(bits == 10 || bits == 16 || bits == 21 || bits == 32, "Invalid morton axis bits (%u)!", bits);
+
+        // 2^32 - 1 rounds up to 2^32 as a float, the last cell is clamped to the largest float below it instead.
+        const float maxCell = (bits < 32) ? static_cast<float>((1u << bits) - 1) : 4294967040.0f;
+
+        const float cell = (value - min) * scale;
+        const float clamped = (cell > 0.0f) ? ((cell < maxCell) ? cell : maxCell) : 0.0f;
+        return static_cast<uint32_t>(clamped);
+    }
+
+    inline uint32_t EncodeMorton(const Vector3 & p, const AABB & bounds)
+    {
+        const Vector3 size = bounds.GetSize();
+        return EncodeMorton(
+            QuantizeMorton(p.X, bounds.Min.X, GetMortonScale(size.X, 10), 10),
+            QuantizeMorton(p.Y, bounds.Min.Y, GetMortonScale(size.Y, 10), 10),
+            QuantizeMorton(p.Z, bounds.Min.Z, GetMortonScale(size.Z, 10), 10));
+    }
+
+    inline uint64_t EncodeMorton64(const Vector3 & p, const AABB & bounds)
+    {
+        const Vector3 size = bounds.GetSize();
+        return EncodeMorton64(
+            QuantizeMorton(p.X, bounds.Min.X, GetMortonScale(size.X, 21), 21),
+            QuantizeMorton(p.Y, bounds.Min.Y, GetMortonScale(size.Y, 21), 21),
+            QuantizeMorton(p.Z, bounds.Min.Z, GetMortonScale(size.Z, 21), 21));
+    }
+
+    inline uint32_t EncodeMorton(const Vector2 & p, const Rect & bounds)
+    {
+        return EncodeMorton(
+            QuantizeMorton(p.X, bounds.X, GetMortonScale(bounds.Width, 16), 16),
+            QuantizeMorton(p.Y, bounds.Y, GetMortonScale(bounds.Height, 16), 16));
+    }
+
+    inline uint64_t EncodeMorton64(const Vector2 & p, const Rect & bounds)
+    {
+        return EncodeMorton64(
+            QuantizeMorton(p.X, bounds.X, GetMortonScale(bounds.Width, 32), 32),
+            QuantizeMorton(p.Y, bounds.Y, GetMortonScale(bounds.Height, 32), 32));
+    }
+
+    template <class T>
+    inline void Permute(const unsigned int * pPermutation, const T * pIn, T * pOut, unsigned int count)
+    {
+        DebugAssert(pIn + count <= pOut || pOut + count <= pIn, "Permute can't be done in place!");
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            pOut[i] = pIn[pPermutation[i]];
+        }
+    }
+
+    // Arguments of the Permute split over threads.
+    template <class T>
+    struct PermuteArgs
+    {
+        const unsigned int * pPermutation;
+        const T * pIn;
+        T * pOut;
+
+        static void Range(void * pContext, unsigned int first, unsigned int count)
+        {
+            const PermuteArgs & args = *static_cast<const PermuteArgs *>(pContext);
+            Permute(args.pPermutation + first, args.pIn, args.pOut + first, count);
+        }
+    };
+
+    template <class T>
+    inline void Permute(const ExecutionPolicy & policy, const unsigned int * pPermutation, const T * pIn, T * pOut, unsigned int count)
+    {
+        PermuteArgs<T> args = { pPermutation, pIn, pOut };
+        ParallelFor(policy, count, sizeof(T), PermuteArgs<T>::Range, &args);
+    }
+
+    inline void Permute(const unsigned int * pPermutation, const Vector3SoA & in, const Vector3SoA & out, unsigned int count)
+    {
+        Permute(pPermutation, in.X, out.X, count);
+        Permute(pPermutation, in.Y, out.Y, count);
+        Permute(pPermutation, in.Z, out.Z, count);
+    }
+
+    inline void Permute(const unsigned int * pPermutation, const QuaternionSoA & in, const QuaternionSoA & out, unsigned int count)
+    {
+        Permute(pPermutation, in.X, out.X, count);
+        Permute(pPermutation, in.Y, out.Y, count);
+        Permute(pPermutation, in.Z, out.Z, count);
+        Permute(pPermutation, in.W, out.W, count);
+    }
+
+    inline void Permute(const ExecutionPolicy & policy, const unsigned int * pPermutation, const Vector3SoA & in, const Vector3SoA & out, unsigned int count)
+    {
+        Permute<float>(policy, pPermutation, in.X, out.X, count);
+        Permute<float>(policy, pPermutation, in.Y, out.Y, count);
+        Permute<float>(policy, pPermutation, in.Z, out.Z, count);
+    }
+
+    inline void Permute(const ExecutionPolicy & policy, const unsigned int * pPermutation, const QuaternionSoA & in, const QuaternionSoA & out, unsigned int count)
+    {
+        Permute<float>(policy, pPermutation, in.X, out.X, count);
+        Permute<float>(policy, pPermutation, in.Y, out.Y, count);
+        Permute<float>(policy, pPermutation, in.Z, out.Z, count);
+        Permute<float>(policy, pPermutation, in.W, out.W, count);
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_MORTON_INL_
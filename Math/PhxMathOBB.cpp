@@ -0,0 +1,194 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMath.h"
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // Cyclic Jacobi rotations, a is diagonalized in place and the columns of v are
+        // the eigenvectors. Three rotations per sweep, a handful of sweeps converge to
+        // double precision for a 3x3.
+        void SymmetricEigen(double a[3][3], double v[3][3])
+        {
+            for (unsigned int i = 0; i < 3; ++i)
+            {
+                for (unsigned int j = 0; j < 3; ++j)
+                {
+                    v[i][j] = (i == j) ? 1.0 : 0.0;
+                }
+            }
+
+            const unsigned int pairs[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+
+            for (unsigned int sweep = 0; sweep < 32; ++sweep)
+            {
+                const double offDiagonal = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+                const double diagonal = a[0][0] * a[0][0] + a[1][1] * a[1][1] + a[2][2] * a[2][2];
+                if (offDiagonal <= DBL_EPSILON * DBL_EPSILON * diagonal)
+                {
+                    break;
+                }
+
+                for (unsigned int k = 0; k < 3; ++k)
+                {
+                    const unsigned int p = pairs[k][0];
+                    const unsigned int q = pairs[k][1];
+                    if (a[p][q] == 0.0)
+                    {
+                        continue;
+                    }
+
+                    // Rotation that zeroes a[p][q], using the smaller of the two angles.
+                    const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                    const double t = (theta >= 0.0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                    const double c = 1.0 / sqrt(t * t + 1.0);
+                    const double s = t * c;
+
+                    for (unsigned int r = 0; r < 3; ++r)
+                    {
+                        const double arp = a[r][p];
+                        const double arq = a[r][q];
+                        a[r][p] = c * arp - s * arq;
+                        a[r][q] = s * arp + c * arq;
+                    }
+
+                    for (unsigned int r = 0; r < 3; ++r)
+                    {
+                        const double apr = a[p][r];
+                        const double aqr = a[q][r];
+                        a[p][r] = c * apr - s * aqr;
+                        a[q][r] = s * apr + c * aqr;
+                    }
+
+                    for (unsigned int r = 0; r < 3; ++r)
+                    {
+                        const double vrp = v[r][p];
+                        const double vrq = v[r][q];
+                        v[r][p] = c * vrp - s * vrq;
+                        v[r][q] = s * vrp + c * vrq;
+                    }
+                }
+            }
+        }
+    }
+
+    OBB OBB::CreateFromPoints(const Vector3 * pPoints, unsigned int count)
+    {
+        OBB out;
+        CreateFromPoints(pPoints, count, out);
+        return out;
+    }
+
+    void OBB::CreateFromPoints(const Vector3 * pPoints, unsigned int count, OBB & out)
+    {
+        DebugAssert(count > 0, "Cannot create an oriented box from an empty array of points.");
+        if (count == 0)
+        {
+            out.Set(Vector3::Zero, Vector3::Zero, Matrix3x3::Identity);
+            return;
+        }
+
+        // Mean and covariance in double, the sums over large point sets lose too much in float.
+        Vector3d mean(0.0);
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            mean += pPoints[i];
+        }
+        mean.Set(mean.X / count, mean.Y / count, mean.Z / count);
+
+        double covariance[3][3] = {};
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            const Vector3d d = Subtract(Vector3d(pPoints[i]), mean);
+            const double c[3] = { d.X, d.Y, d.Z };
+
+            for (unsigned int r = 0; r < 3; ++r)
+            {
+                for (unsigned int col = r; col < 3; ++col)
+                {
+                    covariance[r][col] += c[r] * c[col];
+                }
+            }
+        }
+        covariance[1][0] = covariance[0][1];
+        covariance[2][0] = covariance[0][2];
+        covariance[2][1] = covariance[1][2];
+
+        double eigenvectors[3][3];
+        SymmetricEigen(covariance, eigenvectors);
+
+        // Sort the axes by decreasing variance.
+        unsigned int order[3] = { 0, 1, 2 };
+        for (unsigned int i = 1; i < 3; ++i)
+        {
+            for (unsigned int j = i; j > 0 && covariance[order[j]][order[j]] > covariance[order[j - 1]][order[j - 1]]; --j)
+            {
+                const unsigned int tmp = order[j];
+                order[j] = order[j - 1];
+                order[j - 1] = tmp;
+            }
+        }
+
+        // The eigenvectors are the columns, the third axis is rebuilt from the first two so the
+        // basis is right handed and stays orthonormal after rounding to float.
+        Vector3 axisX(static_cast<float>(eigenvectors[0][order[0]]), static_cast<float>(eigenvectors[1][order[0]]), static_cast<float>(eigenvectors[2][order[0]]));
+        Vector3 axisY(static_cast<float>(eigenvectors[0][order[1]]), static_cast<float>(eigenvectors[1][order[1]]), static_cast<float>(eigenvectors[2][order[1]]));
+        axisX = Normalize(axisX);
+        axisY = Normalize(Subtract(axisY, Multiply(axisX, Dot(axisX, axisY))));
+        const Vector3 axisZ = Cross(axisX, axisY);
+
+        out.Axes.Set(axisX, axisY, axisZ);
+
+        // Bounds of the points along each axis.
+        Vector3 min(FLT_MAX);
+        Vector3 max(-FLT_MAX);
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            const Vector3 projected(Dot(pPoints[i], axisX), Dot(pPoints[i], axisY), Dot(pPoints[i], axisZ));
+            Min(min, projected, min);
+            Max(max, projected, max);
+        }
+
+        const Vector3 middle = Multiply(Add(min, max), 0.5f);
+        out.Center.Set(Add(Add(Multiply(axisX, middle.X), Multiply(axisY, middle.Y)), Multiply(axisZ, middle.Z)));
+
+        // Extents from the points relative to the rounded center, the same way Contains measures them,
+        // so every point is contained.
+        out.Extents.Set(0.0f);
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            const Vector3 d = Subtract(pPoints[i], out.Center);
+            out.Extents.X = Math::Max(out.Extents.X, Abs(Dot(d, axisX)));
+            out.Extents.Y = Math::Max(out.Extents.Y, Abs(Dot(d, axisY)));
+            out.Extents.Z = Math::Max(out.Extents.Z, Abs(Dot(d, axisZ)));
+        }
+    }
+
+} //namespace Math
+} //namespace Phx
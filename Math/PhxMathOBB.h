@@ -0,0 +1,113 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_OBB_H_
+#define _PHX_MATH_OBB_H_
+
+namespace Phx {
+namespace Math {
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Oriented Bounding Box
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // The rows of Axes are the local X, Y and Z axes of the box in world
+    // space and must be orthonormal (a rotation matrix), Extents are the
+    // half sizes along those axes.
+    //
+    // CreateFromPoints fits the axes to the principal components of the
+    // points (the eigenvectors of their covariance), X along the largest
+    // spread. Dense clusters of interior points pull the axes around, for a
+    // tighter box pass only the points of the convex hull.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    class OBB
+    {
+    public:
+        Vector3 Center;
+        Vector3 Extents;
+        Matrix3x3 Axes;
+
+    public:
+        // count must not be 0.
+        static OBB CreateFromPoints(const Vector3 * pPoints, unsigned int count);
+        static void CreateFromPoints(const Vector3 * pPoints, unsigned int count, OBB & out);
+
+        static inline OBB CreateFromAABB(const AABB & box);
+        static inline void CreateFromAABB(const AABB & box, OBB & out);
+
+        // box transformed by m, the scale of m is moved into the extents.
+        // m must not have shear (the rows of its upper 3x3 must be orthogonal).
+        static inline OBB CreateFromAABB(const AABB & box, const Matrix4x4 & m);
+        static inline void CreateFromAABB(const AABB & box, const Matrix4x4 & m, OBB & out);
+
+    public:
+        inline OBB()
+        {
+            // Do nothing in the default ctor.
+            // So we don't have to pay for arrays or boxes initialized as an out parameter.
+        }
+        inline explicit OBB(const Vector3 & center, const Vector3 & extents, const Quaternion & orientation);
+        inline explicit OBB(const Vector3 & center, const Vector3 & extents, const Matrix3x3 & axes);
+        inline OBB(const OBB & src);
+
+        inline ~OBB() { }
+
+        inline OBB & operator=(const OBB & rhs);
+
+        // Corner i is Center +/- each axis times its extent, bit 0 of i picks +X, bit 1 +Y and bit 2 +Z.
+        inline void GetCorners(Vector3 pOutCorners[8]) const;
+
+        inline bool Contains(const Vector3 & p) const;
+
+        inline bool Intersects(const OBB & box) const;
+        inline bool Intersects(const Vector4 * pPlanes, unsigned int planeCount) const;
+
+        inline void Set(const Vector3 & center, const Vector3 & extents, const Matrix3x3 & axes);
+        inline void Set(const OBB & src);
+    };
+
+    inline bool operator==(const OBB & lhs, const OBB & rhs);
+    inline bool operator!=(const OBB & lhs, const OBB & rhs);
+
+    inline bool ExactlyEqual(const OBB & lhs, const OBB & rhs);
+    inline bool NearlyEqual(const OBB & lhs, const OBB & rhs);
+
+    // Points right on the faces are contained.
+    inline bool Contains(const OBB & box, const Vector3 & p);
+
+    // Separating axis test over the 3 face axes of each box and the 9 edge cross products.
+    // Touching boxes intersect.
+    inline bool Intersects(const OBB & box1, const OBB & box2);
+
+    // Planes are (normal, d) with the normals pointing inside the volume, the same as CullSpheres.
+    // False only when the box is completely behind one of the planes, so like the sphere test it is
+    // conservative and can keep boxes that are just outside the corners of a frustum.
+    inline bool Intersects(const OBB & box, const Vector4 * pPlanes, unsigned int planeCount);
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_OBB_H_
@@ -0,0 +1,269 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_OBB_INL_
+#define _PHX_MATH_OBB_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline OBB OBB::CreateFromAABB(const AABB & box)
+    {
+        OBB out;
+        CreateFromAABB(box, out);
+        return out;
+    }
+
+    inline void OBB::CreateFromAABB(const AABB & box, OBB & out)
+    {
+        DebugAssert(false == IsEmpty(box), "Cannot create an oriented box from an empty box.");
+
+        out.Center.Set(box.GetCenter());
+        out.Extents.Set(box.GetExtents());
+        out.Axes.Set(Matrix3x3::Identity);
+    }
+
+    inline OBB OBB::CreateFromAABB(const AABB & box, const Matrix4x4 & m)
+    {
+        OBB out;
+        CreateFromAABB(box, m, out);
+        return out;
+    }
+
+    inline void OBB::CreateFromAABB(const AABB & box, const Matrix4x4 & m, OBB & out)
+    {
+        DebugAssert(false == IsEmpty(box), "Cannot create an oriented box from an empty box.");
+
+        const Vector3 row1(m.M11, m.M12, m.M13);
+        const Vector3 row2(m.M21, m.M22, m.M23);
+        const Vector3 row3(m.M31, m.M32, m.M33);
+
+        const Vector3 scale(Length(row1), Length(row2), Length(row3));
+        DebugAssert(AllGreater(scale, Vector3::Zero), "Cannot create an oriented box with a zero scale.");
+
+        Transform(box.GetCenter(), m, out.Center);
+        Multiply(box.GetExtents(), scale, out.Extents);
+        out.Axes.Set(Divide(row1, scale.X), Divide(row2, scale.Y), Divide(row3, scale.Z));
+    }
+
+    inline OBB::OBB(const Vector3 & center, const Vector3 & extents, const Quaternion & orientation)
+        : Center(center)
+        , Extents(extents)
+    {
+        Matrix3x3::CreateFromQuaternion(orientation, this->Axes);
+    }
+
+    inline OBB::OBB(const Vector3 & center, const Vector3 & extents, const Matrix3x3 & axes)
+        : Center(center)
+        , Extents(extents)
+        , Axes(axes)
+    { }
+
+    inline OBB::OBB(const OBB & src)
+    {
+        Set(src);
+    }
+
+    inline OBB & OBB::operator=(const OBB & rhs)
+    {
+        Set(rhs);
+        return *this;
+    }
+
+    inline void OBB::GetCorners(Vector3 pOutCorners[8]) const
+    {
+        const Vector3 x = Multiply(this->Axes.Row(0), this->Extents.X);
+        const Vector3 y = Multiply(this->Axes.Row(1), this->Extents.Y);
+        const Vector3 z = Multiply(this->Axes.Row(2), this->Extents.Z);
+
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            pOutCorners[i] = this->Center;
+            pOutCorners[i] += (i & 1) ? x : -x;
+            pOutCorners[i] += (i & 2) ? y : -y;
+            pOutCorners[i] += (i & 4) ? z : -z;
+        }
+    }
+
+    inline bool OBB::Contains(const Vector3 & p) const
+    {
+        return Math::Contains(*this, p);
+    }
+
+    inline bool OBB::Intersects(const OBB & box) const
+    {
+        return Math::Intersects(*this, box);
+    }
+
+    inline bool OBB::Intersects(const Vector4 * pPlanes, unsigned int planeCount) const
+    {
+        return Math::Intersects(*this, pPlanes, planeCount);
+    }
+
+    inline void OBB::Set(const Vector3 & center, const Vector3 & extents, const Matrix3x3 & axes)
+    {
+        this->Center.Set(center);
+        this->Extents.Set(extents);
+        this->Axes.Set(axes);
+    }
+
+    inline void OBB::Set(const OBB & src)
+    {
+        this->Center.Set(src.Center);
+        this->Extents.Set(src.Extents);
+        this->Axes.Set(src.Axes);
+    }
+
+    inline bool operator==(const OBB & lhs, const OBB & rhs)
+    {
+        return ExactlyEqual(lhs, rhs);
+    }
+
+    inline bool operator!=(const OBB & lhs, const OBB & rhs)
+    {
+        return (false == ExactlyEqual(lhs, rhs));
+    }
+
+    inline bool ExactlyEqual(const OBB & lhs, const OBB & rhs)
+    {
+        return ExactlyEqual(lhs.Center, rhs.Center) &&
+               ExactlyEqual(lhs.Extents, rhs.Extents) &&
+               ExactlyEqual(lhs.Axes, rhs.Axes);
+    }
+
+    inline bool NearlyEqual(const OBB & lhs, const OBB & rhs)
+    {
+        return NearlyEqual(lhs.Center, rhs.Center) &&
+               NearlyEqual(lhs.Extents, rhs.Extents) &&
+               NearlyEqual(lhs.Axes, rhs.Axes);
+    }
+
+    inline bool Contains(const OBB & box, const Vector3 & p)
+    {
+        const Vector3 d = Subtract(p, box.Center);
+
+        return (Abs(Dot(d, box.Axes.Row(0))) <= box.Extents.X) &&
+               (Abs(Dot(d, box.Axes.Row(1))) <= box.Extents.Y) &&
+               (Abs(Dot(d, box.Axes.Row(2))) <= box.Extents.Z);
+    }
+
+    inline bool Intersects(const OBB & box1, const OBB & box2)
+    {
+        // Everything is done in the frame of box1: R[i][j] is axis j of box2 projected onto
+        // axis i of box1, and t is the offset between the centers. The boxes are separated when
+        // the distance between the centers projected onto an axis is larger than the sum of the
+        // projected extents. The epsilon keeps the edge cross products of (nearly) parallel edges,
+        // which are close to zero vectors, from reporting a separation that isn't there.
+        // The batch kernels (IntersectOBBs) do the same tests in the same order.
+        //
+        // Ref: Christer Ericson, Real-Time Collision Detection, 4.4.1
+
+        const float epsilon = 1e-6f;
+
+        const float e1[3] = { box1.Extents.X, box1.Extents.Y, box1.Extents.Z };
+        const float e2[3] = { box2.Extents.X, box2.Extents.Y, box2.Extents.Z };
+
+        float R[3][3];
+        float absR[3][3];
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            for (unsigned int j = 0; j < 3; ++j)
+            {
+                R[i][j] = Dot(box1.Axes.Row(i), box2.Axes.Row(j));
+                absR[i][j] = Abs(R[i][j]) + epsilon;
+            }
+        }
+
+        const Vector3 d = Subtract(box2.Center, box1.Center);
+        const float t[3] = { Dot(d, box1.Axes.Row(0)), Dot(d, box1.Axes.Row(1)), Dot(d, box1.Axes.Row(2)) };
+
+        // Axes of box1.
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            const float r2 = e2[0] * absR[i][0] + e2[1] * absR[i][1] + e2[2] * absR[i][2];
+            if (Abs(t[i]) > e1[i] + r2)
+            {
+                return false;
+            }
+        }
+
+        // Axes of box2.
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            const float r1 = e1[0] * absR[0][j] + e1[1] * absR[1][j] + e1[2] * absR[2][j];
+            if (Abs(t[0] * R[0][j] + t[1] * R[1][j] + t[2] * R[2][j]) > r1 + e2[j])
+            {
+                return false;
+            }
+        }
+
+        // Axis i of box1 cross axis j of box2.
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            const unsigned int i1 = (i + 1) % 3;
+            const unsigned int i2 = (i + 2) % 3;
+
+            for (unsigned int j = 0; j < 3; ++j)
+            {
+                const unsigned int j1 = (j + 1) % 3;
+                const unsigned int j2 = (j + 2) % 3;
+
+                const float r1 = e1[i1] * absR[i2][j] + e1[i2] * absR[i1][j];
+                const float r2 = e2[j1] * absR[i][j2] + e2[j2] * absR[i][j1];
+                if (Abs(t[i2] * R[i1][j] - t[i1] * R[i2][j]) > r1 + r2)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    inline bool Intersects(const OBB & box, const Vector4 * pPlanes, unsigned int planeCount)
+    {
+        for (unsigned int i = 0; i < planeCount; ++i)
+        {
+            const Vector3 normal(pPlanes[i].X, pPlanes[i].Y, pPlanes[i].Z);
+
+            // Extent of the box along the plane normal.
+            const float radius = box.Extents.X * Abs(Dot(normal, box.Axes.Row(0))) +
+                                 box.Extents.Y * Abs(Dot(normal, box.Axes.Row(1))) +
+                                 box.Extents.Z * Abs(Dot(normal, box.Axes.Row(2)));
+
+            if (Dot(normal, box.Center) + pPlanes[i].W < -radius)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_OBB_INL_
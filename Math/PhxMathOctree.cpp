@@ -0,0 +1,556 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathOctree.h"
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // How a node's loose bounds relate to a query volume.
+        namespace Overlap
+        {
+            enum Type
+            {
+                Outside,
+                Intersects,
+                Inside,     // Everything in the node and below is in the volume.
+            };
+        }
+
+        struct BoxTest
+        {
+            const AABB * pBox;
+
+            Overlap::Type TestNode(const AABB & bounds) const
+            {
+                if (false == Intersects(*pBox, bounds))
+                {
+                    return Overlap::Outside;
+                }
+                return Contains(*pBox, bounds) ? Overlap::Inside : Overlap::Intersects;
+            }
+
+            bool TestObject(const AABB & box) const
+            {
+                return Intersects(*pBox, box);
+            }
+        };
+
+        struct SphereTest
+        {
+            const Sphere * pSphere;
+
+            Overlap::Type TestNode(const AABB & bounds) const
+            {
+                if (false == Intersects(*pSphere, bounds))
+                {
+                    return Overlap::Outside;
+                }
+
+                // Inside when the farthest corner is.
+                const Vector3 & center = pSphere->Center;
+                const Vector3 farthest(Max(center.X - bounds.Min.X, bounds.Max.X - center.X),
+                                       Max(center.Y - bounds.Min.Y, bounds.Max.Y - center.Y),
+                                       Max(center.Z - bounds.Min.Z, bounds.Max.Z - center.Z));
+
+                return (LengthSquared(farthest) <= pSphere->Radius * pSphere->Radius) ? Overlap::Inside : Overlap::Intersects;
+            }
+
+            bool TestObject(const AABB & box) const
+            {
+                return Intersects(*pSphere, box);
+            }
+        };
+
+        struct FrustumTest
+        {
+            const Vector4 * pPlanes;
+            unsigned int PlaneCount;
+
+            Overlap::Type TestNode(const AABB & bounds) const
+            {
+                const Vector3 center = bounds.GetCenter();
+                const Vector3 extents = bounds.GetExtents();
+
+                Overlap::Type overlap = Overlap::Inside;
+
+                for (unsigned int i = 0; i < PlaneCount; ++i)
+                {
+                    const Vector4 & plane = pPlanes[i];
+
+                    // Extent of the box along the plane normal.
+                    const float radius = extents.X * Abs(plane.X) + extents.Y * Abs(plane.Y) + extents.Z * Abs(plane.Z);
+                    const float distance = plane.X * center.X + plane.Y * center.Y + plane.Z * center.Z + plane.W;
+
+                    if (distance < -radius)
+                    {
+                        return Overlap::Outside;
+                    }
+                    if (distance < radius)
+                    {
+                        overlap = Overlap::Intersects;
+                    }
+                }
+
+                return overlap;
+            }
+
+            bool TestObject(const AABB & box) const
+            {
+                return (TestNode(box) != Overlap::Outside);
+            }
+        };
+
+        struct RayTest
+        {
+            const Ray * pRay;
+            float MaxDistance;
+
+            Overlap::Type TestNode(const AABB & bounds) const
+            {
+                return TestObject(bounds) ? Overlap::Intersects : Overlap::Outside;
+            }
+
+            bool TestObject(const AABB & box) const
+            {
+                float t;
+                return Intersects(*pRay, box, t) && (t <= MaxDistance);
+            }
+        };
+    }
+
+    LooseOctree::LooseOctree(const AABB & bounds, unsigned int maxDepth, float looseness)
+        : m_maxDepth((maxDepth < MaxDepth) ? maxDepth : MaxDepth)
+        , m_looseness(looseness)
+        , m_count(0)
+        , m_nodeCount(0)
+        , m_freeNode(InvalidId)
+        , m_freeObject(InvalidId)
+    {
+        DebugAssert(false == bounds.IsEmpty(), "Cannot create an octree over an empty box.");
+        DebugAssert(maxDepth <= MaxDepth, "Octree depth (%u) is more than the max (%u).", maxDepth, MaxDepth);
+        DebugAssert(looseness >= 1.0f, "Octree looseness (%f) must be at least 1.", looseness);
+
+        const Vector3 extents = bounds.GetExtents();
+        AllocateNode(bounds.GetCenter(), Max(extents.X, extents.Y, extents.Z), InvalidId, 0);
+    }
+
+    LooseOctree::~LooseOctree()
+    {
+    }
+
+    unsigned int LooseOctree::Insert(const AABB & box)
+    {
+        const unsigned int id = AllocateObject();
+        m_objects[id].Box.Set(box);
+
+        Link(id);
+        ++m_count;
+
+        return id;
+    }
+
+    unsigned int LooseOctree::Insert(const Vector3 & p)
+    {
+        return Insert(AABB(p, p));
+    }
+
+    void LooseOctree::Update(unsigned int id, const AABB & box)
+    {
+        DebugAssert(id < m_objects.GetCount() && m_objects[id].Owner != InvalidId, "Invalid octree object id (%u).", id);
+
+        Object & object = m_objects[id];
+        object.Box.Set(box);
+
+        // Still inside the loose bounds of its node, nothing else to do.
+        if (IsInLooseBounds(m_nodes[object.Owner], box))
+        {
+            return;
+        }
+
+        Unlink(id);
+        Link(id);
+    }
+
+    void LooseOctree::Update(unsigned int id, const Vector3 & p)
+    {
+        Update(id, AABB(p, p));
+    }
+
+    void LooseOctree::Remove(unsigned int id)
+    {
+        DebugAssert(id < m_objects.GetCount() && m_objects[id].Owner != InvalidId, "Invalid octree object id (%u).", id);
+
+        Unlink(id);
+
+        Object & object = m_objects[id];
+        object.Owner = InvalidId;
+        object.Next = m_freeObject;
+        m_freeObject = id;
+
+        --m_count;
+    }
+
+    void LooseOctree::Clear()
+    {
+        const Node & root = m_nodes[0];
+        const Vector3 center = root.Center;
+        const float halfSize = root.HalfSize;
+
+        m_nodes.Clear();
+        m_objects.Clear();
+        m_freeNode = InvalidId;
+        m_freeObject = InvalidId;
+        m_count = 0;
+        m_nodeCount = 0;
+
+        AllocateNode(center, halfSize, InvalidId, 0);
+    }
+
+    const AABB & LooseOctree::GetBounds(unsigned int id) const
+    {
+        DebugAssert(id < m_objects.GetCount() && m_objects[id].Owner != InvalidId, "Invalid octree object id (%u).", id);
+        return m_objects[id].Box;
+    }
+
+    unsigned int LooseOctree::GetCount() const
+    {
+        return m_count;
+    }
+
+    unsigned int LooseOctree::GetNodeCount() const
+    {
+        return m_nodeCount;
+    }
+
+    unsigned int LooseOctree::Query(const AABB & box, unsigned int * pOutIds, unsigned int maxCount, OctreeQueryStats * pStats) const
+    {
+        BoxTest test;
+        test.pBox = &box;
+        return Traverse(test, pOutIds, maxCount, pStats);
+    }
+
+    unsigned int LooseOctree::Query(const Sphere & sphere, unsigned int * pOutIds, unsigned int maxCount, OctreeQueryStats * pStats) const
+    {
+        SphereTest test;
+        test.pSphere = &sphere;
+        return Traverse(test, pOutIds, maxCount, pStats);
+    }
+
+    unsigned int LooseOctree::Query(const Vector4 * pPlanes, unsigned int planeCount, unsigned int * pOutIds, unsigned int maxCount, OctreeQueryStats * pStats) const
+    {
+        FrustumTest test;
+        test.pPlanes = pPlanes;
+        test.PlaneCount = planeCount;
+        return Traverse(test, pOutIds, maxCount, pStats);
+    }
+
+    unsigned int LooseOctree::Query(const Ray & ray, float maxDistance, unsigned int * pOutIds, unsigned int maxCount, OctreeQueryStats * pStats) const
+    {
+        RayTest test;
+        test.pRay = &ray;
+        test.MaxDistance = maxDistance;
+        return Traverse(test, pOutIds, maxCount, pStats);
+    }
+
+    template <class Test>
+    unsigned int LooseOctree::Traverse(const Test & test, unsigned int * pOutIds, unsigned int maxCount, OctreeQueryStats * pStats) const
+    {
+        // Depth first, at most 7 siblings are waiting on the stack per level.
+        unsigned int stack[7 * MaxDepth + 8];
+        bool stackInside[7 * MaxDepth + 8];
+        unsigned int stackSize = 0;
+
+        unsigned int written = 0;
+        unsigned int nodesVisited = 0;
+        unsigned int objectsTested = 0;
+
+        // The root is always visited, it also holds the objects outside the tree.
+        if (m_count > 0 && maxCount > 0)
+        {
+            stack[0] = 0;
+            stackInside[0] = false;
+            stackSize = 1;
+        }
+
+        AABB bounds;
+
+        while (stackSize > 0)
+        {
+            --stackSize;
+            const Node & node = m_nodes[stack[stackSize]];
+            const bool inside = stackInside[stackSize];
+
+            ++nodesVisited;
+
+            for (unsigned int id = node.FirstObject; id != InvalidId; id = m_objects[id].Next)
+            {
+                if (false == inside)
+                {
+                    ++objectsTested;
+                    if (false == test.TestObject(m_objects[id].Box))
+                    {
+                        continue;
+                    }
+                }
+
+                pOutIds[written++] = id;
+                if (written == maxCount)
+                {
+                    stackSize = 0;
+                    break;
+                }
+            }
+
+            if (written == maxCount)
+            {
+                break;
+            }
+
+            for (unsigned int i = 0; i < 8; ++i)
+            {
+                const unsigned int child = node.Children[i];
+                if (child == InvalidId)
+                {
+                    continue;
+                }
+
+                Overlap::Type overlap = Overlap::Inside;
+                if (false == inside)
+                {
+                    GetLooseBounds(m_nodes[child], bounds);
+                    overlap = test.TestNode(bounds);
+                }
+
+                if (overlap != Overlap::Outside)
+                {
+                    stack[stackSize] = child;
+                    stackInside[stackSize] = (overlap == Overlap::Inside);
+                    ++stackSize;
+                }
+            }
+        }
+
+        if (pStats != nullptr)
+        {
+            pStats->NodesVisited = nodesVisited;
+            pStats->ObjectsTested = objectsTested;
+        }
+
+        return written;
+    }
+
+    unsigned int LooseOctree::AllocateNode(const Vector3 & center, float halfSize, unsigned int parent, unsigned int depth)
+    {
+        unsigned int idx = m_freeNode;
+        if (idx != InvalidId)
+        {
+            m_freeNode = m_nodes[idx].Parent;
+        }
+        else
+        {
+            // Resize only reserves what it is asked for, grow the pool geometrically.
+            idx = m_nodes.GetCount();
+            if (idx == m_nodes.GetCapacity())
+            {
+                m_nodes.Reserve(idx < 64 ? 64 : idx * 2);
+            }
+            m_nodes.Resize(idx + 1);
+        }
+
+        Node & node = m_nodes[idx];
+        node.Center.Set(center);
+        node.HalfSize = halfSize;
+        node.Parent = parent;
+        node.Depth = depth;
+        node.FirstObject = InvalidId;
+        node.ObjectCount = 0;
+
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            node.Children[i] = InvalidId;
+        }
+
+        ++m_nodeCount;
+        return idx;
+    }
+
+    unsigned int LooseOctree::AllocateObject()
+    {
+        unsigned int id = m_freeObject;
+        if (id != InvalidId)
+        {
+            m_freeObject = m_objects[id].Next;
+            return id;
+        }
+
+        id = m_objects.GetCount();
+        if (id == m_objects.GetCapacity())
+        {
+            m_objects.Reserve(id < 64 ? 64 : id * 2);
+        }
+        m_objects.Resize(id + 1);
+        return id;
+    }
+
+    void LooseOctree::ReleaseNode(unsigned int idx)
+    {
+        // Only empty nodes are released, and their children were released when they emptied.
+        Node & node = m_nodes[idx];
+
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            if (m_nodes[node.Parent].Children[i] == idx)
+            {
+                m_nodes[node.Parent].Children[i] = InvalidId;
+                break;
+            }
+        }
+
+        node.Parent = m_freeNode;
+        m_freeNode = idx;
+        --m_nodeCount;
+    }
+
+    void LooseOctree::Link(unsigned int id)
+    {
+        const AABB box = m_objects[id].Box;
+        const Vector3 center = box.GetCenter();
+        const Vector3 extents = box.GetExtents();
+        const float extent = Max(extents.X, extents.Y, extents.Z);
+
+        unsigned int idx = 0;
+
+        // Objects that stick out of the tree stay in the root.
+        const Node & root = m_nodes[0];
+        const bool inRootCell = (Abs(center.X - root.Center.X) <= root.HalfSize) &&
+                                (Abs(center.Y - root.Center.Y) <= root.HalfSize) &&
+                                (Abs(center.Z - root.Center.Z) <= root.HalfSize);
+
+        if (inRootCell && IsInLooseBounds(root, box))
+        {
+            // Go down while the object fits in the loose bounds of the child cell holding its center.
+            while (m_nodes[idx].Depth < m_maxDepth)
+            {
+                const Node & node = m_nodes[idx];
+                const float childHalfSize = node.HalfSize * 0.5f;
+
+                if (extent > (m_looseness - 1.0f) * childHalfSize)
+                {
+                    break;
+                }
+
+                const unsigned int i = ((center.X >= node.Center.X) ? 1 : 0) |
+                                       ((center.Y >= node.Center.Y) ? 2 : 0) |
+                                       ((center.Z >= node.Center.Z) ? 4 : 0);
+
+                unsigned int child = node.Children[i];
+                if (child == InvalidId)
+                {
+                    const Vector3 childCenter(node.Center.X + ((i & 1) ? childHalfSize : -childHalfSize),
+                                              node.Center.Y + ((i & 2) ? childHalfSize : -childHalfSize),
+                                              node.Center.Z + ((i & 4) ? childHalfSize : -childHalfSize));
+
+                    // Can grow the node pool, node is not used after this.
+                    child = AllocateNode(childCenter, childHalfSize, idx, m_nodes[idx].Depth + 1);
+                    m_nodes[idx].Children[i] = child;
+                }
+
+                idx = child;
+            }
+        }
+
+        Object & object = m_objects[id];
+        Node & node = m_nodes[idx];
+
+        object.Owner = idx;
+        object.Prev = InvalidId;
+        object.Next = node.FirstObject;
+        if (node.FirstObject != InvalidId)
+        {
+            m_objects[node.FirstObject].Prev = id;
+        }
+        node.FirstObject = id;
+
+        for (unsigned int n = idx; n != InvalidId; n = m_nodes[n].Parent)
+        {
+            ++m_nodes[n].ObjectCount;
+        }
+    }
+
+    void LooseOctree::Unlink(unsigned int id)
+    {
+        const Object & object = m_objects[id];
+        Node & node = m_nodes[object.Owner];
+
+        if (object.Prev != InvalidId)
+        {
+            m_objects[object.Prev].Next = object.Next;
+        }
+        else
+        {
+            node.FirstObject = object.Next;
+        }
+
+        if (object.Next != InvalidId)
+        {
+            m_objects[object.Next].Prev = object.Prev;
+        }
+
+        for (unsigned int n = object.Owner; n != InvalidId; )
+        {
+            const unsigned int parent = m_nodes[n].Parent;
+
+            if (--m_nodes[n].ObjectCount == 0 && n != 0)
+            {
+                ReleaseNode(n);
+            }
+
+            n = parent;
+        }
+    }
+
+    bool LooseOctree::IsInLooseBounds(const Node & node, const AABB & box) const
+    {
+        const float looseHalfSize = node.HalfSize * m_looseness;
+
+        return (box.Min.X >= node.Center.X - looseHalfSize) && (box.Max.X <= node.Center.X + looseHalfSize) &&
+               (box.Min.Y >= node.Center.Y - looseHalfSize) && (box.Max.Y <= node.Center.Y + looseHalfSize) &&
+               (box.Min.Z >= node.Center.Z - looseHalfSize) && (box.Max.Z <= node.Center.Z + looseHalfSize);
+    }
+
+    void LooseOctree::GetLooseBounds(const Node & node, AABB & out) const
+    {
+        const float looseHalfSize = node.HalfSize * m_looseness;
+        const Vector3 extents(looseHalfSize);
+
+        out.Set(Subtract(node.Center, extents), Add(node.Center, extents));
+    }
+
+} //namespace Math
+} //namespace Phx
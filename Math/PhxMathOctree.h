@@ -0,0 +1,155 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_OCTREE_H_
+#define _PHX_MATH_OCTREE_H_
+
+#include "PhxMathMemory.h"
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Loose Octree
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Octree over boxes (and points) that move, for scenes where the density
+// is too uneven for a uniform grid. Every node is a cube and its loose
+// bounds are the cube scaled by Looseness around its center. An object is
+// stored in one node: the deepest node whose cell contains the center of
+// the object and whose loose bounds still contain the whole object, so an
+// object never straddles nodes.
+//
+// An object that moves but stays inside the loose bounds of its node is
+// updated in place, in O(1). Otherwise it is reinserted from the root.
+//
+// Nodes and objects live in pools with free lists, inserting does not
+// allocate once the pools are large enough. Nodes are only created on the
+// paths to objects, and nodes that become empty go back to the pool.
+//
+// Objects outside the bounds of the tree are kept in the root, which
+// every query visits. Objects are identified by the id Insert returns,
+// queries write the ids of the objects they find in no particular order,
+// stop after maxCount and return the number written.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    // Work done by a query, for profiling.
+    struct OctreeQueryStats
+    {
+        unsigned int NodesVisited;
+        unsigned int ObjectsTested;
+    };
+
+    class LooseOctree
+    {
+    public:
+        static const unsigned int InvalidId = 0xFFFFFFFF;
+        static const unsigned int MaxDepth = 20;
+
+    public:
+        // bounds is made a cube around its center. The root is depth 0, maxDepth is clamped to MaxDepth.
+        explicit LooseOctree(const AABB & bounds, unsigned int maxDepth = 8, float looseness = 2.0f);
+        ~LooseOctree();
+
+        unsigned int Insert(const AABB & box);
+        unsigned int Insert(const Vector3 & p);
+
+        void Update(unsigned int id, const AABB & box);
+        void Update(unsigned int id, const Vector3 & p);
+
+        void Remove(unsigned int id);
+        void Clear();
+
+        const AABB & GetBounds(unsigned int id) const;
+
+        unsigned int GetCount() const;
+        unsigned int GetNodeCount() const;
+
+        // Objects whose boxes touch the volume.
+        unsigned int Query(const AABB & box, unsigned int * pOutIds, unsigned int maxCount, OctreeQueryStats * pStats = nullptr) const;
+        unsigned int Query(const Sphere & sphere, unsigned int * pOutIds, unsigned int maxCount, OctreeQueryStats * pStats = nullptr) const;
+
+        // Planes are (normal, d) with the normals pointing inside the volume, the same as CullSpheres. Like the OBB
+        // frustum test it is conservative, objects are only dropped when their box is completely behind a plane.
+        // Nodes completely inside every plane report all their objects without testing them.
+        unsigned int Query(const Vector4 * pPlanes, unsigned int planeCount, unsigned int * pOutIds, unsigned int maxCount, OctreeQueryStats * pStats = nullptr) const;
+
+        // Objects whose boxes the ray hits within maxDistance (in multiples of the ray direction length).
+        unsigned int Query(const Ray & ray, float maxDistance, unsigned int * pOutIds, unsigned int maxCount, OctreeQueryStats * pStats = nullptr) const;
+
+    private:
+        // Non-copyable.
+        LooseOctree(const LooseOctree &);
+        LooseOctree & operator=(const LooseOctree &);
+
+        struct Node
+        {
+            Vector3 Center;
+            float HalfSize;                 // Of the cell, the loose bounds are HalfSize * Looseness.
+            unsigned int Children[8];       // Child i is on the +X side when bit 0 of i is set, +Y bit 1, +Z bit 2.
+            unsigned int Parent;
+            unsigned int Depth;
+            unsigned int FirstObject;
+            unsigned int ObjectCount;       // In this node and below, a node is released when it drops to 0.
+        };
+
+        struct Object
+        {
+            AABB Box;
+            unsigned int Owner;             // Node holding the object, InvalidId for free objects.
+            unsigned int Next;              // Next object in the node, or in the free list.
+            unsigned int Prev;
+        };
+
+        unsigned int AllocateNode(const Vector3 & center, float halfSize, unsigned int parent, unsigned int depth);
+        unsigned int AllocateObject();
+
+        void Link(unsigned int id);
+        void Unlink(unsigned int id);
+
+        void ReleaseNode(unsigned int node);
+
+        bool IsInLooseBounds(const Node & node, const AABB & box) const;
+        void GetLooseBounds(const Node & node, AABB & out) const;
+
+        template <class Test>
+        unsigned int Traverse(const Test & test, unsigned int * pOutIds, unsigned int maxCount, OctreeQueryStats * pStats) const;
+
+    private:
+        unsigned int m_maxDepth;
+        float m_looseness;
+        unsigned int m_count;
+        unsigned int m_nodeCount;
+
+        AlignedArray<Node> m_nodes;         // Node 0 is the root.
+        AlignedArray<Object> m_objects;
+        unsigned int m_freeNode;            // Free nodes are linked through Parent.
+        unsigned int m_freeObject;
+    };
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_OCTREE_H_
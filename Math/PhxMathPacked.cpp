@@ -0,0 +1,58 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathPacked.h"
+#include "PhxMathBatch.h"
+
+namespace Phx {
+namespace Math {
+
+    // The packed and unpacked arrays are both flat runs of components, so the kernels just convert floats.
+    static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 arrays are converted as float arrays.");
+    static_assert(sizeof(Vector4) == sizeof(float) * 4, "Vector4 arrays are converted as float arrays.");
+
+    void Pack(const Vector3 * pIn, Vector3h * pOut, unsigned int count)
+    {
+        GetBatchKernels().PackHalf(reinterpret_cast<const float *>(pIn), reinterpret_cast<uint16_t *>(pOut), count * 3);
+    }
+
+    void Pack(const Vector4 * pIn, Vector4h * pOut, unsigned int count)
+    {
+        GetBatchKernels().PackHalf(reinterpret_cast<const float *>(pIn), reinterpret_cast<uint16_t *>(pOut), count * 4);
+    }
+
+    void Unpack(const Vector3h * pIn, Vector3 * pOut, unsigned int count)
+    {
+        GetBatchKernels().UnpackHalf(reinterpret_cast<const uint16_t *>(pIn), reinterpret_cast<float *>(pOut), count * 3);
+    }
+
+    void Unpack(const Vector4h * pIn, Vector4 * pOut, unsigned int count)
+    {
+        GetBatchKernels().UnpackHalf(reinterpret_cast<const uint16_t *>(pIn), reinterpret_cast<float *>(pOut), count * 4);
+    }
+
+} //namespace Math
+} //namespace Phx
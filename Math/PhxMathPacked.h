@@ -0,0 +1,165 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_PACKED_H_
+#define _PHX_MATH_PACKED_H_
+
+#include "PhxMath.h"
+
+// C Standard Library Includes
+#include <stdint.h>
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Packed Storage Formats
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Smaller versions of Vector3 and Vector4 for streams that don't need full
+// float precision. They are storage only, unpack them to do any math.
+//
+//   Format              Size       Range           Error (after a round trip)
+//   Vector3h/Vector4h   6/8 bytes  +-65504         relative 2^-11 (4.9e-4) for |f| >= 6.1e-5,
+//                                                  absolute 2^-25 (3e-8) below that
+//   Vector3s/Vector4s   6/8 bytes  [-1, 1]         absolute 1 / (2 * 32767) (1.5e-5)
+//   Unorm1010102        4 bytes    [0, 1]          absolute 1 / (2 * 1023) (4.9e-4) for xyz,
+//                                                  w is 0, 1/3, 2/3 or 1 (1 / 6)
+//   OctahedralNormal    4 bytes    unit vectors    0.004 degrees
+//
+// Half floats round to nearest even, values past the half range become
+// infinity and NaNs stay NaN, the same as the F16C instructions. The other
+// formats clamp to their range and pack NaN as 0.
+//
+// The half float array versions use F16C through the batch kernels
+// (PhxMathBatch.h) and give the same bits as the single versions.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    // Half floats (IEEE 754 binary16)
+    struct Vector3h
+    {
+        uint16_t X;
+        uint16_t Y;
+        uint16_t Z;
+    };
+
+    struct Vector4h
+    {
+        uint16_t X;
+        uint16_t Y;
+        uint16_t Z;
+        uint16_t W;
+    };
+
+    // Signed normalized, -32767 is -1 and 32767 is 1.
+    struct Vector3s
+    {
+        int16_t X;
+        int16_t Y;
+        int16_t Z;
+    };
+
+    struct Vector4s
+    {
+        int16_t X;
+        int16_t Y;
+        int16_t Z;
+        int16_t W;
+    };
+
+    // Unsigned normalized, x in bits 0-9, y in 10-19, z in 20-29 and w in 30-31.
+    struct Unorm1010102
+    {
+        uint32_t Bits;
+    };
+
+    // Unit vector folded onto an octahedron and stored as two snorm16 values.
+    // Ref: Cigolle et al, A Survey of Efficient Representations for Independent Unit Vectors
+    //      http://jcgt.org/published/0003/02/01/
+    struct OctahedralNormal
+    {
+        int16_t X;
+        int16_t Y;
+    };
+
+    inline uint16_t FloatToHalf(float f);
+    inline float HalfToFloat(uint16_t h);
+
+    inline int16_t FloatToSnorm16(float f);
+    inline float Snorm16ToFloat(int16_t s);
+
+    // f in [0, 1] scaled to [0, maxValue].
+    inline uint32_t FloatToUnorm(float f, uint32_t maxValue);
+    inline float UnormToFloat(uint32_t u, uint32_t maxValue);
+
+    inline void Pack(const Vector3 & v, Vector3h & out);
+    inline void Pack(const Vector4 & v, Vector4h & out);
+    inline void Pack(const Vector3 & v, Vector3s & out);
+    inline void Pack(const Vector4 & v, Vector4s & out);
+    inline void Pack(const Vector4 & v, Unorm1010102 & out);
+
+    // normal is expected to be unit length, a zero vector unpacks as UnitZ.
+    inline void Pack(const Vector3 & normal, OctahedralNormal & out);
+
+    inline Vector3 Unpack(const Vector3h & v);
+    inline void Unpack(const Vector3h & v, Vector3 & out);
+    inline Vector4 Unpack(const Vector4h & v);
+    inline void Unpack(const Vector4h & v, Vector4 & out);
+    inline Vector3 Unpack(const Vector3s & v);
+    inline void Unpack(const Vector3s & v, Vector3 & out);
+    inline Vector4 Unpack(const Vector4s & v);
+    inline void Unpack(const Vector4s & v, Vector4 & out);
+    inline Vector4 Unpack(const Unorm1010102 & v);
+    inline void Unpack(const Unorm1010102 & v, Vector4 & out);
+
+    // Always unit length.
+    inline Vector3 Unpack(const OctahedralNormal & n);
+    inline void Unpack(const OctahedralNormal & n, Vector3 & out);
+
+    // Arrays, through the batch kernels.
+    void Pack(const Vector3 * pIn, Vector3h * pOut, unsigned int count);
+    void Pack(const Vector4 * pIn, Vector4h * pOut, unsigned int count);
+    void Unpack(const Vector3h * pIn, Vector3 * pOut, unsigned int count);
+    void Unpack(const Vector4h * pIn, Vector4 * pOut, unsigned int count);
+
+    // Plain loops the compiler can vectorize.
+    inline void Pack(const Vector3 * pIn, Vector3s * pOut, unsigned int count);
+    inline void Pack(const Vector4 * pIn, Vector4s * pOut, unsigned int count);
+    inline void Pack(const Vector4 * pIn, Unorm1010102 * pOut, unsigned int count);
+    inline void Pack(const Vector3 * pNormals, OctahedralNormal * pOut, unsigned int count);
+    inline void Unpack(const Vector3s * pIn, Vector3 * pOut, unsigned int count);
+    inline void Unpack(const Vector4s * pIn, Vector4 * pOut, unsigned int count);
+    inline void Unpack(const Unorm1010102 * pIn, Vector4 * pOut, unsigned int count);
+    inline void Unpack(const OctahedralNormal * pIn, Vector3 * pOut, unsigned int count);
+
+    static_assert(sizeof(Vector3h) == 6 && sizeof(Vector4h) == 8, "Half vectors must be tightly packed.");
+    static_assert(sizeof(Vector3s) == 6 && sizeof(Vector4s) == 8, "Snorm16 vectors must be tightly packed.");
+
+} //namespace Math
+} //namespace Phx
+
+#include "PhxMathPacked.inl"
+
+#endif //_PHX_MATH_PACKED_H_
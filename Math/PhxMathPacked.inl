@@ -0,0 +1,372 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_PACKED_INL_
+#define _PHX_MATH_PACKED_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline uint16_t FloatToHalf(float f)
+    {
+        // Ref: Fabian Giesen, float_to_half_fast3_rtne
+        //      https://gist.github.com/rygorous/2156668
+
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(float));
+
+        const uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        uint32_t half;
+        if (bits >= 0x47800000u)
+        {
+            // Too large for a half (2^16 and up), infinity or NaN. NaNs keep the top of their payload and are made quiet.
+            half = (bits > 0x7F800000u) ? (0x7E00u | ((bits >> 13) & 0x3FFu)) : 0x7C00u;
+        }
+        else if (bits < 0x38800000u)
+        {
+            // Denormal or zero as a half, let the float add do the rounding by lining the mantissa up with 0.5f.
+            const uint32_t denormalMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+            float magic;
+            memcpy(&magic, &denormalMagic, sizeof(float));
+
+            float value;
+            memcpy(&value, &bits, sizeof(float));
+            value += magic;
+
+            memcpy(&half, &value, sizeof(float));
+            half -= denormalMagic;
+        }
+        else
+        {
+            // Rebias the exponent and round to nearest even, a mantissa overflow carries into the exponent
+            // which also rounds the largest values up to infinity.
+            const uint32_t mantissaOdd = (bits >> 13) & 1;
+            bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xFFFu;
+            bits += mantissaOdd;
+            half = bits >> 13;
+        }
+
+        return static_cast<uint16_t>(half | (sign >> 16));
+    }
+
+    inline float HalfToFloat(uint16_t h)
+    {
+        // Ref: Fabian Giesen, half_to_float
+        //      https://gist.github.com/rygorous/2144712
+
+        const uint32_t shiftedExponent = 0x7C00u << 13;
+
+        uint32_t bits = (h & 0x7FFFu) << 13;
+        const uint32_t exponent = bits & shiftedExponent;
+        bits += static_cast<uint32_t>(127 - 15) << 23;
+
+        if (exponent == shiftedExponent)
+        {
+            // Infinity or NaN, NaNs are made quiet like F16C does.
+            bits += static_cast<uint32_t>(128 - 16) << 23;
+            if (bits & 0x007FFFFFu)
+            {
+                bits |= 0x00400000u;
+            }
+        }
+        else if (exponent == 0)
+        {
+            // Zero or denormal, renormalize with a float subtract.
+            const uint32_t magicBits = 113u << 23;
+            float magic;
+            memcpy(&magic, &magicBits, sizeof(float));
+
+            bits += 1u << 23;
+
+            float value;
+            memcpy(&value, &bits, sizeof(float));
+            value -= magic;
+            memcpy(&bits, &value, sizeof(float));
+        }
+
+        bits |= static_cast<uint32_t>(h & 0x8000u) << 16;
+
+        float f;
+        memcpy(&f, &bits, sizeof(float));
+        return f;
+    }
+
+    inline int16_t FloatToSnorm16(float f)
+    {
+        // Written so NaN fails both compares and packs as 0.
+        const float clamped = (f > -1.0f) ? ((f < 1.0f) ? f : 1.0f) : ((f <= -1.0f) ? -1.0f : 0.0f);
+        const float scaled = clamped * 32767.0f;
+        return static_cast<int16_t>(scaled + ((scaled >= 0.0f) ? 0.5f : -0.5f));
+    }
+
+    inline float Snorm16ToFloat(int16_t s)
+    {
+        // -32768 also maps to -1.
+        const float f = static_cast<float>(s) * (1.0f / 32767.0f);
+        return (f < -1.0f) ? -1.0f : f;
+    }
+
+    inline uint32_t FloatToUnorm(float f, uint32_t maxValue)
+    {
+        const float clamped = (f > 0.0f) ? ((f < 1.0f) ? f : 1.0f) : 0.0f;
+        return static_cast<uint32_t>(clamped * static_cast<float>(maxValue) + 0.5f);
+    }
+
+    inline float UnormToFloat(uint32_t u, uint32_t maxValue)
+    {
+        return static_cast<float>(u) / static_cast<float>(maxValue);
+    }
+
+    inline void Pack(const Vector3 & v, Vector3h & out)
+    {
+        out.X = FloatToHalf(v.X);
+        out.Y = FloatToHalf(v.Y);
+        out.Z = FloatToHalf(v.Z);
+    }
+
+    inline void Pack(const Vector4 & v, Vector4h & out)
+    {
+        out.X = FloatToHalf(v.X);
+        out.Y = FloatToHalf(v.Y);
+        out.Z = FloatToHalf(v.Z);
+        out.W = FloatToHalf(v.W);
+    }
+
+    inline void Pack(const Vector3 & v, Vector3s & out)
+    {
+        out.X = FloatToSnorm16(v.X);
+        out.Y = FloatToSnorm16(v.Y);
+        out.Z = FloatToSnorm16(v.Z);
+    }
+
+    inline void Pack(const Vector4 & v, Vector4s & out)
+    {
+        out.X = FloatToSnorm16(v.X);
+        out.Y = FloatToSnorm16(v.Y);
+        out.Z = FloatToSnorm16(v.Z);
+        out.W = FloatToSnorm16(v.W);
+    }
+
+    inline void Pack(const Vector4 & v, Unorm1010102 & out)
+    {
+        out.Bits = FloatToUnorm(v.X, 1023) |
+            (FloatToUnorm(v.Y, 1023) << 10) |
+            (FloatToUnorm(v.Z, 1023) << 20) |
+            (FloatToUnorm(v.W, 3) << 30);
+    }
+
+    inline void Pack(const Vector3 & normal, OctahedralNormal & out)
+    {
+        // Project onto the octahedron |x| + |y| + |z| = 1, then fold the lower half over the upper half.
+        const float l1 = Abs(normal.X) + Abs(normal.Y) + Abs(normal.Z);
+        const float invL1 = (l1 > 0.0f) ? (1.0f / l1) : 0.0f;
+
+        float x = normal.X * invL1;
+        float y = normal.Y * invL1;
+
+        if (normal.Z < 0.0f)
+        {
+            const float foldedX = (1.0f - Abs(y)) * ((x >= 0.0f) ? 1.0f : -1.0f);
+            const float foldedY = (1.0f - Abs(x)) * ((y >= 0.0f) ? 1.0f : -1.0f);
+            x = foldedX;
+            y = foldedY;
+        }
+
+        out.X = FloatToSnorm16(x);
+        out.Y = FloatToSnorm16(y);
+    }
+
+    inline Vector3 Unpack(const Vector3h & v)
+    {
+        Vector3 out;
+        Unpack(v, out);
+        return out;
+    }
+
+    inline void Unpack(const Vector3h & v, Vector3 & out)
+    {
+        out.X = HalfToFloat(v.X);
+        out.Y = HalfToFloat(v.Y);
+        out.Z = HalfToFloat(v.Z);
+    }
+
+    inline Vector4 Unpack(const Vector4h & v)
+    {
+        Vector4 out;
+        Unpack(v, out);
+        return out;
+    }
+
+    inline void Unpack(const Vector4h & v, Vector4 & out)
+    {
+        out.X = HalfToFloat(v.X);
+        out.Y = HalfToFloat(v.Y);
+        out.Z = HalfToFloat(v.Z);
+        out.W = HalfToFloat(v.W);
+    }
+
+    inline Vector3 Unpack(const Vector3s & v)
+    {
+        Vector3 out;
+        Unpack(v, out);
+        return out;
+    }
+
+    inline void Unpack(const Vector3s & v, Vector3 & out)
+    {
+        out.X = Snorm16ToFloat(v.X);
+        out.Y = Snorm16ToFloat(v.Y);
+        out.Z = Snorm16ToFloat(v.Z);
+    }
+
+    inline Vector4 Unpack(const Vector4s & v)
+    {
+        Vector4 out;
+        Unpack(v, out);
+        return out;
+    }
+
+    inline void Unpack(const Vector4s & v, Vector4 & out)
+    {
+        out.X = Snorm16ToFloat(v.X);
+        out.Y = Snorm16ToFloat(v.Y);
+        out.Z = Snorm16ToFloat(v.Z);
+        out.W = Snorm16ToFloat(v.W);
+    }
+
+    inline Vector4 Unpack(const Unorm1010102 & v)
+    {
+        Vector4 out;
+        Unpack(v, out);
+        return out;
+    }
+
+    inline void Unpack(const Unorm1010102 & v, Vector4 & out)
+    {
+        out.X = UnormToFloat(v.Bits & 0x3FF, 1023);
+        out.Y = UnormToFloat((v.Bits >> 10) & 0x3FF, 1023);
+        out.Z = UnormToFloat((v.Bits >> 20) & 0x3FF, 1023);
+        out.W = UnormToFloat(v.Bits >> 30, 3);
+    }
+
+    inline Vector3 Unpack(const OctahedralNormal & n)
+    {
+        Vector3 out;
+        Unpack(n, out);
+        return out;
+    }
+
+    inline void Unpack(const OctahedralNormal & n, Vector3 & out)
+    {
+        // Unfolds the lower half without branching on the sign of z.
+
+        const float x = Snorm16ToFloat(n.X);
+        const float y = Snorm16ToFloat(n.Y);
+        const float z = 1.0f - Abs(x) - Abs(y);
+        const float t = (z < 0.0f) ? -z : 0.0f;
+
+        out.X = x + ((x >= 0.0f) ? -t : t);
+        out.Y = y + ((y >= 0.0f) ? -t : t);
+        out.Z = z;
+
+        // |x| + |y| + |z| is at least 1, so the length can never be zero.
+        const float invLength = 1.0f / sqrtf((out.X * out.X) + (out.Y * out.Y) + (out.Z * out.Z));
+        out.X *= invLength;
+        out.Y *= invLength;
+        out.Z *= invLength;
+    }
+
+    inline void Pack(const Vector3 * pIn, Vector3s * pOut, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Pack(pIn[i], pOut[i]);
+        }
+    }
+
+    inline void Pack(const Vector4 * pIn, Vector4s * pOut, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Pack(pIn[i], pOut[i]);
+        }
+    }
+
+    inline void Pack(const Vector4 * pIn, Unorm1010102 * pOut, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Pack(pIn[i], pOut[i]);
+        }
+    }
+
+    inline void Pack(const Vector3 * pNormals, OctahedralNormal * pOut, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Pack(pNormals[i], pOut[i]);
+        }
+    }
+
+    inline void Unpack(const Vector3s * pIn, Vector3 * pOut, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Unpack(pIn[i], pOut[i]);
+        }
+    }
+
+    inline void Unpack(const Vector4s * pIn, Vector4 * pOut, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Unpack(pIn[i], pOut[i]);
+        }
+    }
+
+    inline void Unpack(const Unorm1010102 * pIn, Vector4 * pOut, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Unpack(pIn[i], pOut[i]);
+        }
+    }
+
+    inline void Unpack(const OctahedralNormal * pIn, Vector3 * pOut, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Unpack(pIn[i], pOut[i]);
+        }
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_PACKED_INL_
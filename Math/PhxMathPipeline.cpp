@@ -0,0 +1,240 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathPipeline.h"
+
+// C++ Standard Library Includes
+#include <chrono>
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        uint64_t GetNanoseconds()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        // Chunks are kept a multiple of the widest batch kernel so only the last chunk has a remainder.
+        const unsigned int ChunkGranularity = 16;
+
+        unsigned int ChunkSizeForCache(unsigned int cacheBytes, unsigned int bytesPerElement)
+        {
+            const unsigned int elements = (cacheBytes / 2) / bytesPerElement;
+            return elements - (elements % ChunkGranularity);
+        }
+    }
+
+    Pipeline::Pipeline()
+        : m_chunkSize(0)
+        , m_bytesPerElement(0)
+        , m_timingEnabled(true)
+    { }
+
+    Pipeline::~Pipeline()
+    { }
+
+    Pipeline::Stage & Pipeline::AddStage(StageType type, const char * pName, unsigned int bytesPerElement)
+    {
+        Stage stage;
+        memset(static_cast<void *>(&stage), 0, sizeof(Stage));
+        stage.Type = type;
+        stage.Stats.pName = pName;
+        stage.BytesPerElement = bytesPerElement;
+
+        m_bytesPerElement += bytesPerElement;
+        return m_stages.PushBack(stage);
+    }
+
+    void Pipeline::AddStage(const char * pName, StageFunction function, void * pUserData, unsigned int bytesPerElement)
+    {
+        DebugAssert(function != nullptr, "Trying to add a pipeline stage without a function!");
+
+        Stage & stage = AddStage(StageCustom, pName, bytesPerElement);
+        stage.Function = function;
+        stage.pUserData = pUserData;
+    }
+
+    void Pipeline::AddTransform(const Vector3 * pIn, const Matrix4x4 & m, Vector3 * pOut)
+    {
+        Stage & stage = AddStage(StageTransformVector3, "TransformVector3", sizeof(Vector3) * 2);
+        stage.Matrix = m;
+        stage.pIn = pIn;
+        stage.pOut = pOut;
+    }
+
+    void Pipeline::AddTransform(const Vector4 * pIn, const Matrix4x4 & m, Vector4 * pOut)
+    {
+        Stage & stage = AddStage(StageTransformVector4, "TransformVector4", sizeof(Vector4) * 2);
+        stage.Matrix = m;
+        stage.pIn = pIn;
+        stage.pOut = pOut;
+    }
+
+    void Pipeline::AddNormalize(const Vector3 * pIn, Vector3 * pOut)
+    {
+        Stage & stage = AddStage(StageNormalizeVector3, "NormalizeVector3", sizeof(Vector3) * 2);
+        stage.pIn = pIn;
+        stage.pOut = pOut;
+    }
+
+    void Pipeline::AddMultiply(const Matrix4x4 * pLhs, const Matrix4x4 & rhs, Matrix4x4 * pOut)
+    {
+        Stage & stage = AddStage(StageMultiplyMatrix4x4ByMatrix, "MultiplyMatrix4x4", sizeof(Matrix4x4) * 2);
+        stage.Matrix = rhs;
+        stage.pIn = pLhs;
+        stage.pOut = pOut;
+    }
+
+    void Pipeline::AddSlerp(const Quaternion * pQ1, const Quaternion * pQ2, float weight, Quaternion * pOut)
+    {
+        Stage & stage = AddStage(StageSlerpQuaternion, "SlerpQuaternion", sizeof(Quaternion) * 3);
+        stage.pIn = pQ1;
+        stage.pIn2 = pQ2;
+        stage.Weight = weight;
+        stage.pOut = pOut;
+    }
+
+    void Pipeline::Clear()
+    {
+        m_stages.Clear();
+        m_bytesPerElement = 0;
+    }
+
+    void Pipeline::Execute(unsigned int count)
+    {
+        const unsigned int stageCount = m_stages.GetCount();
+        const unsigned int chunkSize = GetChunkSize();
+
+        // Counts down what is left, first + chunkSize can wrap when count is close to UINT_MAX.
+        unsigned int first = 0;
+        unsigned int remaining = count;
+        while (remaining > 0)
+        {
+            const unsigned int chunkCount = (remaining < chunkSize) ? remaining : chunkSize;
+
+            for (unsigned int i = 0; i < stageCount; ++i)
+            {
+                Stage & stage = m_stages[i];
+
+                if (m_timingEnabled)
+                {
+                    const uint64_t start = GetNanoseconds();
+                    RunStage(stage, first, chunkCount);
+                    stage.Stats.Nanoseconds += GetNanoseconds() - start;
+                }
+                else
+                {
+                    RunStage(stage, first, chunkCount);
+                }
+
+                stage.Stats.Elements += chunkCount;
+                ++stage.Stats.Chunks;
+            }
+
+            first += chunkCount;
+            remaining -= chunkCount;
+        }
+    }
+
+    void Pipeline::RunStage(const Stage & stage, unsigned int first, unsigned int count) const
+    {
+        const BatchKernels & kernels = GetBatchKernels();
+
+        switch (stage.Type)
+        {
+        case StageCustom:
+            stage.Function(stage.pUserData, first, count);
+            break;
+
+        case StageTransformVector3:
+            kernels.TransformVector3(static_cast<const Vector3 *>(stage.pIn) + first, stage.Matrix, static_cast<Vector3 *>(stage.pOut) + first, count);
+            break;
+
+        case StageTransformVector4:
+            kernels.TransformVector4(static_cast<const Vector4 *>(stage.pIn) + first, stage.Matrix, static_cast<Vector4 *>(stage.pOut) + first, count);
+            break;
+
+        case StageNormalizeVector3:
+            kernels.NormalizeVector3(static_cast<const Vector3 *>(stage.pIn) + first, static_cast<Vector3 *>(stage.pOut) + first, count);
+            break;
+
+        case StageMultiplyMatrix4x4ByMatrix:
+            kernels.MultiplyMatrix4x4ByMatrix(static_cast<const Matrix4x4 *>(stage.pIn) + first, stage.Matrix, static_cast<Matrix4x4 *>(stage.pOut) + first, count);
+            break;
+
+        case StageSlerpQuaternion:
+            kernels.SlerpQuaternion(static_cast<const Quaternion *>(stage.pIn) + first, static_cast<const Quaternion *>(stage.pIn2) + first,
+                stage.Weight, static_cast<Quaternion *>(stage.pOut) + first, count);
+            break;
+        }
+    }
+
+    void Pipeline::SetChunkSize(unsigned int chunkSize)
+    {
+        m_chunkSize = chunkSize;
+    }
+
+    unsigned int Pipeline::GetChunkSize() const
+    {
+        if (m_chunkSize != 0)
+        {
+            return m_chunkSize;
+        }
+
+        const unsigned int bytesPerElement = (m_bytesPerElement > 0) ? m_bytesPerElement : 1;
+        const CpuCacheSizes & cacheSizes = GetCpuCacheSizes();
+
+        const unsigned int l1ChunkSize = ChunkSizeForCache(cacheSizes.L1Data, bytesPerElement);
+        if (l1ChunkSize >= MinL1ChunkSize)
+        {
+            return l1ChunkSize;
+        }
+
+        const unsigned int l2ChunkSize = ChunkSizeForCache(cacheSizes.L2, bytesPerElement);
+        return (l2ChunkSize >= ChunkGranularity) ? l2ChunkSize : ChunkGranularity;
+    }
+
+    void Pipeline::SetTimingEnabled(bool enabled)
+    {
+        m_timingEnabled = enabled;
+    }
+
+    void Pipeline::ResetStats()
+    {
+        const unsigned int stageCount = m_stages.GetCount();
+        for (unsigned int i = 0; i < stageCount; ++i)
+        {
+            PipelineStageStats & stats = m_stages[i].Stats;
+            stats.Nanoseconds = 0;
+            stats.Elements = 0;
+            stats.Chunks = 0;
+        }
+    }
+
+} //namespace Math
+} //namespace Phx
@@ -0,0 +1,157 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_PIPELINE_H_
+#define _PHX_MATH_PIPELINE_H_
+
+#include "PhxMathBatch.h"
+#include "PhxMathMemory.h"
+
+// C Standard Library Includes
+#include <stdint.h>
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Chunked Batch Pipeline
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Runs a list of batch operations (stages) over the same range of elements
+// one chunk at a time: every stage runs over elements [0, chunk), then every
+// stage over [chunk, 2 * chunk)... so the output of one stage is still in
+// cache when the next stage reads it, instead of streaming the whole array
+// through memory once per stage.
+//
+//   Pipeline pipeline;
+//   pipeline.AddTransform(pPositions, world, pWorldPositions);
+//   pipeline.AddStage("Skin", SkinVertices, &skinArgs, sizeof(SkinnedVertex) + sizeof(Vector3));
+//   pipeline.AddNormalize(pNormals, pNormals);
+//   pipeline.AddTransform(pWorldPositions4, viewProjection, pClipPositions);
+//   pipeline.Execute(vertexCount);
+//
+// Element i of a stage is element i of every array it was added with, the
+// arrays must hold at least the count passed to Execute.
+//
+// By default the chunk size is picked so the bytes all stages touch per
+// chunk fill half of the L1 data cache, or half of L2 when that would give
+// chunks too small to amortize the per chunk work (see GetChunkSize).
+//
+// Each stage keeps timing counters, summed over every Execute call until
+// ResetStats is called. Timing reads the clock twice per stage per chunk
+// and can be turned off with SetTimingEnabled.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    struct PipelineStageStats
+    {
+        const char * pName;
+        uint64_t Nanoseconds;
+        uint64_t Elements;
+        uint64_t Chunks;
+    };
+
+    class Pipeline
+    {
+    public:
+        // Processes elements [first, first + count) of the stage's arrays.
+        typedef void (*StageFunction)(void * pUserData, unsigned int first, unsigned int count);
+
+        // Smallest chunk the automatic sizing will pick from L1, below this L2 is used instead.
+        static const unsigned int MinL1ChunkSize = 256;
+
+    public:
+        Pipeline();
+        ~Pipeline();
+
+        // bytesPerElement is the number of bytes the stage reads and writes per element, used for the chunk size.
+        void AddStage(const char * pName, StageFunction function, void * pUserData, unsigned int bytesPerElement);
+
+        // The batch operations from PhxMathBatch.h.
+        void AddTransform(const Vector3 * pIn, const Matrix4x4 & m, Vector3 * pOut);
+        void AddTransform(const Vector4 * pIn, const Matrix4x4 & m, Vector4 * pOut);
+        void AddNormalize(const Vector3 * pIn, Vector3 * pOut);
+        void AddMultiply(const Matrix4x4 * pLhs, const Matrix4x4 & rhs, Matrix4x4 * pOut);
+        void AddSlerp(const Quaternion * pQ1, const Quaternion * pQ2, float weight, Quaternion * pOut);
+
+        void Clear();
+
+        void Execute(unsigned int count);
+
+        // 0 goes back to picking the chunk size from the cache sizes.
+        void SetChunkSize(unsigned int chunkSize);
+        unsigned int GetChunkSize() const;
+
+        void SetTimingEnabled(bool enabled);
+        inline bool IsTimingEnabled() const;
+
+        inline unsigned int GetStageCount() const;
+        inline const PipelineStageStats & GetStageStats(unsigned int idx) const;
+        void ResetStats();
+
+    private:
+        // Non-copyable.
+        Pipeline(const Pipeline &);
+        Pipeline & operator=(const Pipeline &);
+
+        enum StageType
+        {
+            StageCustom,
+            StageTransformVector3,
+            StageTransformVector4,
+            StageNormalizeVector3,
+            StageMultiplyMatrix4x4ByMatrix,
+            StageSlerpQuaternion,
+        };
+
+        struct Stage
+        {
+            Matrix4x4 Matrix;
+            PipelineStageStats Stats;
+            StageType Type;
+            StageFunction Function;
+            void * pUserData;
+            const void * pIn;
+            const void * pIn2;
+            void * pOut;
+            float Weight;
+            unsigned int BytesPerElement;
+        };
+
+        Stage & AddStage(StageType type, const char * pName, unsigned int bytesPerElement);
+        void RunStage(const Stage & stage, unsigned int first, unsigned int count) const;
+
+    private:
+        AlignedArray<Stage> m_stages;
+        unsigned int m_chunkSize;
+        unsigned int m_bytesPerElement;
+        bool m_timingEnabled;
+    };
+
+} //namespace Math
+} //namespace Phx
+
+#include "PhxMathPipeline.inl"
+
+#endif //_PHX_MATH_PIPELINE_H_
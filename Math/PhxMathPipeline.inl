@@ -0,0 +1,52 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_PIPELINE_INL_
+#define _PHX_MATH_PIPELINE_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline bool Pipeline::IsTimingEnabled() const
+    {
+        return m_timingEnabled;
+    }
+
+    inline unsigned int Pipeline::GetStageCount() const
+    {
+        return m_stages.GetCount();
+    }
+
+    inline const PipelineStageStats & Pipeline::GetStageStats(unsigned int idx) const
+    {
+        DebugAssert(idx < m_stages.GetCount(), "Invalid index (%u) into a pipeline with (%u) stages!", idx, m_stages.GetCount());
+        return m_stages[idx].Stats;
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_PIPELINE_INL_
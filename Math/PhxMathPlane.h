@@ -0,0 +1,124 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_PLANE_H_
+#define _PHX_MATH_PLANE_H_
+
+namespace Phx {
+namespace Math {
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Plane
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // The points p on the plane satisfy Dot(Normal, p) + D = 0, the front
+    // of the plane is the side the normal points to. The layout is the same
+    // as the (normal, d) Vector4 planes taken by CullSpheres.
+    //
+    // SignedDistance is only a distance when the normal is unit length, the
+    // Create functions normalize, planes built from the members don't.
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    // Side of a plane, Straddle is Front | Back so the sides of several
+    // points or shapes can be or'ed together.
+    namespace PlaneSide
+    {
+        enum Type
+        {
+            On = 0,
+            Front = 1,
+            Back = 2,
+            Straddle = Front | Back,
+        };
+    }
+
+    class Plane
+    {
+    public:
+        Vector3 Normal;
+        float D;
+
+    public:
+        // Normal = Normalize(Cross(p1 - p0, p2 - p0)).
+        static inline Plane CreateFromPoints(const Vector3 & p0, const Vector3 & p1, const Vector3 & p2);
+        static inline void CreateFromPoints(const Vector3 & p0, const Vector3 & p1, const Vector3 & p2, Plane & out);
+
+        static inline Plane CreateFromPointNormal(const Vector3 & point, const Vector3 & normal);
+        static inline void CreateFromPointNormal(const Vector3 & point, const Vector3 & normal, Plane & out);
+
+    public:
+        inline Plane()
+        {
+            // Do nothing in the default ctor.
+            // So we don't have to pay for arrays or planes initialized as an out parameter.
+        }
+        inline explicit Plane(const Vector3 & normal, float d);
+        inline explicit Plane(float a, float b, float c, float d);
+        inline explicit Plane(const Vector4 & src);
+        inline Plane(const Plane & src);
+
+        inline ~Plane() { }
+
+        inline Plane & operator=(const Plane & rhs);
+
+        inline void Normalize();
+
+        inline void Set(const Vector3 & normal, float d);
+        inline void Set(const Plane & src);
+
+        inline Vector4 ToVector4() const;
+    };
+
+    inline bool operator==(const Plane & lhs, const Plane & rhs);
+    inline bool operator!=(const Plane & lhs, const Plane & rhs);
+
+    inline bool ExactlyEqual(const Plane & lhs, const Plane & rhs);
+    inline bool NearlyEqual(const Plane & lhs, const Plane & rhs);
+
+    // Scales the normal and D so the normal is unit length.
+    inline Plane Normalize(const Plane & plane);
+    inline void Normalize(const Plane & plane, Plane & out);
+
+    // Positive in front of the plane.
+    inline float SignedDistance(const Plane & plane, const Vector3 & p);
+
+    // Points within epsilon of the plane are On, spheres and boxes touching the plane Straddle.
+    inline PlaneSide::Type Classify(const Plane & plane, const Vector3 & p, float epsilon);
+    inline PlaneSide::Type Classify(const Plane & plane, const Sphere & sphere);
+    inline PlaneSide::Type Classify(const Plane & plane, const AABB & box);
+
+    // Planes transform by the inverse transpose of the matrix that transforms the points,
+    // the result is normalized. Use TransformByInverseTranspose to transform several planes
+    // by the same matrix without finding the inverse each time.
+    inline Plane Transform(const Plane & plane, const Matrix4x4 & m);
+    inline void Transform(const Plane & plane, const Matrix4x4 & m, Plane & out);
+
+    inline Plane TransformByInverseTranspose(const Plane & plane, const Matrix4x4 & inverseTranspose);
+    inline void TransformByInverseTranspose(const Plane & plane, const Matrix4x4 & inverseTranspose, Plane & out);
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_PLANE_H_
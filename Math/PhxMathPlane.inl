@@ -0,0 +1,226 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_PLANE_INL_
+#define _PHX_MATH_PLANE_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline Plane Plane::CreateFromPoints(const Vector3 & p0, const Vector3 & p1, const Vector3 & p2)
+    {
+        Plane out;
+        CreateFromPoints(p0, p1, p2, out);
+        return out;
+    }
+
+    inline void Plane::CreateFromPoints(const Vector3 & p0, const Vector3 & p1, const Vector3 & p2, Plane & out)
+    {
+        const Vector3 normal = Cross(Subtract(p1, p0), Subtract(p2, p0));
+        DebugAssert(false == ExactlyZero(normal), "Cannot create a plane from collinear points.");
+
+        CreateFromPointNormal(p0, normal, out);
+    }
+
+    inline Plane Plane::CreateFromPointNormal(const Vector3 & point, const Vector3 & normal)
+    {
+        Plane out;
+        CreateFromPointNormal(point, normal, out);
+        return out;
+    }
+
+    inline void Plane::CreateFromPointNormal(const Vector3 & point, const Vector3 & normal, Plane & out)
+    {
+        const Vector3 unitNormal = Math::Normalize(normal);
+        out.Set(unitNormal, -Dot(unitNormal, point));
+    }
+
+    inline Plane::Plane(const Vector3 & normal, float d)
+        : Normal(normal)
+        , D(d)
+    { }
+
+    inline Plane::Plane(float a, float b, float c, float d)
+        : Normal(a, b, c)
+        , D(d)
+    { }
+
+    inline Plane::Plane(const Vector4 & src)
+        : Normal(src.X, src.Y, src.Z)
+        , D(src.W)
+    { }
+
+    inline Plane::Plane(const Plane & src)
+    {
+        Set(src);
+    }
+
+    inline Plane & Plane::operator=(const Plane & rhs)
+    {
+        Set(rhs);
+        return *this;
+    }
+
+    inline void Plane::Normalize()
+    {
+        Math::Normalize(*this, *this);
+    }
+
+    inline void Plane::Set(const Vector3 & normal, float d)
+    {
+        this->Normal.Set(normal);
+        this->D = d;
+    }
+
+    inline void Plane::Set(const Plane & src)
+    {
+        this->Normal.Set(src.Normal);
+        this->D = src.D;
+    }
+
+    inline Vector4 Plane::ToVector4() const
+    {
+        return Vector4(this->Normal, this->D);
+    }
+
+    inline bool operator==(const Plane & lhs, const Plane & rhs)
+    {
+        return ExactlyEqual(lhs, rhs);
+    }
+
+    inline bool operator!=(const Plane & lhs, const Plane & rhs)
+    {
+        return (false == ExactlyEqual(lhs, rhs));
+    }
+
+    inline bool ExactlyEqual(const Plane & lhs, const Plane & rhs)
+    {
+        return ExactlyEqual(lhs.Normal, rhs.Normal) &&
+               ExactlyEqual(lhs.D, rhs.D);
+    }
+
+    inline bool NearlyEqual(const Plane & lhs, const Plane & rhs)
+    {
+        return NearlyEqual(lhs.Normal, rhs.Normal) &&
+               NearlyEqual(lhs.D, rhs.D);
+    }
+
+    inline Plane Normalize(const Plane & plane)
+    {
+        Plane out;
+        Normalize(plane, out);
+        return out;
+    }
+
+    inline void Normalize(const Plane & plane, Plane & out)
+    {
+        const float length = Length(plane.Normal);
+        DebugAssert(length > 0.0f, "Cannot normalize a plane with a zero normal.");
+
+        const float invLength = 1.0f / length;
+        out.Set(Multiply(plane.Normal, invLength), plane.D * invLength);
+    }
+
+    inline float SignedDistance(const Plane & plane, const Vector3 & p)
+    {
+        return Dot(plane.Normal, p) + plane.D;
+    }
+
+    inline PlaneSide::Type Classify(const Plane & plane, const Vector3 & p, float epsilon)
+    {
+        const float distance = SignedDistance(plane, p);
+
+        if (distance > epsilon)
+        {
+            return PlaneSide::Front;
+        }
+        if (distance < -epsilon)
+        {
+            return PlaneSide::Back;
+        }
+        return PlaneSide::On;
+    }
+
+    inline PlaneSide::Type Classify(const Plane & plane, const Sphere & sphere)
+    {
+        const float distance = SignedDistance(plane, sphere.Center);
+
+        if (distance > sphere.Radius)
+        {
+            return PlaneSide::Front;
+        }
+        if (distance < -sphere.Radius)
+        {
+            return PlaneSide::Back;
+        }
+        return PlaneSide::Straddle;
+    }
+
+    inline PlaneSide::Type Classify(const Plane & plane, const AABB & box)
+    {
+        // The center against the extent of the box along the normal.
+        const Vector3 extents = box.GetExtents();
+        const float radius = extents.X * Abs(plane.Normal.X) +
+                             extents.Y * Abs(plane.Normal.Y) +
+                             extents.Z * Abs(plane.Normal.Z);
+
+        return Classify(plane, Sphere(box.GetCenter(), radius));
+    }
+
+    inline Plane Transform(const Plane & plane, const Matrix4x4 & m)
+    {
+        Plane out;
+        Transform(plane, m, out);
+        return out;
+    }
+
+    inline void Transform(const Plane & plane, const Matrix4x4 & m, Plane & out)
+    {
+        // With row vectors a point p is on the plane when [p, 1] * P = 0 (P the plane as a column).
+        // The transformed points are [p, 1] * m, so [p, 1] * m * Inverse(m) * P = 0 and the
+        // transformed plane is Inverse(m) * P, or P as a row vector times Transpose(Inverse(m)).
+
+        TransformByInverseTranspose(plane, Transpose(Inverse(m)), out);
+    }
+
+    inline Plane TransformByInverseTranspose(const Plane & plane, const Matrix4x4 & inverseTranspose)
+    {
+        Plane out;
+        TransformByInverseTranspose(plane, inverseTranspose, out);
+        return out;
+    }
+
+    inline void TransformByInverseTranspose(const Plane & plane, const Matrix4x4 & inverseTranspose, Plane & out)
+    {
+        // Non-uniform scale changes the length of the normal, so the result is normalized.
+        const Vector4 transformed = Transform(plane.ToVector4(), inverseTranspose);
+        Normalize(Plane(transformed), out);
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_PLANE_INL_
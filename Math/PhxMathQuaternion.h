@@ -30,7 +30,7 @@ THE SOFTWARE
 namespace Phx {
 namespace Math {
 
-    class Quaternion
+    class PHX_ALIGN(16) Quaternion
     {
     public:
         float X;
@@ -619,8 +619,12 @@ namespace Math {
 
     inline void Normalize(const Quaternion & q, Quaternion & out)
     {
+        PHX_MATH_SHADOW_CALL(QuaternionNormalize, ShadowNormalize(q, out));
+
         float lengthSquared = LengthSquared(q);
         DebugAssert(false == NearlyZero(lengthSquared), "Trying to normalize a zero quaternion!");
+        PHX_MATH_STAT_COUNT(QuaternionNormalize);
+        PHX_MATH_STAT_COUNT_IF(NearlyZero(lengthSquared), QuaternionNormalizeZero);
         Multiply(q, InvSqrt(lengthSquared), out);
     }
 
@@ -744,6 +748,9 @@ namespace Math {
         //
         // Ref: http://www.geometrictools.com/Documentation/Quaternions.pdf
 
+        PHX_MATH_SHADOW_CALL(QuaternionSlerp, ShadowSlerp(q1, q2, weight, out));
+        PHX_MATH_STAT_TIMED(QuaternionSlerp);
+
         DebugAssert(IsNormalized(q1), "Quaternaion must be normalized to slerp.");
         DebugAssert(IsNormalized(q2), "Quaternaion must be normalized to slerp.");
 
@@ -751,6 +758,8 @@ namespace Math {
 
         DebugAssert(false == NearlyEqual(Abs(cosTheta), 1.0f), 
             "Using slerp on quaternions that are 180 degrees apart, aligned, or negations of eachother.");
+        PHX_MATH_STAT_COUNT_IF(NearlyEqual(cosTheta, 1.0f), QuaternionSlerpAligned);
+        PHX_MATH_STAT_COUNT_IF(NearlyEqual(cosTheta, -1.0f), QuaternionSlerpOpposite);
 
         const float theta = ACos(cosTheta);
         if (NearlyZero(theta))
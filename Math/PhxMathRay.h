@@ -0,0 +1,84 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_RAY_H_
+#define _PHX_MATH_RAY_H_
+
+namespace Phx {
+namespace Math {
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Ray
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Keeps 1 / Direction around for the box (slab) tests, so the direction
+    // must be changed through Set. The direction doesn't need to be
+    // normalized, hit distances are in multiples of the direction length.
+    //
+    // Packets of rays are stored as a RaySoA (PhxMathSoA.h) and tested
+    // with the batch Intersect operations (PhxMathBatch.h).
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    class Ray
+    {
+    public:
+        Vector3 Origin;
+        Vector3 Direction;
+        Vector3 InvDirection;
+
+    public:
+        inline Ray()
+        {
+            // Do nothing in the default ctor.
+            // So we don't have to pay for arrays or rays initialized as an out parameter.
+        }
+        inline explicit Ray(const Vector3 & origin, const Vector3 & direction);
+        inline Ray(const Ray & src);
+
+        inline ~Ray() { }
+
+        inline Ray & operator=(const Ray & rhs);
+
+        // Origin + Direction * t
+        inline Vector3 GetPoint(float t) const;
+
+        inline void Set(const Vector3 & origin, const Vector3 & direction);
+        inline void Set(const Ray & src);
+    };
+
+    // Hit tests return the distance to the first hit in front of the origin, a ray
+    // starting inside a box hits it at 0. Rays parallel to a triangle never hit it.
+    inline bool Intersects(const Ray & ray, const AABB & box);
+    inline bool Intersects(const Ray & ray, const AABB & box, float & outT);
+
+    // Moller-Trumbore, both sides of the triangle are hit.
+    // outU and outV are the barycentric weights of v1 and v2.
+    inline bool Intersects(const Ray & ray, const Vector3 & v0, const Vector3 & v1, const Vector3 & v2, float & outT);
+    inline bool Intersects(const Ray & ray, const Vector3 & v0, const Vector3 & v1, const Vector3 & v2, float & outT, float & outU, float & outV);
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_RAY_H_
@@ -0,0 +1,151 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_RAY_INL_
+#define _PHX_MATH_RAY_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline Ray::Ray(const Vector3 & origin, const Vector3 & direction)
+    {
+        Set(origin, direction);
+    }
+
+    inline Ray::Ray(const Ray & src)
+    {
+        Set(src);
+    }
+
+    inline Ray & Ray::operator=(const Ray & rhs)
+    {
+        Set(rhs);
+        return *this;
+    }
+
+    inline Vector3 Ray::GetPoint(float t) const
+    {
+        return Vector3(this->Origin.X + this->Direction.X * t,
+                       this->Origin.Y + this->Direction.Y * t,
+                       this->Origin.Z + this->Direction.Z * t);
+    }
+
+    inline void Ray::Set(const Vector3 & origin, const Vector3 & direction)
+    {
+        DebugAssert(false == ExactlyZero(direction), "Trying to create a ray with a zero direction.");
+
+        this->Origin.Set(origin);
+        this->Direction.Set(direction);
+
+        // Zero components become infinity, which the slab test handles.
+        this->InvDirection.Set(1.0f / direction.X, 1.0f / direction.Y, 1.0f / direction.Z);
+    }
+
+    inline void Ray::Set(const Ray & src)
+    {
+        this->Origin.Set(src.Origin);
+        this->Direction.Set(src.Direction);
+        this->InvDirection.Set(src.InvDirection);
+    }
+
+    inline bool Intersects(const Ray & ray, const AABB & box)
+    {
+        float t;
+        return Intersects(ray, box, t);
+    }
+
+    inline bool Intersects(const Ray & ray, const AABB & box, float & outT)
+    {
+        // Slab test: the ray is inside the box between the largest entry distance and the
+        // smallest exit distance of the three pairs of planes. The batch kernels use the
+        // same operations in the same order.
+
+        const float x1 = (box.Min.X - ray.Origin.X) * ray.InvDirection.X;
+        const float x2 = (box.Max.X - ray.Origin.X) * ray.InvDirection.X;
+        const float y1 = (box.Min.Y - ray.Origin.Y) * ray.InvDirection.Y;
+        const float y2 = (box.Max.Y - ray.Origin.Y) * ray.InvDirection.Y;
+        const float z1 = (box.Min.Z - ray.Origin.Z) * ray.InvDirection.Z;
+        const float z2 = (box.Max.Z - ray.Origin.Z) * ray.InvDirection.Z;
+
+        const float tNear = Max(Max(Min(x1, x2), Min(y1, y2)), Max(Min(z1, z2), 0.0f));
+        const float tFar = Min(Min(Max(x1, x2), Max(y1, y2)), Max(z1, z2));
+
+        outT = tNear;
+        return (tNear <= tFar);
+    }
+
+    inline bool Intersects(const Ray & ray, const Vector3 & v0, const Vector3 & v1, const Vector3 & v2, float & outT)
+    {
+        float u, v;
+        return Intersects(ray, v0, v1, v2, outT, u, v);
+    }
+
+    inline bool Intersects(const Ray & ray, const Vector3 & v0, const Vector3 & v1, const Vector3 & v2, float & outT, float & outU, float & outV)
+    {
+        const Vector3 edge1 = Subtract(v1, v0);
+        const Vector3 edge2 = Subtract(v2, v0);
+
+        const Vector3 p = Cross(ray.Direction, edge2);
+        const float det = Dot(edge1, p);
+
+        // Parallel to the plane of the triangle.
+        if (det == 0.0f)
+        {
+            return false;
+        }
+
+        const float invDet = 1.0f / det;
+
+        const Vector3 s = Subtract(ray.Origin, v0);
+        const float u = Dot(s, p) * invDet;
+        if ((u < 0.0f) || (u > 1.0f))
+        {
+            return false;
+        }
+
+        const Vector3 q = Cross(s, edge1);
+        const float v = Dot(ray.Direction, q) * invDet;
+        if ((v < 0.0f) || ((u + v) > 1.0f))
+        {
+            return false;
+        }
+
+        const float t = Dot(edge2, q) * invDet;
+        if (t < 0.0f)
+        {
+            return false;
+        }
+
+        outT = t;
+        outU = u;
+        outV = v;
+        return true;
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_RAY_INL_
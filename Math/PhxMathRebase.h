@@ -0,0 +1,63 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_REBASE_H_
+#define _PHX_MATH_REBASE_H_
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Camera Relative (Origin Rebasing) Transforms
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Object positions are stored in double precision (Vector3d), orientation
+// and scale stay in the float Matrix4x4. The difference between an object
+// position and the origin is taken in double precision, and only the small
+// relative offset is rounded to float, so the float matrices never see
+// large coordinates.
+//
+// The usual setup is to use the camera position as the origin and build
+// the view matrix with CreateRebasedView (a view matrix with no
+// translation), then concatenate it with the rebased world matrices.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    inline Vector3 Rebase(const Vector3d & position, const Vector3d & origin);
+    inline void Rebase(const Vector3d & position, const Vector3d & origin, Vector3 & out);
+
+    inline Matrix4x4 Rebase(const Matrix4x4 & m, const Vector3d & position, const Vector3d & origin);
+    inline void Rebase(const Matrix4x4 & m, const Vector3d & position, const Vector3d & origin, Matrix4x4 & out);
+
+    inline void Rebase(const Vector3d * pPositions, const Vector3d & origin, Vector3 * pOut, unsigned int count);
+    inline void Rebase(const Matrix4x4 * pTransforms, const Vector3d * pPositions, const Vector3d & origin, Matrix4x4 * pOut, unsigned int count);
+    inline void Rebase(const Matrix4x4 * pTransforms, const Vector3d * pPositions, const Vector3d & origin, const Matrix4x4 & view, Matrix4x4 * pOut, unsigned int count);
+
+    inline Matrix4x4 CreateRebasedView(const Vector3d & position, const Vector3d & target, const Vector3 & up);
+    inline void CreateRebasedView(const Vector3d & position, const Vector3d & target, const Vector3 & up, Matrix4x4 & out);
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_REBASE_H_
@@ -0,0 +1,124 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_REBASE_INL_
+#define _PHX_MATH_REBASE_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline Vector3 Rebase(const Vector3d & position, const Vector3d & origin)
+    {
+        Vector3 out;
+        Rebase(position, origin, out);
+        return out;
+    }
+
+    inline void Rebase(const Vector3d & position, const Vector3d & origin, Vector3 & out)
+    {
+        // Subtract in double precision first, then round the (small) result to float.
+        out.X = static_cast<float>(position.X - origin.X);
+        out.Y = static_cast<float>(position.Y - origin.Y);
+        out.Z = static_cast<float>(position.Z - origin.Z);
+    }
+
+    inline Matrix4x4 Rebase(const Matrix4x4 & m, const Vector3d & position, const Vector3d & origin)
+    {
+        Matrix4x4 out;
+        Rebase(m, position, origin, out);
+        return out;
+    }
+
+    inline void Rebase(const Matrix4x4 & m, const Vector3d & position, const Vector3d & origin, Matrix4x4 & out)
+    {
+        // m holds the scale and rotation of the object, its translation row is replaced
+        // with the position of the object relative to the origin.
+
+        out.Set(m);
+
+        out.M41 = static_cast<float>(position.X - origin.X);
+        out.M42 = static_cast<float>(position.Y - origin.Y);
+        out.M43 = static_cast<float>(position.Z - origin.Z);
+    }
+
+    inline void Rebase(const Vector3d * pPositions, const Vector3d & origin, Vector3 * pOut, unsigned int count)
+    {
+        const double originX = origin.X;
+        const double originY = origin.Y;
+        const double originZ = origin.Z;
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            pOut[i].X = static_cast<float>(pPositions[i].X - originX);
+            pOut[i].Y = static_cast<float>(pPositions[i].Y - originY);
+            pOut[i].Z = static_cast<float>(pPositions[i].Z - originZ);
+        }
+    }
+
+    inline void Rebase(const Matrix4x4 * pTransforms, const Vector3d * pPositions, const Vector3d & origin, Matrix4x4 * pOut, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Rebase(pTransforms[i], pPositions[i], origin, pOut[i]);
+        }
+    }
+
+    inline void Rebase(const Matrix4x4 * pTransforms, const Vector3d * pPositions, const Vector3d & origin, const Matrix4x4 & view, Matrix4x4 * pOut, unsigned int count)
+    {
+        // Builds camera relative world-view matrices: Rebase(transform, position, origin) * view.
+        // view is expected to be created with CreateRebasedView using origin as the camera position,
+        // any translation in view is applied in float precision after the rebase.
+
+        Matrix4x4 world;
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Rebase(pTransforms[i], pPositions[i], origin, world);
+            Multiply(world, view, pOut[i]);
+        }
+    }
+
+    inline Matrix4x4 CreateRebasedView(const Vector3d & position, const Vector3d & target, const Vector3 & up)
+    {
+        Matrix4x4 out;
+        CreateRebasedView(position, target, up, out);
+        return out;
+    }
+
+    inline void CreateRebasedView(const Vector3d & position, const Vector3d & target, const Vector3 & up, Matrix4x4 & out)
+    {
+        // A view matrix for a camera sitting at the origin of the rebased space.
+        // The look direction is found in double precision so distant targets don't lose precision.
+
+        DebugAssert(false == ExactlyEqual(position, target), "Cannot create a look at matrix with position == target");
+
+        Matrix4x4::CreateView(Vector3::Zero, Rebase(target, position), up, out);
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_REBASE_INL_
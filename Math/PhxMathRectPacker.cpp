@@ -0,0 +1,780 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathRectPacker.h"
+
+// C++ Standard Library Includes
+#include <algorithm>
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // Entry::Next of the entries that hold a rectangle.
+        const unsigned int InUse = 0xFFFFFFFE;
+
+        // Rect::Intersects counts touching rectangles, packed rectangles touch all the time.
+        inline bool Overlaps(const Rect & a, const Rect & b)
+        {
+            return (a.X < b.X + b.Width) && (b.X < a.X + a.Width) &&
+                   (a.Y < b.Y + b.Height) && (b.Y < a.Y + a.Height);
+        }
+
+        // Closed boxes, true for rectangles that share an edge (or a corner).
+        inline bool Touches(const Rect & a, const Rect & b)
+        {
+            return (a.X <= b.X + b.Width) && (b.X <= a.X + a.Width) &&
+                   (a.Y <= b.Y + b.Height) && (b.Y <= a.Y + a.Height);
+        }
+
+        // Length of the part of [min1, max1] and [min2, max2] in common, 0 when they don't overlap.
+        inline float GetOverlapLength(float min1, float max1, float min2, float max2)
+        {
+            const float length = Min(max1, max2) - Max(min1, min2);
+            return (length > 0.0f) ? length : 0.0f;
+        }
+
+        inline float GetSortKey(const Vector2 & size, RectSortOrder::Type order)
+        {
+            switch (order)
+            {
+            case RectSortOrder::Area:       return size.X * size.Y;
+            case RectSortOrder::Perimeter:  return size.X + size.Y;
+            case RectSortOrder::MaxSide:    return Max(size.X, size.Y);
+            case RectSortOrder::Width:      return size.X;
+            case RectSortOrder::Height:     return size.Y;
+            default:                        return 0.0f;
+            }
+        }
+
+        // Largest first, equal keys keep the input order so the packing does not depend on the sort.
+        struct SortKeyGreater
+        {
+            const Vector2 * pSizes;
+            RectSortOrder::Type Order;
+
+            bool operator()(unsigned int lhs, unsigned int rhs) const
+            {
+                const float lhsKey = GetSortKey(pSizes[lhs], Order);
+                const float rhsKey = GetSortKey(pSizes[rhs], Order);
+                return (lhsKey > rhsKey) || (lhsKey == rhsKey && lhs < rhs);
+            }
+        };
+
+        void SortSizes(const Vector2 * pSizes, unsigned int count, RectSortOrder::Type order, AlignedArray<unsigned int> & outOrder)
+        {
+            outOrder.Resize(count);
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                outOrder[i] = i;
+            }
+
+            if (order != RectSortOrder::None)
+            {
+                SortKeyGreater greater = { pSizes, order };
+                std::sort(outOrder.begin(), outOrder.end(), greater);
+            }
+        }
+
+        template <class Packer>
+        unsigned int InsertSorted(Packer & packer, const Vector2 * pSizes, const AlignedArray<unsigned int> & order, unsigned int * pOutIds)
+        {
+            unsigned int placed = 0;
+            for (unsigned int i = 0; i < order.GetCount(); ++i)
+            {
+                const unsigned int idx = order[i];
+                pOutIds[idx] = packer.Insert(pSizes[idx]);
+                placed += (pOutIds[idx] != Packer::InvalidId) ? 1 : 0;
+            }
+            return placed;
+        }
+    }
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // MaxRectsPacker
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    MaxRectsPacker::MaxRectsPacker(float width, float height, float padding, MaxRectsHeuristic::Type heuristic)
+        : m_width(width)
+        , m_height(height)
+        , m_padding(padding)
+        , m_heuristic(heuristic)
+        , m_freeEntry(InvalidId)
+        , m_count(0)
+        , m_usedArea(0.0f)
+    {
+        DebugAssert(width > 0.0f && height > 0.0f, "Invalid atlas size (%f, %f)!", width, height);
+        DebugAssert(padding >= 0.0f, "Invalid atlas padding (%f)!", padding);
+
+        Clear();
+    }
+
+    MaxRectsPacker::~MaxRectsPacker()
+    {
+    }
+
+    unsigned int MaxRectsPacker::Insert(float width, float height)
+    {
+        DebugAssert(width >= 0.0f && height >= 0.0f, "Invalid rectangle size (%f, %f)!", width, height);
+
+        Rect used;
+        if (false == FindPosition(width + m_padding, height + m_padding, used))
+        {
+            return InvalidId;
+        }
+
+        SplitFreeRects(used);
+
+        unsigned int id = m_freeEntry;
+        if (id != InvalidId)
+        {
+            m_freeEntry = m_entries[id].Next;
+        }
+        else
+        {
+            id = m_entries.GetCount();
+            m_entries.Resize(id + 1);
+        }
+
+        Entry & entry = m_entries[id];
+        entry.Bounds.Set(used.X, used.Y, width, height);
+        entry.Next = InUse;
+
+        ++m_count;
+        m_usedArea += width * height;
+
+        return id;
+    }
+
+    unsigned int MaxRectsPacker::Insert(const Vector2 & size)
+    {
+        return Insert(size.X, size.Y);
+    }
+
+    unsigned int MaxRectsPacker::Insert(const Vector2 * pSizes, unsigned int count, RectSortOrder::Type order, unsigned int * pOutIds)
+    {
+        SortSizes(pSizes, count, order, m_order);
+        return InsertSorted(*this, pSizes, m_order, pOutIds);
+    }
+
+    void MaxRectsPacker::Remove(unsigned int id)
+    {
+        DebugAssert(id < m_entries.GetCount() && m_entries[id].Next == InUse, "Invalid packer rectangle id (%u).", id);
+
+        Entry & entry = m_entries[id];
+        const Rect freed(entry.Bounds.X, entry.Bounds.Y, entry.Bounds.Width + m_padding, entry.Bounds.Height + m_padding);
+
+        m_usedArea -= entry.Bounds.Width * entry.Bounds.Height;
+        --m_count;
+
+        entry.Next = m_freeEntry;
+        m_freeEntry = id;
+
+        if (m_count == 0)
+        {
+            // Back to one free rectangle, whatever the fragmentation was.
+            m_usedArea = 0.0f;
+            m_freeRects.Clear();
+            m_freeRects.PushBack(Rect(0.0f, 0.0f, m_width + m_padding, m_height + m_padding));
+        }
+        else if (freed.Width > 0.0f && freed.Height > 0.0f)
+        {
+            MergeFreeRects(freed);
+        }
+    }
+
+    void MaxRectsPacker::Clear()
+    {
+        m_entries.Clear();
+        m_freeEntry = InvalidId;
+        m_count = 0;
+        m_usedArea = 0.0f;
+
+        m_freeRects.Clear();
+        m_freeRects.PushBack(Rect(0.0f, 0.0f, m_width + m_padding, m_height + m_padding));
+    }
+
+    const Rect & MaxRectsPacker::GetRect(unsigned int id) const
+    {
+        DebugAssert(id < m_entries.GetCount() && m_entries[id].Next == InUse, "Invalid packer rectangle id (%u).", id);
+        return m_entries[id].Bounds;
+    }
+
+    unsigned int MaxRectsPacker::GetCount() const
+    {
+        return m_count;
+    }
+
+    float MaxRectsPacker::GetWidth() const
+    {
+        return m_width;
+    }
+
+    float MaxRectsPacker::GetHeight() const
+    {
+        return m_height;
+    }
+
+    MaxRectsHeuristic::Type MaxRectsPacker::GetHeuristic() const
+    {
+        return m_heuristic;
+    }
+
+    void MaxRectsPacker::SetHeuristic(MaxRectsHeuristic::Type heuristic)
+    {
+        m_heuristic = heuristic;
+    }
+
+    float MaxRectsPacker::GetUsedArea() const
+    {
+        return m_usedArea;
+    }
+
+    float MaxRectsPacker::GetOccupancy() const
+    {
+        return m_usedArea / (m_width * m_height);
+    }
+
+    unsigned int MaxRectsPacker::GetFreeRectCount() const
+    {
+        return m_freeRects.GetCount();
+    }
+
+    bool MaxRectsPacker::FindPosition(float width, float height, Rect & out) const
+    {
+        // Lower is better, the second score breaks ties.
+        float bestScore = FLT_MAX;
+        float bestScore2 = FLT_MAX;
+        bool found = false;
+
+        for (unsigned int i = 0; i < m_freeRects.GetCount(); ++i)
+        {
+            const Rect & freeRect = m_freeRects[i];
+            if (freeRect.Width < width || freeRect.Height < height)
+            {
+                continue;
+            }
+
+            const float leftoverX = freeRect.Width - width;
+            const float leftoverY = freeRect.Height - height;
+
+            float score;
+            float score2;
+            switch (m_heuristic)
+            {
+            case MaxRectsHeuristic::BestLongSideFit:
+                score = Max(leftoverX, leftoverY);
+                score2 = Min(leftoverX, leftoverY);
+                break;
+            case MaxRectsHeuristic::BestAreaFit:
+                score = (freeRect.Width * freeRect.Height) - (width * height);
+                score2 = Min(leftoverX, leftoverY);
+                break;
+            case MaxRectsHeuristic::BottomLeft:
+                score = freeRect.Y + height;
+                score2 = freeRect.X;
+                break;
+            case MaxRectsHeuristic::ContactPoint:
+                score = -GetContactLength(Rect(freeRect.X, freeRect.Y, width, height));
+                score2 = freeRect.Y + height;
+                break;
+            default:
+                score = Min(leftoverX, leftoverY);
+                score2 = Max(leftoverX, leftoverY);
+                break;
+            }
+
+            if (score < bestScore || (score == bestScore && score2 < bestScore2))
+            {
+                bestScore = score;
+                bestScore2 = score2;
+                out.Set(freeRect.X, freeRect.Y, width, height);
+                found = true;
+            }
+        }
+
+        return found;
+    }
+
+    float MaxRectsPacker::GetContactLength(const Rect & r) const
+    {
+        const float right = r.X + r.Width;
+        const float top = r.Y + r.Height;
+
+        float length = 0.0f;
+        if (r.X == 0.0f || right == m_width + m_padding)
+        {
+            length += r.Height;
+        }
+        if (r.Y == 0.0f || top == m_height + m_padding)
+        {
+            length += r.Width;
+        }
+
+        for (unsigned int i = 0; i < m_entries.GetCount(); ++i)
+        {
+            const Entry & entry = m_entries[i];
+            if (entry.Next != InUse)
+            {
+                continue;
+            }
+
+            const float usedRight = entry.Bounds.X + entry.Bounds.Width + m_padding;
+            const float usedTop = entry.Bounds.Y + entry.Bounds.Height + m_padding;
+
+            if (usedRight == r.X || entry.Bounds.X == right)
+            {
+                length += GetOverlapLength(r.Y, top, entry.Bounds.Y, usedTop);
+            }
+            if (usedTop == r.Y || entry.Bounds.Y == top)
+            {
+                length += GetOverlapLength(r.X, right, entry.Bounds.X, usedRight);
+            }
+        }
+
+        return length;
+    }
+
+    void MaxRectsPacker::SplitFreeRects(const Rect & used)
+    {
+        const float usedRight = used.X + used.Width;
+        const float usedTop = used.Y + used.Height;
+
+        // Every free rectangle the new one overlaps is replaced by the (up to) four largest rectangles
+        // left around it, each one the whole free rectangle on one side of the used one.
+        m_newRects.Clear();
+        m_nearRects.Clear();
+
+        unsigned int i = 0;
+        while (i < m_freeRects.GetCount())
+        {
+            const Rect freeRect = m_freeRects[i];
+            if (false == Overlaps(freeRect, used))
+            {
+                if (Touches(freeRect, used))
+                {
+                    m_nearRects.PushBack(freeRect);
+                }
+                ++i;
+                continue;
+            }
+
+            const float freeRight = freeRect.X + freeRect.Width;
+            const float freeTop = freeRect.Y + freeRect.Height;
+
+            if (used.X > freeRect.X)
+            {
+                m_newRects.PushBack(Rect(freeRect.X, freeRect.Y, used.X - freeRect.X, freeRect.Height));
+            }
+            if (usedRight < freeRight)
+            {
+                m_newRects.PushBack(Rect(usedRight, freeRect.Y, freeRight - usedRight, freeRect.Height));
+            }
+            if (used.Y > freeRect.Y)
+            {
+                m_newRects.PushBack(Rect(freeRect.X, freeRect.Y, freeRect.Width, used.Y - freeRect.Y));
+            }
+            if (usedTop < freeTop)
+            {
+                m_newRects.PushBack(Rect(freeRect.X, usedTop, freeRect.Width, freeTop - usedTop));
+            }
+
+            m_freeRects[i] = m_freeRects[m_freeRects.GetCount() - 1];
+            m_freeRects.PopBack();
+        }
+
+        AddFreeRects();
+    }
+
+    void MaxRectsPacker::MergeFreeRects(const Rect & freed)
+    {
+        // One merge only joins the freed space with each free rectangle next to it, so a span across more
+        // than one of them (the freed space between two free rectangles) takes merging the new rectangles
+        // again. Every rectangle a merge adds is taken back out of the free list and merged like freed space,
+        // until a merge adds nothing new.
+        m_mergeRects.Clear();
+        MergeFreeRect(freed);
+
+        while (false == m_mergeRects.IsEmpty())
+        {
+            const Rect r = m_mergeRects[m_mergeRects.GetCount() - 1];
+            m_mergeRects.PopBack();
+
+            // Gone already if a later merge made a rectangle containing it.
+            unsigned int i = 0;
+            while (i < m_freeRects.GetCount() && false == ExactlyEqual(m_freeRects[i], r))
+            {
+                ++i;
+            }
+
+            if (i < m_freeRects.GetCount())
+            {
+                m_freeRects[i] = m_freeRects[m_freeRects.GetCount() - 1];
+                m_freeRects.PopBack();
+                MergeFreeRect(r);
+            }
+        }
+    }
+
+    void MaxRectsPacker::MergeFreeRect(const Rect & freed)
+    {
+        const float freedRight = freed.X + freed.Width;
+        const float freedTop = freed.Y + freed.Height;
+
+        // The freed space, and the largest rectangles made of it and a free rectangle that touches it:
+        // as wide as both of them over the rows they share, and as tall as both over the columns they share.
+        m_newRects.Clear();
+        m_newRects.PushBack(freed);
+        m_nearIndices.Clear();
+
+        for (unsigned int i = 0; i < m_freeRects.GetCount(); ++i)
+        {
+            const Rect & freeRect = m_freeRects[i];
+            if (false == Touches(freeRect, freed))
+            {
+                continue;
+            }
+
+            m_nearIndices.PushBack(i);
+
+            const float freeRight = freeRect.X + freeRect.Width;
+            const float freeTop = freeRect.Y + freeRect.Height;
+
+            const float bottom = Max(freeRect.Y, freed.Y);
+            const float top = Min(freeTop, freedTop);
+            if (top > bottom)
+            {
+                const float left = Min(freeRect.X, freed.X);
+                m_newRects.PushBack(Rect(left, bottom, Max(freeRight, freedRight) - left, top - bottom));
+            }
+
+            const float left = Max(freeRect.X, freed.X);
+            const float right = Min(freeRight, freedRight);
+            if (right > left)
+            {
+                const float newBottom = Min(freeRect.Y, freed.Y);
+                m_newRects.PushBack(Rect(left, newBottom, right - left, Max(freeTop, freedTop) - newBottom));
+            }
+        }
+
+        // The free rectangles inside the new ones are not the largest anymore. A free rectangle inside a new
+        // one touches the freed space (otherwise it would be inside the free rectangle the new one came from),
+        // so only those are tested. Last first, so that removing one does not move the ones left to test.
+        // One equal to a new rectangle stays, AddFreeRects then drops the new one, otherwise the merges of
+        // Remove would keep taking out and adding back the same rectangle.
+        m_nearRects.Clear();
+
+        for (unsigned int n = m_nearIndices.GetCount(); n > 0; --n)
+        {
+            const unsigned int i = m_nearIndices[n - 1];
+
+            bool contained = false;
+            for (unsigned int j = 0; j < m_newRects.GetCount() && false == contained; ++j)
+            {
+                contained = Contains(m_newRects[j], m_freeRects[i]) && false == ExactlyEqual(m_newRects[j], m_freeRects[i]);
+            }
+
+            if (contained)
+            {
+                m_freeRects[i] = m_freeRects[m_freeRects.GetCount() - 1];
+                m_freeRects.PopBack();
+            }
+            else
+            {
+                m_nearRects.PushBack(m_freeRects[i]);
+            }
+        }
+
+        // Rectangles other than the freed one itself are new spans, which can reach further free rectangles.
+        const unsigned int firstAdded = m_freeRects.GetCount();
+        AddFreeRects();
+
+        for (unsigned int i = firstAdded; i < m_freeRects.GetCount(); ++i)
+        {
+            if (false == ExactlyEqual(m_freeRects[i], freed))
+            {
+                m_mergeRects.PushBack(m_freeRects[i]);
+            }
+        }
+    }
+
+    void MaxRectsPacker::AddFreeRects()
+    {
+        // Adds the new rectangles that are not inside another free rectangle. Every new rectangle touches the
+        // used (or freed) rectangle, so a free rectangle that contains one touches it too, and the caller
+        // collected those in m_nearRects. The other way around can't happen: the new rectangles come from
+        // splitting (so they are inside a free rectangle that was there before) or MergeFreeRects already
+        // removed the free rectangles inside them.
+        for (unsigned int i = 0; i < m_newRects.GetCount(); ++i)
+        {
+            const Rect & r = m_newRects[i];
+
+            bool contained = false;
+            for (unsigned int j = 0; j < m_nearRects.GetCount() && false == contained; ++j)
+            {
+                contained = Contains(m_nearRects[j], r);
+            }
+
+            // Of two equal new rectangles only the first one is kept.
+            for (unsigned int j = 0; j < m_newRects.GetCount() && false == contained; ++j)
+            {
+                contained = (j != i) && Contains(m_newRects[j], r) && (j < i || false == Contains(r, m_newRects[j]));
+            }
+
+            if (false == contained)
+            {
+                m_freeRects.PushBack(r);
+            }
+        }
+    }
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // SkylinePacker
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    SkylinePacker::SkylinePacker(float width, float height, float padding, SkylineHeuristic::Type heuristic)
+        : m_width(width)
+        , m_height(height)
+        , m_padding(padding)
+        , m_heuristic(heuristic)
+        , m_usedArea(0.0f)
+    {
+        DebugAssert(width > 0.0f && height > 0.0f, "Invalid atlas size (%f, %f)!", width, height);
+        DebugAssert(padding >= 0.0f, "Invalid atlas padding (%f)!", padding);
+
+        Clear();
+    }
+
+    SkylinePacker::~SkylinePacker()
+    {
+    }
+
+    unsigned int SkylinePacker::Insert(float width, float height)
+    {
+        DebugAssert(width >= 0.0f && height >= 0.0f, "Invalid rectangle size (%f, %f)!", width, height);
+
+        const float paddedWidth = width + m_padding;
+        const float paddedHeight = height + m_padding;
+
+        // Lower is better, the second score breaks ties.
+        float bestScore = FLT_MAX;
+        float bestScore2 = FLT_MAX;
+        unsigned int bestSegment = InvalidId;
+        float bestY = 0.0f;
+
+        for (unsigned int i = 0; i < m_skyline.GetCount(); ++i)
+        {
+            float y;
+            float waste;
+            if (false == Fit(i, paddedWidth, paddedHeight, y, waste))
+            {
+                continue;
+            }
+
+            const float score = (m_heuristic == SkylineHeuristic::MinWaste) ? waste : (y + paddedHeight);
+            const float score2 = (m_heuristic == SkylineHeuristic::MinWaste) ? (y + paddedHeight) : m_skyline[i].Width;
+
+            if (score < bestScore || (score == bestScore && score2 < bestScore2))
+            {
+                bestScore = score;
+                bestScore2 = score2;
+                bestSegment = i;
+                bestY = y;
+            }
+        }
+
+        if (bestSegment == InvalidId)
+        {
+            return InvalidId;
+        }
+
+        const float x = m_skyline[bestSegment].X;
+        if (paddedWidth > 0.0f)
+        {
+            AddSegment(bestSegment, x, bestY + paddedHeight, paddedWidth);
+        }
+
+        m_rects.PushBack(Rect(x, bestY, width, height));
+        m_usedArea += width * height;
+
+        return m_rects.GetCount() - 1;
+    }
+
+    unsigned int SkylinePacker::Insert(const Vector2 & size)
+    {
+        return Insert(size.X, size.Y);
+    }
+
+    unsigned int SkylinePacker::Insert(const Vector2 * pSizes, unsigned int count, RectSortOrder::Type order, unsigned int * pOutIds)
+    {
+        SortSizes(pSizes, count, order, m_order);
+        return InsertSorted(*this, pSizes, m_order, pOutIds);
+    }
+
+    void SkylinePacker::Clear()
+    {
+        m_rects.Clear();
+        m_usedArea = 0.0f;
+
+        const Segment ground = { 0.0f, 0.0f, m_width + m_padding };
+        m_skyline.Clear();
+        m_skyline.PushBack(ground);
+    }
+
+    const Rect & SkylinePacker::GetRect(unsigned int id) const
+    {
+        DebugAssert(id < m_rects.GetCount(), "Invalid packer rectangle id (%u).", id);
+        return m_rects[id];
+    }
+
+    unsigned int SkylinePacker::GetCount() const
+    {
+        return m_rects.GetCount();
+    }
+
+    float SkylinePacker::GetWidth() const
+    {
+        return m_width;
+    }
+
+    float SkylinePacker::GetHeight() const
+    {
+        return m_height;
+    }
+
+    SkylineHeuristic::Type SkylinePacker::GetHeuristic() const
+    {
+        return m_heuristic;
+    }
+
+    void SkylinePacker::SetHeuristic(SkylineHeuristic::Type heuristic)
+    {
+        m_heuristic = heuristic;
+    }
+
+    float SkylinePacker::GetUsedArea() const
+    {
+        return m_usedArea;
+    }
+
+    float SkylinePacker::GetOccupancy() const
+    {
+        return m_usedArea / (m_width * m_height);
+    }
+
+    bool SkylinePacker::Fit(unsigned int segment, float width, float height, float & outY, float & outWaste) const
+    {
+        // The rectangle starts at the left of the segment and rests on the highest segment under it.
+        const float x = m_skyline[segment].X;
+        const float right = x + width;
+        if (right > m_width + m_padding)
+        {
+            return false;
+        }
+
+        float y = m_skyline[segment].Y;
+        unsigned int end = segment + 1;
+        while (end < m_skyline.GetCount() && m_skyline[end].X < right)
+        {
+            y = Max(y, m_skyline[end].Y);
+            ++end;
+        }
+
+        if (y + height > m_height + m_padding)
+        {
+            return false;
+        }
+
+        float waste = 0.0f;
+        for (unsigned int i = segment; i < end; ++i)
+        {
+            const Segment & s = m_skyline[i];
+            waste += (y - s.Y) * (Min(s.X + s.Width, right) - s.X);
+        }
+
+        outY = y;
+        outWaste = waste;
+        return true;
+    }
+
+    void SkylinePacker::AddSegment(unsigned int segment, float x, float y, float width)
+    {
+        const float right = x + width;
+
+        // Segments covered by the new one go away, the last one is cut at its right edge.
+        unsigned int end = segment;
+        while (end < m_skyline.GetCount() && m_skyline[end].X + m_skyline[end].Width <= right)
+        {
+            ++end;
+        }
+        if (end < m_skyline.GetCount() && m_skyline[end].X < right)
+        {
+            Segment & cut = m_skyline[end];
+            cut.Width = (cut.X + cut.Width) - right;
+            cut.X = right;
+        }
+
+        // [segment, end) becomes the new segment, merged with its neighbors at the same height.
+        unsigned int first = segment;
+        Segment added = { x, y, width };
+        if (first > 0 && m_skyline[first - 1].Y == y)
+        {
+            --first;
+            added.X = m_skyline[first].X;
+            added.Width += m_skyline[first].Width;
+        }
+        if (end < m_skyline.GetCount() && m_skyline[end].Y == y)
+        {
+            added.Width += m_skyline[end].Width;
+            ++end;
+        }
+
+        const unsigned int count = m_skyline.GetCount();
+        if (end == first)
+        {
+            // Nothing replaced, make room for the new segment.
+            m_skyline.Resize(count + 1);
+            for (unsigned int i = count; i > first; --i)
+            {
+                m_skyline[i] = m_skyline[i - 1];
+            }
+        }
+        else if (end > first + 1)
+        {
+            const unsigned int removed = end - first - 1;
+            for (unsigned int i = end; i < count; ++i)
+            {
+                m_skyline[i - removed] = m_skyline[i];
+            }
+            m_skyline.Resize(count - removed);
+        }
+
+        m_skyline[first] = added;
+    }
+
+} //namespace Math
+} //namespace Phx
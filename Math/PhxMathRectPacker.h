@@ -0,0 +1,244 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_RECT_PACKER_H_
+#define _PHX_MATH_RECT_PACKER_H_
+
+#include "PhxMathMemory.h"
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Rectangle Packers
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Place rectangles (glyphs, sprites, lightmap charts) in an atlas without
+// overlap. Sizes are meant to be whole pixels, the placement math is exact
+// for integer floats up to 2^24.
+//
+// MaxRectsPacker keeps the list of the largest empty rectangles of the
+// atlas (they overlap each other) and puts each new rectangle in the
+// corner of the one the heuristic likes best. It packs tightest and is the
+// one that can remove rectangles: the space goes back to the free list,
+// merged with the empty rectangles next to it (and the merged rectangles
+// with theirs, until nothing larger comes out), which is what a glyph
+// cache needs. Repeated insert/remove fragments the free space over time, when
+// inserts start failing at a low occupancy, Clear and insert again.
+//
+// SkylinePacker only keeps the top edge of what has been placed, each new
+// rectangle sits on the skyline. It is faster and packs about as well for
+// sizes sorted by height (text), but the space left under the skyline is
+// lost, so it can't remove rectangles.
+//
+// Ref: Jukka Jylanki, A Thousand Ways to Pack the Bin - A Practical
+//      Approach to Two-Dimensional Rectangle Bin Packing (2010)
+//
+// Rectangles are identified by the id Insert returns, InvalidId when they
+// don't fit. The batch inserts sort the sizes first (largest first packs
+// best) and write the id of each size at its index in the input.
+//
+// Padding is the empty space left between rectangles, not counted on the
+// atlas borders. The occupancy only counts the rectangles themselves.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    // Order of the batch inserts, all largest first.
+    namespace RectSortOrder
+    {
+        enum Type
+        {
+            None,           // Input order.
+            Area,
+            Perimeter,
+            MaxSide,        // Largest of width and height.
+            Width,
+            Height,         // Best for text, glyphs are mostly the same height.
+        };
+    }
+
+    // Free rectangle picked by MaxRectsPacker.
+    namespace MaxRectsHeuristic
+    {
+        enum Type
+        {
+            BestShortSideFit,   // Smallest leftover on the shorter side.
+            BestLongSideFit,    // Smallest leftover on the longer side.
+            BestAreaFit,        // Smallest free rectangle.
+            BottomLeft,         // Lowest top edge, then leftmost (Tetris style).
+            ContactPoint,       // Most edge length touching placed rectangles and the atlas border, scans the placed rectangles.
+        };
+    }
+
+    // Position picked by SkylinePacker.
+    namespace SkylineHeuristic
+    {
+        enum Type
+        {
+            BottomLeft,     // Lowest top edge, then the narrowest skyline segment.
+            MinWaste,       // Least area left under the rectangle, then the lowest.
+        };
+    }
+
+    class MaxRectsPacker
+    {
+    public:
+        static const unsigned int InvalidId = 0xFFFFFFFF;
+
+    public:
+        MaxRectsPacker(float width, float height, float padding = 0.0f, MaxRectsHeuristic::Type heuristic = MaxRectsHeuristic::BestShortSideFit);
+        ~MaxRectsPacker();
+
+        unsigned int Insert(float width, float height);
+        unsigned int Insert(const Vector2 & size);
+
+        // Writes the id of pSizes[i] to pOutIds[i] and returns the number of sizes that fit.
+        unsigned int Insert(const Vector2 * pSizes, unsigned int count, RectSortOrder::Type order, unsigned int * pOutIds);
+
+        void Remove(unsigned int id);
+        void Clear();
+
+        const Rect & GetRect(unsigned int id) const;
+
+        unsigned int GetCount() const;
+        float GetWidth() const;
+        float GetHeight() const;
+
+        MaxRectsHeuristic::Type GetHeuristic() const;
+        void SetHeuristic(MaxRectsHeuristic::Type heuristic);
+
+        // Area of the rectangles, and that area over the area of the atlas.
+        float GetUsedArea() const;
+        float GetOccupancy() const;
+
+        // Size of the free list, grows with fragmentation and is what Insert scans.
+        unsigned int GetFreeRectCount() const;
+
+    private:
+        // Non-copyable.
+        MaxRectsPacker(const MaxRectsPacker &);
+        MaxRectsPacker & operator=(const MaxRectsPacker &);
+
+        struct Entry
+        {
+            Rect Bounds;
+            unsigned int Next;      // Next free entry, or InUse.
+        };
+
+        bool FindPosition(float width, float height, Rect & out) const;
+        float GetContactLength(const Rect & r) const;
+
+        void SplitFreeRects(const Rect & used);
+        void MergeFreeRects(const Rect & freed);
+        void MergeFreeRect(const Rect & freed);
+        void AddFreeRects();
+
+    private:
+        float m_width;
+        float m_height;
+        float m_padding;
+        MaxRectsHeuristic::Type m_heuristic;
+
+        AlignedArray<Entry> m_entries;
+        unsigned int m_freeEntry;
+        unsigned int m_count;
+        float m_usedArea;
+
+        // In the atlas grown by the padding on the right and top, with the rectangles grown the same way.
+        AlignedArray<Rect> m_freeRects;
+
+        // Free list update scratch.
+        AlignedArray<Rect> m_newRects;
+        AlignedArray<Rect> m_nearRects;         // Free rectangles that touch the used (or freed) one.
+        AlignedArray<unsigned int> m_nearIndices;
+        AlignedArray<Rect> m_mergeRects;        // Free rectangles added by a merge, still to be merged themselves.
+
+        // Batch insert scratch.
+        AlignedArray<unsigned int> m_order;
+    };
+
+    class SkylinePacker
+    {
+    public:
+        static const unsigned int InvalidId = 0xFFFFFFFF;
+
+    public:
+        SkylinePacker(float width, float height, float padding = 0.0f, SkylineHeuristic::Type heuristic = SkylineHeuristic::BottomLeft);
+        ~SkylinePacker();
+
+        unsigned int Insert(float width, float height);
+        unsigned int Insert(const Vector2 & size);
+
+        // Writes the id of pSizes[i] to pOutIds[i] and returns the number of sizes that fit.
+        unsigned int Insert(const Vector2 * pSizes, unsigned int count, RectSortOrder::Type order, unsigned int * pOutIds);
+
+        void Clear();
+
+        const Rect & GetRect(unsigned int id) const;
+
+        unsigned int GetCount() const;
+        float GetWidth() const;
+        float GetHeight() const;
+
+        SkylineHeuristic::Type GetHeuristic() const;
+        void SetHeuristic(SkylineHeuristic::Type heuristic);
+
+        // Area of the rectangles, and that area over the area of the atlas.
+        float GetUsedArea() const;
+        float GetOccupancy() const;
+
+    private:
+        // Non-copyable.
+        SkylinePacker(const SkylinePacker &);
+        SkylinePacker & operator=(const SkylinePacker &);
+
+        struct Segment
+        {
+            float X;
+            float Y;
+            float Width;
+        };
+
+        bool Fit(unsigned int segment, float width, float height, float & outY, float & outWaste) const;
+        void AddSegment(unsigned int segment, float x, float y, float width);
+
+    private:
+        float m_width;
+        float m_height;
+        float m_padding;
+        SkylineHeuristic::Type m_heuristic;
+
+        AlignedArray<Rect> m_rects;
+        float m_usedArea;
+
+        AlignedArray<Segment> m_skyline;    // Left to right, covering the atlas grown by the padding.
+
+        // Batch insert scratch.
+        AlignedArray<unsigned int> m_order;
+    };
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_RECT_PACKER_H_
@@ -0,0 +1,597 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMath.h"
+
+// C Standard Library Includes
+#include <stddef.h>
+
+// C++ Standard Library Includes
+#include <atomic>
+#include <mutex>
+
+namespace Phx {
+namespace Math {
+
+    thread_local unsigned int t_shadowCountdown[ShadowOp::Count] = { };
+
+    namespace
+    {
+        const char * s_shadowOpNames[ShadowOp::Count] =
+        {
+            "Sin",
+            "Cos",
+            "Tan",
+            "ASin",
+            "ACos",
+            "ATan",
+            "ATan2",
+            "InvSqrt",
+            "Vector2Normalize",
+            "Vector3Normalize",
+            "Vector4Normalize",
+            "QuaternionNormalize",
+            "QuaternionSlerp",
+            "MatrixInverse",
+            "MatrixDecompose",
+        };
+
+        const unsigned int DefaultShadowSampleRate = 1024;
+        const unsigned int MaxShadowSampleRate = 0x7FFFFFFF;
+
+        // While sampling is off the rate is checked again after this many calls.
+        const unsigned int DisabledShadowCountdown = 64 * 1024;
+
+        std::atomic<unsigned int> s_shadowSampleRate(DefaultShadowSampleRate);
+
+        // Set while a shadow function runs the float function, so the functions it calls aren't sampled too.
+        thread_local bool t_inShadowSample = false;
+        thread_local uint32_t t_shadowRandom = 0;
+
+        struct ShadowAccumulator
+        {
+            uint64_t Samples;
+            uint64_t NonFinite;
+            double MaxUlps;
+            double SumUlps;
+            uint64_t Histogram[ShadowHistogramBucketCount];
+        };
+
+        struct ShadowState
+        {
+            std::mutex Mutex;       // Guards Ops.
+            ShadowAccumulator Ops[ShadowOp::Count];
+        };
+
+        ShadowState & GetShadowState()
+        {
+            // Never destroyed, threads can still be exiting while the statics are torn down.
+            static ShadowState * s_pState = new ShadowState();
+            return *s_pState;
+        }
+
+        unsigned int NextShadowCountdown(unsigned int rate)
+        {
+            if (rate <= 1)
+            {
+                return (rate == 0) ? DisabledShadowCountdown : 1;
+            }
+
+            // xorshift32, seeded from the address of the thread local so every thread gets a different sequence.
+            uint32_t x = t_shadowRandom;
+            if (x == 0)
+            {
+                x = static_cast<uint32_t>(reinterpret_cast<size_t>(&t_shadowRandom) >> 4) | 1;
+            }
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            t_shadowRandom = x;
+
+            // Uniform in [1, 2 * rate - 1], the average interval is rate.
+            return 1 + (x % (2 * rate - 1));
+        }
+
+        class ShadowScope
+        {
+        public:
+            ShadowScope() { t_inShadowSample = true; }
+            ~ShadowScope() { t_inShadowSample = false; }
+        };
+
+        bool IsFinite(double d)
+        {
+            return (d - d == 0.0);
+        }
+
+        double GetFloatUlp(double magnitude)
+        {
+            // Spacing of the floats around magnitude, magnitude is rounded to float first.
+            const float f = static_cast<float>(magnitude);
+            if (f == 0.0f)
+            {
+                return ldexp(1.0, -149);
+            }
+
+            int exponent;
+            frexp(f, &exponent);
+            return ldexp(1.0, (exponent - 24 < -149) ? -149 : exponent - 24);
+        }
+
+        // Error of the float results in ULPs of the largest reference component, negative if
+        // only one of a result and its reference is finite.
+        double MeasureUlps(const float * pResult, const double * pReference, unsigned int count)
+        {
+            double largest = 0.0;
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                const double reference = static_cast<float>(pReference[i]);
+                const bool resultFinite = IsFinite(pResult[i]);
+                const bool referenceFinite = IsFinite(reference);
+
+                if (resultFinite != referenceFinite)
+                {
+                    return -1.0;
+                }
+
+                if (false == resultFinite)
+                {
+                    // Both NaN or the same infinity.
+                    if ((pResult[i] == pResult[i] || reference == reference) && pResult[i] != reference)
+                    {
+                        return -1.0;
+                    }
+                    continue;
+                }
+
+                if (fabs(pReference[i]) > largest)
+                {
+                    largest = fabs(pReference[i]);
+                }
+            }
+
+            const double ulp = GetFloatUlp(largest);
+
+            double error = 0.0;
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                if (IsFinite(pResult[i]))
+                {
+                    const double e = fabs(pResult[i] - pReference[i]) / ulp;
+                    error = (e > error) ? e : error;
+                }
+            }
+            return error;
+        }
+
+        unsigned int GetShadowBucket(double ulps)
+        {
+            if (ulps < 0.5)
+            {
+                return 0;
+            }
+
+            // [2^(i - 2), 2^(i - 1)) goes in bucket i.
+            int exponent;
+            frexp(ulps, &exponent);
+            const unsigned int bucket = static_cast<unsigned int>(exponent + 1);
+            return (bucket < ShadowHistogramBucketCount) ? bucket : ShadowHistogramBucketCount - 1;
+        }
+
+        void RecordShadowSample(ShadowOp::Type op, double ulps)
+        {
+            ShadowState & state = GetShadowState();
+            std::lock_guard<std::mutex> lock(state.Mutex);
+
+            ShadowAccumulator & stats = state.Ops[op];
+            ++stats.Samples;
+
+            if (ulps < 0.0)
+            {
+                ++stats.NonFinite;
+                ++stats.Histogram[ShadowHistogramBucketCount - 1];
+                return;
+            }
+
+            stats.MaxUlps = (ulps > stats.MaxUlps) ? ulps : stats.MaxUlps;
+            stats.SumUlps += ulps;
+            ++stats.Histogram[GetShadowBucket(ulps)];
+        }
+
+        void RecordShadowSample(ShadowOp::Type op, float result, double reference)
+        {
+            RecordShadowSample(op, MeasureUlps(&result, &reference, 1));
+        }
+
+        double ClampUnit(double d)
+        {
+            return (d < -1.0) ? -1.0 : ((d > 1.0) ? 1.0 : d);
+        }
+
+        void NormalizeReference(double * pValues, unsigned int count)
+        {
+            double lengthSquared = 0.0;
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                lengthSquared += pValues[i] * pValues[i];
+            }
+
+            const double invLength = 1.0 / sqrt(lengthSquared);
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                pValues[i] *= invLength;
+            }
+        }
+
+        void ShadowNormalize(ShadowOp::Type op, const float * pIn, const float * pResult, unsigned int count)
+        {
+            double reference[4];
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                reference[i] = pIn[i];
+            }
+            NormalizeReference(reference, count);
+
+            RecordShadowSample(op, MeasureUlps(pResult, reference, count));
+        }
+
+        void QuaternionFromRotation(const double r[3][3], double q[4])
+        {
+            // Same branches as Quaternion::CreateFromMatrix.
+            const double trace = r[0][0] + r[1][1] + r[2][2];
+            if (trace >= 0.0)
+            {
+                double s = sqrt(trace + 1.0);
+                q[3] = s * 0.5;
+                s = 0.5 / s;
+                q[0] = (r[1][2] - r[2][1]) * s;
+                q[1] = (r[2][0] - r[0][2]) * s;
+                q[2] = (r[0][1] - r[1][0]) * s;
+            }
+            else if (r[0][0] > r[1][1] && r[0][0] > r[2][2])
+            {
+                double s = sqrt(r[0][0] - r[1][1] - r[2][2] + 1.0);
+                q[0] = s * 0.5;
+                s = 0.5 / s;
+                q[1] = (r[0][1] + r[1][0]) * s;
+                q[2] = (r[0][2] + r[2][0]) * s;
+                q[3] = (r[1][2] - r[2][1]) * s;
+            }
+            else if (r[1][1] > r[2][2])
+            {
+                double s = sqrt(r[1][1] - r[0][0] - r[2][2] + 1.0);
+                q[1] = s * 0.5;
+                s = 0.5 / s;
+                q[0] = (r[0][1] + r[1][0]) * s;
+                q[2] = (r[1][2] + r[2][1]) * s;
+                q[3] = (r[2][0] - r[0][2]) * s;
+            }
+            else
+            {
+                double s = sqrt(r[2][2] - r[0][0] - r[1][1] + 1.0);
+                q[2] = s * 0.5;
+                s = 0.5 / s;
+                q[0] = (r[0][2] + r[2][0]) * s;
+                q[1] = (r[1][2] + r[2][1]) * s;
+                q[3] = (r[0][1] - r[1][0]) * s;
+            }
+        }
+    }
+
+    void SetShadowSampleRate(unsigned int oneIn)
+    {
+        s_shadowSampleRate.store((oneIn < MaxShadowSampleRate) ? oneIn : MaxShadowSampleRate, std::memory_order_relaxed);
+    }
+
+    unsigned int GetShadowSampleRate()
+    {
+        return s_shadowSampleRate.load(std::memory_order_relaxed);
+    }
+
+    void GetShadowReport(ShadowReport & out)
+    {
+        ShadowState & state = GetShadowState();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+
+        for (unsigned int i = 0; i < ShadowOp::Count; ++i)
+        {
+            const ShadowAccumulator & stats = state.Ops[i];
+            const uint64_t finiteSamples = stats.Samples - stats.NonFinite;
+
+            out.Ops[i].Samples = stats.Samples;
+            out.Ops[i].NonFinite = stats.NonFinite;
+            out.Ops[i].MaxUlps = stats.MaxUlps;
+            out.Ops[i].MeanUlps = (finiteSamples > 0) ? (stats.SumUlps / static_cast<double>(finiteSamples)) : 0.0;
+            for (unsigned int j = 0; j < ShadowHistogramBucketCount; ++j)
+            {
+                out.Ops[i].Histogram[j] = stats.Histogram[j];
+            }
+        }
+    }
+
+    void ResetShadowReport()
+    {
+        ShadowState & state = GetShadowState();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+
+        memset(state.Ops, 0, sizeof(state.Ops));
+    }
+
+    const char * GetShadowOpName(ShadowOp::Type op)
+    {
+        DebugAssert(op < ShadowOp::Count, "Invalid shadow op (%d)!", op);
+        return s_shadowOpNames[op];
+    }
+
+    double GetShadowBucketLimit(unsigned int bucket)
+    {
+        DebugAssert(bucket < ShadowHistogramBucketCount, "Invalid shadow histogram bucket (%u)!", bucket);
+        return (bucket + 1 < ShadowHistogramBucketCount) ? ldexp(1.0, static_cast<int>(bucket) - 1) : HUGE_VAL;
+    }
+
+    bool BeginShadowSample(ShadowOp::Type op)
+    {
+        unsigned int & countdown = t_shadowCountdown[op];
+        const bool seeded = (countdown != 0);
+
+        const unsigned int rate = s_shadowSampleRate.load(std::memory_order_relaxed);
+        countdown = NextShadowCountdown(rate);
+
+        return (seeded && rate > 0 && false == t_inShadowSample);
+    }
+
+    float ShadowSin(float radians)
+    {
+        ShadowScope scope;
+        const float result = Sin(radians);
+        RecordShadowSample(ShadowOp::Sin, result, sin(static_cast<double>(radians)));
+        return result;
+    }
+
+    float ShadowCos(float radians)
+    {
+        ShadowScope scope;
+        const float result = Cos(radians);
+        RecordShadowSample(ShadowOp::Cos, result, cos(static_cast<double>(radians)));
+        return result;
+    }
+
+    float ShadowTan(float radians)
+    {
+        ShadowScope scope;
+        const float result = Tan(radians);
+        RecordShadowSample(ShadowOp::Tan, result, tan(static_cast<double>(radians)));
+        return result;
+    }
+
+    float ShadowASin(float f)
+    {
+        ShadowScope scope;
+        const float result = ASin(f);
+        RecordShadowSample(ShadowOp::ASin, result, asin(ClampUnit(f)));
+        return result;
+    }
+
+    float ShadowACos(float f)
+    {
+        ShadowScope scope;
+        const float result = ACos(f);
+        RecordShadowSample(ShadowOp::ACos, result, acos(ClampUnit(f)));
+        return result;
+    }
+
+    float ShadowATan(float f)
+    {
+        ShadowScope scope;
+        const float result = ATan(f);
+        RecordShadowSample(ShadowOp::ATan, result, atan(static_cast<double>(f)));
+        return result;
+    }
+
+    float ShadowATan2(float y, float x)
+    {
+        ShadowScope scope;
+        const float result = ATan2(y, x);
+        RecordShadowSample(ShadowOp::ATan2, result, (y == 0.0f && x == 0.0f) ? 0.0 : atan2(static_cast<double>(y), static_cast<double>(x)));
+        return result;
+    }
+
+    float ShadowInvSqrt(float f)
+    {
+        ShadowScope scope;
+        const float result = InvSqrt(f);
+        RecordShadowSample(ShadowOp::InvSqrt, result, 1.0 / sqrt(static_cast<double>(f)));
+        return result;
+    }
+
+    void ShadowNormalize(const Vector2 & v, Vector2 & out)
+    {
+        ShadowScope scope;
+        const Vector2 in(v);
+        Normalize(in, out);
+        ShadowNormalize(ShadowOp::Vector2Normalize, in.ToArray(), out.ToArray(), 2);
+    }
+
+    void ShadowNormalize(const Vector3 & v, Vector3 & out)
+    {
+        ShadowScope scope;
+        const Vector3 in(v);
+        Normalize(in, out);
+        ShadowNormalize(ShadowOp::Vector3Normalize, in.ToArray(), out.ToArray(), 3);
+    }
+
+    void ShadowNormalize(const Vector4 & v, Vector4 & out)
+    {
+        ShadowScope scope;
+        const Vector4 in(v);
+        Normalize(in, out);
+        ShadowNormalize(ShadowOp::Vector4Normalize, in.ToArray(), out.ToArray(), 4);
+    }
+
+    void ShadowNormalize(const Quaternion & q, Quaternion & out)
+    {
+        ShadowScope scope;
+        const Quaternion in(q);
+        Normalize(in, out);
+        ShadowNormalize(ShadowOp::QuaternionNormalize, in.ToArray(), out.ToArray(), 4);
+    }
+
+    void ShadowSlerp(const Quaternion & q1, const Quaternion & q2, float weight, Quaternion & out)
+    {
+        ShadowScope scope;
+        const Quaternion a(q1);
+        const Quaternion b(q2);
+        Slerp(a, b, weight, out);
+
+        // The exact arc, without the float version's cut off for small angles.
+        const double cosTheta = ClampUnit(static_cast<double>(a.X) * b.X + static_cast<double>(a.Y) * b.Y + static_cast<double>(a.Z) * b.Z + static_cast<double>(a.W) * b.W);
+        const double theta = acos(cosTheta);
+
+        double t1 = 1.0;
+        double t2 = 0.0;
+        if (theta > 0.0)
+        {
+            const double invSinTheta = 1.0 / sin(theta);
+            t1 = sin(theta - weight * theta) * invSinTheta;
+            t2 = sin(weight * theta) * invSinTheta;
+        }
+
+        const double reference[4] =
+        {
+            t1 * a.X + t2 * b.X,
+            t1 * a.Y + t2 * b.Y,
+            t1 * a.Z + t2 * b.Z,
+            t1 * a.W + t2 * b.W,
+        };
+        RecordShadowSample(ShadowOp::QuaternionSlerp, MeasureUlps(out.ToArray(), reference, 4));
+    }
+
+    void ShadowInverse(const Matrix4x4 & m, Matrix4x4 & out)
+    {
+        ShadowScope scope;
+        const Matrix4x4 in(m);
+        Inverse(in, out);
+
+        double a[16];
+        for (unsigned int i = 0; i < 16; ++i)
+        {
+            a[i] = in[i];
+        }
+
+        // Same Laplace expansion as Inverse, in double precision.
+        const double s0 = a[0] * a[5] - a[1] * a[4];
+        const double s1 = a[0] * a[6] - a[2] * a[4];
+        const double s2 = a[0] * a[7] - a[3] * a[4];
+        const double s3 = a[1] * a[6] - a[2] * a[5];
+        const double s4 = a[1] * a[7] - a[3] * a[5];
+        const double s5 = a[2] * a[7] - a[3] * a[6];
+
+        const double c0 = a[8] * a[13] - a[9] * a[12];
+        const double c1 = a[8] * a[14] - a[10] * a[12];
+        const double c2 = a[8] * a[15] - a[11] * a[12];
+        const double c3 = a[9] * a[14] - a[10] * a[13];
+        const double c4 = a[9] * a[15] - a[11] * a[13];
+        const double c5 = a[10] * a[15] - a[11] * a[14];
+
+        const double det = (s0 * c5) - (s1 * c4) + (s2 * c3) + (s3 * c2) - (s4 * c1) + (s5 * c0);
+        if (NearlyZero(static_cast<float>(det)))
+        {
+            // The float version returns the zero matrix, there's nothing to compare against.
+            return;
+        }
+
+        const double invDet = 1.0 / det;
+        const double reference[16] =
+        {
+            (+(a[5] * c5) - (a[6] * c4) + (a[7] * c3)) * invDet,
+            (-(a[1] * c5) + (a[2] * c4) - (a[3] * c3)) * invDet,
+            (+(a[13] * s5) - (a[14] * s4) + (a[15] * s3)) * invDet,
+            (-(a[9] * s5) + (a[10] * s4) - (a[11] * s3)) * invDet,
+
+            (-(a[4] * c5) + (a[6] * c2) - (a[7] * c1)) * invDet,
+            (+(a[0] * c5) - (a[2] * c2) + (a[3] * c1)) * invDet,
+            (-(a[12] * s5) + (a[14] * s2) - (a[15] * s1)) * invDet,
+            (+(a[8] * s5) - (a[10] * s2) + (a[11] * s1)) * invDet,
+
+            (+(a[4] * c4) - (a[5] * c2) + (a[7] * c0)) * invDet,
+            (-(a[0] * c4) + (a[1] * c2) - (a[3] * c0)) * invDet,
+            (+(a[12] * s4) - (a[13] * s2) + (a[15] * s0)) * invDet,
+            (-(a[8] * s4) + (a[9] * s2) - (a[11] * s0)) * invDet,
+
+            (-(a[4] * c3) + (a[5] * c1) - (a[6] * c0)) * invDet,
+            (+(a[0] * c3) - (a[1] * c1) + (a[2] * c0)) * invDet,
+            (-(a[12] * s3) + (a[13] * s1) - (a[14] * s0)) * invDet,
+            (+(a[8] * s3) - (a[9] * s1) + (a[10] * s0)) * invDet,
+        };
+        RecordShadowSample(ShadowOp::MatrixInverse, MeasureUlps(out.ToArray(), reference, 16));
+    }
+
+    bool ShadowDecompose(const Matrix4x4 & m, Vector3 & outScale, Quaternion & outOrientation, Vector3 & outTranslation)
+    {
+        ShadowScope scope;
+        const Matrix4x4 in(m);
+        if (false == Decompose(in, outScale, outOrientation, outTranslation))
+        {
+            return false;
+        }
+
+        double scale[3];
+        double r[3][3];
+        for (unsigned int row = 0; row < 3; ++row)
+        {
+            const double x = in[row * 4 + 0];
+            const double y = in[row * 4 + 1];
+            const double z = in[row * 4 + 2];
+
+            scale[row] = sqrt(x * x + y * y + z * z);
+            r[row][0] = x / scale[row];
+            r[row][1] = y / scale[row];
+            r[row][2] = z / scale[row];
+        }
+
+        double orientation[4];
+        QuaternionFromRotation(r, orientation);
+
+        // q and -q are the same orientation, the float and double versions can take different branches.
+        const double dot = orientation[0] * outOrientation.X + orientation[1] * outOrientation.Y + orientation[2] * outOrientation.Z + orientation[3] * outOrientation.W;
+        if (dot < 0.0)
+        {
+            for (unsigned int i = 0; i < 4; ++i)
+            {
+                orientation[i] = -orientation[i];
+            }
+        }
+
+        // The translation is copied, only the scale and orientation can have any error.
+        const double scaleUlps = MeasureUlps(outScale.ToArray(), scale, 3);
+        const double orientationUlps = MeasureUlps(outOrientation.ToArray(), orientation, 4);
+
+        RecordShadowSample(ShadowOp::MatrixDecompose, (scaleUlps < 0.0 || orientationUlps < 0.0) ? -1.0 : ((scaleUlps > orientationUlps) ? scaleUlps : orientationUlps));
+        return true;
+    }
+
+} //namespace Math
+} //namespace Phx
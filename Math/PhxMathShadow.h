@@ -0,0 +1,147 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_SHADOW_H_
+#define _PHX_MATH_SHADOW_H_
+
+// C Standard Library Includes
+#include <stdint.h>
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Shadow Precision Mode
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Define PHX_MATH_SHADOW as 1 to measure the error of the float functions
+// on real data. A sampled fraction of the calls to the functions below
+// also run a double precision reference on the same input, and the
+// difference is recorded in ULPs (units in the last place of the float
+// result) per function: max, mean and a histogram.
+//
+// Each thread keeps a countdown per function, so a call that isn't
+// sampled costs a decrement and a branch. The sample rate can be changed
+// at any time, GetShadowReport can be called from any thread.
+//
+// For vector, quaternion and matrix results every component is measured
+// in ULPs of the largest component, so a component that should be zero
+// doesn't report a huge error for a tiny absolute difference.
+//
+// Like PHX_MATH_INSTRUMENT the hooks are inlined, so define the flag for
+// the whole project.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+#ifndef PHX_MATH_SHADOW
+# define PHX_MATH_SHADOW 0
+#endif
+
+#if PHX_MATH_SHADOW
+# define PHX_MATH_SHADOW_CALL(op, call) if (::Phx::Math::SampleShadow(::Phx::Math::ShadowOp::op)) { return ::Phx::Math::call; }
+#else
+# define PHX_MATH_SHADOW_CALL(op, call) ((void)0)
+#endif
+
+namespace Phx {
+namespace Math {
+
+    namespace ShadowOp
+    {
+        enum Type
+        {
+            Sin,
+            Cos,
+            Tan,
+            ASin,
+            ACos,
+            ATan,
+            ATan2,
+            InvSqrt,
+            Vector2Normalize,
+            Vector3Normalize,
+            Vector4Normalize,
+            QuaternionNormalize,
+            QuaternionSlerp,
+            MatrixInverse,      // Singular matrices aren't sampled.
+            MatrixDecompose,    // Matrices that can't be decomposed aren't sampled.
+
+            Count
+        };
+    }
+
+    // Bucket 0 holds errors below 0.5 ULP (correctly rounded), bucket i holds errors
+    // below 2^(i - 1) ULPs, and the last bucket everything above that (including NaN and infinity).
+    static const unsigned int ShadowHistogramBucketCount = 16;
+
+    struct ShadowOpStats
+    {
+        uint64_t Samples;
+        uint64_t NonFinite;     // Float result was NaN or infinite and the reference wasn't (or the other way around).
+        double MaxUlps;         // Of the finite samples.
+        double MeanUlps;
+        uint64_t Histogram[ShadowHistogramBucketCount];
+    };
+
+    struct ShadowReport
+    {
+        ShadowOpStats Ops[ShadowOp::Count];
+    };
+
+    // One in every oneIn calls is sampled on average (randomized so periodic call patterns don't alias),
+    // 0 turns sampling off. Defaults to 1024.
+    void SetShadowSampleRate(unsigned int oneIn);
+    unsigned int GetShadowSampleRate();
+
+    void GetShadowReport(ShadowReport & out);
+    void ResetShadowReport();
+
+    const char * GetShadowOpName(ShadowOp::Type op);
+
+    // Upper limit in ULPs of a histogram bucket, infinity for the last bucket.
+    double GetShadowBucketLimit(unsigned int bucket);
+
+    // Hooks, only called by PHX_MATH_SHADOW_CALL.
+    // Each one runs the float function and the reference, records the error and returns the float result.
+    extern thread_local unsigned int t_shadowCountdown[ShadowOp::Count];
+    inline bool SampleShadow(ShadowOp::Type op);
+    bool BeginShadowSample(ShadowOp::Type op);
+
+    float ShadowSin(float radians);
+    float ShadowCos(float radians);
+    float ShadowTan(float radians);
+    float ShadowASin(float f);
+    float ShadowACos(float f);
+    float ShadowATan(float f);
+    float ShadowATan2(float y, float x);
+    float ShadowInvSqrt(float f);
+    void ShadowNormalize(const Vector2 & v, Vector2 & out);
+    void ShadowNormalize(const Vector3 & v, Vector3 & out);
+    void ShadowNormalize(const Vector4 & v, Vector4 & out);
+    void ShadowNormalize(const Quaternion & q, Quaternion & out);
+    void ShadowSlerp(const Quaternion & q1, const Quaternion & q2, float weight, Quaternion & out);
+    void ShadowInverse(const Matrix4x4 & m, Matrix4x4 & out);
+    bool ShadowDecompose(const Matrix4x4 & m, Vector3 & outScale, Quaternion & outOrientation, Vector3 & outTranslation);
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_SHADOW_H_
@@ -0,0 +1,96 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_SOA_H_
+#define _PHX_MATH_SOA_H_
+
+#include "PhxMath.h"
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Structure of Arrays
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Each component lives in its own array, so the batch operations load a
+// full register of X values, Y values... without any shuffling. Used for
+// the largest batches (particles, bones), see PhxMathBatch.h.
+//
+// The views don't own the arrays, allocate them with AlignedAllocArray or
+// AlignedArray (PhxMathMemory.h) to keep the loads on cache line
+// boundaries.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    struct Vector3SoA
+    {
+        float * X;
+        float * Y;
+        float * Z;
+    };
+
+    struct QuaternionSoA
+    {
+        float * X;
+        float * Y;
+        float * Z;
+        float * W;
+    };
+
+    // Same members as Ray, InvDirection must be kept in sync with Direction (Set does it).
+    struct RaySoA
+    {
+        Vector3SoA Origin;
+        Vector3SoA Direction;
+        Vector3SoA InvDirection;
+    };
+
+    // View of the elements starting at idx.
+    inline Vector3SoA Offset(const Vector3SoA & soa, unsigned int idx);
+    inline QuaternionSoA Offset(const QuaternionSoA & soa, unsigned int idx);
+    inline RaySoA Offset(const RaySoA & soa, unsigned int idx);
+
+    inline void Get(const Vector3SoA & soa, unsigned int idx, Vector3 & out);
+    inline void Get(const QuaternionSoA & soa, unsigned int idx, Quaternion & out);
+    inline void Get(const RaySoA & soa, unsigned int idx, Ray & out);
+
+    inline void Set(const Vector3SoA & soa, unsigned int idx, const Vector3 & v);
+    inline void Set(const QuaternionSoA & soa, unsigned int idx, const Quaternion & q);
+    inline void Set(const RaySoA & soa, unsigned int idx, const Ray & r);
+
+    inline void ToSoA(const Vector3 * pIn, const Vector3SoA & out, unsigned int count);
+    inline void ToSoA(const Quaternion * pIn, const QuaternionSoA & out, unsigned int count);
+    inline void ToSoA(const Ray * pIn, const RaySoA & out, unsigned int count);
+
+    inline void ToAoS(const Vector3SoA & in, Vector3 * pOut, unsigned int count);
+    inline void ToAoS(const QuaternionSoA & in, Quaternion * pOut, unsigned int count);
+    inline void ToAoS(const RaySoA & in, Ray * pOut, unsigned int count);
+
+} //namespace Math
+} //namespace Phx
+
+#include "PhxMathSoA.inl"
+
+#endif //_PHX_MATH_SOA_H_
@@ -0,0 +1,141 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_SOA_INL_
+#define _PHX_MATH_SOA_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline Vector3SoA Offset(const Vector3SoA & soa, unsigned int idx)
+    {
+        Vector3SoA out = { soa.X + idx, soa.Y + idx, soa.Z + idx };
+        return out;
+    }
+
+    inline QuaternionSoA Offset(const QuaternionSoA & soa, unsigned int idx)
+    {
+        QuaternionSoA out = { soa.X + idx, soa.Y + idx, soa.Z + idx, soa.W + idx };
+        return out;
+    }
+
+    inline RaySoA Offset(const RaySoA & soa, unsigned int idx)
+    {
+        RaySoA out = { Offset(soa.Origin, idx), Offset(soa.Direction, idx), Offset(soa.InvDirection, idx) };
+        return out;
+    }
+
+    inline void Get(const Vector3SoA & soa, unsigned int idx, Vector3 & out)
+    {
+        out.Set(soa.X[idx], soa.Y[idx], soa.Z[idx]);
+    }
+
+    inline void Get(const QuaternionSoA & soa, unsigned int idx, Quaternion & out)
+    {
+        out.Set(soa.X[idx], soa.Y[idx], soa.Z[idx], soa.W[idx]);
+    }
+
+    inline void Get(const RaySoA & soa, unsigned int idx, Ray & out)
+    {
+        Get(soa.Origin, idx, out.Origin);
+        Get(soa.Direction, idx, out.Direction);
+        Get(soa.InvDirection, idx, out.InvDirection);
+    }
+
+    inline void Set(const Vector3SoA & soa, unsigned int idx, const Vector3 & v)
+    {
+        soa.X[idx] = v.X;
+        soa.Y[idx] = v.Y;
+        soa.Z[idx] = v.Z;
+    }
+
+    inline void Set(const QuaternionSoA & soa, unsigned int idx, const Quaternion & q)
+    {
+        soa.X[idx] = q.X;
+        soa.Y[idx] = q.Y;
+        soa.Z[idx] = q.Z;
+        soa.W[idx] = q.W;
+    }
+
+    inline void Set(const RaySoA & soa, unsigned int idx, const Ray & r)
+    {
+        Set(soa.Origin, idx, r.Origin);
+        Set(soa.Direction, idx, r.Direction);
+        Set(soa.InvDirection, idx, r.InvDirection);
+    }
+
+    inline void ToSoA(const Vector3 * pIn, const Vector3SoA & out, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Set(out, i, pIn[i]);
+        }
+    }
+
+    inline void ToSoA(const Quaternion * pIn, const QuaternionSoA & out, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Set(out, i, pIn[i]);
+        }
+    }
+
+    inline void ToSoA(const Ray * pIn, const RaySoA & out, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Set(out, i, pIn[i]);
+        }
+    }
+
+    inline void ToAoS(const Vector3SoA & in, Vector3 * pOut, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Get(in, i, pOut[i]);
+        }
+    }
+
+    inline void ToAoS(const QuaternionSoA & in, Quaternion * pOut, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Get(in, i, pOut[i]);
+        }
+    }
+
+    inline void ToAoS(const RaySoA & in, Ray * pOut, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Get(in, i, pOut[i]);
+        }
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_SOA_INL_
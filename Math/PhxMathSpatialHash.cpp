@@ -0,0 +1,707 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMathSpatialHash.h"
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // The build first partitions the points on the top bits of their slot, one histogram per block of points,
+        // then counting sorts each bucket on its own, so the histograms stay small and the buckets sort in parallel.
+        const unsigned int BucketBits = 8;
+        const unsigned int BucketCount = 1 << BucketBits;
+        const unsigned int BuildBlockSize = 8192;
+
+        const unsigned int MinSlotBits = BucketBits;
+        const unsigned int MaxSlotBits = 30;
+
+        // Points of a row QueryRadius tests before reporting the ones in the radius.
+        const unsigned int QueryChunkSize = 64;
+
+        // Cell coordinates are clamped so they can be offset by a query range without overflowing.
+        const float CellLimit = 1073741824.0f;
+
+        int FloorToCell(float f)
+        {
+            // floorf is a library call without SSE4.1, truncate and step down for negative fractions instead.
+            f = Clamp(f, -CellLimit, CellLimit);
+            const int i = static_cast<int>(f);
+            return (f < static_cast<float>(i)) ? i - 1 : i;
+        }
+
+        unsigned int CeilLog2(unsigned int value)
+        {
+            unsigned int bits = 0;
+            while (bits < 32 && (1u << bits) < value)
+            {
+                ++bits;
+            }
+            return bits;
+        }
+
+        bool IsInCell(const int * pCell, long long x, long long y, long long z)
+        {
+            return (pCell[0] == x && pCell[1] == y && pCell[2] == z);
+        }
+
+        long long MaxOf(long long a, long long b)
+        {
+            return (a > b) ? a : b;
+        }
+
+        long long MinOf(long long a, long long b)
+        {
+            return (a < b) ? a : b;
+        }
+
+        // Max heap on distance, for the k nearest search.
+        void SiftUp(unsigned int * pIndices, float * pDistances, unsigned int i)
+        {
+            while (i > 0)
+            {
+                const unsigned int parent = (i - 1) / 2;
+                if (pDistances[parent] >= pDistances[i])
+                {
+                    break;
+                }
+
+                const float distance = pDistances[parent]; pDistances[parent] = pDistances[i]; pDistances[i] = distance;
+                const unsigned int index = pIndices[parent]; pIndices[parent] = pIndices[i]; pIndices[i] = index;
+                i = parent;
+            }
+        }
+
+        void SiftDown(unsigned int * pIndices, float * pDistances, unsigned int i, unsigned int count)
+        {
+            for (;;)
+            {
+                unsigned int largest = i;
+                const unsigned int left = 2 * i + 1;
+                const unsigned int right = left + 1;
+
+                if (left < count && pDistances[left] > pDistances[largest])
+                {
+                    largest = left;
+                }
+                if (right < count && pDistances[right] > pDistances[largest])
+                {
+                    largest = right;
+                }
+                if (largest == i)
+                {
+                    break;
+                }
+
+                const float distance = pDistances[largest]; pDistances[largest] = pDistances[i]; pDistances[i] = distance;
+                const unsigned int index = pIndices[largest]; pIndices[largest] = pIndices[i]; pIndices[i] = index;
+                i = largest;
+            }
+        }
+
+        unsigned int InsertNearest(unsigned int * pIndices, float * pDistances, unsigned int found, unsigned int k, unsigned int index, float distanceSquared)
+        {
+            if (found < k)
+            {
+                pIndices[found] = index;
+                pDistances[found] = distanceSquared;
+                SiftUp(pIndices, pDistances, found);
+                return found + 1;
+            }
+
+            pIndices[0] = index;
+            pDistances[0] = distanceSquared;
+            SiftDown(pIndices, pDistances, 0, k);
+            return found;
+        }
+
+        struct QueryRadiusArgs
+        {
+            const SpatialHashGrid * pGrid;
+            const Vector3 * pCenters;
+            float Radius;
+            unsigned int MaxNeighbors;
+            unsigned int * pOutIndices;
+            unsigned int * pOutCounts;
+        };
+
+        void QueryRadiusRange(void * pContext, unsigned int first, unsigned int count)
+        {
+            const QueryRadiusArgs & args = *static_cast<const QueryRadiusArgs *>(pContext);
+
+            for (unsigned int i = first; i < first + count; ++i)
+            {
+                unsigned int * pIndices = args.pOutIndices + static_cast<size_t>(i) * args.MaxNeighbors;
+                args.pOutCounts[i] = args.pGrid->QueryRadius(args.pCenters[i], args.Radius, pIndices, args.MaxNeighbors);
+            }
+        }
+
+        struct QueryNeighborsArgs
+        {
+            const SpatialHashGrid * pGrid;
+            const Vector3 * pPoints;
+            const unsigned int * pIndices;
+            float Radius;
+            unsigned int MaxNeighbors;
+            unsigned int * pOutIndices;
+            unsigned int * pOutCounts;
+        };
+
+        void QueryNeighborsRange(void * pContext, unsigned int first, unsigned int count)
+        {
+            const QueryNeighborsArgs & args = *static_cast<const QueryNeighborsArgs *>(pContext);
+
+            // [first, first + count) is a range of the sorted points, the results go to the input order.
+            for (unsigned int j = first; j < first + count; ++j)
+            {
+                const unsigned int i = args.pIndices[j];
+                unsigned int * pIndices = args.pOutIndices + static_cast<size_t>(i) * args.MaxNeighbors;
+                args.pOutCounts[i] = args.pGrid->QueryRadius(args.pPoints[j], args.Radius, pIndices, args.MaxNeighbors);
+            }
+        }
+    }
+
+    struct SpatialHashGrid::BuildContext
+    {
+        SpatialHashGrid * pGrid;
+        const Vector3 * pPoints;
+        unsigned int Count;
+        unsigned int BucketShift;
+        unsigned int BucketStarts[BucketCount + 1];
+    };
+
+    SpatialHashGrid::SpatialHashGrid(float cellSize)
+        : m_cellSize(cellSize)
+        , m_inverseCellSize(1.0f / cellSize)
+        , m_slotBits(MinSlotBits)
+    {
+        DebugAssert(cellSize > 0.0f, "The cell size (%f) of a spatial hash grid must be positive.", cellSize);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            m_minCell[i] = 0;
+            m_maxCell[i] = -1;
+        }
+    }
+
+    SpatialHashGrid::~SpatialHashGrid()
+    {
+    }
+
+    void SpatialHashGrid::Build(const Vector3 * pPoints, unsigned int count)
+    {
+        Build(ExecutionPolicy::CreateSequential(), pPoints, count);
+    }
+
+    void SpatialHashGrid::Build(const ExecutionPolicy & policy, const Vector3 * pPoints, unsigned int count)
+    {
+        m_slotBits = CeilLog2(count);
+        m_slotBits = (m_slotBits < MinSlotBits) ? MinSlotBits : m_slotBits;
+        m_slotBits = (m_slotBits > MaxSlotBits) ? MaxSlotBits : m_slotBits;
+
+        const unsigned int slotCount = 1u << m_slotBits;
+        const unsigned int blockCount = (count + BuildBlockSize - 1) / BuildBlockSize;
+
+        m_slotStarts.Resize(slotCount + 1);
+        m_points.Resize(count);
+        m_indices.Resize(count);
+        m_slots.Resize(count);
+        m_partition.Resize(count);
+        m_partitionSlots.Resize(count);
+        m_partitionPoints.Resize(count);
+        m_blockOffsets.Resize(blockCount * BucketCount);
+        m_blockBounds.Resize(blockCount * 6);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            m_minCell[i] = 0;
+            m_maxCell[i] = -1;
+        }
+
+        if (count == 0)
+        {
+            memset(m_slotStarts.GetData(), 0, sizeof(unsigned int) * (slotCount + 1));
+            return;
+        }
+
+        BuildContext context;
+        context.pGrid = this;
+        context.pPoints = pPoints;
+        context.Count = count;
+        context.BucketShift = m_slotBits - BucketBits;
+
+        // The block passes go over whole blocks, keep the policy's task size in points.
+        ExecutionPolicy blockPolicy = policy;
+        blockPolicy.MinElementsPerTask = policy.MinElementsPerTask / BuildBlockSize;
+        blockPolicy.MinElementsPerTask = (blockPolicy.MinElementsPerTask > 0) ? blockPolicy.MinElementsPerTask : 1;
+
+        // Slots of the points and a bucket histogram per block.
+        ParallelFor(blockPolicy, blockCount, PHX_CACHE_LINE_SIZE, HashRange, &context);
+
+        // Turn the histograms into the offset of each block in each bucket, blocks in order so the partition is stable.
+        unsigned int offset = 0;
+        for (unsigned int bucket = 0; bucket < BucketCount; ++bucket)
+        {
+            context.BucketStarts[bucket] = offset;
+            for (unsigned int block = 0; block < blockCount; ++block)
+            {
+                const unsigned int blockCountInBucket = m_blockOffsets[block * BucketCount + bucket];
+                m_blockOffsets[block * BucketCount + bucket] = offset;
+                offset += blockCountInBucket;
+            }
+        }
+        context.BucketStarts[BucketCount] = offset;
+
+        for (unsigned int block = 0; block < blockCount; ++block)
+        {
+            const int * pBounds = &m_blockBounds[block * 6];
+            for (int i = 0; i < 3; ++i)
+            {
+                m_minCell[i] = (block == 0 || pBounds[i] < m_minCell[i]) ? pBounds[i] : m_minCell[i];
+                m_maxCell[i] = (block == 0 || pBounds[i + 3] > m_maxCell[i]) ? pBounds[i + 3] : m_maxCell[i];
+            }
+        }
+
+        ParallelFor(blockPolicy, blockCount, PHX_CACHE_LINE_SIZE, PartitionRange, &context);
+
+        // Each bucket owns a contiguous range of slots and of the sorted points.
+        ExecutionPolicy bucketPolicy = policy;
+        const unsigned int pointsPerBucket = (count / BucketCount > 0) ? count / BucketCount : 1;
+        bucketPolicy.MinElementsPerTask = policy.MinElementsPerTask / pointsPerBucket;
+        bucketPolicy.MinElementsPerTask = (bucketPolicy.MinElementsPerTask > 0) ? bucketPolicy.MinElementsPerTask : 1;
+
+        ParallelFor(bucketPolicy, BucketCount, sizeof(unsigned int) << context.BucketShift, SortBucketRange, &context);
+
+        m_slotStarts[slotCount] = count;
+    }
+
+    void SpatialHashGrid::HashRange(void * pContext, unsigned int first, unsigned int count)
+    {
+        const BuildContext & context = *static_cast<const BuildContext *>(pContext);
+        SpatialHashGrid & grid = *context.pGrid;
+
+        for (unsigned int block = first; block < first + count; ++block)
+        {
+            const unsigned int begin = block * BuildBlockSize;
+            const unsigned int end = (context.Count - begin > BuildBlockSize) ? begin + BuildBlockSize : context.Count;
+
+            unsigned int * pHistogram = &grid.m_blockOffsets[block * BucketCount];
+            memset(pHistogram, 0, sizeof(unsigned int) * BucketCount);
+
+            int * pBounds = &grid.m_blockBounds[block * 6];
+            int cell[3];
+
+            grid.GetCell(context.pPoints[begin], cell);
+            for (int i = 0; i < 3; ++i)
+            {
+                pBounds[i] = cell[i];
+                pBounds[i + 3] = cell[i];
+            }
+
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                grid.GetCell(context.pPoints[i], cell);
+
+                const unsigned int slot = grid.GetSlot(cell[0], cell[1], cell[2]);
+                grid.m_slots[i] = slot;
+                ++pHistogram[slot >> context.BucketShift];
+
+                for (int j = 0; j < 3; ++j)
+                {
+                    pBounds[j] = (cell[j] < pBounds[j]) ? cell[j] : pBounds[j];
+                    pBounds[j + 3] = (cell[j] > pBounds[j + 3]) ? cell[j] : pBounds[j + 3];
+                }
+            }
+        }
+    }
+
+    void SpatialHashGrid::PartitionRange(void * pContext, unsigned int first, unsigned int count)
+    {
+        const BuildContext & context = *static_cast<const BuildContext *>(pContext);
+        SpatialHashGrid & grid = *context.pGrid;
+
+        const unsigned int * pSlots = grid.m_slots.GetData();
+        unsigned int * pPartition = grid.m_partition.GetData();
+        unsigned int * pPartitionSlots = grid.m_partitionSlots.GetData();
+        Vector3 * pPartitionPoints = grid.m_partitionPoints.GetData();
+
+        for (unsigned int block = first; block < first + count; ++block)
+        {
+            const unsigned int begin = block * BuildBlockSize;
+            const unsigned int end = (context.Count - begin > BuildBlockSize) ? begin + BuildBlockSize : context.Count;
+
+            unsigned int * pOffsets = &grid.m_blockOffsets[block * BucketCount];
+
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                // The slot and point go along so the bucket sort reads them in order.
+                const unsigned int slot = pSlots[i];
+                const unsigned int idx = pOffsets[slot >> context.BucketShift]++;
+
+                pPartition[idx] = i;
+                pPartitionSlots[idx] = slot;
+                pPartitionPoints[idx].Set(context.pPoints[i]);
+            }
+        }
+    }
+
+    void SpatialHashGrid::SortBucketRange(void * pContext, unsigned int first, unsigned int count)
+    {
+        const BuildContext & context = *static_cast<const BuildContext *>(pContext);
+        SpatialHashGrid & grid = *context.pGrid;
+
+        const unsigned int * pPartition = grid.m_partition.GetData();
+        const unsigned int * pPartitionSlots = grid.m_partitionSlots.GetData();
+        const Vector3 * pPartitionPoints = grid.m_partitionPoints.GetData();
+        unsigned int * pSlotStarts = grid.m_slotStarts.GetData();
+        Vector3 * pPoints = grid.m_points.GetData();
+        unsigned int * pIndices = grid.m_indices.GetData();
+
+        const unsigned int slotsPerBucket = 1u << context.BucketShift;
+
+        for (unsigned int bucket = first; bucket < first + count; ++bucket)
+        {
+            const unsigned int begin = context.BucketStarts[bucket];
+            const unsigned int end = context.BucketStarts[bucket + 1];
+            const unsigned int firstSlot = bucket * slotsPerBucket;
+
+            memset(pSlotStarts + firstSlot, 0, sizeof(unsigned int) * slotsPerBucket);
+
+            for (unsigned int j = begin; j < end; ++j)
+            {
+                ++pSlotStarts[pPartitionSlots[j]];
+            }
+
+            // End of each slot, then walk the points backwards so each slot ends up at its start and keeps the input order.
+            unsigned int offset = begin;
+            for (unsigned int slot = firstSlot; slot < firstSlot + slotsPerBucket; ++slot)
+            {
+                offset += pSlotStarts[slot];
+                pSlotStarts[slot] = offset;
+            }
+
+            for (unsigned int j = end; j > begin; --j)
+            {
+                const unsigned int idx = --pSlotStarts[pPartitionSlots[j - 1]];
+
+                pPoints[idx].Set(pPartitionPoints[j - 1]);
+                pIndices[idx] = pPartition[j - 1];
+            }
+        }
+    }
+
+    unsigned int SpatialHashGrid::QueryRadius(const Vector3 & center, float radius, unsigned int * pOutIndices, unsigned int maxCount) const
+    {
+        DebugAssert(radius >= 0.0f, "Negative query radius (%f).", radius);
+
+        if (m_points.IsEmpty() || maxCount == 0)
+        {
+            return 0;
+        }
+
+        const float radiusSquared = radius * radius;
+
+        int minCell[3];
+        int maxCell[3];
+        GetCell(Vector3(center.X - radius, center.Y - radius, center.Z - radius), minCell);
+        GetCell(Vector3(center.X + radius, center.Y + radius, center.Z + radius), maxCell);
+
+        unsigned long long cellCount = 1;
+        for (int i = 0; i < 3; ++i)
+        {
+            minCell[i] = (minCell[i] < m_minCell[i]) ? m_minCell[i] : minCell[i];
+            maxCell[i] = (maxCell[i] > m_maxCell[i]) ? m_maxCell[i] : maxCell[i];
+            if (minCell[i] > maxCell[i])
+            {
+                return 0;
+            }
+            cellCount *= static_cast<unsigned long long>(maxCell[i] - minCell[i] + 1);
+        }
+
+        unsigned int written = 0;
+
+        // With more cells than slots in range it is cheaper to test every point.
+        if (cellCount > m_slotStarts.GetCount() - 1)
+        {
+            for (unsigned int j = 0; j < m_points.GetCount(); ++j)
+            {
+                if (DistanceSquared(m_points[j], center) <= radiusSquared)
+                {
+                    pOutIndices[written++] = m_indices[j];
+                    if (written == maxCount)
+                    {
+                        break;
+                    }
+                }
+            }
+            return written;
+        }
+
+        const unsigned int slotMask = m_slotStarts.GetCount() - 2;
+        const unsigned int rowLength = static_cast<unsigned int>(maxCell[0] - minCell[0] + 1);
+        int cell[3];
+
+        for (int z = minCell[2]; z <= maxCell[2]; ++z)
+        {
+            for (int y = minCell[1]; y <= maxCell[1]; ++y)
+            {
+                // The cells of a row are in consecutive slots, so their points are one range of the sorted
+                // points (two when the slots wrap around the end of the table).
+                const unsigned int firstSlot = GetSlot(minCell[0], y, z);
+                const unsigned int lastSlot = (firstSlot + rowLength - 1) & slotMask;
+
+                unsigned int ranges[4] = { m_slotStarts[firstSlot], m_slotStarts[lastSlot + 1], 0, 0 };
+                if (lastSlot < firstSlot)
+                {
+                    ranges[1] = m_slotStarts[slotMask + 1];
+                    ranges[3] = m_slotStarts[lastSlot + 1];
+                }
+
+                for (int range = 0; range < 4; range += 2)
+                {
+                    for (unsigned int chunk = ranges[range]; chunk < ranges[range + 1]; chunk += QueryChunkSize)
+                    {
+                        const unsigned int chunkEnd = (ranges[range + 1] - chunk > QueryChunkSize) ? chunk + QueryChunkSize : ranges[range + 1];
+
+                        // Most points read are out of the radius and which ones is random, a branch on each would
+                        // mispredict. Every point is written to the hits and only the ones in the radius are counted.
+                        unsigned int hits[QueryChunkSize];
+                        unsigned int hitCount = 0;
+                        for (unsigned int j = chunk; j < chunkEnd; ++j)
+                        {
+                            hits[hitCount] = j;
+                            hitCount += (DistanceSquared(m_points[j], center) > radiusSquared) ? 0 : 1;
+                        }
+
+                        for (unsigned int h = 0; h < hitCount; ++h)
+                        {
+                            // Other cells can share the slots, only report the points of the row so none is reported twice.
+                            const unsigned int j = hits[h];
+                            GetCell(m_points[j], cell);
+                            if (cell[1] != y || cell[2] != z || cell[0] < minCell[0] || cell[0] > maxCell[0])
+                            {
+                                continue;
+                            }
+
+                            pOutIndices[written++] = m_indices[j];
+                            if (written == maxCount)
+                            {
+                                return written;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        return written;
+    }
+
+    void SpatialHashGrid::QueryRadius(const ExecutionPolicy & policy, const Vector3 * pCenters, unsigned int count, float radius, unsigned int maxNeighbors, unsigned int * pOutIndices, unsigned int * pOutCounts) const
+    {
+        QueryRadiusArgs args;
+        args.pGrid = this;
+        args.pCenters = pCenters;
+        args.Radius = radius;
+        args.MaxNeighbors = maxNeighbors;
+        args.pOutIndices = pOutIndices;
+        args.pOutCounts = pOutCounts;
+
+        ParallelFor(policy, count, sizeof(unsigned int), QueryRadiusRange, &args);
+    }
+
+    void SpatialHashGrid::QueryRadius(const ExecutionPolicy & policy, float radius, unsigned int maxNeighbors, unsigned int * pOutIndices, unsigned int * pOutCounts) const
+    {
+        QueryNeighborsArgs args;
+        args.pGrid = this;
+        args.pPoints = m_points.GetData();
+        args.pIndices = m_indices.GetData();
+        args.Radius = radius;
+        args.MaxNeighbors = maxNeighbors;
+        args.pOutIndices = pOutIndices;
+        args.pOutCounts = pOutCounts;
+
+        // The outputs are scattered, so the tasks can share cache lines of pOutCounts at their ends, that is only a
+        // performance issue, every element is written by one task.
+        ParallelFor(policy, m_points.GetCount(), sizeof(unsigned int), QueryNeighborsRange, &args);
+    }
+
+    unsigned int SpatialHashGrid::QueryNearest(const Vector3 & center, unsigned int k, float maxRadius, unsigned int * pOutIndices, float * pOutDistancesSquared) const
+    {
+        DebugAssert(maxRadius >= 0.0f, "Negative query radius (%f).", maxRadius);
+
+        if (m_points.IsEmpty() || k == 0)
+        {
+            return 0;
+        }
+
+        const float maxRadiusSquared = maxRadius * maxRadius;
+        const float centerCoords[3] = { center.X, center.Y, center.Z };
+
+        int centerCell[3];
+        GetCell(center, centerCell);
+
+        // Search shells of cells around the center cell, starting at the first shell that reaches an occupied cell.
+        long long firstShell = 0;
+        for (int i = 0; i < 3; ++i)
+        {
+            firstShell = MaxOf(firstShell, static_cast<long long>(m_minCell[i]) - centerCell[i]);
+            firstShell = MaxOf(firstShell, static_cast<long long>(centerCell[i]) - m_maxCell[i]);
+        }
+
+        unsigned int found = 0;
+        int cell[3];
+
+        for (long long shell = firstShell; ; ++shell)
+        {
+            const long long minZ = MaxOf(centerCell[2] - shell, m_minCell[2]);
+            const long long maxZ = MinOf(centerCell[2] + shell, m_maxCell[2]);
+            const long long minY = MaxOf(centerCell[1] - shell, m_minCell[1]);
+            const long long maxY = MinOf(centerCell[1] + shell, m_maxCell[1]);
+            const long long minX = MaxOf(centerCell[0] - shell, m_minCell[0]);
+            const long long maxX = MinOf(centerCell[0] + shell, m_maxCell[0]);
+
+            // Sparse points spread over a lot of cells, once a shell spans more cells than there are slots it is cheaper to test every point.
+            const unsigned long long shellBoxCells = static_cast<unsigned long long>(maxX - minX + 1) * static_cast<unsigned long long>(maxY - minY + 1) * static_cast<unsigned long long>(maxZ - minZ + 1);
+            if (shellBoxCells > m_slotStarts.GetCount() - 1)
+            {
+                found = 0;
+                for (unsigned int j = 0; j < m_points.GetCount(); ++j)
+                {
+                    const float distanceSquared = DistanceSquared(m_points[j], center);
+                    if (distanceSquared <= maxRadiusSquared && (found < k || distanceSquared < pOutDistancesSquared[0]))
+                    {
+                        found = InsertNearest(pOutIndices, pOutDistancesSquared, found, k, m_indices[j], distanceSquared);
+                    }
+                }
+                break;
+            }
+
+            for (long long z = minZ; z <= maxZ; ++z)
+            {
+                for (long long y = minY; y <= maxY; ++y)
+                {
+                    // Inside the shell only the two cells at the ends of the row are on it.
+                    const bool fullRow = (z == centerCell[2] - shell || z == centerCell[2] + shell || y == centerCell[1] - shell || y == centerCell[1] + shell);
+                    const long long step = (fullRow || shell == 0) ? 1 : 2 * shell;
+                    const long long firstX = fullRow ? minX : centerCell[0] - shell;
+
+                    for (long long x = firstX; x <= maxX; x += step)
+                    {
+                        if (x < minX)
+                        {
+                            continue;
+                        }
+
+                        const unsigned int slot = GetSlot(static_cast<int>(x), static_cast<int>(y), static_cast<int>(z));
+                        const unsigned int end = m_slotStarts[slot + 1];
+
+                        for (unsigned int j = m_slotStarts[slot]; j < end; ++j)
+                        {
+                            const float distanceSquared = DistanceSquared(m_points[j], center);
+                            if (distanceSquared > maxRadiusSquared || (found == k && distanceSquared >= pOutDistancesSquared[0]))
+                            {
+                                continue;
+                            }
+
+                            GetCell(m_points[j], cell);
+                            if (false == IsInCell(cell, x, y, z))
+                            {
+                                continue;
+                            }
+
+                            found = InsertNearest(pOutIndices, pOutDistancesSquared, found, k, m_indices[j], distanceSquared);
+                        }
+                    }
+                }
+            }
+
+            // Every occupied cell searched?
+            bool covered = true;
+            for (int i = 0; i < 3; ++i)
+            {
+                covered = covered && (centerCell[i] - shell <= m_minCell[i]) && (centerCell[i] + shell >= m_maxCell[i]);
+            }
+            if (covered)
+            {
+                break;
+            }
+
+            // Closest any point outside the searched cells can be.
+            float bound = FLT_MAX;
+            for (int i = 0; i < 3; ++i)
+            {
+                const float low = static_cast<float>(centerCell[i] - shell) * m_cellSize;
+                const float high = static_cast<float>(centerCell[i] + shell + 1) * m_cellSize;
+                bound = Min(bound, centerCoords[i] - low, high - centerCoords[i]);
+            }
+            bound = (bound > 0.0f) ? bound : 0.0f;
+
+            if (bound * bound > maxRadiusSquared || (found == k && bound * bound >= pOutDistancesSquared[0]))
+            {
+                break;
+            }
+        }
+
+        // Heap sort, nearest first.
+        for (unsigned int end = found; end > 1; --end)
+        {
+            const float distance = pOutDistancesSquared[0]; pOutDistancesSquared[0] = pOutDistancesSquared[end - 1]; pOutDistancesSquared[end - 1] = distance;
+            const unsigned int index = pOutIndices[0]; pOutIndices[0] = pOutIndices[end - 1]; pOutIndices[end - 1] = index;
+            SiftDown(pOutIndices, pOutDistancesSquared, 0, end - 1);
+        }
+
+        return found;
+    }
+
+    float SpatialHashGrid::GetCellSize() const
+    {
+        return m_cellSize;
+    }
+
+    unsigned int SpatialHashGrid::GetCount() const
+    {
+        return m_points.GetCount();
+    }
+
+    void SpatialHashGrid::GetCell(const Vector3 & position, int * pOutCell) const
+    {
+        pOutCell[0] = FloorToCell(position.X * m_inverseCellSize);
+        pOutCell[1] = FloorToCell(position.Y * m_inverseCellSize);
+        pOutCell[2] = FloorToCell(position.Z * m_inverseCellSize);
+    }
+
+    unsigned int SpatialHashGrid::GetSlot(int x, int y, int z) const
+    {
+        // Only y and z are hashed (Teschner et al. primes, then a Fibonacci hash to mix the top bits) and x is added,
+        // so the cells along a row land in consecutive slots and a query reads a row of cells as one range.
+        const unsigned int hash = (static_cast<unsigned int>(y) * 19349663u) ^ (static_cast<unsigned int>(z) * 83492791u);
+        return (((hash * 2654435761u) >> (32 - m_slotBits)) + static_cast<unsigned int>(x)) & ((1u << m_slotBits) - 1);
+    }
+
+} //namespace Math
+} //namespace Phx
@@ -0,0 +1,121 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_SPATIAL_HASH_H_
+#define _PHX_MATH_SPATIAL_HASH_H_
+
+#include "PhxMathExecution.h"
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Spatial Hash Grid
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Uniform grid over unbounded space for radius and nearest neighbor
+// searches in point sets that move every frame (crowds, particles).
+// Points are quantized to cubic cells of CellSize and the cell coordinates
+// are hashed into a power of two table, so distant cells can share a slot,
+// the queries only report the points of the cells they visit.
+//
+// Build copies the points sorted by slot with a counting sort, there is
+// one contiguous range of points per slot and no allocation per cell. The
+// arrays are kept between builds, so rebuilding a grid every frame only
+// allocates when the point count grows.
+//
+// Queries are fastest when the radius is at most CellSize (27 cells), so
+// the cell size is usually set to the typical query radius.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    class SpatialHashGrid
+    {
+    public:
+        explicit SpatialHashGrid(float cellSize);
+        ~SpatialHashGrid();
+
+        // Rebuilds the grid from the points, queries return indices into pPoints.
+        // The points are copied, pPoints does not have to outlive the build.
+        void Build(const Vector3 * pPoints, unsigned int count);
+        void Build(const ExecutionPolicy & policy, const Vector3 * pPoints, unsigned int count);
+
+        // Writes the indices of the points with DistanceSquared(point, center) <= radius * radius, in no particular order.
+        // Stops after maxCount points and returns the number of indices written.
+        unsigned int QueryRadius(const Vector3 & center, float radius, unsigned int * pOutIndices, unsigned int maxCount) const;
+
+        // QueryRadius for every center. The neighbors of pCenters[i] are written to pOutIndices + i * maxNeighbors
+        // and their number to pOutCounts[i].
+        void QueryRadius(const ExecutionPolicy & policy, const Vector3 * pCenters, unsigned int count, float radius, unsigned int maxNeighbors, unsigned int * pOutIndices, unsigned int * pOutCounts) const;
+
+        // QueryRadius around every point of the grid, a point is its own neighbor. Same output as passing the built
+        // points as the centers, but runs the queries in grid order so neighboring queries share cached cells.
+        void QueryRadius(const ExecutionPolicy & policy, float radius, unsigned int maxNeighbors, unsigned int * pOutIndices, unsigned int * pOutCounts) const;
+
+        // Writes the indices of the (up to) k nearest points within maxRadius of center, nearest first, and
+        // their squared distances. Both arrays need room for k elements. Returns the number of points written.
+        unsigned int QueryNearest(const Vector3 & center, unsigned int k, float maxRadius, unsigned int * pOutIndices, float * pOutDistancesSquared) const;
+
+        float GetCellSize() const;
+        unsigned int GetCount() const;
+
+    private:
+        // Non-copyable.
+        SpatialHashGrid(const SpatialHashGrid &);
+        SpatialHashGrid & operator=(const SpatialHashGrid &);
+
+        struct BuildContext;
+        static void HashRange(void * pContext, unsigned int first, unsigned int count);
+        static void PartitionRange(void * pContext, unsigned int first, unsigned int count);
+        static void SortBucketRange(void * pContext, unsigned int first, unsigned int count);
+
+        void GetCell(const Vector3 & position, int * pOutCell) const;
+        unsigned int GetSlot(int x, int y, int z) const;
+
+    private:
+        float m_cellSize;
+        float m_inverseCellSize;
+        unsigned int m_slotBits;
+
+        // Bounds of the occupied cells.
+        int m_minCell[3];
+        int m_maxCell[3];
+
+        AlignedArray<unsigned int> m_slotStarts;    // Points of slot i are [m_slotStarts[i], m_slotStarts[i + 1]).
+        AlignedArray<Vector3> m_points;             // Sorted by slot.
+        AlignedArray<unsigned int> m_indices;       // Index of each sorted point in the array passed to Build.
+
+        // Build scratch.
+        AlignedArray<unsigned int> m_slots;
+        AlignedArray<unsigned int> m_partition;
+        AlignedArray<unsigned int> m_partitionSlots;
+        AlignedArray<Vector3> m_partitionPoints;
+        AlignedArray<unsigned int> m_blockOffsets;
+        AlignedArray<int> m_blockBounds;
+    };
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_SPATIAL_HASH_H_
@@ -0,0 +1,329 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMath.h"
+#include "PhxMathBatch.h"
+#include "PhxMathMemory.h"
+
+namespace Phx {
+namespace Math {
+
+    namespace
+    {
+        // The Welzl spheres are found in double precision, the circumcenter formulas divide by
+        // squared areas and volumes that lose most of their bits in float for thin sets of points.
+        struct SphereD
+        {
+            Vector3d Center;
+            double RadiusSquared;
+        };
+
+        inline double Dot(const Vector3d & lhs, const Vector3d & rhs)
+        {
+            return lhs.X * rhs.X + lhs.Y * rhs.Y + lhs.Z * rhs.Z;
+        }
+
+        inline Vector3d Cross(const Vector3d & lhs, const Vector3d & rhs)
+        {
+            return Vector3d(lhs.Y * rhs.Z - lhs.Z * rhs.Y,
+                            lhs.Z * rhs.X - lhs.X * rhs.Z,
+                            lhs.X * rhs.Y - lhs.Y * rhs.X);
+        }
+
+        inline Vector3d Scale(const Vector3d & v, double s)
+        {
+            return Vector3d(v.X * s, v.Y * s, v.Z * s);
+        }
+
+        // Slack for points that end up on the surface, so rounding doesn't make the loops
+        // rebuild the sphere from a point that is already on it.
+        const double InsideTolerance = 1e-10;
+
+        inline bool IsInside(const SphereD & sphere, const Vector3 & p)
+        {
+            return DistanceSquared(sphere.Center, Vector3d(p)) <= sphere.RadiusSquared * (1.0 + InsideTolerance);
+        }
+
+        inline void SphereFrom(const Vector3 & p0, SphereD & out)
+        {
+            out.Center.Set(p0);
+            out.RadiusSquared = 0.0;
+        }
+
+        inline void SphereFrom(const Vector3 & p0, const Vector3 & p1, SphereD & out)
+        {
+            const Vector3d d0(p0);
+            const Vector3d d1(p1);
+
+            out.Center.Set((d0.X + d1.X) * 0.5, (d0.Y + d1.Y) * 0.5, (d0.Z + d1.Z) * 0.5);
+            out.RadiusSquared = DistanceSquared(d0, d1) * 0.25;
+        }
+
+        // Smallest of the spheres through the pairs that contains all 3 points, for collinear points.
+        void SphereFromPairs(const Vector3 * pPoints[3], SphereD & out)
+        {
+            out.RadiusSquared = DBL_MAX;
+
+            for (unsigned int i = 0; i < 3; ++i)
+            {
+                SphereD sphere;
+                SphereFrom(*pPoints[i], *pPoints[(i + 1) % 3], sphere);
+
+                if ((sphere.RadiusSquared < out.RadiusSquared) && IsInside(sphere, *pPoints[(i + 2) % 3]))
+                {
+                    out = sphere;
+                }
+            }
+        }
+
+        void SphereFrom(const Vector3 & p0, const Vector3 & p1, const Vector3 & p2, SphereD & out)
+        {
+            // Circumcircle of the triangle:
+            //   center = p0 + (|a|^2 * (b x n) + |b|^2 * (n x a)) / (2 * |n|^2), n = a x b
+
+            const Vector3d d0(p0);
+            const Vector3d a = Subtract(Vector3d(p1), d0);
+            const Vector3d b = Subtract(Vector3d(p2), d0);
+            const Vector3d n = Cross(a, b);
+
+            const double denom = 2.0 * Dot(n, n);
+            if (denom <= DBL_EPSILON * Dot(a, a) * Dot(b, b))
+            {
+                const Vector3 * pPoints[3] = { &p0, &p1, &p2 };
+                SphereFromPairs(pPoints, out);
+                return;
+            }
+
+            const Vector3d offset = Scale(Add(Scale(Cross(b, n), Dot(a, a)), Scale(Cross(n, a), Dot(b, b))), 1.0 / denom);
+
+            out.Center = Add(d0, offset);
+            out.RadiusSquared = Dot(offset, offset);
+        }
+
+        void SphereFrom(const Vector3 & p0, const Vector3 & p1, const Vector3 & p2, const Vector3 & p3, SphereD & out)
+        {
+            // Circumsphere of the tetrahedron:
+            //   center = p0 + (|a|^2 * (b x c) + |b|^2 * (c x a) + |c|^2 * (a x b)) / (2 * a . (b x c))
+
+            const Vector3d d0(p0);
+            const Vector3d a = Subtract(Vector3d(p1), d0);
+            const Vector3d b = Subtract(Vector3d(p2), d0);
+            const Vector3d c = Subtract(Vector3d(p3), d0);
+
+            const Vector3d bc = Cross(b, c);
+            const double denom = 2.0 * Dot(a, bc);
+
+            const double scale = Length(a) * Length(b) * Length(c);
+            if (fabs(denom) <= DBL_EPSILON * 16.0 * scale)
+            {
+                // Coplanar, the smallest sphere through 2 or 3 of the points that contains all 4.
+                const Vector3 * pPoints[4] = { &p0, &p1, &p2, &p3 };
+
+                out.RadiusSquared = DBL_MAX;
+                for (unsigned int skip = 0; skip < 4; ++skip)
+                {
+                    const Vector3 * pTriangle[3];
+                    for (unsigned int i = 0, j = 0; i < 4; ++i)
+                    {
+                        if (i != skip)
+                        {
+                            pTriangle[j++] = pPoints[i];
+                        }
+                    }
+
+                    SphereD sphere;
+                    SphereFrom(*pTriangle[0], *pTriangle[1], *pTriangle[2], sphere);
+
+                    if ((sphere.RadiusSquared < out.RadiusSquared) && IsInside(sphere, *pPoints[skip]))
+                    {
+                        out = sphere;
+                    }
+                }
+                return;
+            }
+
+            const Vector3d offset = Scale(Add(Add(Scale(bc, Dot(a, a)), Scale(Cross(c, a), Dot(b, b))), Scale(Cross(a, b), Dot(c, c))), 1.0 / denom);
+
+            out.Center = Add(d0, offset);
+            out.RadiusSquared = Dot(offset, offset);
+        }
+
+        // Grows the radius until every point is inside in float, so Contains holds for all the
+        // points even after the center was rounded.
+        void FitRadius(const Vector3 * pPoints, unsigned int count, Sphere & sphere)
+        {
+            float maxDistanceSquared = 0.0f;
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                maxDistanceSquared = Max(maxDistanceSquared, DistanceSquared(sphere.Center, pPoints[i]));
+            }
+
+            float radius = Sqrt(maxDistanceSquared);
+            for (unsigned int step = 0; step < Sphere::MaxRadiusSteps && radius * radius < maxDistanceSquared; ++step)
+            {
+                radius = nextafterf(radius, FLT_MAX);
+            }
+
+            sphere.Radius = radius;
+        }
+    }
+
+    Sphere Sphere::CreateFromPoints(const Vector3 * pPoints, unsigned int count)
+    {
+        Sphere out;
+        CreateFromPoints(pPoints, count, out);
+        return out;
+    }
+
+    void Sphere::CreateFromPoints(const Vector3 * pPoints, unsigned int count, Sphere & out)
+    {
+        DebugAssert(count > 0, "Cannot create a sphere from an empty array of points.");
+        if (count == 0)
+        {
+            out.Set(Vector3::Zero, 0.0f);
+            return;
+        }
+
+        // Start from the pair of extreme points that are farthest apart.
+        unsigned int extremes[6];
+        FindExtremePoints(pPoints, count, extremes);
+
+        unsigned int axis = 0;
+        float maxDistanceSquared = -1.0f;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            const float distanceSquared = DistanceSquared(pPoints[extremes[i * 2]], pPoints[extremes[i * 2 + 1]]);
+            if (distanceSquared > maxDistanceSquared)
+            {
+                maxDistanceSquared = distanceSquared;
+                axis = i;
+            }
+        }
+
+        const Vector3 & p0 = pPoints[extremes[axis * 2]];
+        const Vector3 & p1 = pPoints[extremes[axis * 2 + 1]];
+
+        Vector3 center = Multiply(Add(p0, p1), 0.5f);
+        float radius = Sqrt(maxDistanceSquared) * 0.5f;
+
+        // Grow the sphere just enough to take in each point that is outside,
+        // keeping the side opposite the point where it is.
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            const float distanceSquared = DistanceSquared(center, pPoints[i]);
+            if (distanceSquared > radius * radius)
+            {
+                const float distance = Sqrt(distanceSquared);
+                const float newRadius = (radius + distance) * 0.5f;
+
+                center = Add(center, Multiply(Subtract(pPoints[i], center), (newRadius - radius) / distance));
+                radius = newRadius;
+            }
+        }
+
+        out.Center.Set(center);
+        FitRadius(pPoints, count, out);
+    }
+
+    Sphere Sphere::CreateFromPointsExact(const Vector3 * pPoints, unsigned int count)
+    {
+        Sphere out;
+        CreateFromPointsExact(pPoints, count, out);
+        return out;
+    }
+
+    void Sphere::CreateFromPointsExact(const Vector3 * pPoints, unsigned int count, Sphere & out)
+    {
+        DebugAssert(count > 0, "Cannot create a sphere from an empty array of points.");
+        if (count == 0)
+        {
+            out.Set(Vector3::Zero, 0.0f);
+            return;
+        }
+
+        // The expected linear time depends on the points being in random order, sorted or
+        // scanline ordered input is the worst case. A fixed seed keeps the result repeatable.
+        AlignedArray<Vector3> points(count);
+        memcpy(static_cast<void *>(points.GetData()), pPoints, sizeof(Vector3) * count);
+
+        uint32_t seed = 0x9E3779B9u;
+        for (unsigned int i = count - 1; i > 0; --i)
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+
+            Swap(points[i], points[seed % (i + 1)]);
+        }
+
+        // Each loop level adds one point that must be on the surface, the innermost
+        // sphere is the circumsphere of the 4 surface points.
+        const Vector3 * p = points.GetData();
+
+        SphereD sphere;
+        SphereFrom(p[0], sphere);
+
+        for (unsigned int i = 1; i < count; ++i)
+        {
+            if (IsInside(sphere, p[i]))
+            {
+                continue;
+            }
+
+            SphereFrom(p[i], sphere);
+            for (unsigned int j = 0; j < i; ++j)
+            {
+                if (IsInside(sphere, p[j]))
+                {
+                    continue;
+                }
+
+                SphereFrom(p[i], p[j], sphere);
+                for (unsigned int k = 0; k < j; ++k)
+                {
+                    if (IsInside(sphere, p[k]))
+                    {
+                        continue;
+                    }
+
+                    SphereFrom(p[i], p[j], p[k], sphere);
+                    for (unsigned int l = 0; l < k; ++l)
+                    {
+                        if (false == IsInside(sphere, p[l]))
+                        {
+                            SphereFrom(p[i], p[j], p[k], p[l], sphere);
+                        }
+                    }
+                }
+            }
+        }
+
+        out.Center.Set(static_cast<float>(sphere.Center.X), static_cast<float>(sphere.Center.Y), static_cast<float>(sphere.Center.Z));
+        FitRadius(pPoints, count, out);
+    }
+
+} //namespace Math
+} //namespace Phx
@@ -0,0 +1,126 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_SPHERE_H_
+#define _PHX_MATH_SPHERE_H_
+
+namespace Phx {
+namespace Math {
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Bounding Sphere
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // CreateFromPoints is Ritter's method: two passes over the points after
+    // the extreme points are found with the batch kernels, the sphere is
+    // usually within 5-20% of the minimum radius.
+    // CreateFromPointsExact is Welzl's minimum sphere, written as nested
+    // loops over a shuffled copy of the points instead of recursion. It is
+    // expected linear time but well over 10x slower than Ritter's method,
+    // meant for offline tools and spheres that are built once.
+    //
+    // Both always contain every point (the radius is grown in float after
+    // the fit), and count must not be 0.
+    //
+    // Ref: Jack Ritter, An Efficient Bounding Sphere, Graphics Gems (1990)
+    //      Emo Welzl, Smallest Enclosing Disks (Balls and Ellipsoids) (1991)
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    class Sphere
+    {
+    public:
+        Vector3 Center;
+        float Radius;
+
+    public:
+        static Sphere CreateFromPoints(const Vector3 * pPoints, unsigned int count);
+        static void CreateFromPoints(const Vector3 * pPoints, unsigned int count, Sphere & out);
+
+        static Sphere CreateFromPointsExact(const Vector3 * pPoints, unsigned int count);
+        static void CreateFromPointsExact(const Vector3 * pPoints, unsigned int count, Sphere & out);
+
+        static inline Sphere CreateFromAABB(const AABB & box);
+        static inline void CreateFromAABB(const AABB & box, Sphere & out);
+
+        // The most ulps a fitted radius is grown by to cover float rounding. Rounding needs a few,
+        // the cap is there so NaN input (which Contains never holds for) can't loop forever.
+        static const unsigned int MaxRadiusSteps = 64;
+
+    public:
+        inline Sphere()
+        {
+            // Do nothing in the default ctor.
+            // So we don't have to pay for arrays or spheres initialized as an out parameter.
+        }
+        inline explicit Sphere(const Vector3 & center, float radius);
+        inline Sphere(const Sphere & src);
+
+        inline ~Sphere() { }
+
+        inline Sphere & operator=(const Sphere & rhs);
+
+        inline bool Contains(const Vector3 & p) const;
+        inline bool Contains(const Sphere & sphere) const;
+
+        inline bool Intersects(const Sphere & sphere) const;
+        inline bool Intersects(const AABB & box) const;
+
+        inline void Merge(const Vector3 & p);
+        inline void Merge(const Sphere & sphere);
+
+        inline void Set(const Vector3 & center, float radius);
+        inline void Set(const Sphere & src);
+    };
+
+    inline bool operator==(const Sphere & lhs, const Sphere & rhs);
+    inline bool operator!=(const Sphere & lhs, const Sphere & rhs);
+
+    inline bool ExactlyEqual(const Sphere & lhs, const Sphere & rhs);
+    inline bool NearlyEqual(const Sphere & lhs, const Sphere & rhs);
+
+    // Points right on the surface are contained.
+    inline bool Contains(const Sphere & sphere, const Vector3 & p);
+    inline bool Contains(const Sphere & sphere1, const Sphere & sphere2);
+
+    // Touching spheres intersect.
+    inline bool Intersects(const Sphere & sphere1, const Sphere & sphere2);
+    inline bool Intersects(const Sphere & sphere, const AABB & box);
+
+    // Smallest sphere containing both. If the centers, radii or point hold a NaN, the result
+    // does too and contains nothing.
+    inline Sphere Merge(const Sphere & sphere, const Vector3 & p);
+    inline Sphere Merge(const Sphere & sphere1, const Sphere & sphere2);
+    inline void Merge(const Sphere & sphere, const Vector3 & p, Sphere & out);
+    inline void Merge(const Sphere & sphere1, const Sphere & sphere2, Sphere & out);
+
+    // The radius is scaled by the largest stretch of the upper 3x3 of m (its largest singular value),
+    // so the sphere still contains the transformed one under non-uniform scale and shear.
+    inline Sphere Transform(const Sphere & sphere, const Matrix4x4 & m);
+    inline void Transform(const Sphere & sphere, const Matrix4x4 & m, Sphere & out);
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_SPHERE_H_
@@ -0,0 +1,275 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_SPHERE_INL_
+#define _PHX_MATH_SPHERE_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline Sphere Sphere::CreateFromAABB(const AABB & box)
+    {
+        Sphere out;
+        CreateFromAABB(box, out);
+        return out;
+    }
+
+    inline void Sphere::CreateFromAABB(const AABB & box, Sphere & out)
+    {
+        DebugAssert(false == IsEmpty(box), "Cannot create a sphere from an empty box.");
+
+        out.Center.Set(box.GetCenter());
+        out.Radius = Length(box.GetExtents());
+    }
+
+    inline Sphere::Sphere(const Vector3 & center, float radius)
+        : Center(center)
+        , Radius(radius)
+    { }
+
+    inline Sphere::Sphere(const Sphere & src)
+    {
+        Set(src);
+    }
+
+    inline Sphere & Sphere::operator=(const Sphere & rhs)
+    {
+        Set(rhs);
+        return *this;
+    }
+
+    inline bool Sphere::Contains(const Vector3 & p) const
+    {
+        return Math::Contains(*this, p);
+    }
+
+    inline bool Sphere::Contains(const Sphere & sphere) const
+    {
+        return Math::Contains(*this, sphere);
+    }
+
+    inline bool Sphere::Intersects(const Sphere & sphere) const
+    {
+        return Math::Intersects(*this, sphere);
+    }
+
+    inline bool Sphere::Intersects(const AABB & box) const
+    {
+        return Math::Intersects(*this, box);
+    }
+
+    inline void Sphere::Merge(const Vector3 & p)
+    {
+        Math::Merge(*this, p, *this);
+    }
+
+    inline void Sphere::Merge(const Sphere & sphere)
+    {
+        Math::Merge(*this, sphere, *this);
+    }
+
+    inline void Sphere::Set(const Vector3 & center, float radius)
+    {
+        this->Center.Set(center);
+        this->Radius = radius;
+    }
+
+    inline void Sphere::Set(const Sphere & src)
+    {
+        this->Center.Set(src.Center);
+        this->Radius = src.Radius;
+    }
+
+    inline bool operator==(const Sphere & lhs, const Sphere & rhs)
+    {
+        return ExactlyEqual(lhs, rhs);
+    }
+
+    inline bool operator!=(const Sphere & lhs, const Sphere & rhs)
+    {
+        return (false == ExactlyEqual(lhs, rhs));
+    }
+
+    inline bool ExactlyEqual(const Sphere & lhs, const Sphere & rhs)
+    {
+        return ExactlyEqual(lhs.Center, rhs.Center) &&
+               ExactlyEqual(lhs.Radius, rhs.Radius);
+    }
+
+    inline bool NearlyEqual(const Sphere & lhs, const Sphere & rhs)
+    {
+        return NearlyEqual(lhs.Center, rhs.Center) &&
+               NearlyEqual(lhs.Radius, rhs.Radius);
+    }
+
+    inline bool Contains(const Sphere & sphere, const Vector3 & p)
+    {
+        return DistanceSquared(sphere.Center, p) <= sphere.Radius * sphere.Radius;
+    }
+
+    inline bool Contains(const Sphere & sphere1, const Sphere & sphere2)
+    {
+        return Distance(sphere1.Center, sphere2.Center) + sphere2.Radius <= sphere1.Radius;
+    }
+
+    inline bool Intersects(const Sphere & sphere1, const Sphere & sphere2)
+    {
+        const float radius = sphere1.Radius + sphere2.Radius;
+        return DistanceSquared(sphere1.Center, sphere2.Center) <= radius * radius;
+    }
+
+    inline bool Intersects(const Sphere & sphere, const AABB & box)
+    {
+        // Distance to the closest point of the box.
+        const Vector3 closest = Clamp(sphere.Center, box.Min, box.Max);
+        return DistanceSquared(sphere.Center, closest) <= sphere.Radius * sphere.Radius;
+    }
+
+    inline Sphere Merge(const Sphere & sphere, const Vector3 & p)
+    {
+        Sphere out;
+        Merge(sphere, p, out);
+        return out;
+    }
+
+    inline Sphere Merge(const Sphere & sphere1, const Sphere & sphere2)
+    {
+        Sphere out;
+        Merge(sphere1, sphere2, out);
+        return out;
+    }
+
+    inline void Merge(const Sphere & sphere, const Vector3 & p, Sphere & out)
+    {
+        Merge(sphere, Sphere(p, 0.0f), out);
+
+        // Contains(sphere, point) compares squared distances, which can round the other way than the sphere test.
+        for (unsigned int step = 0; step < Sphere::MaxRadiusSteps && false == Contains(out, p); ++step)
+        {
+            out.Radius = nextafterf(out.Radius, FLT_MAX);
+        }
+    }
+
+    inline void Merge(const Sphere & sphere1, const Sphere & sphere2, Sphere & out)
+    {
+        const Vector3 offset = Subtract(sphere2.Center, sphere1.Center);
+        const float distance = Length(offset);
+
+        if (distance + sphere2.Radius <= sphere1.Radius)
+        {
+            out.Set(sphere1);
+            return;
+        }
+
+        if (distance + sphere1.Radius <= sphere2.Radius)
+        {
+            out.Set(sphere2);
+            return;
+        }
+
+        // Neither contains the other so distance > 0. The new sphere spans from the far side
+        // of sphere1 to the far side of sphere2 along the line between the centers.
+        const float radius = (distance + sphere1.Radius + sphere2.Radius) * 0.5f;
+        const Vector3 center = Add(sphere1.Center, Multiply(offset, (radius - sphere1.Radius) / distance));
+
+        // Grows the radius to cover the rounding of the center and radius, so Contains holds for both
+        // spheres (the same as CreateFromPoints does for its points).
+        const float reach1 = Distance(center, sphere1.Center) + sphere1.Radius;
+        const float reach2 = Distance(center, sphere2.Center) + sphere2.Radius;
+        out.Set(center, Max(radius, Max(reach1, reach2)));
+
+        for (unsigned int step = 0; step < Sphere::MaxRadiusSteps && (false == Contains(out, sphere1) || false == Contains(out, sphere2)); ++step)
+        {
+            out.Radius = nextafterf(out.Radius, FLT_MAX);
+        }
+    }
+
+    inline Sphere Transform(const Sphere & sphere, const Matrix4x4 & m)
+    {
+        Sphere out;
+        Transform(sphere, m, out);
+        return out;
+    }
+
+    inline void Transform(const Sphere & sphere, const Matrix4x4 & m, Sphere & out)
+    {
+        // The largest stretch of the upper 3x3 is the square root of the largest eigenvalue of
+        // A = M * transpose(M), found in closed form since A is symmetric. The rows are the
+        // transformed axes, so A holds their dot products. The largest row length alone is
+        // only enough when the rows are orthogonal (no shear from a non-uniformly scaled parent).
+        //
+        // Ref: Oliver K. Smith, Eigenvalues of a Symmetric 3x3 Matrix (1961)
+
+        const double r0[3] = { m.M11, m.M12, m.M13 };
+        const double r1[3] = { m.M21, m.M22, m.M23 };
+        const double r2[3] = { m.M31, m.M32, m.M33 };
+
+        const double a00 = r0[0] * r0[0] + r0[1] * r0[1] + r0[2] * r0[2];
+        const double a11 = r1[0] * r1[0] + r1[1] * r1[1] + r1[2] * r1[2];
+        const double a22 = r2[0] * r2[0] + r2[1] * r2[1] + r2[2] * r2[2];
+        const double a01 = r0[0] * r1[0] + r0[1] * r1[1] + r0[2] * r1[2];
+        const double a02 = r0[0] * r2[0] + r0[1] * r2[1] + r0[2] * r2[2];
+        const double a12 = r1[0] * r2[0] + r1[1] * r2[1] + r1[2] * r2[2];
+
+        double maxEigenvalue;
+
+        const double p1 = a01 * a01 + a02 * a02 + a12 * a12;
+        if (p1 == 0.0)
+        {
+            // Diagonal, the rows are orthogonal.
+            maxEigenvalue = (a00 > a11) ? a00 : a11;
+            maxEigenvalue = (maxEigenvalue > a22) ? maxEigenvalue : a22;
+        }
+        else
+        {
+            const double q = (a00 + a11 + a22) / 3.0;
+            const double p2 = (a00 - q) * (a00 - q) + (a11 - q) * (a11 - q) + (a22 - q) * (a22 - q) + 2.0 * p1;
+            const double p = sqrt(p2 / 6.0);
+
+            // B = (A - q * I) / p, the largest eigenvalue is q + 2p * cos(acos(det(B) / 2) / 3).
+            const double b00 = (a00 - q) / p;
+            const double b11 = (a11 - q) / p;
+            const double b22 = (a22 - q) / p;
+            const double b01 = a01 / p;
+            const double b02 = a02 / p;
+            const double b12 = a12 / p;
+
+            double r = (b00 * (b11 * b22 - b12 * b12) - b01 * (b01 * b22 - b12 * b02) + b02 * (b01 * b12 - b11 * b02)) * 0.5;
+            r = (r < -1.0) ? -1.0 : ((r > 1.0) ? 1.0 : r);
+
+            maxEigenvalue = q + 2.0 * p * cos(acos(r) / 3.0);
+        }
+
+        const float radius = sphere.Radius * static_cast<float>(sqrt(maxEigenvalue));
+
+        Transform(sphere.Center, m, out.Center);
+        out.Radius = radius;
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_SPHERE_INL_
@@ -0,0 +1,193 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#include "PhxMath.h"
+
+// C++ Standard Library Includes
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace Phx {
+namespace Math {
+
+    thread_local ThreadStats * t_pThreadStats = nullptr;
+
+    namespace
+    {
+        const char * s_statCounterNames[StatCounter::Count] =
+        {
+            "MatrixInverse",
+            "MatrixInverseSingular",
+            "MatrixDecompose",
+            "MatrixDecomposeFailed",
+            "QuaternionSlerp",
+            "QuaternionSlerpAligned",
+            "QuaternionSlerpOpposite",
+            "QuaternionNormalize",
+            "QuaternionNormalizeZero",
+            "Vector2Normalize",
+            "Vector2NormalizeZero",
+            "Vector3Normalize",
+            "Vector3NormalizeZero",
+            "Vector4Normalize",
+            "Vector4NormalizeZero",
+        };
+
+        struct StatsRegistry
+        {
+            std::mutex Mutex;                   // Guards everything below.
+            std::vector<ThreadStats *> Threads;
+            StatsSnapshot Exited;               // Totals of the threads that have exited.
+            StatsSnapshot Baseline;             // Totals at the last ResetStats.
+        };
+
+        StatsRegistry & GetStatsRegistry()
+        {
+            // Never destroyed, threads can still be exiting while the statics are torn down.
+            static StatsRegistry * s_pRegistry = new StatsRegistry();
+            return *s_pRegistry;
+        }
+
+        void AddThreadStats(const ThreadStats & stats, StatsSnapshot & out)
+        {
+            for (unsigned int i = 0; i < StatCounter::Count; ++i)
+            {
+                out.Counts[i] += stats.Counts[i].load(std::memory_order_relaxed);
+                out.Cycles[i] += stats.Cycles[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        // Caller holds the registry mutex.
+        void GetTotals(const StatsRegistry & registry, StatsSnapshot & out)
+        {
+            out = registry.Exited;
+            for (size_t i = 0; i < registry.Threads.size(); ++i)
+            {
+                AddThreadStats(*registry.Threads[i], out);
+            }
+        }
+
+        // Owns a thread's counters, folds them into the registry when the thread exits.
+        class ThreadStatsOwner
+        {
+        public:
+            ThreadStatsOwner()
+            {
+                for (unsigned int i = 0; i < StatCounter::Count; ++i)
+                {
+                    m_stats.Counts[i].store(0, std::memory_order_relaxed);
+                    m_stats.Cycles[i].store(0, std::memory_order_relaxed);
+                }
+
+                StatsRegistry & registry = GetStatsRegistry();
+                std::lock_guard<std::mutex> lock(registry.Mutex);
+                registry.Threads.push_back(&m_stats);
+            }
+
+            ~ThreadStatsOwner()
+            {
+                StatsRegistry & registry = GetStatsRegistry();
+                std::lock_guard<std::mutex> lock(registry.Mutex);
+
+                AddThreadStats(m_stats, registry.Exited);
+                for (size_t i = 0; i < registry.Threads.size(); ++i)
+                {
+                    if (registry.Threads[i] == &m_stats)
+                    {
+                        registry.Threads[i] = registry.Threads.back();
+                        registry.Threads.pop_back();
+                        break;
+                    }
+                }
+
+                t_pThreadStats = nullptr;
+                t_threadExited = true;
+            }
+
+            ThreadStats & GetStats() { return m_stats; }
+
+        public:
+            static thread_local bool t_threadExited;
+
+        private:
+            ThreadStats m_stats;
+        };
+
+        thread_local bool ThreadStatsOwner::t_threadExited = false;
+
+        // Soaks up the counts from thread local destructors that run after the owner is gone.
+        ThreadStats s_discardedStats;
+    }
+
+    ThreadStats * RegisterThreadStats()
+    {
+        if (ThreadStatsOwner::t_threadExited)
+        {
+            return &s_discardedStats;
+        }
+
+        static thread_local ThreadStatsOwner s_owner;
+        t_pThreadStats = &s_owner.GetStats();
+        return t_pThreadStats;
+    }
+
+    void GetStatsSnapshot(StatsSnapshot & out)
+    {
+        StatsRegistry & registry = GetStatsRegistry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+
+        GetTotals(registry, out);
+        for (unsigned int i = 0; i < StatCounter::Count; ++i)
+        {
+            out.Counts[i] -= registry.Baseline.Counts[i];
+            out.Cycles[i] -= registry.Baseline.Cycles[i];
+        }
+    }
+
+    void ResetStats()
+    {
+        // The live counters are only written by their own threads, so instead of
+        // clearing them the current totals are subtracted from later snapshots.
+        StatsRegistry & registry = GetStatsRegistry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+
+        GetTotals(registry, registry.Baseline);
+    }
+
+    const char * GetStatCounterName(StatCounter::Type counter)
+    {
+        DebugAssert(counter < StatCounter::Count, "Invalid stat counter (%d)!", counter);
+        return s_statCounterNames[counter];
+    }
+
+    uint64_t ReadCycleCounterFallback()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+} //namespace Math
+} //namespace Phx
@@ -0,0 +1,154 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_STATS_H_
+#define _PHX_MATH_STATS_H_
+
+// C Standard Library Includes
+#include <stdint.h>
+
+// C++ Standard Library Includes
+#include <atomic>
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Instrumentation Counters
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Define PHX_MATH_INSTRUMENT as 1 to count calls to the expensive functions
+// and how often they take a degenerate path (singular matrices, aligned
+// slerps, zero length normalizes) that is otherwise only a DebugAssert.
+// Also define PHX_MATH_INSTRUMENT_CYCLES as 1 to add up the cycles spent in
+// the functions marked as timed below.
+//
+// The counters are kept per thread and only summed when a snapshot is
+// taken, so counting is a load and a store to memory no other thread
+// writes. The functions are inlined, so the flags have to be the same for
+// every file that includes PhxMath.h (define them for the whole project).
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+#ifndef PHX_MATH_INSTRUMENT
+# define PHX_MATH_INSTRUMENT 0
+#endif
+
+#ifndef PHX_MATH_INSTRUMENT_CYCLES
+# define PHX_MATH_INSTRUMENT_CYCLES 0
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+# include <intrin.h>
+#endif
+
+#if PHX_MATH_INSTRUMENT
+# define PHX_MATH_STAT_COUNT(counter) ::Phx::Math::CountStat(::Phx::Math::StatCounter::counter)
+# define PHX_MATH_STAT_COUNT_IF(condition, counter) do { if (condition) { PHX_MATH_STAT_COUNT(counter); } } while (false)
+# if PHX_MATH_INSTRUMENT_CYCLES
+#  define PHX_MATH_STAT_TIMED(counter) ::Phx::Math::StatScope statScope(::Phx::Math::StatCounter::counter)
+# else
+#  define PHX_MATH_STAT_TIMED(counter) PHX_MATH_STAT_COUNT(counter)
+# endif
+#else
+# define PHX_MATH_STAT_COUNT(counter) ((void)0)
+# define PHX_MATH_STAT_COUNT_IF(condition, counter) ((void)0)
+# define PHX_MATH_STAT_TIMED(counter) ((void)0)
+#endif
+
+namespace Phx {
+namespace Math {
+
+    namespace StatCounter
+    {
+        enum Type
+        {
+            MatrixInverse,              // Timed.
+            MatrixInverseSingular,
+            MatrixDecompose,            // Timed.
+            MatrixDecomposeFailed,
+            QuaternionSlerp,            // Timed.
+            QuaternionSlerpAligned,     // Nearly the same orientation, too close to slerp accurately.
+            QuaternionSlerpOpposite,    // Nearly negations of each other, the arc is ill defined.
+            QuaternionNormalize,
+            QuaternionNormalizeZero,
+            Vector2Normalize,
+            Vector2NormalizeZero,
+            Vector3Normalize,
+            Vector3NormalizeZero,
+            Vector4Normalize,
+            Vector4NormalizeZero,
+
+            Count
+        };
+    }
+
+    // Totals over every thread since the last ResetStats, including threads that have exited.
+    struct StatsSnapshot
+    {
+        uint64_t Counts[StatCounter::Count];
+
+        // Only filled in for the timed counters, with PHX_MATH_INSTRUMENT_CYCLES.
+        // Time stamp counter cycles on x86, nanoseconds elsewhere.
+        uint64_t Cycles[StatCounter::Count];
+    };
+
+    void GetStatsSnapshot(StatsSnapshot & out);
+    void ResetStats();
+
+    const char * GetStatCounterName(StatCounter::Type counter);
+
+    // Per thread storage, written only by its own thread.
+    struct ThreadStats
+    {
+        std::atomic<uint64_t> Counts[StatCounter::Count];
+        std::atomic<uint64_t> Cycles[StatCounter::Count];
+    };
+
+    extern thread_local ThreadStats * t_pThreadStats;
+    ThreadStats * RegisterThreadStats();
+
+    inline void CountStat(StatCounter::Type counter);
+    inline void AddStatCycles(StatCounter::Type counter, uint64_t cycles);
+    // The time stamp counter on x86, a nanosecond clock elsewhere.
+    inline uint64_t ReadCycleCounter();
+    uint64_t ReadCycleCounterFallback();
+
+    // Counts the call on construction and adds the cycles on destruction.
+    class StatScope
+    {
+    public:
+        inline explicit StatScope(StatCounter::Type counter);
+        inline ~StatScope();
+
+    private:
+        StatScope(const StatScope &);
+        StatScope & operator=(const StatScope &);
+
+    private:
+        StatCounter::Type m_counter;
+        uint64_t m_start;
+    };
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_STATS_H_
@@ -0,0 +1,84 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_STATS_INL_
+#define _PHX_MATH_STATS_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline void CountStat(StatCounter::Type counter)
+    {
+        ThreadStats * pStats = t_pThreadStats;
+        if (pStats == nullptr)
+        {
+            pStats = RegisterThreadStats();
+        }
+
+        // Only this thread writes the counter, no need for a locked add.
+        std::atomic<uint64_t> & count = pStats->Counts[counter];
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    inline void AddStatCycles(StatCounter::Type counter, uint64_t cycles)
+    {
+        ThreadStats * pStats = t_pThreadStats;
+        if (pStats == nullptr)
+        {
+            pStats = RegisterThreadStats();
+        }
+
+        std::atomic<uint64_t> & total = pStats->Cycles[counter];
+        total.store(total.load(std::memory_order_relaxed) + cycles, std::memory_order_relaxed);
+    }
+
+    inline uint64_t ReadCycleCounter()
+    {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+        return __rdtsc();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+        return __builtin_ia32_rdtsc();
+#else
+        return ReadCycleCounterFallback();
+#endif
+    }
+
+    inline StatScope::StatScope(StatCounter::Type counter)
+        : m_counter(counter)
+    {
+        CountStat(counter);
+        m_start = ReadCycleCounter();
+    }
+
+    inline StatScope::~StatScope()
+    {
+        AddStatCycles(m_counter, ReadCycleCounter() - m_start);
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_STATS_INL_
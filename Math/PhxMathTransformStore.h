@@ -0,0 +1,181 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_TRANSFORM_STORE_H_
+#define _PHX_MATH_TRANSFORM_STORE_H_
+
+#include "PhxMathArena.h"
+
+// C Standard Library Includes
+#include <stdint.h>
+
+// C++ Standard Library Includes
+#include <atomic>
+
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// Multi Buffered Transform Store
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+// An array of transforms written by one thread (simulation) while any
+// number of threads (render, audio...) read them, without locks.
+//
+// The store keeps BufferCount copies of the array. The writer fills a copy
+// no reader is using and publishes it, which bumps the epoch and makes it
+// the copy new readers get. A reader takes a snapshot of the latest
+// published copy and keeps reading that same copy until it releases the
+// snapshot, no matter how many times the writer publishes meanwhile.
+//
+//   Simulation thread                          Render thread
+//   Span<Matrix4x4> next = store.BeginWrite(); TransformSnapshot<Matrix4x4> snapshot;
+//   ... fill next ...                          store.AcquireSnapshot(snapshot);
+//   store.Publish();                           ... read snapshot[i] ...
+//                                              snapshot.Release();
+//
+// Readers never wait on the writer. Acquiring a snapshot is an atomic
+// increment on the copy, retried only if the writer publishes at the same
+// moment. The writer waits only when every copy other than the latest is
+// still held by a reader. With the default three copies that can only
+// happen when a reader holds a snapshot across two publishes.
+//
+// Only one thread may write at a time. Until the first Publish, snapshots
+// are epoch 0 and their contents are uninitialized.
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+namespace Phx {
+namespace Math {
+
+    // Scale, rotation and translation of an object, the same parts Matrix4x4::Decompose returns.
+    struct TransformSRT
+    {
+        Quaternion Orientation;
+        Vector3 Scale;
+        Vector3 Translation;
+    };
+
+    inline Matrix4x4 ToMatrix(const TransformSRT & transform);
+    inline void ToMatrix(const TransformSRT & transform, Matrix4x4 & out);
+
+    // False if the matrix can't be decomposed, see Matrix4x4::Decompose.
+    inline bool ToTransformSRT(const Matrix4x4 & m, TransformSRT & out);
+
+    template <class T, unsigned int BufferCount>
+    class TransformStore;
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Read only view of one published copy, held until Release (or the
+    // snapshot is destroyed).
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    template <class T>
+    class TransformSnapshot
+    {
+    public:
+        inline TransformSnapshot();
+        inline ~TransformSnapshot();
+
+        inline void Release();
+
+        inline bool IsValid() const;
+
+        inline const T & operator[](unsigned int idx) const;
+
+        inline unsigned int GetCount() const;
+        inline const T * GetData() const;
+        inline Span<const T> GetSpan() const;
+
+        inline uint64_t GetEpoch() const;
+
+    private:
+        // Non-copyable, a copy would release the buffer twice.
+        TransformSnapshot(const TransformSnapshot &);
+        TransformSnapshot & operator=(const TransformSnapshot &);
+
+        template <class U, unsigned int BufferCount>
+        friend class TransformStore;
+
+    private:
+        const T * m_pData;
+        unsigned int m_count;
+        uint64_t m_epoch;
+        std::atomic<uint32_t> * m_pState;
+    };
+
+    template <class T, unsigned int BufferCount = 3>
+    class TransformStore
+    {
+    public:
+        explicit TransformStore(unsigned int count);
+        ~TransformStore();
+
+        inline unsigned int GetCount() const;
+
+        // Epoch of the latest published copy, starts at 0 and goes up by one per Publish.
+        inline uint64_t GetEpoch() const;
+
+        // Readers, any thread.
+        inline void AcquireSnapshot(TransformSnapshot<T> & out) const;
+
+        // Writer, one thread at a time.
+        // copyLatest fills the copy with the latest published values first, for writers that only change some transforms.
+        inline bool TryBeginWrite(Span<T> & out, bool copyLatest = false);
+        inline Span<T> BeginWrite(bool copyLatest = false);
+        inline uint64_t Publish();
+        inline void CancelWrite();
+
+    private:
+        // Non-copyable.
+        TransformStore(const TransformStore &);
+        TransformStore & operator=(const TransformStore &);
+
+    private:
+        static_assert(BufferCount >= 2, "A transform store needs at least two buffers.");
+
+        // Top bit set while the writer owns the buffer, the rest counts the readers holding it.
+        static const uint32_t WriterBit = 0x80000000u;
+
+        // Each buffer's state on its own cache line, so readers of one copy don't slow down readers of another.
+        struct PHX_ALIGN(PHX_CACHE_LINE_SIZE) BufferState
+        {
+            std::atomic<uint32_t> State;
+            uint64_t Epoch;
+        };
+
+        T * m_pBuffers[BufferCount];
+        mutable BufferState m_states[BufferCount];
+        std::atomic<unsigned int> m_latest;
+        std::atomic<uint64_t> m_epoch;
+        unsigned int m_count;
+        unsigned int m_writeBuffer;
+    };
+
+    typedef TransformStore<Matrix4x4> Matrix4x4Store;
+    typedef TransformStore<TransformSRT> TransformSRTStore;
+
+} //namespace Math
+} //namespace Phx
+
+#include "PhxMathTransformStore.inl"
+
+#endif //_PHX_MATH_TRANSFORM_STORE_H_
@@ -0,0 +1,269 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_TRANSFORM_STORE_INL_
+#define _PHX_MATH_TRANSFORM_STORE_INL_
+
+// C++ Standard Library Includes
+#include <thread>
+
+namespace Phx {
+namespace Math {
+
+    inline Matrix4x4 ToMatrix(const TransformSRT & transform)
+    {
+        Matrix4x4 out;
+        ToMatrix(transform, out);
+        return out;
+    }
+
+    inline void ToMatrix(const TransformSRT & transform, Matrix4x4 & out)
+    {
+        // Scale * Rotation * Translation, with row vectors the scale lands on the rows of the rotation.
+        Matrix4x4::CreateFromQuaternion(transform.Orientation, out);
+
+        out.M11 *= transform.Scale.X;
+        out.M12 *= transform.Scale.X;
+        out.M13 *= transform.Scale.X;
+
+        out.M21 *= transform.Scale.Y;
+        out.M22 *= transform.Scale.Y;
+        out.M23 *= transform.Scale.Y;
+
+        out.M31 *= transform.Scale.Z;
+        out.M32 *= transform.Scale.Z;
+        out.M33 *= transform.Scale.Z;
+
+        out.M41 = transform.Translation.X;
+        out.M42 = transform.Translation.Y;
+        out.M43 = transform.Translation.Z;
+    }
+
+    inline bool ToTransformSRT(const Matrix4x4 & m, TransformSRT & out)
+    {
+        return Decompose(m, out.Scale, out.Orientation, out.Translation);
+    }
+
+    template <class T>
+    inline TransformSnapshot<T>::TransformSnapshot()
+        : m_pData(nullptr)
+        , m_count(0)
+        , m_epoch(0)
+        , m_pState(nullptr)
+    { }
+
+    template <class T>
+    inline TransformSnapshot<T>::~TransformSnapshot()
+    {
+        Release();
+    }
+
+    template <class T>
+    inline void TransformSnapshot<T>::Release()
+    {
+        if (m_pState != nullptr)
+        {
+            m_pState->fetch_sub(1, std::memory_order_release);
+            m_pState = nullptr;
+            m_pData = nullptr;
+            m_count = 0;
+        }
+    }
+
+    template <class T>
+    inline bool TransformSnapshot<T>::IsValid() const
+    {
+        return (m_pState != nullptr);
+    }
+
+    template <class T>
+    inline const T & TransformSnapshot<T>::operator[](unsigned int idx) const
+    {
+        DebugAssert(idx < m_count, "Invalid index (%u) into a transform snapshot of size (%u)!", idx, m_count);
+        return m_pData[idx];
+    }
+
+    template <class T>
+    inline unsigned int TransformSnapshot<T>::GetCount() const
+    {
+        return m_count;
+    }
+
+    template <class T>
+    inline const T * TransformSnapshot<T>::GetData() const
+    {
+        return m_pData;
+    }
+
+    template <class T>
+    inline Span<const T> TransformSnapshot<T>::GetSpan() const
+    {
+        return Span<const T>(m_pData, m_count);
+    }
+
+    template <class T>
+    inline uint64_t TransformSnapshot<T>::GetEpoch() const
+    {
+        return m_epoch;
+    }
+
+    template <class T, unsigned int BufferCount>
+    TransformStore<T, BufferCount>::TransformStore(unsigned int count)
+        : m_latest(0)
+        , m_epoch(0)
+        , m_count(count)
+        , m_writeBuffer(BufferCount)
+    {
+        for (unsigned int i = 0; i < BufferCount; ++i)
+        {
+            m_pBuffers[i] = AlignedAllocArray<T>(count);
+            m_states[i].State.store(0, std::memory_order_relaxed);
+            m_states[i].Epoch = 0;
+        }
+    }
+
+    template <class T, unsigned int BufferCount>
+    TransformStore<T, BufferCount>::~TransformStore()
+    {
+        for (unsigned int i = 0; i < BufferCount; ++i)
+        {
+            DebugAssert(m_states[i].State.load(std::memory_order_relaxed) == 0, "Destroying a transform store with snapshots still held!");
+            AlignedFree(m_pBuffers[i]);
+        }
+    }
+
+    template <class T, unsigned int BufferCount>
+    inline unsigned int TransformStore<T, BufferCount>::GetCount() const
+    {
+        return m_count;
+    }
+
+    template <class T, unsigned int BufferCount>
+    inline uint64_t TransformStore<T, BufferCount>::GetEpoch() const
+    {
+        return m_epoch.load(std::memory_order_acquire);
+    }
+
+    template <class T, unsigned int BufferCount>
+    inline void TransformStore<T, BufferCount>::AcquireSnapshot(TransformSnapshot<T> & out) const
+    {
+        out.Release();
+
+        for (;;)
+        {
+            const unsigned int latest = m_latest.load(std::memory_order_acquire);
+            BufferState & state = m_states[latest];
+
+            // Count this reader on the buffer first, then make sure the writer hasn't taken it
+            // and that it is still the latest. Otherwise back off and try the new latest.
+            const uint32_t previous = state.State.fetch_add(1, std::memory_order_acq_rel);
+            if ((previous & WriterBit) == 0 && m_latest.load(std::memory_order_acquire) == latest)
+            {
+                out.m_pData = m_pBuffers[latest];
+                out.m_count = m_count;
+                out.m_epoch = state.Epoch;
+                out.m_pState = &state.State;
+                return;
+            }
+
+            state.State.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    template <class T, unsigned int BufferCount>
+    inline bool TransformStore<T, BufferCount>::TryBeginWrite(Span<T> & out, bool copyLatest)
+    {
+        DebugAssert(m_writeBuffer == BufferCount, "TryBeginWrite called twice without a Publish or CancelWrite!");
+
+        // Only the writer changes m_latest, so the latest buffer can't go anywhere while it is copied.
+        const unsigned int latest = m_latest.load(std::memory_order_relaxed);
+
+        for (unsigned int i = 1; i < BufferCount; ++i)
+        {
+            // Oldest first, it is the most likely to have been released by every reader.
+            const unsigned int candidate = (latest + i) % BufferCount;
+
+            uint32_t expected = 0;
+            if (m_states[candidate].State.compare_exchange_strong(expected, WriterBit, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                if (copyLatest)
+                {
+                    memcpy(static_cast<void *>(m_pBuffers[candidate]), m_pBuffers[latest], sizeof(T) * m_count);
+                }
+
+                m_writeBuffer = candidate;
+                out = Span<T>(m_pBuffers[candidate], m_count);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    template <class T, unsigned int BufferCount>
+    inline Span<T> TransformStore<T, BufferCount>::BeginWrite(bool copyLatest)
+    {
+        Span<T> out;
+        while (false == TryBeginWrite(out, copyLatest))
+        {
+            std::this_thread::yield();
+        }
+        return out;
+    }
+
+    template <class T, unsigned int BufferCount>
+    inline uint64_t TransformStore<T, BufferCount>::Publish()
+    {
+        DebugAssert(m_writeBuffer < BufferCount, "Publish called without a BeginWrite!");
+
+        const uint64_t epoch = m_epoch.load(std::memory_order_relaxed) + 1;
+
+        // Hand the buffer back to the readers before making it the latest, a reader that sees it
+        // as the latest must not find the writer bit still set.
+        BufferState & state = m_states[m_writeBuffer];
+        state.Epoch = epoch;
+        state.State.fetch_and(~WriterBit, std::memory_order_release);
+
+        m_latest.store(m_writeBuffer, std::memory_order_release);
+        m_epoch.store(epoch, std::memory_order_release);
+
+        m_writeBuffer = BufferCount;
+        return epoch;
+    }
+
+    template <class T, unsigned int BufferCount>
+    inline void TransformStore<T, BufferCount>::CancelWrite()
+    {
+        DebugAssert(m_writeBuffer < BufferCount, "CancelWrite called without a BeginWrite!");
+
+        m_states[m_writeBuffer].State.fetch_and(~WriterBit, std::memory_order_release);
+        m_writeBuffer = BufferCount;
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_TRANSFORM_STORE_INL_
@@ -610,8 +610,12 @@ namespace Math {
 
     inline void Normalize(const Vector2 & v, Vector2 & out)
     {
+        PHX_MATH_SHADOW_CALL(Vector2Normalize, ShadowNormalize(v, out));
+
         float lengthSquared = LengthSquared(v);
         DebugAssert(false == NearlyZero(lengthSquared), "Trying to normalize a zero vector!");
+        PHX_MATH_STAT_COUNT(Vector2Normalize);
+        PHX_MATH_STAT_COUNT_IF(NearlyZero(lengthSquared), Vector2NormalizeZero);
         Multiply(v, InvSqrt(lengthSquared), out);
     }
 
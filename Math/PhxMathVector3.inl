@@ -640,8 +640,12 @@ namespace Math {
 
     inline void Normalize(const Vector3 & v, Vector3 & out)
     {
+        PHX_MATH_SHADOW_CALL(Vector3Normalize, ShadowNormalize(v, out));
+
         float lengthSquared = LengthSquared(v);
         DebugAssert(false == NearlyZero(lengthSquared), "Trying to normalize a zero vector!");
+        PHX_MATH_STAT_COUNT(Vector3Normalize);
+        PHX_MATH_STAT_COUNT_IF(NearlyZero(lengthSquared), Vector3NormalizeZero);
         Multiply(v, InvSqrt(lengthSquared), out);
     }
 
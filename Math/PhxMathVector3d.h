@@ -0,0 +1,122 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_VECTOR3D_H_
+#define _PHX_MATH_VECTOR3D_H_
+
+namespace Phx {
+namespace Math {
+
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Double precision 3D position
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+    // Floats only have 24 bits of mantissa, 1000km from the origin the
+    // spacing between representable values is already 6cm. Store large
+    // world positions as Vector3d and rebase them against a nearby origin
+    // (usually the camera) before handing them to the float math types.
+    // See PhxMathRebase.h
+    //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=--=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+    class Vector3d
+    {
+    public:
+        double X;
+        double Y;
+        double Z;
+
+    public:
+        static const Vector3d Zero;
+
+    public:
+        inline Vector3d()
+        {
+            // Do nothing in the default ctor.
+            // So we don't have to pay for arrays or vectors initialized as an out parameter.
+        }
+        inline explicit Vector3d(double d);
+        inline explicit Vector3d(double x, double y, double z);
+        inline explicit Vector3d(const Vector3 & src);
+        inline Vector3d(const Vector3d & src);
+
+        inline ~Vector3d() { }
+
+        inline Vector3d & operator=(const Vector3d & rhs);
+
+        inline double & operator[](unsigned int idx);
+        inline const double & operator[](unsigned int idx) const;
+
+        inline Vector3d & operator+=(const Vector3d & rhs);
+        inline Vector3d & operator+=(const Vector3 & rhs);
+
+        inline Vector3d & operator-=(const Vector3d & rhs);
+        inline Vector3d & operator-=(const Vector3 & rhs);
+
+        inline double Length() const;
+        inline double LengthSquared() const;
+
+        inline void Set(const Vector3d & src);
+        inline void Set(const Vector3 & src);
+        inline void Set(double x, double y, double z);
+        inline void Set(double d);
+
+        inline double * ToArray();
+        inline const double * ToArray() const;
+    };
+
+    inline bool operator==(const Vector3d & lhs, const Vector3d & rhs);
+    inline bool operator!=(const Vector3d & lhs, const Vector3d & rhs);
+
+    inline Vector3d operator+(const Vector3d & lhs, const Vector3d & rhs);
+    inline Vector3d operator+(const Vector3d & lhs, const Vector3 & rhs);
+
+    inline Vector3d operator-(const Vector3d & lhs, const Vector3d & rhs);
+    inline Vector3d operator-(const Vector3d & lhs, const Vector3 & rhs);
+
+    inline bool ExactlyEqual(const Vector3d & lhs, const Vector3d & rhs);
+
+    inline Vector3d Add(const Vector3d & lhs, const Vector3d & rhs);
+    inline Vector3d Add(const Vector3d & lhs, const Vector3 & rhs);
+    inline void Add(const Vector3d & lhs, const Vector3d & rhs, Vector3d & out);
+    inline void Add(const Vector3d & lhs, const Vector3 & rhs, Vector3d & out);
+
+    inline Vector3d Subtract(const Vector3d & lhs, const Vector3d & rhs);
+    inline Vector3d Subtract(const Vector3d & lhs, const Vector3 & rhs);
+    inline void Subtract(const Vector3d & lhs, const Vector3d & rhs, Vector3d & out);
+    inline void Subtract(const Vector3d & lhs, const Vector3 & rhs, Vector3d & out);
+
+    inline double Length(const Vector3d & v);
+    inline double LengthSquared(const Vector3d & v);
+
+    inline double Distance(const Vector3d & lhs, const Vector3d & rhs);
+    inline double DistanceSquared(const Vector3d & lhs, const Vector3d & rhs);
+
+    inline Vector3d Lerp(const Vector3d & v1, const Vector3d & v2, double weight);
+    inline void Lerp(const Vector3d & v1, const Vector3d & v2, double weight, Vector3d & out);
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_VECTOR3D_H_
@@ -0,0 +1,276 @@
+/*  
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Jim Garvey
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+
+*/
+
+#ifndef _PHX_MATH_VECTOR3D_INL_
+#define _PHX_MATH_VECTOR3D_INL_
+
+namespace Phx {
+namespace Math {
+
+    inline Vector3d::Vector3d(double d)
+        : X(d), Y(d), Z(d)
+    { }
+
+    inline Vector3d::Vector3d(double x, double y, double z)
+        : X(x), Y(y), Z(z)
+    { }
+
+    inline Vector3d::Vector3d(const Vector3 & src)
+        : X(src.X), Y(src.Y), Z(src.Z)
+    { }
+
+    inline Vector3d::Vector3d(const Vector3d & src)
+    {
+        Set(src);
+    }
+
+    inline Vector3d & Vector3d::operator=(const Vector3d & rhs)
+    {
+        Set(rhs);
+        return *this;
+    }
+
+    inline double & Vector3d::operator[](unsigned int idx)
+    {
+        DebugAssert(idx < 3, "Invalid index (%u) into a vector 3d!", idx);
+        return ToArray()[idx];
+    }
+
+    inline const double & Vector3d::operator[](unsigned int idx) const
+    {
+        DebugAssert(idx < 3, "Invalid index (%u) into a vector 3d!", idx);
+        return ToArray()[idx];
+    }
+
+    inline Vector3d & Vector3d::operator+=(const Vector3d & rhs)
+    {
+        Math::Add(*this, rhs, *this);
+        return *this;
+    }
+
+    inline Vector3d & Vector3d::operator+=(const Vector3 & rhs)
+    {
+        Math::Add(*this, rhs, *this);
+        return *this;
+    }
+
+    inline Vector3d & Vector3d::operator-=(const Vector3d & rhs)
+    {
+        Math::Subtract(*this, rhs, *this);
+        return *this;
+    }
+
+    inline Vector3d & Vector3d::operator-=(const Vector3 & rhs)
+    {
+        Math::Subtract(*this, rhs, *this);
+        return *this;
+    }
+
+    inline double Vector3d::Length() const
+    {
+        return Math::Length(*this);
+    }
+
+    inline double Vector3d::LengthSquared() const
+    {
+        return Math::LengthSquared(*this);
+    }
+
+    inline void Vector3d::Set(const Vector3d & src)
+    {
+        memcpy(this, &src, sizeof(Vector3d));
+    }
+
+    inline void Vector3d::Set(const Vector3 & src)
+    {
+        this->X = src.X;
+        this->Y = src.Y;
+        this->Z = src.Z;
+    }
+
+    inline void Vector3d::Set(double x, double y, double z)
+    {
+        this->X = x;
+        this->Y = y;
+        this->Z = z;
+    }
+
+    inline void Vector3d::Set(double d)
+    {
+        this->X = d;
+        this->Y = d;
+        this->Z = d;
+    }
+
+    inline double * Vector3d::ToArray()
+    {
+        return &(this->X);
+    }
+
+    inline const double * Vector3d::ToArray() const
+    {
+        return &(this->X);
+    }
+
+    inline bool operator==(const Vector3d & lhs, const Vector3d & rhs)
+    {
+        return ExactlyEqual(lhs, rhs);
+    }
+
+    inline bool operator!=(const Vector3d & lhs, const Vector3d & rhs)
+    {
+        return (false == ExactlyEqual(lhs, rhs));
+    }
+
+    inline Vector3d operator+(const Vector3d & lhs, const Vector3d & rhs)
+    {
+        Vector3d out;
+        Add(lhs, rhs, out);
+        return out;
+    }
+
+    inline Vector3d operator+(const Vector3d & lhs, const Vector3 & rhs)
+    {
+        Vector3d out;
+        Add(lhs, rhs, out);
+        return out;
+    }
+
+    inline Vector3d operator-(const Vector3d & lhs, const Vector3d & rhs)
+    {
+        Vector3d out;
+        Subtract(lhs, rhs, out);
+        return out;
+    }
+
+    inline Vector3d operator-(const Vector3d & lhs, const Vector3 & rhs)
+    {
+        Vector3d out;
+        Subtract(lhs, rhs, out);
+        return out;
+    }
+
+    inline bool ExactlyEqual(const Vector3d & lhs, const Vector3d & rhs)
+    {
+        return ((lhs.X == rhs.X) &&
+                (lhs.Y == rhs.Y) &&
+                (lhs.Z == rhs.Z));
+    }
+
+    inline Vector3d Add(const Vector3d & lhs, const Vector3d & rhs)
+    {
+        Vector3d out;
+        Add(lhs, rhs, out);
+        return out;
+    }
+
+    inline Vector3d Add(const Vector3d & lhs, const Vector3 & rhs)
+    {
+        Vector3d out;
+        Add(lhs, rhs, out);
+        return out;
+    }
+
+    inline void Add(const Vector3d & lhs, const Vector3d & rhs, Vector3d & out)
+    {
+        out.X = lhs.X + rhs.X;
+        out.Y = lhs.Y + rhs.Y;
+        out.Z = lhs.Z + rhs.Z;
+    }
+
+    inline void Add(const Vector3d & lhs, const Vector3 & rhs, Vector3d & out)
+    {
+        out.X = lhs.X + rhs.X;
+        out.Y = lhs.Y + rhs.Y;
+        out.Z = lhs.Z + rhs.Z;
+    }
+
+    inline Vector3d Subtract(const Vector3d & lhs, const Vector3d & rhs)
+    {
+        Vector3d out;
+        Subtract(lhs, rhs, out);
+        return out;
+    }
+
+    inline Vector3d Subtract(const Vector3d & lhs, const Vector3 & rhs)
+    {
+        Vector3d out;
+        Subtract(lhs, rhs, out);
+        return out;
+    }
+
+    inline void Subtract(const Vector3d & lhs, const Vector3d & rhs, Vector3d & out)
+    {
+        out.X = lhs.X - rhs.X;
+        out.Y = lhs.Y - rhs.Y;
+        out.Z = lhs.Z - rhs.Z;
+    }
+
+    inline void Subtract(const Vector3d & lhs, const Vector3 & rhs, Vector3d & out)
+    {
+        out.X = lhs.X - rhs.X;
+        out.Y = lhs.Y - rhs.Y;
+        out.Z = lhs.Z - rhs.Z;
+    }
+
+    inline double Length(const Vector3d & v)
+    {
+        return sqrt(LengthSquared(v));
+    }
+
+    inline double LengthSquared(const Vector3d & v)
+    {
+        return ((v.X * v.X) + (v.Y * v.Y) + (v.Z * v.Z));
+    }
+
+    inline double Distance(const Vector3d & lhs, const Vector3d & rhs)
+    {
+        return Length(lhs - rhs);
+    }
+
+    inline double DistanceSquared(const Vector3d & lhs, const Vector3d & rhs)
+    {
+        return LengthSquared(lhs - rhs);
+    }
+
+    inline Vector3d Lerp(const Vector3d & v1, const Vector3d & v2, double weight)
+    {
+        Vector3d out;
+        Lerp(v1, v2, weight, out);
+        return out;
+    }
+
+    inline void Lerp(const Vector3d & v1, const Vector3d & v2, double weight, Vector3d & out)
+    {
+        out.X = v1.X + ((v2.X - v1.X) * weight);
+        out.Y = v1.Y + ((v2.Y - v1.Y) * weight);
+        out.Z = v1.Z + ((v2.Z - v1.Z) * weight);
+    }
+
+} //namespace Math
+} //namespace Phx
+
+#endif //_PHX_MATH_VECTOR3D_INL_
@@ -30,7 +30,7 @@ THE SOFTWARE
 namespace Phx {
 namespace Math {
 
-    class Vector4
+    class PHX_ALIGN(16) Vector4
     {
     public:
         float X;
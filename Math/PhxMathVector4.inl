@@ -623,8 +623,12 @@ namespace Math {
 
     inline void Normalize(const Vector4 & v, Vector4 & out)
     {
+        PHX_MATH_SHADOW_CALL(Vector4Normalize, ShadowNormalize(v, out));
+
         float lengthSquared = LengthSquared(v);
         DebugAssert(false == NearlyZero(lengthSquared), "Trying to normalize a zero vector!");
+        PHX_MATH_STAT_COUNT(Vector4Normalize);
+        PHX_MATH_STAT_COUNT_IF(NearlyZero(lengthSquared), Vector4NormalizeZero);
         Multiply(v, InvSqrt(lengthSquared), out);
     }
 